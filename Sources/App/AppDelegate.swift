@@ -46,6 +46,9 @@ class AppDelegate: NSObject, UIApplicationDelegate {
         // Setup app lifecycle notifications
         setupAppLifecycleNotifications()
         
+        // Route SDWebImage through ImageCacheManager before any WebImage view is created
+        SDWebImageBridge.install()
+        
         // Initialize memory warning manager
         _ = MemoryWarningManager.shared
         
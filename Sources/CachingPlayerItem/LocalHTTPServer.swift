@@ -33,6 +33,7 @@ private class StreamingDownloadDelegate: NSObject, URLSessionDataDelegate {
     private let sessionCleanup: () -> Void
     private let buildHeaders: (Int, [String: String]) -> Data
     private let onTotalSizeKnown: ((Int64) -> Void)?
+    private let contentType: String
     /// Called once when AVPlayer closes the proxy connection (either normally or mid-stream).
     /// Used to release the NodeConnectionPool slot early so subsequent downloads aren't blocked.
     var onConnectionDead: (() -> Void)?
@@ -54,7 +55,8 @@ private class StreamingDownloadDelegate: NSObject, URLSessionDataDelegate {
         contiguousSizeUpdate: @escaping (Int64) -> Void,
         sessionCleanup: @escaping () -> Void,
         buildHeaders: @escaping (Int, [String: String]) -> Data,
-        onTotalSizeKnown: ((Int64) -> Void)?
+        onTotalSizeKnown: ((Int64) -> Void)?,
+        contentType: String = "video/mp4"
     ) {
         self.connection = connection
         self.mediaID = mediaID
@@ -67,6 +69,7 @@ private class StreamingDownloadDelegate: NSObject, URLSessionDataDelegate {
         self.sessionCleanup = sessionCleanup
         self.buildHeaders = buildHeaders
         self.onTotalSizeKnown = onTotalSizeKnown
+        self.contentType = contentType
         self.lastPersistedContiguousSize = initialCachedSize
     }
 
@@ -80,7 +83,7 @@ private class StreamingDownloadDelegate: NSObject, URLSessionDataDelegate {
             return
         }
         var headers: [String: String] = [
-            "Content-Type": "video/mp4",
+            "Content-Type": contentType,
             "Accept-Ranges": "bytes"
         ]
         if let cl = httpResponse.allHeaderFields["Content-Length"] as? String {
@@ -348,7 +351,9 @@ public class LocalHTTPServer: @unchecked Sendable {
     }
 
     private var mediaRealURLs: [String: URL] = [:] // mediaID -> real URL
-    private let mediaLock = NSLock() // Protects mediaCache and mediaRealURLs
+    private var progressiveContentTypes: [String: String] = [:] // mediaID -> Content-Type, when not video/mp4
+    private var foregroundAudioMediaIDs: Set<String> = [] // audio the user is playing; gets primary slots
+    private let mediaLock = NSLock() // Protects mediaCache, mediaRealURLs, progressiveContentTypes, foregroundAudioMediaIDs
     // Concurrent queue: NWConnection serializes per-connection events internally, so different
     // connections can safely process in parallel. A serial queue here bottlenecks when many
     // connections have pending send completions (e.g., large progressive downloads to paused
@@ -446,6 +451,18 @@ public class LocalHTTPServer: @unchecked Sendable {
     // Only one writer per starting offset is allowed; parallel connections skip disk write.
     private var progressiveCacheWriters: Set<String> = []
     private let progressiveCacheWritersLock = NSLock()
+
+    // Alternate provider base URLs per mediaID, and mediaIDs with a multi-source fill running.
+    // Only the primary (feed or fullscreen) progressive object, at least multiSourceMinimumSize,
+    // is filled from several providers. A fill is reserved by token before its task exists.
+    private var alternateSources: [String: [URL]] = [:]
+    private var multiSourceFills: [String: (token: UUID, task: Task<Void, Never>?)] = [:]
+    private let multiSourceLock = NSLock()
+    private let multiSourceMinimumSize: Int64 = 4 * 1024 * 1024
+
+    // Serializes the read-compare-write of video.contiguous across streaming writers,
+    // the multi-source fill and metadata recovery, so the marker only moves forward.
+    private let progressiveContiguousLock = NSLock()
     
     // Connection pool for efficient HTTP requests
     private var _connectionPool: URLSession?
@@ -967,6 +984,34 @@ public class LocalHTTPServer: @unchecked Sendable {
         progressiveCacheWritersLock.lock()
         progressiveCacheWriters = progressiveCacheWriters.filter { !$0.hasPrefix(mediaID) }
         progressiveCacheWritersLock.unlock()
+
+        // 4. Stop any multi-source fill and forget alternate providers; they are
+        //    re-resolved when the media is shown again
+        let fill = multiSourceLock.withLock { () -> Task<Void, Never>? in
+            alternateSources.removeValue(forKey: mediaID)
+            return multiSourceFills.removeValue(forKey: mediaID)?.task
+        }
+        fill?.cancel()
+    }
+
+    /// Stop the multi-source fill for `mediaID` (its cell left the screen), keeping the
+    /// alternate providers so a later cache miss as primary can start it again.
+    public func stopMultiSourceFill(for mediaID: String) {
+        let fill = multiSourceLock.withLock { multiSourceFills.removeValue(forKey: mediaID)?.task }
+        if let fill {
+            fill.cancel()
+            print("📡 [MULTI-SOURCE \(shortMID(mediaID))] fill stopped: no longer visible")
+        }
+    }
+
+    /// Stop every multi-source fill except the one for `keepMediaID`.
+    private func stopMultiSourceFills(except keepMediaID: String?) {
+        let fills = multiSourceLock.withLock { () -> [Task<Void, Never>] in
+            let stale = multiSourceFills.filter { $0.key != keepMediaID }
+            stale.keys.forEach { multiSourceFills.removeValue(forKey: $0) }
+            return stale.values.compactMap { $0.task }
+        }
+        fills.forEach { $0.cancel() }
     }
 
     /// Clear stale preload cancellation state when a media cell becomes visible.
@@ -988,7 +1033,8 @@ public class LocalHTTPServer: @unchecked Sendable {
         }
 
         let cachedSize = cachedContiguousSize(for: mediaID, cacheFileURL: cacheFileURL)
-        return cachedSize >= totalSize && isValidProgressiveCache(fileURL: cacheFileURL)
+        return cachedSize >= totalSize
+            && (!isMP4Progressive(mediaID) || isValidProgressiveCache(fileURL: cacheFileURL))
     }
 
     private func trackHLSDataTask(_ task: URLSessionTask, mediaID: String, taskKey: UUID) {
@@ -1089,6 +1135,10 @@ public class LocalHTTPServer: @unchecked Sendable {
         let previousPrimary = currentPrimaryMediaID
         currentPrimaryMediaID = mediaID
         primaryMediaIDLock.unlock()
+        if mediaID != previousPrimary {
+            // Multi-source fills only serve the primary
+            stopMultiSourceFills(except: mediaID)
+        }
         if let mediaID {
             // Clear cancelled state so a preloaded-then-cancelled player can download once primary.
             Task { await activeDownloadsActor.clearCancelledMediaID(mediaID) }
@@ -1117,6 +1167,7 @@ public class LocalHTTPServer: @unchecked Sendable {
         primaryMediaIDLock.lock()
         currentPrimaryMediaID = nil
         primaryMediaIDLock.unlock()
+        stopMultiSourceFills(except: nil)
     }
 
     /// Clear the cancelled state for a mediaID so the proxy serves fresh downloads.
@@ -1146,9 +1197,14 @@ public class LocalHTTPServer: @unchecked Sendable {
         mediaLock.unlock()
     }
 
-    public func registerAndGetURL(for mediaID: String, realURL: URL) -> URL {
+    /// - Parameter contentType: Content-Type served for progressive media. Defaults to
+    ///   video/mp4; audio passes its own type so AVPlayer picks the right parser.
+    public func registerAndGetURL(for mediaID: String, realURL: URL, contentType: String? = nil) -> URL {
         mediaLock.lock()
         mediaRealURLs[mediaID] = realURL
+        if let contentType {
+            progressiveContentTypes[mediaID] = contentType
+        }
         mediaLock.unlock()
 
         // A new player is being created for this mediaID — clear any cancelled state so
@@ -1168,6 +1224,54 @@ public class LocalHTTPServer: @unchecked Sendable {
         return localhostURL
     }
 
+    private func progressiveContentType(for mediaID: String) -> String {
+        mediaLock.withLock { progressiveContentTypes[mediaID] } ?? "video/mp4"
+    }
+
+    /// The moov/ftyp validation only applies to MP4-family progressive media.
+    private func isMP4Progressive(_ mediaID: String) -> Bool {
+        let contentType = progressiveContentType(for: mediaID)
+        return contentType == "video/mp4" || contentType == "audio/mp4"
+    }
+
+    /// Mark audio the user is actively playing so its range requests take primary
+    /// slots instead of queueing behind video preloads.
+    public func setForegroundAudio(_ mediaID: String, active: Bool) {
+        mediaLock.withLock {
+            if active {
+                foregroundAudioMediaIDs.insert(mediaID)
+            } else {
+                foregroundAudioMediaIDs.remove(mediaID)
+            }
+        }
+    }
+
+    private func isForegroundAudio(_ mediaID: String) -> Bool {
+        mediaLock.withLock { foregroundAudioMediaIDs.contains(mediaID) }
+    }
+
+    /// Warm the progressive cache with the first `byteCount` bytes of a registered media.
+    /// Goes through the proxy itself, so the fetch uses the same node slots and cache
+    /// writer as playback and a later play starts from disk.
+    public func prefetchProgressivePrefix(mediaID: String, byteCount: Int64) {
+        guard byteCount > 0, isRunning,
+              let realURL = getRealURL(for: mediaID),
+              let localURL = URL(string: "\(Constants.LOCAL_HOST):\(port)\(realURL.path)") else { return }
+        let cacheFileURL = progressiveCacheFileURL(for: mediaID)
+        if hasCompleteProgressiveCache(for: mediaID)
+            || cachedContiguousSize(for: mediaID, cacheFileURL: cacheFileURL) >= byteCount {
+            return
+        }
+        var request = URLRequest(url: localURL)
+        request.setValue("bytes=0-\(byteCount - 1)", forHTTPHeaderField: "Range")
+        request.timeoutInterval = 60
+        connectionPool.dataTask(with: request) { [weak self] _, _, error in
+            if let error, let self {
+                print("⚠️ [PREFETCH \(self.shortMID(mediaID))] prefix prefetch failed: \(error.localizedDescription)")
+            }
+        }.resume()
+    }
+
     public func getLocalURL(for mediaID: String) -> URL? {
         return URL(string: "http://localhost:\(port)/media/\(mediaID)/")
     }
@@ -1871,13 +1975,14 @@ public class LocalHTTPServer: @unchecked Sendable {
         let nodeHost = NodePoolRegistry.nodeHost(from: fullRealURL)
         let pool = NodePoolRegistry.shared.pool(for: nodeHost)
         // Progressive video can use 2 parallel range requests; HLS segments are sequential (cap=1).
-        var isPrimary = isCurrentPrimary(mediaID)
+        // Audio the user is playing is treated as primary for its own node.
+        var isPrimary = isCurrentPrimary(mediaID) || isForegroundAudio(mediaID)
         var slotAcquired = await pool.acquireSlot(mediaID: mediaID, isPrimary: isPrimary, primarySlotCap: 2)
         if !slotAcquired {
             for _ in 0..<20 {
                 try? await Task.sleep(nanoseconds: 250_000_000)
                 switch connection.state { case .cancelled, .failed: return; default: break }
-                isPrimary = isCurrentPrimary(mediaID)
+                isPrimary = isCurrentPrimary(mediaID) || isForegroundAudio(mediaID)
                 slotAcquired = await pool.acquireSlot(mediaID: mediaID, isPrimary: isPrimary, primarySlotCap: 2)
                 if slotAcquired { break }
             }
@@ -1894,6 +1999,11 @@ public class LocalHTTPServer: @unchecked Sendable {
             if slotAcquired { await pool.releaseSlot(mediaID: mediaID) }
             return
         }
+
+        // With alternate providers known, fill the primary's cache prefix from all of them in
+        // the background; AVPlayer's follow-up ranges then hit the cache instead of one peer.
+        // Feed preloads don't qualify, so they never hold slots on every provider.
+        startMultiSourceFillIfPossible(mediaID: mediaID, fullRealURL: fullRealURL)
         
         let requestedStart = rangeStart ?? 0
         let shortId = shortMID(mediaID)
@@ -1966,7 +2076,8 @@ public class LocalHTTPServer: @unchecked Sendable {
             },
             onTotalSizeKnown: { [weak self] totalSize in
                 self?.storeProgressiveTotalSize(mediaID: mediaID, totalSize: totalSize)
-            }
+            },
+            contentType: progressiveContentType(for: mediaID)
         )
         // Hold the pool slot until the IPFS download completes (or is cancelled).
         // Unlike HLS segments (which must release early on NWConnection close to allow same-segment
@@ -2001,6 +2112,102 @@ public class LocalHTTPServer: @unchecked Sendable {
         }
     }
 
+    // MARK: - Multi-Source Progressive Fill
+
+    /// Register other providers holding the same content as `mediaID`.
+    /// Base URLs only (scheme/host/port); the path comes from the registered real URL.
+    public func registerAlternateSources(for mediaID: String, baseURLs: [URL]) {
+        multiSourceLock.withLock {
+            alternateSources[mediaID] = baseURLs
+        }
+    }
+
+    public func hasAlternateSources(for mediaID: String) -> Bool {
+        multiSourceLock.withLock { alternateSources[mediaID] != nil }
+    }
+
+    /// Start one background fill of the progressive cache prefix from the primary and
+    /// alternate providers. No-op unless `mediaID` is the current primary (feed or
+    /// fullscreen), without alternates, for small objects, or if the prefix is already cached.
+    /// The fill is stopped when the primary changes or the media leaves the screen.
+    private func startMultiSourceFillIfPossible(mediaID: String, fullRealURL: URL) {
+        guard isCurrentPrimary(mediaID) else { return }
+        let token = UUID()
+        let alternates: [URL]? = multiSourceLock.withLock {
+            guard let baseURLs = alternateSources[mediaID], !baseURLs.isEmpty,
+                  multiSourceFills[mediaID] == nil else { return nil }
+            // Reserve before the task exists so concurrent misses don't start a second fill.
+            multiSourceFills[mediaID] = (token, nil)
+            return baseURLs
+        }
+        guard let alternates else { return }
+
+        let sources = [fullRealURL] + alternates.compactMap {
+            MultiSourceRangeFetcher.url(fullRealURL, onProvider: $0)
+        }
+        let cacheFileURL = progressiveCacheFileURL(for: mediaID)
+        let knownTotal = loadProgressiveTotalSize(mediaID: mediaID)
+        let cachedPrefix = cachedContiguousSize(for: mediaID, cacheFileURL: cacheFileURL)
+        let shortId = shortMID(mediaID)
+
+        let fillTask = Task.detached(priority: .utility) { [weak self] in
+            guard let self else { return }
+            defer {
+                self.multiSourceLock.withLock {
+                    if self.multiSourceFills[mediaID]?.token == token {
+                        self.multiSourceFills.removeValue(forKey: mediaID)
+                    }
+                }
+            }
+            if let knownTotal, knownTotal < self.multiSourceMinimumSize { return }
+
+            // Each provider's node pool still gates how many downloads it serves.
+            var slotPools: [NodeConnectionPool] = []
+            var admittedSources: [URL] = []
+            for source in sources {
+                let pool = NodePoolRegistry.shared.pool(for: NodePoolRegistry.nodeHost(from: source))
+                guard !Task.isCancelled else { break }
+                if await pool.acquireSlot(mediaID: mediaID, isPrimary: self.isCurrentPrimary(mediaID), primarySlotCap: 2) {
+                    slotPools.append(pool)
+                    admittedSources.append(source)
+                }
+            }
+            defer {
+                for pool in slotPools { Task { await pool.releaseSlot(mediaID: mediaID) } }
+            }
+            guard admittedSources.count >= 2 else { return }
+
+            let fetcher = MultiSourceRangeFetcher(sources: admittedSources)
+            do {
+                let result = try await fetcher.fetch(
+                    into: cacheFileURL,
+                    start: cachedPrefix,
+                    end: self.progressiveDiskCacheLimit,
+                    totalSize: knownTotal,
+                    onTotalSizeKnown: { total in
+                        self.storeProgressiveTotalSize(mediaID: mediaID, totalSize: total)
+                    },
+                    onContiguousProgress: { contiguous in
+                        self.storeProgressiveContiguousSize(mediaID: mediaID, contiguousSize: contiguous)
+                    }
+                )
+                print("📡 [MULTI-SOURCE \(shortId)] filled \(result.bytesWritten / 1024)KB from \(result.bytesPerSource.count) providers in \(String(format: "%.1f", result.duration))s (hedged=\(result.hedgedRequests))")
+            } catch {
+                print("⚠️ [MULTI-SOURCE \(shortId)] fill stopped: \(error)")
+            }
+        }
+        // If the reservation was cancelled (or replaced) before the task existed, the
+        // task must not run untracked
+        let tracked = multiSourceLock.withLock { () -> Bool in
+            guard multiSourceFills[mediaID]?.token == token else { return false }
+            multiSourceFills[mediaID] = (token, fillTask)
+            return true
+        }
+        if !tracked {
+            fillTask.cancel()
+        }
+    }
+
     // MARK: - Progressive Video Cache Helpers
     
     private func progressiveCacheDirectory(for mediaID: String) -> URL {
@@ -2020,7 +2227,14 @@ public class LocalHTTPServer: @unchecked Sendable {
         progressiveCacheDirectory(for: mediaID).appendingPathComponent("video.contiguous")
     }
     
+    /// Streaming writers and the multi-source fill both advance the contiguous prefix;
+    /// a slower writer never moves it backwards.
     private func storeProgressiveContiguousSize(mediaID: String, contiguousSize: Int64) {
+        progressiveContiguousLock.lock()
+        defer { progressiveContiguousLock.unlock() }
+        if let current = loadProgressiveContiguousSize(mediaID: mediaID), current >= contiguousSize {
+            return
+        }
         let url = progressiveContiguousFileURL(for: mediaID)
         let directory = url.deletingLastPathComponent()
         do {
@@ -2285,7 +2499,7 @@ public class LocalHTTPServer: @unchecked Sendable {
                     reason: "zero-prefix"
                 )
                 return false
-            } else if !isValidProgressiveCache(fileURL: cacheFileURL) {
+            } else if isMP4Progressive(mediaID) && !isValidProgressiveCache(fileURL: cacheFileURL) {
                 print("⚠️ [PROGRESSIVE CACHE] Invalid/corrupted COMPLETE cache for \(mediaID), deleting entire cache directory")
                 // Delete the entire cache directory (including legacy per-range files)
                 let cacheDir = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0]
@@ -2420,7 +2634,7 @@ public class LocalHTTPServer: @unchecked Sendable {
         }
 
         var headers: [String: String] = [
-            "Content-Type": "video/mp4",
+            "Content-Type": progressiveContentType(for: mediaID),
             "Content-Length": "\(requestedLength)",
             "Accept-Ranges": "bytes"
         ]
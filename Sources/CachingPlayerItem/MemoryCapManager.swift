@@ -1,7 +1,6 @@
 import Foundation
 import UIKit
 import os.log
-import SDWebImage
 
 /// Manages memory usage with a 2GB cap to prevent OS termination
 class MemoryCapManager {
@@ -288,7 +287,6 @@ class MemoryCapManager {
         GlobalImageLoadManager.shared.prepareForBackground()
         SharedAssetCache.shared.releaseForBackground()
         ImageCacheManager.shared.clearMemoryCache()
-        SDImageCache.shared.clearMemory()
         TweetCacheManager.shared.clearMemoryCache()
         ChatCacheManager.shared.clearMemoryCache()
         VideoStateCache.shared.clearPlaybackCacheForMemoryPressure()
@@ -0,0 +1,518 @@
+// MultiSourceRangeFetcher.swift
+// Tweet
+//
+// Parallel range downloader for IPFS content held by several provider nodes.
+//
+// A single provider bounds large progressive videos and documents to that one
+// peer's upload speed. The fetcher splits the object into fixed-size ranges and
+// pulls them from every known provider at once:
+//   - Work stealing: each source runs a small number of workers that pull the
+//     lowest pending range when they go idle, so fast peers naturally take more.
+//   - Slow peers: a source whose throughput drops below slowSourceRatio of the
+//     best source stops taking new ranges while faster workers can absorb them.
+//   - Tail hedging: when nothing is pending, an idle worker duplicates an
+//     in-flight range that is overdue on a slower peer. The first response wins
+//     and the loser's request is cancelled.
+//   - Failing sources are dropped after maxSourceFailures consecutive errors and
+//     their ranges go back to the pending queue.
+// Ranges are written at their own offsets into the destination file (the same
+// sparse layout LocalHTTPServer uses for progressive cache), and the completed
+// contiguous prefix is reported as it grows.
+
+import Foundation
+
+// MARK: - MultiSourceRangeFetcher
+
+final class MultiSourceRangeFetcher: @unchecked Sendable {
+    struct Configuration {
+        /// Size of each range request.
+        var chunkSize: Int64 = 1024 * 1024
+        /// Concurrent range requests per source.
+        var workersPerSource: Int = 2
+        /// Hedge an in-flight range once it has run this many times longer than
+        /// the idle source would need for it.
+        var hedgeAfterFactor: Double = 3.0
+        /// Sources below this fraction of the best observed throughput stop taking new ranges.
+        var slowSourceRatio: Double = 0.25
+        /// Consecutive failures before a source is dropped for this fetch.
+        var maxSourceFailures: Int = 2
+        /// Per-request timeout.
+        var requestTimeout: TimeInterval = 30
+    }
+
+    struct Result {
+        let totalSize: Int64
+        let bytesWritten: Int64
+        let bytesPerSource: [String: Int64]
+        let hedgedRequests: Int
+        let duration: TimeInterval
+    }
+
+    enum FetchError: Error {
+        case noSources
+        case unknownTotalSize
+        case allSourcesFailed
+        case invalidResponse
+    }
+
+    private let sources: [URL]
+    private let configuration: Configuration
+    private let session: URLSession
+
+    /// - Parameter sources: Full content URLs for the same object on different providers
+    ///   (e.g. `http://ip1:8080/mm/<mid>`, `http://ip2:8080/mm/<mid>`).
+    init(sources: [URL], configuration: Configuration = Configuration()) {
+        self.sources = sources
+        self.configuration = configuration
+
+        let config = URLSessionConfiguration.default
+        config.httpMaximumConnectionsPerHost = max(2, configuration.workersPerSource + 1)
+        config.timeoutIntervalForRequest = configuration.requestTimeout
+        config.timeoutIntervalForResource = 300
+        config.urlCache = nil
+        config.requestCachePolicy = .reloadIgnoringLocalCacheData
+        self.session = URLSession(configuration: config)
+    }
+
+    deinit {
+        session.finishTasksAndInvalidate()
+    }
+
+    /// Source key used for logging and per-source accounting ("host:port").
+    static func sourceKey(_ url: URL) -> String {
+        NodePoolRegistry.nodeHost(from: url)
+    }
+
+    /// Rewrite `url` so it targets another provider's base URL, keeping path and query.
+    static func url(_ url: URL, onProvider baseURL: URL) -> URL? {
+        guard var components = URLComponents(url: url, resolvingAgainstBaseURL: false) else { return nil }
+        components.scheme = baseURL.scheme ?? components.scheme
+        components.host = baseURL.host
+        components.port = baseURL.port
+        return components.url
+    }
+
+    /// Download `[start, end)` of the object into `destination` at matching offsets.
+    ///
+    /// - Parameters:
+    ///   - start: First byte to fetch. Bytes before it are assumed already present.
+    ///   - end: Exclusive upper bound; nil fetches to the end of the object.
+    ///   - totalSize: Known object size, or nil to probe it from the sources.
+    ///   - onTotalSizeKnown: Called once the object size is known.
+    ///   - onContiguousProgress: Called with the new end of the contiguous prefix
+    ///     (measured from byte 0, assuming `[0, start)` is present) as it grows.
+    func fetch(
+        into destination: URL,
+        start: Int64 = 0,
+        end: Int64? = nil,
+        totalSize: Int64? = nil,
+        onTotalSizeKnown: ((Int64) -> Void)? = nil,
+        onContiguousProgress: ((Int64) -> Void)? = nil
+    ) async throws -> Result {
+        guard !sources.isEmpty else { throw FetchError.noSources }
+        let startedAt = Date()
+
+        let resolvedTotal: Int64
+        if let totalSize, totalSize > 0 {
+            resolvedTotal = totalSize
+        } else {
+            guard let probed = await probeTotalSize() else { throw FetchError.unknownTotalSize }
+            resolvedTotal = probed
+        }
+        onTotalSizeKnown?(resolvedTotal)
+
+        let upperBound = min(end ?? resolvedTotal, resolvedTotal)
+        guard upperBound > start else {
+            return Result(totalSize: resolvedTotal, bytesWritten: 0, bytesPerSource: [:], hedgedRequests: 0, duration: 0)
+        }
+
+        let writer = try RangeFileWriter(fileURL: destination)
+        defer { writer.close() }
+
+        let scheduler = RangeScheduler(
+            ranges: Self.plan(start: start, end: upperBound, chunkSize: configuration.chunkSize),
+            sourceCount: sources.count,
+            configuration: configuration
+        )
+
+        await withTaskGroup(of: Void.self) { group in
+            for sourceIndex in sources.indices {
+                for _ in 0..<max(1, configuration.workersPerSource) {
+                    group.addTask { [self] in
+                        await self.runWorker(
+                            sourceIndex: sourceIndex,
+                            scheduler: scheduler,
+                            writer: writer,
+                            onContiguousProgress: onContiguousProgress
+                        )
+                    }
+                }
+            }
+        }
+
+        let summary = await scheduler.summary()
+        guard summary.isComplete else { throw FetchError.allSourcesFailed }
+
+        var bytesPerSource: [String: Int64] = [:]
+        for (index, bytes) in summary.bytesPerSource.enumerated() where bytes > 0 {
+            bytesPerSource[Self.sourceKey(sources[index]), default: 0] += bytes
+        }
+        return Result(
+            totalSize: resolvedTotal,
+            bytesWritten: upperBound - start,
+            bytesPerSource: bytesPerSource,
+            hedgedRequests: summary.hedgedRequests,
+            duration: Date().timeIntervalSince(startedAt)
+        )
+    }
+
+    /// Split `[start, end)` into consecutive ranges of at most `chunkSize` bytes.
+    static func plan(start: Int64, end: Int64, chunkSize: Int64) -> [ClosedRange<Int64>] {
+        guard end > start, chunkSize > 0 else { return [] }
+        var ranges: [ClosedRange<Int64>] = []
+        var offset = start
+        while offset < end {
+            let last = min(offset + chunkSize, end) - 1
+            ranges.append(offset...last)
+            offset = last + 1
+        }
+        return ranges
+    }
+
+    // MARK: - Workers
+
+    private func runWorker(
+        sourceIndex: Int,
+        scheduler: RangeScheduler,
+        writer: RangeFileWriter,
+        onContiguousProgress: ((Int64) -> Void)?
+    ) async {
+        let source = sources[sourceIndex]
+        while !Task.isCancelled {
+            let assignment = await scheduler.next(for: sourceIndex)
+            switch assignment {
+            case .done:
+                return
+            case .wait:
+                try? await Task.sleep(nanoseconds: 50_000_000)
+                continue
+            case .fetch(let chunkIndex, let range, let attemptID):
+                let requestStart = Date()
+                let task = Task { try await self.download(range: range, from: source) }
+                await scheduler.attach(task: task, chunkIndex: chunkIndex, attemptID: attemptID)
+
+                do {
+                    let data = try await withTaskCancellationHandler {
+                        try await task.value
+                    } onCancel: {
+                        task.cancel()
+                    }
+                    let elapsed = Date().timeIntervalSince(requestStart)
+                    // Only the first attempt to finish a range writes it.
+                    guard await scheduler.claim(chunkIndex: chunkIndex, attemptID: attemptID) else { continue }
+                    try writer.write(data, at: range.lowerBound)
+                    let contiguousEnd = await scheduler.complete(
+                        chunkIndex: chunkIndex,
+                        sourceIndex: sourceIndex,
+                        bytes: Int64(data.count),
+                        elapsed: elapsed
+                    )
+                    if let contiguousEnd { onContiguousProgress?(contiguousEnd) }
+                } catch {
+                    await scheduler.fail(chunkIndex: chunkIndex, sourceIndex: sourceIndex, attemptID: attemptID)
+                }
+            }
+        }
+    }
+
+    private func download(range: ClosedRange<Int64>, from url: URL) async throws -> Data {
+        var request = URLRequest(url: url)
+        request.httpMethod = "GET"
+        request.setValue("bytes=\(range.lowerBound)-\(range.upperBound)", forHTTPHeaderField: "Range")
+        request.timeoutInterval = configuration.requestTimeout
+
+        let (data, response) = try await session.data(for: request)
+        guard let http = response as? HTTPURLResponse, http.statusCode == 206,
+              Int64(data.count) == Int64(range.count) else {
+            // A 200 means the node ignored Range; treat it as unusable for parallel fetch.
+            throw FetchError.invalidResponse
+        }
+        if let contentRange = http.value(forHTTPHeaderField: "Content-Range"),
+           let parsedStart = Self.parseContentRangeStart(contentRange),
+           parsedStart != range.lowerBound {
+            throw FetchError.invalidResponse
+        }
+        return data
+    }
+
+    /// Race a 1-byte range request across the first few sources and take the first total size.
+    private func probeTotalSize() async -> Int64? {
+        await withTaskGroup(of: Int64?.self) { group in
+            for source in sources.prefix(3) {
+                group.addTask { [session, configuration] in
+                    var request = URLRequest(url: source)
+                    request.setValue("bytes=0-0", forHTTPHeaderField: "Range")
+                    request.timeoutInterval = configuration.requestTimeout
+                    guard let (_, response) = try? await session.data(for: request),
+                          let http = response as? HTTPURLResponse,
+                          let contentRange = http.value(forHTTPHeaderField: "Content-Range") else {
+                        return nil
+                    }
+                    return Self.parseContentRangeTotal(contentRange)
+                }
+            }
+            for await total in group {
+                if let total, total > 0 {
+                    group.cancelAll()
+                    return total
+                }
+            }
+            return nil
+        }
+    }
+
+    /// Parse `Z` from "bytes X-Y/Z".
+    static func parseContentRangeTotal(_ header: String) -> Int64? {
+        guard let slash = header.lastIndex(of: "/") else { return nil }
+        return Int64(header[header.index(after: slash)...].trimmingCharacters(in: .whitespaces))
+    }
+
+    /// Parse `X` from "bytes X-Y/Z".
+    static func parseContentRangeStart(_ header: String) -> Int64? {
+        guard let space = header.firstIndex(of: " "),
+              let dash = header[space...].firstIndex(of: "-") else { return nil }
+        return Int64(header[header.index(after: space)..<dash])
+    }
+}
+
+// MARK: - RangeScheduler
+
+/// Shared work queue for one fetch. Tracks pending, in-flight and completed ranges
+/// plus per-source throughput, and decides which range each idle worker takes next.
+private actor RangeScheduler {
+    enum Assignment {
+        case fetch(chunkIndex: Int, range: ClosedRange<Int64>, attemptID: Int)
+        case wait
+        case done
+    }
+
+    struct Summary {
+        let isComplete: Bool
+        let bytesPerSource: [Int64]
+        let hedgedRequests: Int
+    }
+
+    private struct Attempt {
+        let id: Int
+        let sourceIndex: Int
+        let startedAt: Date
+        var task: Task<Data, Error>?
+    }
+
+    private struct SourceStats {
+        /// EWMA of bytes/second for completed ranges; nil until the first completion.
+        var throughput: Double?
+        var consecutiveFailures = 0
+        var isDisabled = false
+        var bytes: Int64 = 0
+    }
+
+    private let ranges: [ClosedRange<Int64>]
+    private let configuration: MultiSourceRangeFetcher.Configuration
+    private var pending: [Int]
+    private var inFlight: [Int: [Attempt]] = [:]
+    private var completed: [Bool]
+    private var contiguousIndex = 0
+    private var sources: [SourceStats]
+    private var nextAttemptID = 0
+    private var hedgedRequests = 0
+
+    init(ranges: [ClosedRange<Int64>], sourceCount: Int, configuration: MultiSourceRangeFetcher.Configuration) {
+        self.ranges = ranges
+        self.configuration = configuration
+        self.pending = Array(ranges.indices)
+        self.completed = Array(repeating: false, count: ranges.count)
+        self.sources = Array(repeating: SourceStats(), count: sourceCount)
+    }
+
+    func next(for sourceIndex: Int) -> Assignment {
+        if contiguousIndex >= ranges.count || !sources.contains(where: { !$0.isDisabled }) {
+            return .done
+        }
+        guard !sources[sourceIndex].isDisabled else { return .done }
+
+        if !pending.isEmpty {
+            // Slow peers yield pending ranges while faster sources have workers to spare.
+            if isSlow(sourceIndex), pending.count <= fastWorkerCount() {
+                return inFlight.isEmpty ? takePending(for: sourceIndex) : .wait
+            }
+            return takePending(for: sourceIndex)
+        }
+
+        if let hedge = hedgeCandidate(for: sourceIndex) {
+            hedgedRequests += 1
+            return startAttempt(chunkIndex: hedge, sourceIndex: sourceIndex)
+        }
+        return inFlight.isEmpty ? .done : .wait
+    }
+
+    func attach(task: Task<Data, Error>, chunkIndex: Int, attemptID: Int) {
+        guard var attempts = inFlight[chunkIndex],
+              let index = attempts.firstIndex(where: { $0.id == attemptID }) else {
+            // The range was finished by another attempt before this one attached.
+            task.cancel()
+            return
+        }
+        attempts[index].task = task
+        inFlight[chunkIndex] = attempts
+    }
+
+    /// Returns true for the first attempt to finish a range; cancels and forgets the others.
+    func claim(chunkIndex: Int, attemptID: Int) -> Bool {
+        guard !completed[chunkIndex],
+              let attempts = inFlight[chunkIndex],
+              let winner = attempts.first(where: { $0.id == attemptID }) else {
+            return false
+        }
+        for attempt in attempts where attempt.id != attemptID {
+            attempt.task?.cancel()
+        }
+        inFlight[chunkIndex] = [winner]
+        return true
+    }
+
+    /// Mark a claimed range finished. Returns the new contiguous end if it advanced.
+    func complete(chunkIndex: Int, sourceIndex: Int, bytes: Int64, elapsed: TimeInterval) -> Int64? {
+        inFlight.removeValue(forKey: chunkIndex)
+        completed[chunkIndex] = true
+
+        var stats = sources[sourceIndex]
+        stats.consecutiveFailures = 0
+        stats.bytes += bytes
+        let sample = Double(bytes) / max(elapsed, 0.001)
+        stats.throughput = stats.throughput.map { 0.7 * $0 + 0.3 * sample } ?? sample
+        sources[sourceIndex] = stats
+
+        let previous = contiguousIndex
+        while contiguousIndex < ranges.count && completed[contiguousIndex] {
+            contiguousIndex += 1
+        }
+        guard contiguousIndex > previous else { return nil }
+        return ranges[contiguousIndex - 1].upperBound + 1
+    }
+
+    func fail(chunkIndex: Int, sourceIndex: Int, attemptID: Int) {
+        // Hedge losers were already dropped by claim(); their cancellation is not a source failure.
+        guard var attempts = inFlight[chunkIndex],
+              attempts.contains(where: { $0.id == attemptID }) else { return }
+        attempts.removeAll { $0.id == attemptID }
+        if attempts.isEmpty {
+            inFlight.removeValue(forKey: chunkIndex)
+            requeue(chunkIndex)
+        } else {
+            inFlight[chunkIndex] = attempts
+        }
+        sources[sourceIndex].consecutiveFailures += 1
+        if sources[sourceIndex].consecutiveFailures >= configuration.maxSourceFailures {
+            sources[sourceIndex].isDisabled = true
+        }
+    }
+
+    func summary() -> Summary {
+        Summary(
+            isComplete: !completed.contains(false),
+            bytesPerSource: sources.map(\.bytes),
+            hedgedRequests: hedgedRequests
+        )
+    }
+
+    // MARK: - Internal
+
+    private func takePending(for sourceIndex: Int) -> Assignment {
+        let chunkIndex = pending.removeFirst()
+        return startAttempt(chunkIndex: chunkIndex, sourceIndex: sourceIndex)
+    }
+
+    private func startAttempt(chunkIndex: Int, sourceIndex: Int) -> Assignment {
+        nextAttemptID += 1
+        inFlight[chunkIndex, default: []].append(
+            Attempt(id: nextAttemptID, sourceIndex: sourceIndex, startedAt: Date(), task: nil)
+        )
+        return .fetch(chunkIndex: chunkIndex, range: ranges[chunkIndex], attemptID: nextAttemptID)
+    }
+
+    private func requeue(_ chunkIndex: Int) {
+        // Keep pending ordered so the contiguous prefix fills first.
+        let insertAt = pending.firstIndex(where: { $0 > chunkIndex }) ?? pending.endIndex
+        pending.insert(chunkIndex, at: insertAt)
+    }
+
+    private var bestThroughput: Double? {
+        sources.filter { !$0.isDisabled }.compactMap(\.throughput).max()
+    }
+
+    private func isSlow(_ sourceIndex: Int) -> Bool {
+        guard let best = bestThroughput, let own = sources[sourceIndex].throughput else { return false }
+        return own < best * configuration.slowSourceRatio
+    }
+
+    private func fastWorkerCount() -> Int {
+        sources.indices.filter { !sources[$0].isDisabled && !isSlow($0) }.count * configuration.workersPerSource
+    }
+
+    /// Lowest in-flight range, held by a single attempt on another source, that has run
+    /// longer than hedgeAfterFactor times this source's expected time for it.
+    private func hedgeCandidate(for sourceIndex: Int) -> Int? {
+        let now = Date()
+        let ownThroughput = sources[sourceIndex].throughput ?? bestThroughput
+        for chunkIndex in inFlight.keys.sorted() {
+            guard let attempts = inFlight[chunkIndex], attempts.count == 1,
+                  let attempt = attempts.first, attempt.sourceIndex != sourceIndex else { continue }
+            let elapsed = now.timeIntervalSince(attempt.startedAt)
+            guard let throughput = ownThroughput, throughput > 0 else {
+                // No measurements yet: hedge only ranges that are clearly stuck.
+                if elapsed > configuration.requestTimeout / 2 { return chunkIndex }
+                continue
+            }
+            let expected = Double(ranges[chunkIndex].count) / throughput
+            if elapsed > expected * configuration.hedgeAfterFactor {
+                return chunkIndex
+            }
+        }
+        return nil
+    }
+}
+
+// MARK: - RangeFileWriter
+
+/// Writes ranges at arbitrary offsets into one file. Serialized because FileHandle
+/// seek+write is not atomic across threads.
+private final class RangeFileWriter: @unchecked Sendable {
+    private let handle: FileHandle
+    private let lock = NSLock()
+
+    init(fileURL: URL) throws {
+        try FileManager.default.createDirectory(
+            at: fileURL.deletingLastPathComponent(),
+            withIntermediateDirectories: true
+        )
+        if !FileManager.default.fileExists(atPath: fileURL.path) {
+            FileManager.default.createFile(atPath: fileURL.path, contents: nil)
+        }
+        handle = try FileHandle(forUpdating: fileURL)
+    }
+
+    func write(_ data: Data, at offset: Int64) throws {
+        lock.lock()
+        defer { lock.unlock() }
+        try handle.seek(toOffset: UInt64(offset))
+        try handle.write(contentsOf: data)
+    }
+
+    func close() {
+        lock.lock()
+        defer { lock.unlock() }
+        try? handle.synchronize()
+        try? handle.close()
+    }
+}
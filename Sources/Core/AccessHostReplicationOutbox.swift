@@ -0,0 +1,225 @@
+import Foundation
+import UIKit
+
+/// Durable queue of home→access host replication calls.
+///
+/// When update_following_tweets brings new tweets to the home host, the access host has to
+/// re-run it with `homeupdated` so it pulls them. That call used to run inline on the feed
+/// path and was dropped on failure. Jobs are now journaled to disk, coalesced per access host
+/// (the access host pulls the home host's latest state, so one call covers every pending sync),
+/// and drained by a background worker with exponential backoff and jitter.
+final class AccessHostReplicationOutbox: @unchecked Sendable {
+    static let shared = AccessHostReplicationOutbox()
+
+    struct Job: Codable {
+        let accessHostId: String
+        let homeHostId: String
+        let appUserId: MimeiId
+        var userId: MimeiId
+        var appId: String
+        var pageSize: UInt
+        /// Bumped on every coalesced enqueue; a delivery only retires the revision it sent
+        var revision: Int
+        var attempts: Int
+        let firstEnqueuedAt: Date
+        var nextAttemptAt: Date
+
+        var key: String { "\(appUserId)|\(accessHostId)" }
+    }
+
+    private var jobs: [String: Job] = [:]
+    private let lock = NSLock()
+    private var drainTask: Task<Void, Never>?
+    private var drainGeneration = 0
+    /// True while the worker is only waiting for the next retry, so a new job can interrupt it
+    private var isWaiting = false
+
+    private let persistQueue = DispatchQueue(label: "com.zz.AccessHostReplicationOutbox.persist", qos: .utility)
+    private let baseRetryDelay: TimeInterval = 5
+    private let maxRetryDelay: TimeInterval = 10 * 60
+    /// A job this old is superseded by the next home sync anyway
+    private let maxJobAge: TimeInterval = 24 * 60 * 60
+
+    private static let journalURL: URL = {
+        let directory = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask)[0]
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        return directory.appendingPathComponent("AccessHostReplicationOutbox.json")
+    }()
+
+    private init() {
+        loadJournal()
+        NotificationCenter.default.addObserver(
+            forName: UIApplication.didBecomeActiveNotification,
+            object: nil,
+            queue: nil
+        ) { [weak self] _ in
+            self?.kick()
+        }
+    }
+
+    // MARK: - Public Methods
+
+    /// Record that `accessHostId` must pull new following tweets from `homeHostId`. Returns at once.
+    func enqueue(accessHostId: String, homeHostId: String, appUserId: MimeiId, userId: MimeiId, appId: String, pageSize: UInt) {
+        let now = Date()
+        lock.withLock {
+            let key = "\(appUserId)|\(accessHostId)"
+            if var existing = jobs[key] {
+                existing.userId = userId
+                existing.appId = appId
+                existing.pageSize = max(existing.pageSize, pageSize)
+                existing.revision += 1
+                existing.nextAttemptAt = min(existing.nextAttemptAt, now)
+                jobs[key] = existing
+                print("DEBUG: [AccessHostReplicationOutbox] Coalesced sync to \(accessHostId) (revision \(existing.revision))")
+            } else {
+                jobs[key] = Job(
+                    accessHostId: accessHostId,
+                    homeHostId: homeHostId,
+                    appUserId: appUserId,
+                    userId: userId,
+                    appId: appId,
+                    pageSize: pageSize,
+                    revision: 0,
+                    attempts: 0,
+                    firstEnqueuedAt: now,
+                    nextAttemptAt: now
+                )
+            }
+            persistLocked()
+        }
+        kick()
+    }
+
+    /// Start the worker if there is anything to deliver. Interrupts a pending retry wait.
+    func kick() {
+        lock.withLock {
+            guard !jobs.isEmpty, drainTask == nil || isWaiting else { return }
+            drainTask?.cancel()
+            drainGeneration += 1
+            isWaiting = false
+            let generation = drainGeneration
+            drainTask = Task.detached(priority: .utility) { [weak self] in
+                await self?.drain(generation: generation)
+            }
+        }
+    }
+
+    var pendingCount: Int {
+        lock.withLock { jobs.count }
+    }
+
+    // MARK: - Worker
+
+    private func drain(generation: Int) async {
+        while !Task.isCancelled {
+            let now = Date()
+            let (due, nextWake) = lock.withLock { () -> ([Job], Date?) in
+                jobs = jobs.filter { now.timeIntervalSince($0.value.firstEnqueuedAt) < maxJobAge }
+                let due = jobs.values.filter { $0.nextAttemptAt <= now }
+                let pending = jobs.values.filter { $0.nextAttemptAt > now }
+                return (due, pending.map(\.nextAttemptAt).min())
+            }
+
+            if due.isEmpty {
+                guard let nextWake else { break }
+                lock.withLock { isWaiting = true }
+                try? await Task.sleep(nanoseconds: UInt64(max(0, nextWake.timeIntervalSinceNow) * 1_000_000_000))
+                let stillCurrent = lock.withLock { () -> Bool in
+                    guard drainGeneration == generation else { return false }
+                    isWaiting = false
+                    return true
+                }
+                guard stillCurrent, !Task.isCancelled else { return }
+                continue
+            }
+
+            for job in due {
+                guard !Task.isCancelled else { break }
+                await deliver(job)
+            }
+        }
+
+        lock.withLock {
+            guard drainGeneration == generation else { return }
+            drainTask = nil
+            isWaiting = false
+        }
+    }
+
+    private func deliver(_ job: Job) async {
+        let hproseInstance = HproseInstance.shared
+        // Jobs from a previous login belong to another account's hosts
+        guard job.appUserId == hproseInstance.appUser.mid else {
+            finish(job, delivered: true)
+            return
+        }
+
+        do {
+            try await hproseInstance.replicateFollowingTweets(job)
+            print("DEBUG: [AccessHostReplicationOutbox] Synced home host \(job.homeHostId) to access host \(job.accessHostId) after \(job.attempts + 1) attempt(s)")
+            finish(job, delivered: true)
+        } catch {
+            print("ERROR: [AccessHostReplicationOutbox] Sync to access host \(job.accessHostId) failed (attempt \(job.attempts + 1)): \(error)")
+            finish(job, delivered: false)
+        }
+    }
+
+    private func finish(_ job: Job, delivered: Bool) {
+        lock.withLock {
+            guard var current = jobs[job.key] else { return }
+            if delivered {
+                if current.revision == job.revision {
+                    jobs.removeValue(forKey: job.key)
+                } else {
+                    // Enqueued again while in flight; that sync may not have been covered
+                    current.attempts = 0
+                    current.nextAttemptAt = Date()
+                    jobs[job.key] = current
+                }
+            } else {
+                current.attempts += 1
+                current.nextAttemptAt = Date().addingTimeInterval(retryDelay(afterAttempts: current.attempts))
+                jobs[job.key] = current
+            }
+            persistLocked()
+        }
+    }
+
+    /// Full jitter: uniform in [0, min(cap, base * 2^attempts)], floored at the base delay.
+    private func retryDelay(afterAttempts attempts: Int) -> TimeInterval {
+        let ceiling = min(maxRetryDelay, baseRetryDelay * pow(2, Double(min(attempts, 16))))
+        return max(baseRetryDelay, Double.random(in: 0...ceiling))
+    }
+
+    // MARK: - Journal
+
+    /// Caller holds `lock`. Writes the whole (small, coalesced) job set atomically.
+    private func persistLocked() {
+        let snapshot = Array(jobs.values)
+        persistQueue.async {
+            do {
+                if snapshot.isEmpty {
+                    try? FileManager.default.removeItem(at: Self.journalURL)
+                } else {
+                    let data = try JSONEncoder().encode(snapshot)
+                    try data.write(to: Self.journalURL, options: [.atomic])
+                }
+            } catch {
+                print("ERROR: [AccessHostReplicationOutbox] Failed to write journal: \(error)")
+            }
+        }
+    }
+
+    private func loadJournal() {
+        guard let data = try? Data(contentsOf: Self.journalURL) else { return }
+        do {
+            let loaded = try JSONDecoder().decode([Job].self, from: data)
+            jobs = Dictionary(loaded.map { ($0.key, $0) }, uniquingKeysWith: { $0.revision >= $1.revision ? $0 : $1 })
+            print("DEBUG: [AccessHostReplicationOutbox] Restored \(jobs.count) pending sync(s)")
+        } catch {
+            print("ERROR: [AccessHostReplicationOutbox] Discarding unreadable journal: \(error)")
+            try? FileManager.default.removeItem(at: Self.journalURL)
+        }
+    }
+}
@@ -136,33 +136,68 @@ class AgentTokenManager {
     
     // MARK: - Request Signing
     
-    /// Sign request data with the private key from an agent token
-    static func signRequest(data: [String: Any], token: AgentToken) -> AgentAuth? {
-        guard let privateKeyData = Data(base64Encoded: token.privateKey),
-              let privateKey = try? Curve25519.Signing.PrivateKey(rawRepresentation: privateKeyData) else {
-            return nil
+    /// Parsed signing keys by token public key, so signing doesn't re-derive the key each call
+    private static var signingKeys: [String: Curve25519.Signing.PrivateKey] = [:]
+    private static let signingKeysLock = NSLock()
+    private static let maxCachedSigningKeys = 8
+    
+    private static func signingKey(for token: AgentToken) -> Curve25519.Signing.PrivateKey? {
+        signingKeysLock.withLock {
+            if let cached = signingKeys[token.publicKey] {
+                return cached
+            }
+            guard let privateKeyData = Data(base64Encoded: token.privateKey),
+                  let privateKey = try? Curve25519.Signing.PrivateKey(rawRepresentation: privateKeyData) else {
+                return nil
+            }
+            if signingKeys.count >= maxCachedSigningKeys {
+                signingKeys.removeAll()
+            }
+            signingKeys[token.publicKey] = privateKey
+            return privateKey
         }
-        
-        let timestamp = Int64(Date().timeIntervalSince1970 * 1000)
-        
+    }
+    
+    /// Canonical (RFC 8785) bytes of `data` plus the auth fields, appended to `encoder`.
+    private static func appendSignable(_ data: [String: Any], mimeiId: String, timestamp: Int64, to encoder: inout CanonicalJSONEncoder) -> Bool {
         var signableData = data
-        signableData["mimeiId"] = token.mimeiId
+        signableData["mimeiId"] = mimeiId
         signableData["timestamp"] = timestamp
-        
-        guard let jsonData = try? JSONSerialization.data(withJSONObject: signableData, options: .sortedKeys),
-              let jsonString = String(data: jsonData, encoding: .utf8) else {
-            return nil
+        do {
+            try encoder.append(signableData)
+            return true
+        } catch {
+            print("ERROR: [AgentTokenManager] Request is not canonically encodable: \(error)")
+            return false
         }
-        
-        guard let signature = try? privateKey.signature(for: Data(jsonString.utf8)) else {
-            return nil
+    }
+    
+    /// Sign request data with the private key from an agent token
+    static func signRequest(data: [String: Any], token: AgentToken) -> AgentAuth? {
+        signRequests([data], token: token)[0]
+    }
+    
+    /// Sign several requests in one pass: one key lookup, one timestamp and one reused encode
+    /// buffer. Requests that can't be encoded come back nil.
+    static func signRequests(_ requests: [[String: Any]], token: AgentToken) -> [AgentAuth?] {
+        guard let privateKey = signingKey(for: token) else {
+            return Array(repeating: nil, count: requests.count)
         }
         
-        return AgentAuth(
-            mimeiId: token.mimeiId,
-            timestamp: timestamp,
-            signature: signature.base64EncodedString()
-        )
+        let timestamp = Int64(Date().timeIntervalSince1970 * 1000)
+        var encoder = CanonicalJSONEncoder()
+        return requests.map { data in
+            encoder.reset()
+            guard appendSignable(data, mimeiId: token.mimeiId, timestamp: timestamp, to: &encoder),
+                  let signature = try? privateKey.signature(for: encoder.bytes) else {
+                return nil
+            }
+            return AgentAuth(
+                mimeiId: token.mimeiId,
+                timestamp: timestamp,
+                signature: signature.base64EncodedString()
+            )
+        }
     }
     
     // MARK: - Signature Verification (for testing)
@@ -175,16 +210,11 @@ class AgentTokenManager {
             return false
         }
         
-        var signableData = data
-        signableData["mimeiId"] = auth.mimeiId
-        signableData["timestamp"] = auth.timestamp
-        
-        guard let jsonData = try? JSONSerialization.data(withJSONObject: signableData, options: .sortedKeys),
-              let jsonString = String(data: jsonData, encoding: .utf8) else {
+        var encoder = CanonicalJSONEncoder()
+        guard appendSignable(data, mimeiId: auth.mimeiId, timestamp: auth.timestamp, to: &encoder) else {
             return false
         }
-        
-        return publicKey.isValidSignature(signatureData, for: Data(jsonString.utf8))
+        return publicKey.isValidSignature(signatureData, for: encoder.bytes)
     }
     
     // MARK: - Token Export/Import Helpers
@@ -0,0 +1,75 @@
+import Foundation
+import AVFoundation
+
+/// Builds player items for audio attachments through `LocalHTTPServer`, the same way
+/// progressive video is served: the proxy keeps a sparse range cache per media and
+/// takes `NodeConnectionPool` slots, so replays come from disk and audio downloads are
+/// counted against the node's bandwidth budget.
+///
+/// Audio is only proxied when its container is known from the file name; the proxy
+/// must declare the right Content-Type for AVPlayer to pick a parser. Anything else
+/// falls back to streaming the remote URL directly.
+enum AudioAssetLoader {
+    /// Seconds of the next playlist track to warm before the user reaches it.
+    static let prefetchSeconds: Int64 = 15
+    /// Conservative bitrate used to turn prefetchSeconds into bytes (256 kbps).
+    private static let assumedBytesPerSecond: Int64 = 256_000 / 8
+
+    /// Player item for `url`, served through the local proxy when possible.
+    static func playerItem(for url: URL, fileName: String?) async -> AVPlayerItem {
+        AVPlayerItem(asset: AVURLAsset(url: await playbackURL(for: url, fileName: fileName)))
+    }
+
+    /// Proxy URL for `url`, or `url` itself if the proxy can't serve it.
+    static func playbackURL(for url: URL, fileName: String?) async -> URL {
+        guard let mediaID = proxiableMediaID(for: url),
+              let contentType = contentType(forFileName: fileName) else {
+            return url
+        }
+        let isReady = await LocalHTTPServer.shared.ensureReadyForPlaybackAsync(
+            reason: "audio \(mediaID.prefix(8))"
+        )
+        guard isReady else { return url }
+        return LocalHTTPServer.shared.registerAndGetURL(for: mediaID, realURL: url, contentType: contentType)
+    }
+
+    /// Mark audio as actively played (or stopped) so its proxy requests get primary slots.
+    static func setPlaybackActive(_ active: Bool, for url: URL) {
+        guard let mediaID = proxiableMediaID(for: url) else { return }
+        LocalHTTPServer.shared.setForegroundAudio(mediaID, active: active)
+    }
+
+    /// Warm the proxy cache with roughly the first `prefetchSeconds` of `url`.
+    static func prefetchStart(of url: URL, fileName: String?) {
+        guard let mediaID = proxiableMediaID(for: url),
+              contentType(forFileName: fileName) != nil else { return }
+        Task.detached(priority: .utility) {
+            _ = await playbackURL(for: url, fileName: fileName)
+            LocalHTTPServer.shared.prefetchProgressivePrefix(
+                mediaID: mediaID,
+                byteCount: prefetchSeconds * assumedBytesPerSecond
+            )
+        }
+    }
+
+    // MARK: - Helpers
+
+    /// The proxy routes `/ipfs/<mediaID>` paths only.
+    private static func proxiableMediaID(for url: URL) -> String? {
+        let components = url.path.split(separator: "/")
+        guard components.count == 2, components[0] == "ipfs" else { return nil }
+        return String(components[1])
+    }
+
+    private static func contentType(forFileName fileName: String?) -> String? {
+        guard let fileName else { return nil }
+        switch (fileName as NSString).pathExtension.lowercased() {
+        case "mp3": return "audio/mpeg"
+        case "m4a", "mp4", "m4b": return "audio/mp4"
+        case "aac": return "audio/aac"
+        case "wav": return "audio/wav"
+        case "flac": return "audio/flac"
+        default: return nil
+        }
+    }
+}
@@ -1,13 +1,47 @@
 import Foundation
+import UIKit
 
 /// Manages blacklisted resources to avoid repeated failed access attempts
 /// Once a resource fails 14+ times over 1+ week, it's permanently blacklisted and never tried again
+///
+/// `isBlacklisted` runs on every media, user and HTML fetch, so reads go through an immutable
+/// snapshot (Bloom filter in front of an exact set) republished only when the blocked set changes.
+/// Writes are serialized by `lock` and persisted in a compact binary form, debounced; the iCloud
+/// mirror is batched further.
 class BlackList {
     static let shared = BlackList()
-    private let queue = DispatchQueue(label: "com.zz.BlackList", attributes: .concurrent)
+    private let lock = NSLock()
+    
+    /// Blocked-set snapshot read by `isBlacklisted`; swapped under `snapshotLock` only
+    private var snapshot = BlockedSnapshot(blocked: [])
+    private let snapshotLock = NSLock()
+    
+    private let persistQueue = DispatchQueue(label: "com.zz.BlackList.persist", qos: .utility)
+    private var pendingSave: DispatchWorkItem?
+    private let saveDebounceInterval: TimeInterval = 2
+    private var lastICloudMirrorAt: TimeInterval = 0
+    private let iCloudMirrorInterval: TimeInterval = 5 * 60
+    
+    private static let storageKey = "BlackList.v2"
+    private static let legacyBlacklistKey = "BlackList.blacklist"
+    private static let legacyCandidatesKey = "BlackList.candidates"
     
     private init() {
         loadFromStorage()
+        NotificationCenter.default.addObserver(
+            forName: UIApplication.didEnterBackgroundNotification,
+            object: nil,
+            queue: nil
+        ) { [weak self] _ in
+            self?.flush(mirrorToICloud: true)
+        }
+        NotificationCenter.default.addObserver(
+            forName: UIApplication.willTerminateNotification,
+            object: nil,
+            queue: nil
+        ) { [weak self] _ in
+            self?.flush(mirrorToICloud: true)
+        }
     }
     
     // MARK: - Data Structures
@@ -43,19 +77,18 @@ class BlackList {
     
     // MARK: - Public Methods
     
-    /// Check if a resource is blacklisted
+    /// Check if a resource is blacklisted (session-blocked or permanent)
     func isBlacklisted(_ mimeiId: MimeiId) -> Bool {
-        queue.sync {
-            sessionBlockedResources.contains(mimeiId) || blacklist.contains(mimeiId)
-        }
+        let current = snapshotLock.withLock { snapshot }
+        return current.contains(mimeiId)
     }
     
     /// Record a successful access to a resource
     func recordSuccess(_ mimeiId: MimeiId) {
-        queue.sync(flags: .barrier) {
+        lock.withLock {
             let wasInCandidates = candidates.removeValue(forKey: mimeiId) != nil
             sessionFailureCounts.removeValue(forKey: mimeiId)
-            sessionBlockedResources.remove(mimeiId)
+            let wasSessionBlocked = sessionBlockedResources.remove(mimeiId) != nil
             lastFailureRecordedAt.removeValue(forKey: mimeiId)
             
             if wasInCandidates {
@@ -65,13 +98,19 @@ class BlackList {
             // Note: Blacklisted resources are never tried, so they can never succeed
             // The blacklist is permanent - once a resource fails 14+ times over 1+ week, it's permanently ignored
             
-            saveToStorageLocked()
+            if wasSessionBlocked {
+                publishSnapshotLocked()
+            }
+            // Session state isn't persisted; only a candidate change needs a save
+            if wasInCandidates {
+                scheduleSaveLocked()
+            }
         }
     }
     
     /// Record a failed access to a resource
     func recordFailure(_ mimeiId: MimeiId) {
-        queue.sync(flags: .barrier) {
+        lock.withLock {
             let now = Date().timeIntervalSince1970
             if let lastFailure = lastFailureRecordedAt[mimeiId],
                now - lastFailure < failureDedupWindow {
@@ -84,6 +123,7 @@ class BlackList {
             if sessionFailureCount >= sessionBlockFailureCount,
                !sessionBlockedResources.contains(mimeiId) {
                 sessionBlockedResources.insert(mimeiId)
+                publishSnapshotLocked()
                 print("[BlackList] Temporarily blocked \(mimeiId) for this session after \(sessionFailureCount) failures")
             }
             
@@ -114,7 +154,7 @@ class BlackList {
                 print("[BlackList] Added \(mimeiId) to candidates after first failure")
             }
             
-            saveToStorageLocked()
+            scheduleSaveLocked()
         }
     }
     
@@ -122,7 +162,7 @@ class BlackList {
     /// A candidate is moved to blacklist if it has failed 14+ times over 1+ week
     /// This should be called periodically to check if candidates should be moved to blacklist
     func processCandidates() {
-        queue.sync(flags: .barrier) {
+        lock.withLock {
             let candidatesToProcess = Array(candidates.values)
             
             for entry in candidatesToProcess {
@@ -132,13 +172,13 @@ class BlackList {
                 }
             }
             
-            saveToStorageLocked()
+            scheduleSaveLocked()
         }
     }
     
     /// Get statistics for monitoring
     func getStats() -> (candidates: Int, blacklisted: Int) {
-        queue.sync {
+        lock.withLock {
             (candidates: candidates.count, blacklisted: blacklist.count)
         }
     }
@@ -161,13 +201,62 @@ class BlackList {
         sessionFailureCounts.removeValue(forKey: mimeiId)
         sessionBlockedResources.remove(mimeiId)
         blacklist.insert(mimeiId)
+        publishSnapshotLocked()
         print("[BlackList] Permanently blacklisted \(mimeiId) - will never be tried again")
     }
     
+    /// Rebuild the read snapshot from the current blocked sets. Caller holds `lock`.
+    private func publishSnapshotLocked() {
+        let next = BlockedSnapshot(blocked: sessionBlockedResources.union(blacklist))
+        snapshotLock.withLock { snapshot = next }
+    }
+    
     // MARK: - Persistence
     
+    /// Write pending changes now (app backgrounding / termination)
+    func flush(mirrorToICloud: Bool = false) {
+        let data: Data = lock.withLock {
+            pendingSave?.cancel()
+            pendingSave = nil
+            return encodeLocked()
+        }
+        persistQueue.sync {
+            write(data, forceICloud: mirrorToICloud)
+        }
+    }
+    
+    /// Coalesce bursts of failures into one write. Caller holds `lock`.
+    private func scheduleSaveLocked() {
+        guard pendingSave == nil else { return }
+        let work = DispatchWorkItem { [weak self] in
+            guard let self else { return }
+            let data: Data = self.lock.withLock {
+                self.pendingSave = nil
+                return self.encodeLocked()
+            }
+            self.write(data, forceICloud: false)
+        }
+        pendingSave = work
+        persistQueue.asyncAfter(deadline: .now() + saveDebounceInterval, execute: work)
+    }
+    
+    /// UserDefaults is the authoritative store; iCloud is a best-effort backup mirrored at most
+    /// every `iCloudMirrorInterval` (and when the app goes to the background)
+    private func write(_ data: Data, forceICloud: Bool) {
+        UserDefaults.standard.set(data, forKey: Self.storageKey)
+        
+        let now = Date().timeIntervalSince1970
+        guard forceICloud || now - lastICloudMirrorAt >= iCloudMirrorInterval else { return }
+        lastICloudMirrorAt = now
+        let iCloudStore = NSUbiquitousKeyValueStore.default
+        iCloudStore.set(data, forKey: Self.storageKey)
+        iCloudStore.removeObject(forKey: Self.legacyBlacklistKey)
+        iCloudStore.removeObject(forKey: Self.legacyCandidatesKey)
+        iCloudStore.synchronize()
+    }
+    
     /// Load blacklist data preferring UserDefaults, with iCloud as backup
-    /// UserDefaults is the source of truth; iCloud is only a secondary backup
+    /// Reads the binary format, falling back to the legacy JSON keys once
     private func loadFromStorage() {
         let localStore = UserDefaults.standard
         let iCloudStore = NSUbiquitousKeyValueStore.default
@@ -175,60 +264,180 @@ class BlackList {
         // Sync iCloud in background; we still read local first
         iCloudStore.synchronize()
         
-        // Load blacklist - prefer UserDefaults, fallback to iCloud
-        if let blacklistData = localStore.data(forKey: "BlackList.blacklist"),
-           let blacklistArray = try? JSONDecoder().decode([String].self, from: blacklistData) {
-            queue.sync(flags: .barrier) {
-                blacklist = Set(blacklistArray.map { MimeiId($0) })
-                print("[BlackList] Loaded \(blacklist.count) blacklisted items from UserDefaults")
-            }
-        } else if let blacklistData = iCloudStore.data(forKey: "BlackList.blacklist"),
-                  let blacklistArray = try? JSONDecoder().decode([String].self, from: blacklistData) {
-            queue.sync(flags: .barrier) {
-                blacklist = Set(blacklistArray.map { MimeiId($0) })
-                print("[BlackList] Loaded \(blacklist.count) blacklisted items from iCloud (local missing)")
-            }
+        var loaded: (blacklist: Set<MimeiId>, candidates: [CandidateEntry])?
+        var source = ""
+        if let data = localStore.data(forKey: Self.storageKey), let decoded = Self.decode(data) {
+            loaded = decoded
+            source = "UserDefaults"
+        } else if let legacy = Self.decodeLegacy(from: { localStore.data(forKey: $0) }) {
+            loaded = legacy
+            source = "UserDefaults (legacy JSON)"
+        } else if let data = iCloudStore.data(forKey: Self.storageKey), let decoded = Self.decode(data) {
+            loaded = decoded
+            source = "iCloud (local missing)"
+        } else if let legacy = Self.decodeLegacy(from: { iCloudStore.data(forKey: $0) }) {
+            loaded = legacy
+            source = "iCloud legacy JSON (local missing)"
         }
         
-        // Load candidates - prefer UserDefaults, fallback to iCloud
-        if let candidatesData = localStore.data(forKey: "BlackList.candidates"),
-           let candidatesArray = try? JSONDecoder().decode([CandidateEntry].self, from: candidatesData) {
-            queue.sync(flags: .barrier) {
-                candidates = Dictionary(uniqueKeysWithValues: candidatesArray.map { ($0.mimeiId, $0) })
-                print("[BlackList] Loaded \(candidates.count) candidates from UserDefaults")
-            }
-        } else if let candidatesData = iCloudStore.data(forKey: "BlackList.candidates"),
-                  let candidatesArray = try? JSONDecoder().decode([CandidateEntry].self, from: candidatesData) {
-            queue.sync(flags: .barrier) {
-                candidates = Dictionary(uniqueKeysWithValues: candidatesArray.map { ($0.mimeiId, $0) })
-                print("[BlackList] Loaded \(candidates.count) candidates from iCloud (local missing)")
-            }
+        guard let loaded else { return }
+        lock.withLock {
+            blacklist = loaded.blacklist
+            candidates = Dictionary(loaded.candidates.map { ($0.mimeiId, $0) }, uniquingKeysWith: { first, _ in first })
+            publishSnapshotLocked()
+            print("[BlackList] Loaded \(blacklist.count) blacklisted items and \(candidates.count) candidates from \(source)")
+        }
+        
+        if source.contains("legacy") {
+            // Rewrite in the binary format and drop the JSON keys
+            localStore.removeObject(forKey: Self.legacyBlacklistKey)
+            localStore.removeObject(forKey: Self.legacyCandidatesKey)
+            flush(mirrorToICloud: true)
         }
     }
     
-    /// Save blacklist data to UserDefaults first, then mirror to iCloud as backup
-    /// UserDefaults is the authoritative store; iCloud is best-effort backup
-    private func saveToStorageLocked() {
-        let blacklistArray = Array(blacklist).map { $0 }
-        let candidatesArray = Array(candidates.values)
-        
-        // Encode data
-        guard let blacklistData = try? JSONEncoder().encode(blacklistArray),
-              let candidatesData = try? JSONEncoder().encode(candidatesArray) else {
-            print("[BlackList] Failed to encode data for storage")
-            return
+    // MARK: - Binary Format
+    //
+    // "BL2" | u32 blacklistCount | u32 candidateCount
+    // blacklist:  u8 idLength | id (UTF-8)
+    // candidates: u8 idLength | id (UTF-8) | u32 failureCount | f64 firstFailureTimestamp
+    // Integers and doubles are little-endian.
+    
+    private static let magic: [UInt8] = Array("BL2".utf8)
+    
+    private func encodeLocked() -> Data {
+        var data = Data(Self.magic)
+        data.reserveCapacity(11 + blacklist.count * 48 + candidates.count * 60)
+        data.appendLittleEndian(UInt32(blacklist.count))
+        data.appendLittleEndian(UInt32(candidates.count))
+        for mimeiId in blacklist {
+            data.appendShortString(mimeiId)
         }
-        
-        // Save to UserDefaults first (authoritative)
-        let localStore = UserDefaults.standard
-        localStore.set(blacklistData, forKey: "BlackList.blacklist")
-        localStore.set(candidatesData, forKey: "BlackList.candidates")
-        
-        // Mirror to iCloud as backup (best-effort; survives reinstallation)
-        let iCloudStore = NSUbiquitousKeyValueStore.default
-        iCloudStore.set(blacklistData, forKey: "BlackList.blacklist")
-        iCloudStore.set(candidatesData, forKey: "BlackList.candidates")
-        iCloudStore.synchronize()
+        for entry in candidates.values {
+            data.appendShortString(entry.mimeiId)
+            data.appendLittleEndian(UInt32(clamping: entry.failureCount))
+            data.appendLittleEndian(entry.firstFailureTimestamp.bitPattern)
+        }
+        return data
+    }
+    
+    private static func decode(_ data: Data) -> (blacklist: Set<MimeiId>, candidates: [CandidateEntry])? {
+        var reader = ByteReader(bytes: [UInt8](data))
+        guard reader.read(count: magic.count) == magic,
+              let blacklistCount = reader.readUInt32(),
+              let candidateCount = reader.readUInt32() else {
+            return nil
+        }
+        var blacklist = Set<MimeiId>()
+        blacklist.reserveCapacity(Int(blacklistCount))
+        for _ in 0..<blacklistCount {
+            guard let mimeiId = reader.readShortString() else { return nil }
+            blacklist.insert(mimeiId)
+        }
+        var candidates: [CandidateEntry] = []
+        candidates.reserveCapacity(Int(candidateCount))
+        for _ in 0..<candidateCount {
+            guard let mimeiId = reader.readShortString(),
+                  let failureCount = reader.readUInt32(),
+                  let timestampBits = reader.readUInt64() else { return nil }
+            candidates.append(CandidateEntry(
+                mimeiId: mimeiId,
+                failureCount: Int(failureCount),
+                firstFailureTimestamp: TimeInterval(bitPattern: timestampBits)
+            ))
+        }
+        return (blacklist, candidates)
+    }
+    
+    private static func decodeLegacy(from read: (String) -> Data?) -> (blacklist: Set<MimeiId>, candidates: [CandidateEntry])? {
+        let blacklistArray = read(legacyBlacklistKey).flatMap { try? JSONDecoder().decode([String].self, from: $0) }
+        let candidatesArray = read(legacyCandidatesKey).flatMap { try? JSONDecoder().decode([CandidateEntry].self, from: $0) }
+        guard blacklistArray != nil || candidatesArray != nil else { return nil }
+        return (Set((blacklistArray ?? []).map { MimeiId($0) }), candidatesArray ?? [])
+    }
+}
+
+// MARK: - Read Snapshot
+
+/// Immutable blocked set with a Bloom filter in front, so the common "not blocked" answer
+/// costs a few bit tests instead of hashing into the exact set.
+private final class BlockedSnapshot: @unchecked Sendable {
+    private let exact: Set<MimeiId>
+    private let bits: [UInt64]
+    private let mask: UInt64
+    private static let hashCount = 4
+    
+    init(blocked: Set<MimeiId>) {
+        exact = blocked
+        // ~16 bits per entry keeps false positives well under 1% with 4 hashes
+        var bitCount = 1024
+        while bitCount < blocked.count * 16 { bitCount <<= 1 }
+        let mask = UInt64(bitCount - 1)
+        var bits = [UInt64](repeating: 0, count: bitCount / 64)
+        for mimeiId in blocked {
+            Self.forEachBit(of: mimeiId, mask: mask) { bits[Int($0 >> 6)] |= 1 << ($0 & 63) }
+        }
+        self.mask = mask
+        self.bits = bits
+    }
+    
+    func contains(_ mimeiId: MimeiId) -> Bool {
+        guard !exact.isEmpty else { return false }
+        var maybe = true
+        Self.forEachBit(of: mimeiId, mask: mask) { bit in
+            if maybe && bits[Int(bit >> 6)] & (1 << (bit & 63)) == 0 { maybe = false }
+        }
+        return maybe && exact.contains(mimeiId)
+    }
+    
+    /// Double hashing over FNV-1a: bit_i = h1 + i * h2
+    private static func forEachBit(of mimeiId: MimeiId, mask: UInt64, _ body: (UInt64) -> Void) {
+        var h1: UInt64 = 0xcbf29ce484222325
+        for byte in mimeiId.utf8 {
+            h1 = (h1 ^ UInt64(byte)) &* 0x100000001b3
+        }
+        let h2 = (h1 >> 33 | h1 << 31) | 1
+        for i in 0..<UInt64(hashCount) {
+            body((h1 &+ i &* h2) & mask)
+        }
+    }
+}
+
+// MARK: - Binary Helpers
+
+private extension Data {
+    mutating func appendLittleEndian<T: FixedWidthInteger>(_ value: T) {
+        Swift.withUnsafeBytes(of: value.littleEndian) { append(contentsOf: $0) }
+    }
+    
+    mutating func appendShortString(_ string: String) {
+        let utf8 = Array(string.utf8.prefix(255))
+        append(UInt8(utf8.count))
+        append(contentsOf: utf8)
+    }
+}
+
+private struct ByteReader {
+    let bytes: [UInt8]
+    var offset = 0
+    
+    mutating func read(count: Int) -> [UInt8]? {
+        guard count >= 0, offset + count <= bytes.count else { return nil }
+        defer { offset += count }
+        return Array(bytes[offset..<(offset + count)])
+    }
+    
+    mutating func readUInt32() -> UInt32? {
+        read(count: 4).map { $0.reversed().reduce(UInt32(0)) { $0 << 8 | UInt32($1) } }
+    }
+    
+    mutating func readUInt64() -> UInt64? {
+        read(count: 8).map { $0.reversed().reduce(UInt64(0)) { $0 << 8 | UInt64($1) } }
+    }
+    
+    mutating func readShortString() -> String? {
+        guard let length = read(count: 1)?.first, let utf8 = read(count: Int(length)) else { return nil }
+        return String(decoding: utf8, as: UTF8.self)
     }
 }
 
@@ -0,0 +1,175 @@
+//
+//  CanonicalJSONEncoder.swift
+//  Tweet
+//
+//  RFC 8785 (JSON Canonicalization Scheme) encoding for signed payloads.
+//
+
+import Foundation
+
+/// Encodes Foundation JSON values (`[String: Any]`, `[Any]`, String, NSNumber, NSNull) in the
+/// canonical form of RFC 8785, so a signer and a verifier in any language produce the same
+/// bytes:
+/// - object keys sorted by UTF-16 code units, no whitespace
+/// - strings escaped minimally (`"`, `\`, control characters), everything else as UTF-8
+/// - numbers formatted like ECMAScript `Number.prototype.toString`
+///
+/// Output is appended to `bytes`; call `reset()` to reuse the buffer for the next payload.
+struct CanonicalJSONEncoder {
+    enum EncodingError: Error {
+        case unsupportedValue(Any)
+        case nonFiniteNumber
+    }
+
+    private(set) var bytes: [UInt8] = []
+
+    init(capacity: Int = 512) {
+        bytes.reserveCapacity(capacity)
+    }
+
+    mutating func reset() {
+        bytes.removeAll(keepingCapacity: true)
+    }
+
+    /// Canonical bytes of `value`, encoded into a fresh buffer.
+    static func encode(_ value: Any) throws -> Data {
+        var encoder = CanonicalJSONEncoder()
+        try encoder.append(value)
+        return Data(encoder.bytes)
+    }
+
+    mutating func append(_ value: Any) throws {
+        switch value {
+        case let string as String:
+            appendString(string)
+        case let dictionary as [String: Any]:
+            bytes.append(UInt8(ascii: "{"))
+            let keys = dictionary.keys.sorted { $0.utf16.lexicographicallyPrecedes($1.utf16) }
+            for (index, key) in keys.enumerated() {
+                if index > 0 { bytes.append(UInt8(ascii: ",")) }
+                appendString(key)
+                bytes.append(UInt8(ascii: ":"))
+                try append(dictionary[key]!)
+            }
+            bytes.append(UInt8(ascii: "}"))
+        case let array as [Any]:
+            bytes.append(UInt8(ascii: "["))
+            for (index, element) in array.enumerated() {
+                if index > 0 { bytes.append(UInt8(ascii: ",")) }
+                try append(element)
+            }
+            bytes.append(UInt8(ascii: "]"))
+        case is NSNull:
+            appendASCII("null")
+        case let number as NSNumber:
+            try appendNumber(number)
+        default:
+            throw EncodingError.unsupportedValue(value)
+        }
+    }
+
+    // MARK: - Strings
+
+    private mutating func appendString(_ string: String) {
+        bytes.append(UInt8(ascii: "\""))
+        for byte in string.utf8 {
+            switch byte {
+            case UInt8(ascii: "\""): appendASCII("\\\"")
+            case UInt8(ascii: "\\"): appendASCII("\\\\")
+            case 0x08: appendASCII("\\b")
+            case 0x09: appendASCII("\\t")
+            case 0x0A: appendASCII("\\n")
+            case 0x0C: appendASCII("\\f")
+            case 0x0D: appendASCII("\\r")
+            case 0x00..<0x20:
+                appendASCII("\\u00")
+                bytes.append(Self.hexDigits[Int(byte >> 4)])
+                bytes.append(Self.hexDigits[Int(byte & 0x0F)])
+            default:
+                bytes.append(byte)
+            }
+        }
+        bytes.append(UInt8(ascii: "\""))
+    }
+
+    private static let hexDigits: [UInt8] = Array("0123456789abcdef".utf8)
+
+    private mutating func appendASCII(_ literal: StaticString) {
+        literal.withUTF8Buffer { bytes.append(contentsOf: $0) }
+    }
+
+    // MARK: - Numbers
+
+    private mutating func appendNumber(_ number: NSNumber) throws {
+        if CFGetTypeID(number) == CFBooleanGetTypeID() {
+            appendASCII(number.boolValue ? "true" : "false")
+            return
+        }
+        // Integers that are exact as doubles print as-is; everything else goes through the
+        // ECMAScript double formatting, as I-JSON requires.
+        if !CFNumberIsFloatType(number) {
+            let integer = number.int64Value
+            if integer.magnitude <= 1 << 53, number.compare(NSNumber(value: integer)) == .orderedSame {
+                bytes.append(contentsOf: String(integer).utf8)
+                return
+            }
+        }
+        try appendDouble(number.doubleValue)
+    }
+
+    /// ECMAScript Number::toString on the shortest round-trip digits.
+    private mutating func appendDouble(_ value: Double) throws {
+        guard value.isFinite else { throw EncodingError.nonFiniteNumber }
+        if value == 0 {
+            bytes.append(UInt8(ascii: "0"))
+            return
+        }
+        if value < 0 {
+            bytes.append(UInt8(ascii: "-"))
+        }
+
+        // Swift's description is the shortest round-trip form ("1.5", "1e-07", "1.25e+22");
+        // reduce it to digits `s` and exponent `n` with value = 0.s × 10^n.
+        let description = value.magnitude.description
+        let parts = description.split(separator: "e", maxSplits: 1)
+        let mantissa = parts[0]
+        let exponent = parts.count > 1 ? Int(parts[1]) ?? 0 : 0
+        let mantissaParts = mantissa.split(separator: ".", maxSplits: 1, omittingEmptySubsequences: false)
+        let integerPart = mantissaParts[0]
+        let fractionPart = mantissaParts.count > 1 ? mantissaParts[1] : ""
+
+        var digits = Array((integerPart + fractionPart).utf8)
+        var scale = exponent - fractionPart.count
+        while digits.count > 1, digits.first == UInt8(ascii: "0") {
+            digits.removeFirst()
+        }
+        while digits.count > 1, digits.last == UInt8(ascii: "0") {
+            digits.removeLast()
+            scale += 1
+        }
+        let k = digits.count
+        let n = k + scale
+
+        if k <= n && n <= 21 {
+            bytes.append(contentsOf: digits)
+            bytes.append(contentsOf: repeatElement(UInt8(ascii: "0"), count: n - k))
+        } else if 0 < n && n <= 21 {
+            bytes.append(contentsOf: digits[0..<n])
+            bytes.append(UInt8(ascii: "."))
+            bytes.append(contentsOf: digits[n...])
+        } else if -6 < n && n <= 0 {
+            appendASCII("0.")
+            bytes.append(contentsOf: repeatElement(UInt8(ascii: "0"), count: -n))
+            bytes.append(contentsOf: digits)
+        } else {
+            bytes.append(digits[0])
+            if k > 1 {
+                bytes.append(UInt8(ascii: "."))
+                bytes.append(contentsOf: digits[1...])
+            }
+            bytes.append(UInt8(ascii: "e"))
+            bytes.append(UInt8(ascii: n - 1 >= 0 ? "+" : "-"))
+            bytes.append(contentsOf: String(abs(n - 1)).utf8)
+        }
+    }
+}
@@ -10,13 +10,16 @@ class ChatCacheManager {
         // No periodic cleanup needed - messages are only removed manually by user
     }
     
+    /// Main-queue context for reads. Writes go through the writer queue: session saves and
+    /// deletes don't wait (the session list is kept in memory); message writes wait, which keeps
+    /// read-after-write ordering for chat without running on the main queue.
     var context: NSManagedObjectContext { coreDataManager.context }
 }
 
 // MARK: - Chat Session Caching
 extension ChatCacheManager {
     func saveChatSession(_ session: ChatSession) {
-        context.performAndWait {
+        coreDataManager.performWrite { context in
             let request: NSFetchRequest<CDChatSession> = CDChatSession.fetchRequest()
             request.predicate = NSPredicate(format: "id == %@", session.id)
             let cdSession = (try? context.fetch(request).first) ?? CDChatSession(context: context)
@@ -63,7 +66,7 @@ extension ChatCacheManager {
     }
     
     func deleteChatSession(id: String) {
-        context.performAndWait {
+        coreDataManager.performWrite { context in
             let request: NSFetchRequest<CDChatSession> = CDChatSession.fetchRequest()
             request.predicate = NSPredicate(format: "id == %@", id)
             
@@ -82,7 +85,7 @@ extension ChatCacheManager {
     }
     
     func deleteChatSessionByReceiptId(userId: String, receiptId: String) {
-        context.performAndWait {
+        coreDataManager.performWriteAndWait { context in
             let request: NSFetchRequest<CDChatSession> = CDChatSession.fetchRequest()
             request.predicate = NSPredicate(format: "userId == %@ AND receiptId == %@", userId, receiptId)
             
@@ -171,7 +174,7 @@ extension ChatCacheManager {
 // MARK: - Chat Message Caching
 extension ChatCacheManager {
     func saveChatMessage(_ message: ChatMessage) {
-        context.performAndWait {
+        coreDataManager.performWriteAndWait { context in
             let request: NSFetchRequest<CDChatMessage> = CDChatMessage.fetchRequest()
             request.predicate = NSPredicate(format: "id == %@", message.id)
             let cdMessage = (try? context.fetch(request).first) ?? CDChatMessage(context: context)
@@ -237,7 +240,7 @@ extension ChatCacheManager {
     }
     
     func deleteMessagesForConversation(authorId: String, receiptId: String) {
-        context.performAndWait {
+        coreDataManager.performWriteAndWait { context in
             let request: NSFetchRequest<CDChatMessage> = CDChatMessage.fetchRequest()
             request.predicate = NSPredicate(format: "(authorId == %@ AND receiptId == %@) OR (authorId == %@ AND receiptId == %@)",
                                             authorId, receiptId, receiptId, authorId)
@@ -253,7 +256,7 @@ extension ChatCacheManager {
     
     /// Delete a single chat message
     func deleteChatMessage(_ message: ChatMessage) {
-        context.performAndWait {
+        coreDataManager.performWriteAndWait { context in
             let request: NSFetchRequest<CDChatMessage> = CDChatMessage.fetchRequest()
             request.predicate = NSPredicate(format: "id == %@", message.id)
             
@@ -319,15 +322,16 @@ extension ChatCacheManager {
     }
     
     private func deleteExpiredMessages() {
-        let request: NSFetchRequest<CDChatMessage> = CDChatMessage.fetchRequest()
-        let thirtyDaysAgo = Calendar.current.date(byAdding: .day, value: -30, to: Date())!
-        request.predicate = NSPredicate(format: "timeCached < %@", thirtyDaysAgo as NSDate)
-        
-        if let expiredMessages = try? context.fetch(request) {
-            for message in expiredMessages {
-                context.delete(message)
+        coreDataManager.performWrite { context in
+            let request: NSFetchRequest<CDChatMessage> = CDChatMessage.fetchRequest()
+            let thirtyDaysAgo = Calendar.current.date(byAdding: .day, value: -30, to: Date())!
+            request.predicate = NSPredicate(format: "timeCached < %@", thirtyDaysAgo as NSDate)
+            
+            if let expiredMessages = try? context.fetch(request) {
+                for message in expiredMessages {
+                    context.delete(message)
+                }
             }
-            try? context.save()
         }
     }
     
@@ -363,7 +367,7 @@ extension ChatCacheManager {
     func clearAllCache() {
         print("DEBUG: [ChatCacheManager] Manual cache clear - clearing all chat messages and their media")
         
-        context.performAndWait {
+        coreDataManager.performWriteAndWait { context in
             // Delete all chat messages AND their media
             let messageRequest: NSFetchRequest<CDChatMessage> = CDChatMessage.fetchRequest()
             if let allMessages = try? context.fetch(messageRequest) {
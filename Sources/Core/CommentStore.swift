@@ -0,0 +1,324 @@
+import Foundation
+import UIKit
+
+/// Local window of comment pages per parent tweet.
+///
+/// The page index (comment ids per page, the parent's comment count when fetched, fetch time)
+/// is persisted in Application Support. A page keeps one slot per server item, nil where the
+/// server sent nothing usable, so a cached page has the length the list paginates on. The comments themselves are saved to the tweet cache
+/// under `comment_list_<parentId>`, so they share its size and age budget; a page whose
+/// comments were evicted there is simply a miss.
+///
+/// Cached pages are served at once and revalidated in the background when they are older
+/// than `revalidateAfter` or the parent's comment count changed. Concurrent requests for the
+/// same page share one RPC.
+final class CommentStore: @unchecked Sendable {
+    static let shared = CommentStore()
+
+    typealias PageResult = (comments: [Tweet?], failedIds: [String])
+
+    private struct CachedPage: Codable {
+        /// One slot per item the server returned; nil for items that couldn't be used
+        var ids: [MimeiId?]
+        /// Ids of the nil slots that failed to parse, for the list's retry
+        var failedIds: [String]
+        var fetchedAt: Date
+
+        init(ids: [MimeiId?], failedIds: [String], fetchedAt: Date) {
+            self.ids = ids
+            self.failedIds = failedIds
+            self.fetchedAt = fetchedAt
+        }
+
+        // Indexes written before failedIds existed still load
+        init(from decoder: Decoder) throws {
+            let container = try decoder.container(keyedBy: CodingKeys.self)
+            ids = try container.decode([MimeiId?].self, forKey: .ids)
+            failedIds = try container.decodeIfPresent([String].self, forKey: .failedIds) ?? []
+            fetchedAt = try container.decode(Date.self, forKey: .fetchedAt)
+        }
+    }
+
+    private struct Thread: Codable {
+        /// Parent's commentCount when the pages were fetched
+        var version: Int
+        /// Keyed by "pageSize:page"
+        var pages: [String: CachedPage]
+        var lastAccess: Date
+    }
+
+    private var threads: [MimeiId: Thread] = [:]
+    private var inFlight: [String: Task<PageResult, Error>] = [:]
+    private let lock = NSLock()
+
+    private let persistQueue = DispatchQueue(label: "com.zz.CommentStore.persist", qos: .utility)
+    private var pendingSave: DispatchWorkItem?
+    private let saveDelay: TimeInterval = 2
+    private let revalidateAfter: TimeInterval = 30
+    private let maxThreads = 300
+    /// Most-engaged comments whose first replies are prefetched
+    private let replyPrefetchCount = 3
+    /// Fraction of the loaded list after which the next page is prefetched
+    static let prefetchThreshold = 0.7
+
+    private static let indexURL: URL = {
+        let directory = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask)[0]
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        return directory.appendingPathComponent("CommentStore.json")
+    }()
+
+    private init() {
+        loadIndex()
+        NotificationCenter.default.addObserver(
+            forName: UIApplication.didEnterBackgroundNotification,
+            object: nil,
+            queue: nil
+        ) { [weak self] _ in
+            self?.saveNow()
+        }
+        for name in [Notification.Name.newCommentAdded, .commentRestored] {
+            NotificationCenter.default.addObserver(forName: name, object: nil, queue: nil) { [weak self] notification in
+                guard let comment = notification.userInfo?["comment"] as? Tweet,
+                      let parentId = notification.userInfo?["parentTweetId"] as? String else { return }
+                self?.insert(comment, parentId: parentId)
+            }
+        }
+        NotificationCenter.default.addObserver(
+            forName: .commentDeleted,
+            object: nil,
+            queue: nil
+        ) { [weak self] notification in
+            guard let comment = notification.userInfo?["comment"] as? Tweet,
+                  let parentId = notification.userInfo?["parentTweetId"] as? String else { return }
+            self?.remove(commentId: comment.mid, parentId: parentId)
+        }
+    }
+
+    // MARK: - Public Methods
+
+    /// A page of comments: the cached window when there is one, otherwise the network.
+    /// When a cached page turns out to be stale, `onRevalidated` gets the fresh comments and
+    /// the ids that dropped out of the page.
+    func page(
+        for parentTweet: Tweet,
+        page: UInt,
+        pageSize: UInt,
+        onRevalidated: (@MainActor @Sendable (_ fresh: [Tweet], _ removedIds: [MimeiId]) -> Void)? = nil
+    ) async throws -> PageResult {
+        let parentId = parentTweet.mid
+        let version = parentTweet.commentCount ?? 0
+        guard let cached = lock.withLock({ cachedPageLocked(parentId: parentId, page: page, pageSize: pageSize) }),
+              let comments = await resolve(cached.page.ids) else {
+            return try await fetchPage(for: parentTweet, page: page, pageSize: pageSize)
+        }
+
+        let isStale = Date().timeIntervalSince(cached.page.fetchedAt) > revalidateAfter || cached.version != version
+        if isStale {
+            Task(priority: .utility) {
+                guard let fresh = try? await self.fetchPage(for: parentTweet, page: page, pageSize: pageSize) else { return }
+                let freshComments = fresh.comments.compactMap { $0 }
+                let freshIds = Set(freshComments.map { $0.mid })
+                let cachedIds = cached.page.ids.compactMap { $0 }
+                guard freshComments.map({ $0.mid }) != cachedIds else { return }
+                let removed = cachedIds.filter { !freshIds.contains($0) }
+                await onRevalidated?(freshComments, removed)
+            }
+        }
+        print("DEBUG: [CommentStore] Served \(comments.compactMap { $0 }.count)/\(comments.count) cached comments for \(parentId) page \(page)\(isStale ? ", revalidating" : "")")
+        return (comments, cached.page.failedIds)
+    }
+
+    /// Fetch a page from the network and store it. Concurrent calls for one page share the RPC.
+    func fetchPage(for parentTweet: Tweet, page: UInt, pageSize: UInt) async throws -> PageResult {
+        let parentId = parentTweet.mid
+        let key = "\(parentId)|\(pageSize):\(page)"
+        let task = lock.withLock { () -> Task<PageResult, Error> in
+            if let existing = inFlight[key] {
+                return existing
+            }
+            let task = Task<PageResult, Error> {
+                defer { _ = self.lock.withLock { self.inFlight.removeValue(forKey: key) } }
+                let result = try await HproseInstance.shared.fetchComments(parentTweet, pageNumber: page, pageSize: pageSize)
+                self.store(result, parentId: parentId, version: parentTweet.commentCount ?? 0, page: page, pageSize: pageSize)
+                return result
+            }
+            inFlight[key] = task
+            return task
+        }
+        return try await task.value
+    }
+
+    /// Called once the user has scrolled past `prefetchThreshold` of `loaded`: warm the next
+    /// page and the first replies of the most-engaged loaded comments.
+    func prefetch(after loaded: [Tweet], parentTweet: Tweet, nextPage: UInt, pageSize: UInt, hasMore: Bool) {
+        var targets: [(tweet: Tweet, page: UInt)] = []
+        if hasMore {
+            targets.append((parentTweet, nextPage))
+        }
+        let engaged = loaded
+            .filter { ($0.commentCount ?? 0) > 0 }
+            .sorted { engagement(of: $0) > engagement(of: $1) }
+            .prefix(replyPrefetchCount)
+        targets.append(contentsOf: engaged.map { ($0, 0) })
+
+        for (tweet, page) in targets {
+            let isFresh = lock.withLock { () -> Bool in
+                guard let cached = cachedPageLocked(parentId: tweet.mid, page: page, pageSize: pageSize) else { return false }
+                return Date().timeIntervalSince(cached.page.fetchedAt) <= revalidateAfter
+                    && cached.version == (tweet.commentCount ?? 0)
+            }
+            guard !isFresh else { continue }
+            Task(priority: .utility) {
+                _ = try? await self.fetchPage(for: tweet, page: page, pageSize: pageSize)
+            }
+        }
+    }
+
+    /// A new comment goes to the top of every cached first page; later pages shift by one,
+    /// so they are left to revalidate.
+    func insert(_ comment: Tweet, parentId: MimeiId) {
+        TweetCacheManager.shared.saveTweet(comment, userId: Self.cacheKey(parentId))
+        lock.withLock {
+            guard var thread = threads[parentId] else { return }
+            for (key, var cached) in thread.pages {
+                if key.hasSuffix(":0") {
+                    if !cached.ids.contains(comment.mid) {
+                        cached.ids.insert(comment.mid, at: 0)
+                    }
+                } else {
+                    cached.fetchedAt = .distantPast
+                }
+                thread.pages[key] = cached
+            }
+            thread.version += 1
+            threads[parentId] = thread
+            scheduleSaveLocked()
+        }
+    }
+
+    func remove(commentId: MimeiId, parentId: MimeiId) {
+        TweetCacheManager.shared.removeTweet(mid: commentId, fromCache: Self.cacheKey(parentId))
+        lock.withLock {
+            guard var thread = threads[parentId] else { return }
+            for (key, var cached) in thread.pages {
+                if let index = cached.ids.firstIndex(of: commentId) {
+                    // Keep the slot so the page still reads as full to pagination
+                    cached.ids[index] = nil
+                } else {
+                    cached.fetchedAt = .distantPast
+                }
+                thread.pages[key] = cached
+            }
+            thread.version = max(0, thread.version - 1)
+            threads[parentId] = thread
+            scheduleSaveLocked()
+        }
+    }
+
+    func clear() {
+        lock.withLock {
+            threads.removeAll()
+            scheduleSaveLocked()
+        }
+    }
+
+    // MARK: - Private
+
+    private static func cacheKey(_ parentId: MimeiId) -> String {
+        "comment_list_\(parentId)"
+    }
+
+    private func engagement(of tweet: Tweet) -> Int {
+        (tweet.commentCount ?? 0) * 3 + (tweet.retweetCount ?? 0) * 2 + (tweet.favoriteCount ?? 0)
+    }
+
+    private func cachedPageLocked(parentId: MimeiId, page: UInt, pageSize: UInt) -> (page: CachedPage, version: Int)? {
+        guard var thread = threads[parentId], let cached = thread.pages["\(pageSize):\(page)"] else { return nil }
+        thread.lastAccess = Date()
+        threads[parentId] = thread
+        return (cached, thread.version)
+    }
+
+    /// Comments for `ids` with nil slots kept, or nil when any of them is no longer in the tweet cache.
+    private func resolve(_ ids: [MimeiId?]) async -> [Tweet?]? {
+        var comments: [Tweet?] = []
+        comments.reserveCapacity(ids.count)
+        for mid in ids {
+            guard let mid else {
+                comments.append(nil)
+                continue
+            }
+            guard let comment = await TweetCacheManager.shared.fetchTweet(mid: mid) else { return nil }
+            comments.append(comment)
+        }
+        return comments
+    }
+
+    private func store(_ result: PageResult, parentId: MimeiId, version: Int, page: UInt, pageSize: UInt) {
+        let cacheKey = Self.cacheKey(parentId)
+        for comment in result.comments.compactMap({ $0 }) {
+            TweetCacheManager.shared.saveTweet(comment, userId: cacheKey)
+        }
+        lock.withLock {
+            var thread = threads[parentId] ?? Thread(version: version, pages: [:], lastAccess: Date())
+            if thread.version != version {
+                // The thread changed since the other pages were fetched
+                thread.pages.removeAll()
+                thread.version = version
+            }
+            thread.pages["\(pageSize):\(page)"] = CachedPage(
+                ids: result.comments.map { $0?.mid },
+                failedIds: result.failedIds,
+                fetchedAt: Date()
+            )
+            thread.lastAccess = Date()
+            threads[parentId] = thread
+
+            if threads.count > maxThreads {
+                let overflow = threads.sorted { $0.value.lastAccess < $1.value.lastAccess }.prefix(threads.count - maxThreads)
+                for (id, _) in overflow {
+                    threads.removeValue(forKey: id)
+                }
+            }
+            scheduleSaveLocked()
+        }
+    }
+
+    // MARK: - Persistence
+
+    private func scheduleSaveLocked() {
+        pendingSave?.cancel()
+        let work = DispatchWorkItem { [weak self] in
+            self?.saveNow()
+        }
+        pendingSave = work
+        persistQueue.asyncAfter(deadline: .now() + saveDelay, execute: work)
+    }
+
+    private func saveNow() {
+        let snapshot = lock.withLock { () -> [MimeiId: Thread] in
+            pendingSave?.cancel()
+            pendingSave = nil
+            return threads
+        }
+        persistQueue.async {
+            do {
+                let data = try JSONEncoder().encode(snapshot)
+                try data.write(to: Self.indexURL, options: [.atomic])
+            } catch {
+                print("ERROR: [CommentStore] Failed to write index: \(error)")
+            }
+        }
+    }
+
+    private func loadIndex() {
+        guard let data = try? Data(contentsOf: Self.indexURL) else { return }
+        do {
+            threads = try JSONDecoder().decode([MimeiId: Thread].self, from: data)
+            print("DEBUG: [CommentStore] Restored \(threads.count) comment threads")
+        } catch {
+            print("ERROR: [CommentStore] Discarding unreadable index: \(error)")
+            try? FileManager.default.removeItem(at: Self.indexURL)
+        }
+    }
+}
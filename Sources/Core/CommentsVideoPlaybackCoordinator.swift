@@ -3,12 +3,13 @@
 //  Tweet
 //
 //  Coordinates video playback for comments in TweetDetailView
-//  Tracks visible comments and autoplays the topmost visible video
+//  Tracks comment video frames and autoplays the topmost visible video
 //
 
 import Foundation
 import SwiftUI
 import Combine
+import QuartzCore
 
 /// Tracks video information within a comment
 struct CommentVideoInfo: Equatable, Hashable {
@@ -25,6 +26,10 @@ struct CommentVideoInfo: Equatable, Hashable {
 /// Coordinates video playback for comments in TweetDetailView
 /// Only one video plays at a time - the topmost visible video
 /// Comment videos only play when the main tweet's video attachment is scrolled out of view
+///
+/// Video views report their frames in scroll-content coordinates (which only change on
+/// layout) and the scroll view reports its visible rect. Decisions run on the shared display
+/// link, at most once per frame, and only while something changed or a switch is pending.
 @MainActor
 class CommentsVideoPlaybackCoordinator: ObservableObject {
 
@@ -42,25 +47,30 @@ class CommentsVideoPlaybackCoordinator: ObservableObject {
 
     // MARK: - Private State
 
-    /// Visible comments with their video info and visibility ratios
-    /// Key: commentId, Value: (videoInfo, visibilityRatio, yPosition)
-    private var visibleCommentVideos: [String: (info: CommentVideoInfo, ratio: CGFloat, yPosition: CGFloat)] = [:]
+    /// Registered videos, keyed by commentId (or "att<index>" for main tweet attachments)
+    private var registeredVideos: [String: CommentVideoInfo] = [:]
 
-    /// Debounce timer for visibility updates
-    private var visibilityDebounceTimer: Timer?
-    private let debounceInterval = FeedPlaybackTuning.videoVisibilityThrottleInterval
+    /// New videos can start once half of the media is visible; the current one stops early
+    /// as the user scrolls it away, matching feed behavior. A new winner must hold for the
+    /// throttle interval before playback moves to it.
+    private var visibilityEngine = VideoVisibilityEngine(
+        startRatio: Double(FeedPlaybackTuning.videoStartVisibilityRatio),
+        continueRatio: Double(FeedPlaybackTuning.videoContinueVisibilityRatio),
+        switchDelay: FeedPlaybackTuning.videoVisibilityThrottleInterval
+    )
 
-    /// New videos can start once half of the media is visible.
-    private let startVisibilityRatio = FeedPlaybackTuning.videoStartVisibilityRatio
-    /// Stop the current video early as the user scrolls it away, matching feed behavior.
-    private let continueVisibilityRatio = FeedPlaybackTuning.videoContinueVisibilityRatio
+    /// Visible rect of the scroll view, in content coordinates
+    private var viewport: CGRect?
+
+    private let displayLinkObserverID = UUID()
+    private var isObservingDisplayLink = false
 
     /// Track if coordinator is active
     private var isActive: Bool = false
 
     /// Track if the main tweet's video attachment is visible
     /// When true, comment videos should NOT autoplay
-    /// Kept for backward compatibility but unified tracking now uses visibleCommentVideos
+    /// Kept for backward compatibility but unified tracking now uses registeredVideos
     private var isMainTweetVideoVisible: Bool = false
 
     // MARK: - Lifecycle
@@ -70,7 +80,11 @@ class CommentsVideoPlaybackCoordinator: ObservableObject {
     }
 
     deinit {
-        visibilityDebounceTimer?.invalidate()
+        // The display link callback only holds self weakly; drop it so the link can stop
+        let observerID = displayLinkObserverID
+        Task { @MainActor in
+            SharedDisplayLinkManager.shared.removeObserver(id: observerID)
+        }
         print("📹 [CommentsVideoCoordinator] Deinitialized")
     }
 
@@ -81,6 +95,7 @@ class CommentsVideoPlaybackCoordinator: ObservableObject {
     func activate(hasMainVideo: Bool = false) {
         isActive = true
         isMainTweetVideoVisible = false
+        setNeedsVisibilityUpdate()
         print("📹 [CommentsVideoCoordinator] Activated")
     }
 
@@ -91,12 +106,12 @@ class CommentsVideoPlaybackCoordinator: ObservableObject {
         // This avoids any potential interference with feed videos when returning to the tweet list
         currentlyPlayingVideoId = nil
         currentlyPlayingVideoInfo = nil
-        visibleCommentVideos.removeAll()
+        registeredVideos.removeAll()
+        visibilityEngine.removeAll()
         allVideos.removeAll()
         currentOuterTweetId = nil
         isMainTweetVideoVisible = false
-        visibilityDebounceTimer?.invalidate()
-        visibilityDebounceTimer = nil
+        stopObservingDisplayLink()
         print("📹 [CommentsVideoCoordinator] Deactivated")
     }
 
@@ -135,23 +150,30 @@ class CommentsVideoPlaybackCoordinator: ObservableObject {
         print("📹 [CommentsVideoCoordinator] Foreground visibility refresh: \(reason)")
         currentlyPlayingVideoId = nil
         currentlyPlayingVideoInfo = nil
-        processVisibilityUpdate()
+        visibilityEngine.resetCurrent()
+        processVisibilityUpdate(now: CACurrentMediaTime())
     }
 
-    /// Report that a comment video has become visible
+    /// Report the scroll view's visible rect, in the content coordinate space videos report in
+    func updateViewport(_ visibleRect: CGRect) {
+        guard viewport != visibleRect else { return }
+        // Kept while inactive too: the scroll view may report before activate()
+        viewport = visibleRect
+        setNeedsVisibilityUpdate()
+    }
+
+    /// Report where a comment video sits in the scroll content
     /// - Parameters:
     ///   - commentId: The comment's ID
     ///   - videoMid: The video attachment's mid
     ///   - attachmentIndex: Index of the video attachment
-    ///   - visibilityRatio: How much of the video is visible (0.0 - 1.0)
-    ///   - yPosition: The Y position of the video in the scroll coordinate space
-    func reportVideoVisible(
+    ///   - frame: The video's frame in the scroll content coordinate space
+    func reportVideoFrame(
         commentId: String,
         outerTweetId: String? = nil,
         videoMid: String,
         attachmentIndex: Int,
-        visibilityRatio: CGFloat,
-        yPosition: CGFloat
+        frame: CGRect
     ) {
         guard isActive else { return }
 
@@ -161,19 +183,13 @@ class CommentsVideoPlaybackCoordinator: ObservableObject {
             videoMid: videoMid,
             attachmentIndex: attachmentIndex
         )
-
-        visibleCommentVideos[commentId] = (info: info, ratio: visibilityRatio, yPosition: yPosition)
-
-        scheduleVisibilityUpdate()
+        registerVideo(key: commentId, info: info, frame: frame)
     }
 
-    /// Report that a comment video is no longer visible
+    /// Report that a comment video left the view hierarchy
     func reportVideoNotVisible(commentId: String) {
         guard isActive else { return }
-
-        visibleCommentVideos.removeValue(forKey: commentId)
-
-        scheduleVisibilityUpdate()
+        unregisterVideo(key: commentId)
     }
 
     /// Report the visibility of the main tweet's video attachment
@@ -188,22 +204,21 @@ class CommentsVideoPlaybackCoordinator: ObservableObject {
 
         if wasVisible && !isVisible {
             print("📹 [CommentsVideoCoordinator] Main tweet video scrolled out - enabling comment autoplay")
-            scheduleVisibilityUpdate()
+            setNeedsVisibilityUpdate()
         } else if !wasVisible && isVisible {
             print("📹 [CommentsVideoCoordinator] Main tweet video visible - pausing comment videos")
             stopCurrentVideo()
         }
     }
 
-    /// Report that a main tweet attachment video became visible (unified tracking)
-    func reportAttachmentVideoVisible(
+    /// Report where a main tweet attachment video sits in the scroll content (unified tracking)
+    func reportAttachmentVideoFrame(
         attachmentIndex: Int,
         videoMid: String,
-        visibilityRatio: CGFloat,
-        yPosition: CGFloat
+        frame: CGRect
     ) {
         guard isActive else { return }
-        // Synthetic comment id keeps main attachment videos in the same visibility map
+        // Synthetic comment id keeps main attachment videos in the same engine
         // as comment videos while the outer tweet id remains part of the identifier.
         let syntheticId = "att\(attachmentIndex)"
         let info = CommentVideoInfo(
@@ -212,60 +227,84 @@ class CommentsVideoPlaybackCoordinator: ObservableObject {
             videoMid: videoMid,
             attachmentIndex: attachmentIndex
         )
-        visibleCommentVideos[syntheticId] = (info: info, ratio: visibilityRatio, yPosition: yPosition)
-        scheduleVisibilityUpdate()
+        registerVideo(key: syntheticId, info: info, frame: frame)
     }
 
-    /// Report that a main tweet attachment video is no longer visible
+    /// Report that a main tweet attachment video left the view hierarchy
     func reportAttachmentVideoNotVisible(attachmentIndex: Int) {
         guard isActive else { return }
-        visibleCommentVideos.removeValue(forKey: "att\(attachmentIndex)")
-        scheduleVisibilityUpdate()
+        unregisterVideo(key: "att\(attachmentIndex)")
     }
 
     // MARK: - Private Methods
 
-    private func scheduleVisibilityUpdate() {
-        visibilityDebounceTimer?.invalidate()
-        visibilityDebounceTimer = Timer.scheduledTimer(withTimeInterval: debounceInterval, repeats: false) { [weak self] _ in
-            Task { @MainActor [weak self] in
-                self?.processVisibilityUpdate()
-            }
+    private func registerVideo(key: String, info: CommentVideoInfo, frame: CGRect) {
+        let infoChanged = registeredVideos[key] != info
+        if infoChanged {
+            // Same slot, different video (cell reuse): never let the old decision carry over
+            visibilityEngine.remove(id: key)
+            registeredVideos[key] = info
+        }
+        let frameChanged = visibilityEngine.update(
+            id: key,
+            frame: VideoVisibilityEngine.Frame(minY: Double(frame.minY), maxY: Double(frame.maxY))
+        )
+        if infoChanged || frameChanged {
+            setNeedsVisibilityUpdate()
         }
     }
 
-    private func processVisibilityUpdate() {
-        guard isActive else { return }
+    private func unregisterVideo(key: String) {
+        guard registeredVideos.removeValue(forKey: key) != nil else { return }
+        visibilityEngine.remove(id: key)
+        setNeedsVisibilityUpdate()
+    }
 
-        if let currentInfo = currentlyPlayingVideoInfo,
-           let currentEntry = visibleCommentVideos[currentInfo.commentId],
-           currentEntry.info == currentInfo,
-           currentEntry.ratio >= continueVisibilityRatio {
-            return
+    /// Run a decision on the next display link frame
+    private func setNeedsVisibilityUpdate() {
+        guard isActive, !isObservingDisplayLink else { return }
+        isObservingDisplayLink = true
+        SharedDisplayLinkManager.shared.addObserver(id: displayLinkObserverID) { [weak self] link in
+            self?.displayLinkTick(now: link.timestamp)
         }
+    }
 
-        // Find the topmost stable video. Attachment videos and comment videos compete
-        // on equal footing, but a new video must be more visible than a continuing one.
-        let eligibleVideos = visibleCommentVideos.values
-            .filter { $0.ratio >= startVisibilityRatio }
-            .sorted { $0.yPosition < $1.yPosition } // Sort by Y position (topmost first)
+    private func stopObservingDisplayLink() {
+        guard isObservingDisplayLink else { return }
+        isObservingDisplayLink = false
+        SharedDisplayLinkManager.shared.removeObserver(id: displayLinkObserverID)
+    }
 
-        guard let topVideo = eligibleVideos.first else {
+    private func displayLinkTick(now: CFTimeInterval) {
+        processVisibilityUpdate(now: now)
+        // Keep ticking only while a switch waits out the hysteresis delay
+        if !visibilityEngine.hasPendingSwitch {
+            stopObservingDisplayLink()
+        }
+    }
+
+    private func processVisibilityUpdate(now: CFTimeInterval) {
+        guard isActive, let viewport else { return }
+
+        let chosenKey = visibilityEngine.decide(
+            viewportMinY: Double(viewport.minY),
+            viewportMaxY: Double(viewport.maxY),
+            now: now
+        )
+        guard let chosenKey, let chosen = registeredVideos[chosenKey] else {
             // No eligible videos visible - stop current playback
             stopCurrentVideo()
             return
         }
 
-        let videoId = topVideo.info.identifier
-
         // If the same video is already playing, do nothing
-        if currentlyPlayingVideoId == videoId {
+        if currentlyPlayingVideoId == chosen.identifier {
             return
         }
 
         // Stop current video and start the new one
         stopCurrentVideo()
-        startVideo(topVideo.info)
+        startVideo(chosen)
     }
 
     private func startVideo(_ videoInfo: CommentVideoInfo) {
@@ -312,7 +351,7 @@ class CommentsVideoPlaybackCoordinator: ObservableObject {
 
 // MARK: - View Modifier for Comment Video Visibility Tracking
 
-/// A view modifier that tracks video visibility within a comment
+/// A view modifier that reports the frame of a video within a comment
 @available(iOS 16.0, *)
 struct CommentVideoVisibilityTracker: ViewModifier {
     let commentId: String
@@ -320,9 +359,7 @@ struct CommentVideoVisibilityTracker: ViewModifier {
     let videoMid: String
     let attachmentIndex: Int
     let coordinator: CommentsVideoPlaybackCoordinator
-    let scrollCoordinateSpace: String
-
-    @State private var isInViewport = false
+    let contentCoordinateSpace: String
 
     func body(content: Content) -> some View {
         content
@@ -332,7 +369,7 @@ struct CommentVideoVisibilityTracker: ViewModifier {
                         .onAppear {
                             updateVisibility(geometry: geometry)
                         }
-                        .onChange(of: geometry.frame(in: .named(scrollCoordinateSpace))) { _, _ in
+                        .onChange(of: geometry.frame(in: .named(contentCoordinateSpace))) { _, _ in
                             updateVisibility(geometry: geometry)
                         }
                 }
@@ -343,29 +380,13 @@ struct CommentVideoVisibilityTracker: ViewModifier {
     }
 
     private func updateVisibility(geometry: GeometryProxy) {
-        let frame = geometry.frame(in: .named(scrollCoordinateSpace))
-        let screenBounds = UIScreen.main.bounds
-
-        // Calculate how much of the video is visible
-        let visibleTop = max(frame.minY, 0)
-        let visibleBottom = min(frame.maxY, screenBounds.height)
-        let visibleHeight = max(0, visibleBottom - visibleTop)
-        let totalHeight = frame.height
-
-        let visibilityRatio = totalHeight > 0 ? visibleHeight / totalHeight : 0
-
-        if visibilityRatio > 0 {
-            coordinator.reportVideoVisible(
-                commentId: commentId,
-                outerTweetId: outerTweetId,
-                videoMid: videoMid,
-                attachmentIndex: attachmentIndex,
-                visibilityRatio: visibilityRatio,
-                yPosition: frame.minY
-            )
-        } else {
-            coordinator.reportVideoNotVisible(commentId: commentId)
-        }
+        coordinator.reportVideoFrame(
+            commentId: commentId,
+            outerTweetId: outerTweetId,
+            videoMid: videoMid,
+            attachmentIndex: attachmentIndex,
+            frame: geometry.frame(in: .named(contentCoordinateSpace))
+        )
     }
 }
 
@@ -378,7 +399,7 @@ extension View {
         videoMid: String,
         attachmentIndex: Int,
         coordinator: CommentsVideoPlaybackCoordinator,
-        scrollCoordinateSpace: String
+        contentCoordinateSpace: String
     ) -> some View {
         self.modifier(CommentVideoVisibilityTracker(
             commentId: commentId,
@@ -386,7 +407,7 @@ extension View {
             videoMid: videoMid,
             attachmentIndex: attachmentIndex,
             coordinator: coordinator,
-            scrollCoordinateSpace: scrollCoordinateSpace
+            contentCoordinateSpace: contentCoordinateSpace
         ))
     }
 
@@ -395,26 +416,26 @@ extension View {
         attachmentIndex: Int,
         videoMid: String,
         coordinator: CommentsVideoPlaybackCoordinator,
-        scrollCoordinateSpace: String
+        contentCoordinateSpace: String
     ) -> some View {
         self.modifier(AttachmentVideoVisibilityTracker(
             attachmentIndex: attachmentIndex,
             videoMid: videoMid,
             coordinator: coordinator,
-            scrollCoordinateSpace: scrollCoordinateSpace
+            contentCoordinateSpace: contentCoordinateSpace
         ))
     }
 }
 
 // MARK: - View Modifier for Attachment Video Visibility Tracking
 
-/// Tracks visibility of a main tweet attachment video in TweetDetailView's scroll space
+/// Reports the frame of a main tweet attachment video in TweetDetailView's scroll content
 @available(iOS 16.0, *)
 struct AttachmentVideoVisibilityTracker: ViewModifier {
     let attachmentIndex: Int
     let videoMid: String
     let coordinator: CommentsVideoPlaybackCoordinator
-    let scrollCoordinateSpace: String
+    let contentCoordinateSpace: String
 
     func body(content: Content) -> some View {
         content
@@ -424,7 +445,7 @@ struct AttachmentVideoVisibilityTracker: ViewModifier {
                         .onAppear {
                             updateVisibility(geometry: geometry)
                         }
-                        .onChange(of: geometry.frame(in: .named(scrollCoordinateSpace))) { _, _ in
+                        .onChange(of: geometry.frame(in: .named(contentCoordinateSpace))) { _, _ in
                             updateVisibility(geometry: geometry)
                         }
                 }
@@ -436,22 +457,10 @@ struct AttachmentVideoVisibilityTracker: ViewModifier {
     }
 
     private func updateVisibility(geometry: GeometryProxy) {
-        let frame = geometry.frame(in: .named(scrollCoordinateSpace))
-        let screenHeight = UIScreen.main.bounds.height
-        let visibleTop = max(frame.minY, 0)
-        let visibleBottom = min(frame.maxY, screenHeight)
-        let visibleHeight = max(0, visibleBottom - visibleTop)
-        let ratio = frame.height > 0 ? visibleHeight / frame.height : 0
-
-        if ratio > 0 {
-            coordinator.reportAttachmentVideoVisible(
-                attachmentIndex: attachmentIndex,
-                videoMid: videoMid,
-                visibilityRatio: ratio,
-                yPosition: frame.minY
-            )
-        } else {
-            coordinator.reportAttachmentVideoNotVisible(attachmentIndex: attachmentIndex)
-        }
+        coordinator.reportAttachmentVideoFrame(
+            attachmentIndex: attachmentIndex,
+            videoMid: videoMid,
+            frame: geometry.frame(in: .named(contentCoordinateSpace))
+        )
     }
 }
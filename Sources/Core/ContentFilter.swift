@@ -0,0 +1,373 @@
+//
+//  ContentFilter.swift
+//  Tweet
+//
+//  Client-side filtering of feed content: muted keywords, muted authors and
+//  built-in category lexicons, applied by the feed, search and profile lists.
+//
+
+import Foundation
+
+/// Decides whether a tweet is hidden from feeds.
+///
+/// Rules are persisted in UserDefaults. All keywords (the user's plus the lexicons of the
+/// enabled categories) are compiled into one `KeywordMatcher` per rule-set version, so a tweet
+/// is scanned once however many keywords there are. Verdicts are cached per tweet id for the
+/// current version; any rule change bumps the version and drops them.
+///
+/// Lists apply it themselves, with their `ListScope`; bookmarks and favorites don't apply it.
+/// The app user's own tweets are never hidden, and a muted author's own profile still
+/// shows their tweets.
+final class ContentFilter: @unchecked Sendable {
+    static let shared = ContentFilter()
+
+    enum Category: String, Codable, CaseIterable {
+        case profanity
+        case violence
+        case adult
+    }
+
+    struct Rules: Codable, Equatable {
+        var keywords: [String] = []
+        var mutedAuthorIds: Set<MimeiId> = []
+        var categories: Set<Category> = []
+        /// Bumped on every change; cached verdicts belong to one version
+        var version = 0
+
+        var isEmpty: Bool {
+            keywords.isEmpty && mutedAuthorIds.isEmpty && categories.isEmpty
+        }
+    }
+
+    /// The list a tweet is about to be shown in
+    enum ListScope: Equatable {
+        /// Home feed, search results
+        case feed
+        /// A user's tweets; muting that user doesn't empty their own profile
+        case profile(MimeiId)
+
+        var ownerId: MimeiId? {
+            if case .profile(let id) = self { return id }
+            return nil
+        }
+    }
+
+    /// Why a tweet is hidden; author mutes depend on the list, so they are kept apart
+    private enum Verdict {
+        case visible
+        case matched
+        case mutedAuthor(MimeiId)
+    }
+
+    private var rules: Rules
+    private var matcher: KeywordMatcher?
+    private var verdicts: [MimeiId: Verdict] = [:]
+    private var verdictsVersion = -1
+    private let lock = NSLock()
+    private let maxCachedVerdicts = 20_000
+
+    private static let storageKey = "ContentFilter.rules"
+
+    private init() {
+        if let data = UserDefaults.standard.data(forKey: Self.storageKey),
+           let stored = try? JSONDecoder().decode(Rules.self, from: data) {
+            rules = stored
+        } else {
+            rules = Rules()
+        }
+    }
+
+    // MARK: - Public Methods
+
+    var currentRules: Rules {
+        lock.withLock { rules }
+    }
+
+    /// Change the rules, persist them and tell the feeds to drop what is now hidden.
+    func update(_ change: (inout Rules) -> Void) {
+        let updated: Rules? = lock.withLock {
+            var candidate = rules
+            change(&candidate)
+            candidate.keywords = Self.normalizedKeywords(candidate.keywords)
+            candidate.version = rules.version
+            guard candidate != rules else { return nil }
+            candidate.version += 1
+            rules = candidate
+            matcher = nil
+            verdicts.removeAll()
+            return candidate
+        }
+        guard let updated else { return }
+
+        if let data = try? JSONEncoder().encode(updated) {
+            UserDefaults.standard.set(data, forKey: Self.storageKey)
+        }
+        print("DEBUG: [ContentFilter] Rules v\(updated.version): \(updated.keywords.count) keywords, \(updated.mutedAuthorIds.count) authors, categories \(updated.categories.map(\.rawValue).sorted())")
+        DispatchQueue.main.async {
+            NotificationCenter.default.post(name: .contentFilterChanged, object: nil)
+        }
+    }
+
+    /// True when `tweet` (or the tweet it retweets) matches a rule that applies in `scope`.
+    func shouldHide(_ tweet: Tweet, in scope: ListScope = .feed) -> Bool {
+        switch verdict(for: tweet) {
+        case .visible:
+            return false
+        case .matched:
+            return true
+        case .mutedAuthor(let authorId):
+            return authorId != scope.ownerId
+        }
+    }
+
+    func filter(_ tweets: [Tweet], in scope: ListScope = .feed) -> [Tweet] {
+        guard !lock.withLock({ rules.isEmpty }) else { return tweets }
+        return tweets.filter { !shouldHide($0, in: scope) }
+    }
+
+    /// Hidden tweets become nil, so a page keeps its length for pagination.
+    func masked(_ tweets: [Tweet?], in scope: ListScope = .feed) -> [Tweet?] {
+        guard !lock.withLock({ rules.isEmpty }) else { return tweets }
+        return tweets.map { tweet in
+            guard let tweet, !shouldHide(tweet, in: scope) else { return nil }
+            return tweet
+        }
+    }
+
+    // MARK: - Private
+
+    private func verdict(for tweet: Tweet) -> Verdict {
+        let state: (rules: Rules, matcher: KeywordMatcher?, cached: Verdict?)? = lock.withLock {
+            guard !rules.isEmpty else { return nil }
+            if verdictsVersion != rules.version {
+                verdicts.removeAll()
+                verdictsVersion = rules.version
+            }
+            if let cached = verdicts[tweet.mid] {
+                return (rules, nil, cached)
+            }
+            return (rules, compiledMatcherLocked(), nil)
+        }
+        guard let state else { return .visible }
+        if let cached = state.cached {
+            return cached
+        }
+
+        let result = evaluate(tweet, rules: state.rules, matcher: state.matcher)
+        lock.withLock {
+            guard verdictsVersion == state.rules.version else { return }
+            if verdicts.count >= maxCachedVerdicts {
+                verdicts.removeAll(keepingCapacity: true)
+            }
+            verdicts[tweet.mid] = result
+        }
+        return result
+    }
+
+    /// Keywords first, so a keyword hit isn't excused by the profile-owner exemption.
+    private func evaluate(_ tweet: Tweet, rules: Rules, matcher: KeywordMatcher?) -> Verdict {
+        let appUserId = HproseInstance.shared.appUser.mid
+        if tweet.authorId == appUserId {
+            return .visible
+        }
+        // A retweet's own text is usually empty; judge it by the original as well
+        var original: Tweet?
+        if let originalId = tweet.originalTweetId, originalId != tweet.mid,
+           let candidate = Tweet.getInstance(for: originalId), candidate.authorId != appUserId {
+            original = candidate
+        }
+        if let matcher {
+            if matcher.matches(in: tweet.title) || matcher.matches(in: tweet.content) {
+                return .matched
+            }
+            if let original, matcher.matches(in: original.title) || matcher.matches(in: original.content) {
+                return .matched
+            }
+        }
+        if rules.mutedAuthorIds.contains(tweet.authorId) {
+            return .mutedAuthor(tweet.authorId)
+        }
+        if let original, rules.mutedAuthorIds.contains(original.authorId) {
+            return .mutedAuthor(original.authorId)
+        }
+        return .visible
+    }
+
+    private func compiledMatcherLocked() -> KeywordMatcher? {
+        if let matcher {
+            return matcher
+        }
+        let patterns = rules.keywords + rules.categories.sorted { $0.rawValue < $1.rawValue }.flatMap { Self.lexicon(for: $0) }
+        guard !patterns.isEmpty else { return nil }
+        let compiled = KeywordMatcher(patterns: patterns)
+        matcher = compiled
+        print("DEBUG: [ContentFilter] Compiled \(patterns.count) patterns for rules v\(rules.version)")
+        return compiled
+    }
+
+    private static func normalizedKeywords(_ keywords: [String]) -> [String] {
+        var seen = Set<String>()
+        return keywords
+            .map { $0.trimmingCharacters(in: .whitespacesAndNewlines) }
+            .filter { !$0.isEmpty && seen.insert(KeywordMatcher.fold($0)).inserted }
+    }
+
+    /// Small built-in lexicons; users add anything else as keywords.
+    private static func lexicon(for category: Category) -> [String] {
+        switch category {
+        case .profanity:
+            return ["fuck", "fucking", "motherfucker", "shit", "bullshit", "bitch", "asshole", "bastard", "cunt",
+                    "他妈的", "傻逼", "操你", "混蛋", "王八蛋"]
+        case .violence:
+            return ["kill you", "murder", "behead", "massacre", "shoot up", "bomb threat", "stab you",
+                    "杀了你", "砍死", "屠杀", "炸死"]
+        case .adult:
+            return ["porn", "nsfw", "nude", "nudes", "xxx", "onlyfans", "hentai",
+                    "色情", "裸照", "约炮", "黄片"]
+        }
+    }
+}
+
+/// Aho-Corasick automaton over folded Unicode scalars.
+///
+/// Patterns and text are folded the same way (case, diacritics, full/half width). Patterns
+/// that start or end with a letter or digit of a spaced script only match at word boundaries,
+/// so "ass" doesn't hit "class"; CJK, kana and Hangul have no spaces and match as substrings.
+struct KeywordMatcher {
+    private struct Pattern {
+        let length: Int
+        let leadingBoundary: Bool
+        let trailingBoundary: Bool
+    }
+
+    /// Per state: outgoing edges by scalar value
+    private var transitions: [[UInt32: Int32]] = [[:]]
+    private var failure: [Int32] = [0]
+    /// Patterns ending at each state
+    private var outputs: [[Int32]] = [[]]
+    /// Nearest state along the failure chain that has outputs, or -1
+    private var outputLink: [Int32] = [-1]
+    private var patterns: [Pattern] = []
+
+    init(patterns rawPatterns: [String]) {
+        for raw in rawPatterns {
+            let scalars = Array(Self.fold(raw).unicodeScalars)
+            guard !scalars.isEmpty else { continue }
+            var state = 0
+            for scalar in scalars {
+                if let next = transitions[state][scalar.value] {
+                    state = Int(next)
+                } else {
+                    transitions.append([:])
+                    failure.append(0)
+                    outputs.append([])
+                    outputLink.append(-1)
+                    let next = transitions.count - 1
+                    transitions[state][scalar.value] = Int32(next)
+                    state = next
+                }
+            }
+            outputs[state].append(Int32(patterns.count))
+            patterns.append(Pattern(
+                length: scalars.count,
+                leadingBoundary: Self.isWordScalar(scalars[0]) && !Self.isUnspacedScalar(scalars[0]),
+                trailingBoundary: Self.isWordScalar(scalars[scalars.count - 1]) && !Self.isUnspacedScalar(scalars[scalars.count - 1])
+            ))
+        }
+        buildFailureLinks()
+    }
+
+    var patternCount: Int { patterns.count }
+
+    /// True when any pattern occurs in `text` (respecting word boundaries).
+    func matches(in text: String?) -> Bool {
+        guard let text, !text.isEmpty, !patterns.isEmpty else { return false }
+        let scalars = Array(Self.fold(text).unicodeScalars)
+        var state: Int32 = 0
+        for (index, scalar) in scalars.enumerated() {
+            state = step(from: state, scalar.value)
+            var hit = outputs[Int(state)].isEmpty ? outputLink[Int(state)] : state
+            while hit >= 0 {
+                for patternIndex in outputs[Int(hit)] where accepts(patterns[Int(patternIndex)], endingAt: index, in: scalars) {
+                    return true
+                }
+                hit = outputLink[Int(hit)]
+            }
+        }
+        return false
+    }
+
+    /// The folding applied to both patterns and text.
+    static func fold(_ string: String) -> String {
+        string.folding(options: [.caseInsensitive, .diacriticInsensitive, .widthInsensitive], locale: nil)
+    }
+
+    // MARK: - Private
+
+    private func step(from state: Int32, _ value: UInt32) -> Int32 {
+        var current = state
+        while true {
+            if let next = transitions[Int(current)][value] {
+                return next
+            }
+            if current == 0 {
+                return 0
+            }
+            current = failure[Int(current)]
+        }
+    }
+
+    private func accepts(_ pattern: Pattern, endingAt end: Int, in scalars: [Unicode.Scalar]) -> Bool {
+        let start = end - pattern.length + 1
+        if pattern.leadingBoundary, start > 0, Self.continuesWord(scalars[start - 1]) {
+            return false
+        }
+        if pattern.trailingBoundary, end + 1 < scalars.count, Self.continuesWord(scalars[end + 1]) {
+            return false
+        }
+        return true
+    }
+
+    /// A neighbour that makes a Latin-style match part of a longer word; "porn色情" still matches "porn"
+    private static func continuesWord(_ scalar: Unicode.Scalar) -> Bool {
+        isWordScalar(scalar) && !isUnspacedScalar(scalar)
+    }
+
+    /// Breadth-first, so every failure target is finished before it is used.
+    private mutating func buildFailureLinks() {
+        var queue: [Int32] = Array(transitions[0].values)
+        var head = 0
+        while head < queue.count {
+            let state = queue[head]
+            head += 1
+            for (value, child) in transitions[Int(state)] {
+                let fallback = state == 0 ? 0 : step(from: failure[Int(state)], value)
+                failure[Int(child)] = fallback == child ? 0 : fallback
+                let target = failure[Int(child)]
+                outputLink[Int(child)] = outputs[Int(target)].isEmpty ? outputLink[Int(target)] : target
+                queue.append(child)
+            }
+        }
+    }
+
+    private static let wordCharacters = CharacterSet.alphanumerics
+
+    private static func isWordScalar(_ scalar: Unicode.Scalar) -> Bool {
+        wordCharacters.contains(scalar)
+    }
+
+    /// Scripts written without spaces between words
+    private static func isUnspacedScalar(_ scalar: Unicode.Scalar) -> Bool {
+        switch scalar.value {
+        case 0x3040...0x30FF,   // Hiragana, Katakana
+             0x3400...0x4DBF,   // CJK Extension A
+             0x4E00...0x9FFF,   // CJK Unified Ideographs
+             0xAC00...0xD7AF,   // Hangul syllables
+             0xF900...0xFAFF,   // CJK Compatibility Ideographs
+             0x20000...0x2FA1F: // CJK Extensions B+
+            return true
+        default:
+            return false
+        }
+    }
+}
@@ -1,11 +1,36 @@
 import CoreData
 import Foundation
 
+/// Core Data stack shared by the tweet, user and chat caches.
+///
+/// - `context` (viewContext, main queue) is for UI reads; it merges writer saves automatically.
+/// - `writerContext` (private queue) takes cache ingest and cleanup so they never run on the main queue.
+/// - Batch deletes bypass contexts; their changes reach viewContext through persistent history.
 class CoreDataManager {
     static let shared = CoreDataManager()
     
     let container: NSPersistentContainer
     
+    /// Serial private-queue context for all cache writes
+    private(set) lazy var writerContext: NSManagedObjectContext = {
+        let context = container.newBackgroundContext()
+        context.name = "writer"
+        context.transactionAuthor = Self.writerAuthor
+        context.mergePolicy = NSMergeByPropertyObjectTrumpMergePolicy
+        context.undoManager = nil
+        return context
+    }()
+    
+    private static let viewAuthor = "app.view"
+    private static let writerAuthor = "app.writer"
+    private static let batchAuthor = "app.batch"
+    
+    /// Persistent history is only needed until viewContext has merged it
+    private let historyRetention: TimeInterval = 24 * 60 * 60
+    private var lastHistoryToken: NSPersistentHistoryToken?
+    private var lastHistoryPurge = Date.distantPast
+    private let historyQueue = DispatchQueue(label: "com.zz.coredata.history", qos: .utility)
+    
     private init() {
         print("[CoreDataManager] Initializing CoreDataManager")
         container = NSPersistentContainer(name: "TweetModel")
@@ -20,6 +45,8 @@ class CoreDataManager {
         description.url = storeURL
         description.shouldMigrateStoreAutomatically = true
         description.shouldInferMappingModelAutomatically = true
+        description.setOption(true as NSNumber, forKey: NSPersistentHistoryTrackingKey)
+        description.setOption(true as NSNumber, forKey: NSPersistentStoreRemoteChangeNotificationPostOptionKey)
         container.persistentStoreDescriptions = [description]
         
         print("[CoreDataManager] Core Data store URL: \(description.url?.absoluteString ?? "nil")")
@@ -36,15 +63,146 @@ class CoreDataManager {
                 print("[CoreDataManager] Core Data loaded successfully")
             }
         }
+        
+        let viewContext = container.viewContext
+        viewContext.name = "view"
+        viewContext.transactionAuthor = Self.viewAuthor
+        viewContext.automaticallyMergesChangesFromParent = true
+        viewContext.mergePolicy = NSMergeByPropertyObjectTrumpMergePolicy
+        
+        lastHistoryToken = container.persistentStoreCoordinator.currentPersistentHistoryToken(
+            fromStores: container.persistentStoreCoordinator.persistentStores
+        )
+        NotificationCenter.default.addObserver(
+            forName: .NSPersistentStoreRemoteChange,
+            object: container.persistentStoreCoordinator,
+            queue: nil
+        ) { [weak self] _ in
+            self?.historyQueue.async {
+                self?.mergePersistentHistory()
+            }
+        }
+    }
+    
+    // MARK: - Writes
+    
+    /// Run `block` on the writer queue and save if it left changes. Returns immediately.
+    func performWrite(_ block: @escaping (NSManagedObjectContext) -> Void) {
+        let context = writerContext
+        context.perform {
+            block(context)
+            self.saveIfNeeded(context)
+        }
+    }
+    
+    /// Run `block` on the writer queue and wait for it (and its save) to finish.
+    /// Blocks the caller, but not the main queue's run loop work unless called from main.
+    @discardableResult
+    func performWriteAndWait<T>(_ block: (NSManagedObjectContext) -> T) -> T {
+        let context = writerContext
+        return context.performAndWait {
+            let result = block(context)
+            saveIfNeeded(context)
+            return result
+        }
+    }
+    
+    /// Delete every row matching `request` in the store without loading objects.
+    /// Call from inside a writer block. Returns the number of deleted rows.
+    @discardableResult
+    func batchDelete(_ request: NSFetchRequest<NSFetchRequestResult>, in context: NSManagedObjectContext) -> Int {
+        let deleteRequest = NSBatchDeleteRequest(fetchRequest: request)
+        return executeBatchDelete(deleteRequest, in: context)
+    }
+    
+    /// Delete the given objects in the store without loading them. Call from inside a writer block.
+    @discardableResult
+    func batchDelete(objectIDs: [NSManagedObjectID], in context: NSManagedObjectContext) -> Int {
+        guard !objectIDs.isEmpty else { return 0 }
+        return executeBatchDelete(NSBatchDeleteRequest(objectIDs: objectIDs), in: context)
+    }
+    
+    private func executeBatchDelete(_ deleteRequest: NSBatchDeleteRequest, in context: NSManagedObjectContext) -> Int {
+        deleteRequest.resultType = .resultTypeObjectIDs
+        let previousAuthor = context.transactionAuthor
+        context.transactionAuthor = Self.batchAuthor
+        defer { context.transactionAuthor = previousAuthor }
+        do {
+            let result = try context.execute(deleteRequest) as? NSBatchDeleteResult
+            let deletedIDs = result?.result as? [NSManagedObjectID] ?? []
+            // The writer itself isn't a history consumer; drop any registered copies right away
+            if !deletedIDs.isEmpty {
+                NSManagedObjectContext.mergeChanges(
+                    fromRemoteContextSave: [NSDeletedObjectsKey: deletedIDs],
+                    into: [context]
+                )
+            }
+            return deletedIDs.count
+        } catch {
+            print("[CoreDataManager] Batch delete failed: \(error)")
+            return 0
+        }
+    }
+    
+    private func saveIfNeeded(_ context: NSManagedObjectContext) {
+        guard context.hasChanges else { return }
+        do {
+            try context.save()
+        } catch {
+            print("[CoreDataManager] \(context.name ?? "context") save failed: \(error)")
+            context.rollback()
+        }
+    }
+    
+    // MARK: - Persistent History
+    
+    /// Merge store changes that didn't come from a context save (batch requests) into viewContext,
+    /// then purge history older than `historyRetention`. Runs on `historyQueue`.
+    private func mergePersistentHistory() {
+        let context = container.newBackgroundContext()
+        context.performAndWait {
+            let request = NSPersistentHistoryChangeRequest.fetchHistory(after: lastHistoryToken)
+            guard let result = try? context.execute(request) as? NSPersistentHistoryResult,
+                  let transactions = result.result as? [NSPersistentHistoryTransaction],
+                  let lastToken = transactions.last?.token else {
+                return
+            }
+            lastHistoryToken = lastToken
+            
+            // viewContext and writer saves are already merged by automaticallyMergesChangesFromParent
+            let unmerged = transactions.filter { $0.author != Self.viewAuthor && $0.author != Self.writerAuthor }
+            if !unmerged.isEmpty {
+                let viewContext = container.viewContext
+                viewContext.perform {
+                    for transaction in unmerged {
+                        viewContext.mergeChanges(fromContextDidSave: transaction.objectIDNotification())
+                    }
+                }
+            }
+            
+            if Date().timeIntervalSince(lastHistoryPurge) > historyRetention / 4 {
+                lastHistoryPurge = Date()
+                let purge = NSPersistentHistoryChangeRequest.deleteHistory(before: Date().addingTimeInterval(-historyRetention))
+                _ = try? context.execute(purge)
+            }
+        }
     }
     
+    /// Recreate the store with the same description as the initial load, so history tracking
+    /// and remote-change notifications (which keep writer and viewContext merged) survive.
     private func recoverFromError() throws {
-        guard let storeURL = container.persistentStoreDescriptions.first?.url else {
+        guard let description = container.persistentStoreDescriptions.first,
+              let storeURL = description.url else {
             throw NSError(domain: "CoreDataManager", code: -1, userInfo: [NSLocalizedDescriptionKey: "No store URL found"])
         }
         
-        try container.persistentStoreCoordinator.destroyPersistentStore(at: storeURL, ofType: NSSQLiteStoreType, options: nil)
-        try container.persistentStoreCoordinator.addPersistentStore(ofType: NSSQLiteStoreType, configurationName: nil, at: storeURL, options: nil)
+        try container.persistentStoreCoordinator.destroyPersistentStore(at: storeURL, ofType: NSSQLiteStoreType, options: description.options)
+        try container.persistentStoreCoordinator.addPersistentStore(
+            ofType: description.type,
+            configurationName: description.configuration,
+            at: storeURL,
+            options: description.options
+        )
     }
     
     var context: NSManagedObjectContext { container.viewContext }
@@ -0,0 +1,338 @@
+import Foundation
+
+/// On-disk cache for document attachments (PDF, Office, ZIP...), keyed by MimeiId.
+///
+/// Blobs live next to the video caches in `Caches/<mid>/` so `DiskCacheCleanupManager`
+/// retention and privacy rules apply to them too:
+///   - `document.blob`: complete content, served instantly on re-open
+///   - `document.part`: partial download; the next attempt resumes it with a Range request
+///
+/// Downloads stream straight to disk, concurrent requests for the same mid share one
+/// transfer, and dropped connections resume from the bytes already on disk.
+final class DocumentBlobCache: @unchecked Sendable {
+    static let shared = DocumentBlobCache()
+
+    private let maxAttemptsWithoutProgress = 4
+    private let inFlight = InFlightBlobDownloads()
+
+    private init() {}
+
+    // MARK: - Public API
+
+    /// URL of the complete cached blob for `mid`, or nil if it isn't cached yet.
+    func cachedBlobURL(for mid: MimeiId) -> URL? {
+        let url = blobURL(for: mid)
+        guard let size = fileSize(at: url), size > 0 else { return nil }
+        return url
+    }
+
+    /// Return the cached blob for `mid`, downloading (or resuming) it from `url` if needed.
+    ///
+    /// Concurrent calls for the same mid join the in-flight download; every caller's
+    /// `progress` handler receives updates (0...1) on an arbitrary queue.
+    func fetch(mid: MimeiId, from url: URL, progress: ((Double) -> Void)? = nil) async throws -> URL {
+        if let cached = cachedBlobURL(for: mid) {
+            touch(cached)
+            return cached
+        }
+        return try await inFlight.join(mid: mid, progress: progress) { fanout in
+            try await self.download(mid: mid, from: url, fanout: fanout)
+        }
+    }
+
+    /// Expose the blob under a display file name (QuickLook and the share sheet pick the
+    /// viewer from the extension). Uses a hard link, so no bytes are copied.
+    func presentableURL(for blobURL: URL, fileName: String) throws -> URL {
+        let directory = blobURL.deletingLastPathComponent().appendingPathComponent("named", isDirectory: true)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        let safeName = fileName
+            .replacingOccurrences(of: "/", with: "_")
+            .replacingOccurrences(of: ":", with: "_")
+        let destination = directory.appendingPathComponent(safeName.isEmpty ? "Document" : safeName)
+
+        if let existing = fileSize(at: destination), existing == fileSize(at: blobURL) {
+            return destination
+        }
+        try? FileManager.default.removeItem(at: destination)
+        do {
+            try FileManager.default.linkItem(at: blobURL, to: destination)
+        } catch {
+            try FileManager.default.copyItem(at: blobURL, to: destination)
+        }
+        return destination
+    }
+
+    // MARK: - Download
+
+    private func download(mid: MimeiId, from url: URL, fanout: BlobProgressFanout) async throws -> URL {
+        let partURL = self.partURL(for: mid)
+        try FileManager.default.createDirectory(
+            at: partURL.deletingLastPathComponent(),
+            withIntermediateDirectories: true
+        )
+
+        var attemptsWithoutProgress = 0
+        var lastError: Error?
+        while attemptsWithoutProgress < maxAttemptsWithoutProgress {
+            try Task.checkCancellation()
+            let offset = fileSize(at: partURL) ?? 0
+            do {
+                let totalSize = try await streamAttempt(url: url, partURL: partURL, offset: offset, fanout: fanout)
+                let finalSize = fileSize(at: partURL) ?? 0
+                guard finalSize > 0, totalSize.map({ finalSize == $0 }) ?? true else {
+                    throw URLError(.cannotDecodeContentData)
+                }
+                let blob = blobURL(for: mid)
+                try? FileManager.default.removeItem(at: blob)
+                try FileManager.default.moveItem(at: partURL, to: blob)
+                fanout.report(1.0)
+                print("DEBUG: [DocumentBlobCache] Cached \(mid.prefix(8)) (\(finalSize) bytes)")
+                return blob
+            } catch is CancellationError {
+                throw CancellationError()
+            } catch {
+                lastError = error
+                let newOffset = fileSize(at: partURL) ?? 0
+                if newOffset > offset {
+                    // The connection dropped mid-transfer but we kept what arrived; resume right away.
+                    attemptsWithoutProgress = 0
+                    print("DEBUG: [DocumentBlobCache] \(mid.prefix(8)) interrupted at \(newOffset) bytes, resuming")
+                } else {
+                    attemptsWithoutProgress += 1
+                    let backoff = UInt64(500_000_000) << UInt64(attemptsWithoutProgress - 1)
+                    try await Task.sleep(nanoseconds: backoff)
+                }
+            }
+        }
+        print("ERROR: [DocumentBlobCache] Giving up on \(mid.prefix(8)): \(String(describing: lastError))")
+        throw lastError ?? URLError(.unknown)
+    }
+
+    /// One HTTP request appending to `partURL` from `offset`. Returns the total object size if known.
+    private func streamAttempt(url: URL, partURL: URL, offset: Int64, fanout: BlobProgressFanout) async throws -> Int64? {
+        var request = URLRequest(url: url)
+        request.httpMethod = "GET"
+        request.timeoutInterval = 60
+        if offset > 0 {
+            request.setValue("bytes=\(offset)-", forHTTPHeaderField: "Range")
+        }
+
+        let config = URLSessionConfiguration.default
+        config.timeoutIntervalForRequest = 60
+        config.timeoutIntervalForResource = 30 * 60
+        config.urlCache = nil
+        config.requestCachePolicy = .reloadIgnoringLocalCacheData
+
+        let delegate = try BlobStreamDelegate(partURL: partURL, requestedOffset: offset, fanout: fanout)
+        let session = URLSession(configuration: config, delegate: delegate, delegateQueue: nil)
+        defer { session.finishTasksAndInvalidate() }
+
+        let task = session.dataTask(with: request)
+        return try await withTaskCancellationHandler {
+            try await withCheckedThrowingContinuation { continuation in
+                delegate.continuation = continuation
+                task.resume()
+            }
+        } onCancel: {
+            task.cancel()
+        }
+    }
+
+    // MARK: - Paths
+
+    private func directory(for mid: MimeiId) -> URL {
+        FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+            .appendingPathComponent(mid, isDirectory: true)
+    }
+
+    private func blobURL(for mid: MimeiId) -> URL {
+        directory(for: mid).appendingPathComponent("document.blob")
+    }
+
+    private func partURL(for mid: MimeiId) -> URL {
+        directory(for: mid).appendingPathComponent("document.part")
+    }
+
+    private func fileSize(at url: URL) -> Int64? {
+        (try? FileManager.default.attributesOfItem(atPath: url.path)[.size] as? NSNumber)?.int64Value
+    }
+
+    /// Refresh the directory's modification date so retention cleanup sees the re-open.
+    private func touch(_ url: URL) {
+        try? FileManager.default.setAttributes(
+            [.modificationDate: Date()],
+            ofItemAtPath: url.deletingLastPathComponent().path
+        )
+    }
+}
+
+// MARK: - In-flight dedup
+
+/// One download task per mid; later callers attach their progress handler and await it.
+private actor InFlightBlobDownloads {
+    private var tasks: [MimeiId: (task: Task<URL, Error>, fanout: BlobProgressFanout)] = [:]
+
+    func join(
+        mid: MimeiId,
+        progress: ((Double) -> Void)?,
+        start: @escaping @Sendable (BlobProgressFanout) async throws -> URL
+    ) async throws -> URL {
+        if let existing = tasks[mid] {
+            if let progress { existing.fanout.add(progress) }
+            return try await existing.task.value
+        }
+        let fanout = BlobProgressFanout()
+        if let progress { fanout.add(progress) }
+        let task = Task { try await start(fanout) }
+        tasks[mid] = (task, fanout)
+        defer { tasks.removeValue(forKey: mid) }
+        return try await task.value
+    }
+}
+
+/// Fans download progress out to every caller waiting on the same blob.
+private final class BlobProgressFanout: @unchecked Sendable {
+    private var handlers: [(Double) -> Void] = []
+    private var lastFraction: Double = 0
+    private let lock = NSLock()
+
+    func add(_ handler: @escaping (Double) -> Void) {
+        let current = lock.withLock { () -> Double in
+            handlers.append(handler)
+            return lastFraction
+        }
+        handler(current)
+    }
+
+    func report(_ fraction: Double) {
+        let snapshot = lock.withLock { () -> [(Double) -> Void] in
+            lastFraction = fraction
+            return handlers
+        }
+        snapshot.forEach { $0(fraction) }
+    }
+}
+
+// MARK: - Streaming delegate
+
+/// Appends response bytes to the partial file as they arrive.
+/// A 206 whose start matches the partial size is appended; a 200 restarts from zero; a 416
+/// finishes a partial file that is already whole.
+private final class BlobStreamDelegate: NSObject, URLSessionDataDelegate {
+    var continuation: CheckedContinuation<Int64?, Error>?
+
+    private let partURL: URL
+    private let requestedOffset: Int64
+    private let fanout: BlobProgressFanout
+    private var handle: FileHandle?
+    private var received: Int64 = 0
+    private var baseOffset: Int64 = 0
+    private var totalSize: Int64?
+    private var lastReportedFraction: Double = 0
+
+    init(partURL: URL, requestedOffset: Int64, fanout: BlobProgressFanout) throws {
+        self.partURL = partURL
+        self.requestedOffset = requestedOffset
+        self.fanout = fanout
+        if !FileManager.default.fileExists(atPath: partURL.path) {
+            FileManager.default.createFile(atPath: partURL.path, contents: nil)
+        }
+        super.init()
+    }
+
+    func urlSession(_ session: URLSession, dataTask: URLSessionDataTask,
+                    didReceive response: URLResponse,
+                    completionHandler: @escaping (URLSession.ResponseDisposition) -> Void) {
+        guard let http = response as? HTTPURLResponse else {
+            completionHandler(.cancel)
+            return
+        }
+        do {
+            let fileHandle = try FileHandle(forWritingTo: partURL)
+            switch http.statusCode {
+            case 206 where requestedOffset > 0:
+                let contentRange = http.value(forHTTPHeaderField: "Content-Range") ?? ""
+                guard MultiSourceRangeFetcher.parseContentRangeStart(contentRange) == requestedOffset else {
+                    // Unexpected range: start over rather than corrupt the partial file.
+                    try fileHandle.truncate(atOffset: 0)
+                    try? fileHandle.close()
+                    completionHandler(.cancel)
+                    return
+                }
+                baseOffset = requestedOffset
+                totalSize = MultiSourceRangeFetcher.parseContentRangeTotal(contentRange)
+                try fileHandle.seek(toOffset: UInt64(requestedOffset))
+            case 200, 206:
+                // Node ignored Range (or this is a fresh download): rewrite from zero.
+                baseOffset = 0
+                try fileHandle.truncate(atOffset: 0)
+                totalSize = http.expectedContentLength > 0 ? http.expectedContentLength : nil
+                if http.statusCode == 206,
+                   let contentRange = http.value(forHTTPHeaderField: "Content-Range") {
+                    totalSize = MultiSourceRangeFetcher.parseContentRangeTotal(contentRange)
+                }
+            case 416 where requestedOffset > 0:
+                // Nothing past the partial file: it is complete if it matches the object's size,
+                // otherwise it is wrong and the next attempt starts from zero.
+                let total = http.value(forHTTPHeaderField: "Content-Range")
+                    .flatMap(MultiSourceRangeFetcher.parseContentRangeTotal)
+                if let total, total == requestedOffset {
+                    try? fileHandle.close()
+                    completionHandler(.cancel)
+                    finish(with: .success(total))
+                } else {
+                    try fileHandle.truncate(atOffset: 0)
+                    try? fileHandle.close()
+                    completionHandler(.cancel)
+                    finish(with: .failure(URLError(.badServerResponse)))
+                }
+                return
+            default:
+                try? fileHandle.close()
+                completionHandler(.cancel)
+                finish(with: .failure(URLError(.badServerResponse)))
+                return
+            }
+            handle = fileHandle
+            completionHandler(.allow)
+        } catch {
+            completionHandler(.cancel)
+            finish(with: .failure(error))
+        }
+    }
+
+    func urlSession(_ session: URLSession, dataTask: URLSessionDataTask, didReceive data: Data) {
+        guard let handle else { return }
+        do {
+            try handle.write(contentsOf: data)
+            received += Int64(data.count)
+        } catch {
+            dataTask.cancel()
+            return
+        }
+        if let totalSize, totalSize > 0 {
+            let fraction = Double(baseOffset + received) / Double(totalSize)
+            if fraction - lastReportedFraction >= 0.01 {
+                lastReportedFraction = fraction
+                fanout.report(min(fraction, 0.99))
+            }
+        }
+    }
+
+    func urlSession(_ session: URLSession, task: URLSessionTask, didCompleteWithError error: Error?) {
+        try? handle?.synchronize()
+        try? handle?.close()
+        handle = nil
+        if let error {
+            finish(with: .failure(error))
+        } else {
+            finish(with: .success(totalSize))
+        }
+    }
+
+    private func finish(with result: Result<Int64?, Error>) {
+        guard let continuation else { return }
+        self.continuation = nil
+        continuation.resume(with: result)
+    }
+}
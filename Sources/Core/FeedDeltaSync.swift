@@ -0,0 +1,156 @@
+import Foundation
+
+/// What a feed refresh has already delivered: the newest timestamp seen, a version token over
+/// the last page, and a fingerprint per tweet. The next refresh is diffed against it.
+///
+/// The backend has no "since" query, so page 0 is still downloaded in full; the mark lets the
+/// client skip decoding, caching and author fetches for tweets that didn't change, and hand the
+/// view model a patch instead of a page to re-merge.
+struct FeedHighWaterMark {
+    /// Milliseconds since 1970 of the newest tweet delivered so far
+    var newestTimestamp: Double = 0
+    /// Hash of the last page's (mid, fingerprint) sequence; equal tokens mean nothing changed
+    var versionToken: UInt64 = 0
+    fileprivate var entries: [MimeiId: (timestamp: Double?, fingerprint: UInt64)] = [:]
+
+    /// Entries older than the newest `maxEntries` are forgotten; they've scrolled out of page 0
+    fileprivate static let maxEntries = 200
+
+    /// Drop tweets that couldn't be delivered (decode failed, original missing) so the next
+    /// refresh treats them as new again.
+    mutating func forget(_ mids: some Sequence<MimeiId>) {
+        for mid in mids {
+            entries.removeValue(forKey: mid)
+        }
+    }
+}
+
+/// Result of diffing one page against a `FeedHighWaterMark`.
+struct FeedPageDiff {
+    /// Indices into the page of dicts that are new or whose content changed
+    let changedIndices: [Int]
+    let insertedIds: Set<MimeiId>
+    let editedIds: Set<MimeiId>
+    /// Delivered tweets inside the page's time window that the server no longer returns
+    let deletedIds: [MimeiId]
+    let mark: FeedHighWaterMark
+
+    var isEmpty: Bool { changedIndices.isEmpty && deletedIds.isEmpty }
+}
+
+/// A page-0 refresh expressed as a patch for the displayed feed.
+struct FeedDelta {
+    /// New and edited tweets, decoded and cached; merge them into the list
+    let upserts: [Tweet]
+    let insertedCount: Int
+    let editedCount: Int
+    let deletedIds: [MimeiId]
+    let mark: FeedHighWaterMark
+
+    var changeCount: Int { insertedCount + editedCount + deletedIds.count }
+}
+
+enum FeedDeltaSync {
+    /// Diff raw feed dicts (as returned by get_tweet_feed) against `mark`.
+    static func diff(_ page: [[String: Any]?], against mark: FeedHighWaterMark?) -> FeedPageDiff {
+        var next = mark ?? FeedHighWaterMark()
+        var changed: [Int] = []
+        var inserted = Set<MimeiId>()
+        var edited = Set<MimeiId>()
+        var seen = Set<MimeiId>()
+        var pageTimestamps: [Double] = []
+        var token = FNV1a64()
+
+        for (index, item) in page.enumerated() {
+            guard let dict = item, let mid = dict["mid"] as? String, !mid.isEmpty else { continue }
+            let fingerprint = Self.fingerprint(of: dict)
+            let timestamp = Self.timestampMillis(dict["timestamp"])
+            seen.insert(mid)
+            token.combine(mid)
+            token.combine(fingerprint)
+            if let timestamp { pageTimestamps.append(timestamp) }
+
+            if let previous = mark?.entries[mid] {
+                if previous.fingerprint != fingerprint {
+                    edited.insert(mid)
+                    changed.append(index)
+                }
+            } else {
+                inserted.insert(mid)
+                changed.append(index)
+            }
+            next.entries[mid] = (timestamp, fingerprint)
+            if let timestamp, timestamp > next.newestTimestamp {
+                next.newestTimestamp = timestamp
+            }
+        }
+
+        // A delivered tweet that falls inside this page's time window but is missing from it
+        // was deleted (or hidden) on the server. Outside the window we can't tell.
+        var deleted: [MimeiId] = []
+        if let mark, let oldest = pageTimestamps.min(), let newest = pageTimestamps.max() {
+            for (mid, entry) in mark.entries where !seen.contains(mid) {
+                guard let timestamp = entry.timestamp, timestamp >= oldest, timestamp <= newest else { continue }
+                deleted.append(mid)
+                next.entries.removeValue(forKey: mid)
+            }
+        }
+
+        next.versionToken = token.value
+        if next.entries.count > FeedHighWaterMark.maxEntries {
+            let keep = next.entries
+                .sorted { ($0.value.timestamp ?? 0) > ($1.value.timestamp ?? 0) }
+                .prefix(FeedHighWaterMark.maxEntries)
+            next.entries = Dictionary(uniqueKeysWithValues: keep.map { ($0.key, $0.value) })
+        }
+
+        return FeedPageDiff(changedIndices: changed, insertedIds: inserted, editedIds: edited, deletedIds: deleted, mark: next)
+    }
+
+    // MARK: - Helpers
+
+    /// Stable hash of a tweet dict's content (counts, favorites, edits). Dicts that can't be
+    /// serialized get a random fingerprint, i.e. are always treated as changed.
+    private static func fingerprint(of dict: [String: Any]) -> UInt64 {
+        guard JSONSerialization.isValidJSONObject(dict),
+              let data = try? JSONSerialization.data(withJSONObject: dict, options: [.sortedKeys]) else {
+            return UInt64.random(in: .min ... .max)
+        }
+        var hash = FNV1a64()
+        hash.combine(data)
+        return hash.value
+    }
+
+    /// Feed timestamps arrive as milliseconds, either numeric or as a numeric string.
+    private static func timestampMillis(_ value: Any?) -> Double? {
+        if let number = value as? NSNumber { return number.doubleValue }
+        if let string = value as? String, let millis = Double(string) {
+            return millis < 1e10 ? millis * 1000 : millis
+        }
+        return nil
+    }
+}
+
+/// 64-bit FNV-1a, used for fingerprints that must be stable across runs (unlike `Hasher`).
+private struct FNV1a64 {
+    private(set) var value: UInt64 = 0xcbf29ce484222325
+
+    mutating func combine(_ data: Data) {
+        for byte in data {
+            value ^= UInt64(byte)
+            value &*= 0x100000001b3
+        }
+    }
+
+    mutating func combine(_ string: String) {
+        for byte in string.utf8 {
+            value ^= UInt64(byte)
+            value &*= 0x100000001b3
+        }
+    }
+
+    mutating func combine(_ number: UInt64) {
+        var littleEndian = number.littleEndian
+        combine(Data(bytes: &littleEndian, count: MemoryLayout<UInt64>.size))
+    }
+}
@@ -11,142 +11,49 @@ import UIKit
 import ffmpegkit
 
 /// HLSVideoProcessor provides video metadata extraction for backend-based video processing
-/// Since video conversion is now handled on the backend, this class focuses on aspect ratio detection
+/// All queries are answered from one cached MediaProbe per file, so asking for the aspect ratio,
+/// dimensions and bitrate of the same upload opens the file once
 public class HLSVideoProcessor {
     
     public static let shared = HLSVideoProcessor()
     
     private init() {}
     
-    /// Get video aspect ratio with multiple fallback approaches
+    /// Get video display aspect ratio (rotation applied), clamped to 0.1...10
     public func getVideoAspectRatio(filePath: String) async throws -> Float? {
-        print("DEBUG: Getting video aspect ratio for file: \(filePath)")
-
-        let asset = AVURLAsset(url: URL(fileURLWithPath: filePath))
-        let tracks = try await asset.loadTracks(withMediaType: .video)
-        guard let track = tracks.first else { return nil }
-
-        let size = try await track.load(.naturalSize)
+        guard let probe = await MediaProbeCache.shared.probe(fileAt: URL(fileURLWithPath: filePath)),
+              probe.hasVideo else { return nil }
 
         // Validate dimensions are reasonable (allow small videos but reject impossible values)
-        guard size.width >= 1, size.height >= 1,
-              size.width.isFinite, size.height.isFinite,
-              size.width < 100000, size.height < 100000 else {
-            print("DEBUG: Unreasonable video dimensions: width=\(size.width), height=\(size.height), using fallback")
-            // For truly invalid dimensions, return a standard aspect ratio instead of failing
+        guard probe.width < 100000, probe.height < 100000,
+              let displayAspectRatio = probe.displayAspectRatio else {
+            print("DEBUG: Unreasonable video dimensions: width=\(probe.width), height=\(probe.height), using fallback")
             return 16.0/9.0 // Standard widescreen fallback
         }
 
-        // Get comprehensive video parameters
-        await printVideoParameters(filePath: filePath, track: track, size: size)
-
-        // Calculate display aspect ratio that accounts for rotation
-        let displayAspectRatio = await getDisplayAspectRatio(track: track, naturalSize: size)
-
-        // Validate and clamp the calculated aspect ratio to reasonable bounds
-        let clampedAspectRatio: Float
-        if displayAspectRatio.isFinite && displayAspectRatio > 0 {
-            // Clamp to reasonable bounds (0.1:1 to 10:1 aspect ratios)
-            clampedAspectRatio = max(0.1, min(10.0, displayAspectRatio))
-        } else {
-            print("DEBUG: Invalid calculated aspect ratio: \(displayAspectRatio), using fallback")
-            clampedAspectRatio = 16.0/9.0 // Standard widescreen fallback
-        }
-
+        // Clamp to reasonable bounds (0.1:1 to 10:1 aspect ratios)
+        let clampedAspectRatio = max(0.1, min(10.0, displayAspectRatio))
         print("DEBUG: Display aspect ratio: \(clampedAspectRatio)")
         return clampedAspectRatio
     }
     
-    /// Calculate display aspect ratio accounting for video rotation
-    private func getDisplayAspectRatio(track: AVAssetTrack, naturalSize: CGSize) async -> Float {
-        do {
-            let preferredTransform = try await track.load(.preferredTransform)
-
-            // Calculate rotation from transform
-            let angle = atan2(preferredTransform.b, preferredTransform.a) * 180 / .pi
-            let rotation = Int(round(angle))
-
-            // Check if dimensions should be swapped for display
-            let isRotated90or270 = rotation == 90 || rotation == 270 ||
-                                  (abs(preferredTransform.a) < 0.1 && abs(preferredTransform.d) < 0.1)
-
-            let aspectRatio: Float
-            if isRotated90or270 {
-                // For 90° or 270° rotation, swap width and height
-                // Use max() to avoid division by zero, but allow very small dimensions
-                let safeWidth = max(Float(naturalSize.width), 1.0)
-                aspectRatio = Float(naturalSize.height) / safeWidth
-            } else {
-                // For 0° or 180° rotation, use normal dimensions
-                // Use max() to avoid division by zero, but allow very small dimensions
-                let safeHeight = max(Float(naturalSize.height), 1.0)
-                aspectRatio = Float(naturalSize.width) / safeHeight
-            }
-
-            // Ensure aspect ratio is reasonable (clamp to valid range or use fallback)
-            if !aspectRatio.isFinite || aspectRatio <= 0 {
-                print("DEBUG: Invalid aspect ratio calculated: \(aspectRatio), using fallback")
-                return 16.0/9.0 // Standard widescreen fallback
-            }
-
-            return aspectRatio
-        } catch {
-            print("DEBUG: Error getting preferred transform, using natural aspect ratio: \(error)")
-            // Fallback to natural aspect ratio if transform loading fails
-            // Use max() to avoid division by zero
-            let safeHeight = max(Float(naturalSize.height), 1.0)
-            let fallbackRatio = Float(naturalSize.width) / safeHeight
-
-            if !fallbackRatio.isFinite || fallbackRatio <= 0 {
-                print("DEBUG: Invalid fallback aspect ratio: \(fallbackRatio), using standard fallback")
-                return 16.0/9.0 // Standard widescreen fallback
-            }
-            return fallbackRatio
-        }
-    }
-    
     /// Get video dimensions (width and height) from a video file
     public func getVideoDimensions(filePath: String) async -> CGSize {
-        print("DEBUG: Getting video dimensions for file: \(filePath)")
-        
-        let asset = AVURLAsset(url: URL(fileURLWithPath: filePath))
-        
-        do {
-            let tracks = try await asset.loadTracks(withMediaType: .video)
-            print("DEBUG: Found \(tracks.count) video tracks")
-            guard let videoTrack = tracks.first else {
-                print("DEBUG: No video track found, using default fallback")
-                return CGSize(width: 480, height: 270) // Default fallback
-            }
-            
-            let size = try await videoTrack.load(.naturalSize)
-            
-            // Get comprehensive video parameters
-            await printVideoParameters(filePath: filePath, track: videoTrack, size: size)
-            
-            print("DEBUG: Loaded video dimensions: \(size)")
-            return size
-        } catch {
-            print("DEBUG: Error getting video dimensions: \(error)")
+        guard let probe = await MediaProbeCache.shared.probe(fileAt: URL(fileURLWithPath: filePath)),
+              probe.hasVideo else {
+            print("DEBUG: No video track found, using default fallback")
             return CGSize(width: 480, height: 270) // Default fallback
         }
+        return CGSize(width: probe.width, height: probe.height)
     }
     
     /// Get source video bitrate in kbps
     public func getSourceVideoBitrate(filePath: String) async throws -> Int? {
-        let asset = AVURLAsset(url: URL(fileURLWithPath: filePath))
-        let tracks = try await asset.loadTracks(withMediaType: .video)
-        guard let track = tracks.first else { return nil }
-        
-        do {
-            let bitRate = try await track.load(.estimatedDataRate)
-            // Convert from bps to kbps
-            let bitRateKbps = Int(bitRate / 1000)
-            return bitRateKbps
-        } catch {
-            print("❌ Error getting source video bitrate: \(error)")
-            return nil
-        }
+        guard let probe = await MediaProbeCache.shared.probe(fileAt: URL(fileURLWithPath: filePath)),
+              probe.hasVideo,
+              let bitRate = probe.videoBitrate ?? probe.overallBitrate else { return nil }
+        // Convert from bps to kbps
+        return bitRate / 1000
     }
     
     /// Check if video format is supported based on file extension
@@ -171,173 +78,13 @@ public class HLSVideoProcessor {
         return fileExtension != nil && supportedExtensions.contains(fileExtension!)
     }
     
-    /// Print comprehensive video parameters for uploaded files
-    private func printVideoParameters(filePath: String, track: AVAssetTrack, size: CGSize) async {
-        print("=== VIDEO PARAMETERS FOR: \(filePath) ===")
-        
-        // Basic file info
-        let fileName = URL(fileURLWithPath: filePath).lastPathComponent
-        print("📁 File Name: \(fileName)")
-        
-        // File size
-        do {
-            let fileAttributes = try FileManager.default.attributesOfItem(atPath: filePath)
-            let fileSize = fileAttributes[.size] as? Int64 ?? 0
-            let fileSizeMB = Double(fileSize) / (1024 * 1024)
-            print("📏 File Size: \(fileSize) bytes (\(String(format: "%.2f", fileSizeMB)) MB)")
-        } catch {
-            print("❌ Error getting file size: \(error)")
-        }
-        
-        // Video dimensions
-        print("📐 Natural Dimensions: \(size.width) x \(size.height)")
-        print("📐 Aspect Ratio: \(size.width / size.height)")
-        
-        // Get preferred transform and rotation
-        do {
-            let preferredTransform = try await track.load(.preferredTransform)
-            print("🔄 Preferred Transform: \(preferredTransform)")
-            
-            // Calculate rotation from transform
-            let angle = atan2(preferredTransform.b, preferredTransform.a) * 180 / .pi
-            let rotation = Int(round(angle))
-            print("🔄 Calculated Rotation: \(rotation)°")
-            
-            // Check if dimensions should be swapped for display
-            let isRotated90or270 = rotation == 90 || rotation == 270 || 
-                                  (abs(preferredTransform.a) < 0.1 && abs(preferredTransform.d) < 0.1)
-            
-            if isRotated90or270 {
-                let displaySize = CGSize(width: size.height, height: size.width)
-                print("🔄 Display Dimensions (rotated): \(displaySize.width) x \(displaySize.height)")
-                print("🔄 Display Aspect Ratio (rotated): \(displaySize.width / displaySize.height)")
-            } else {
-                print("🔄 Display Dimensions: \(size.width) x \(size.height)")
-                print("🔄 Display Aspect Ratio: \(size.width / size.height)")
-            }
-        } catch {
-            print("❌ Error getting preferred transform: \(error)")
-        }
-        
-        // Get format descriptions and side data
-        do {
-            let formatDescriptions = try await track.load(.formatDescriptions)
-            print("📋 Format Descriptions Count: \(formatDescriptions.count)")
-            
-            for (index, formatDescription) in formatDescriptions.enumerated() {
-                print("📋 Format Description \(index + 1):")
-                
-                let videoFormatDescription = formatDescription 
-                let extensions = CMFormatDescriptionGetExtensions(videoFormatDescription) as? [String: Any]
-                
-                if let extensions = extensions {
-                    print("📋 Extensions: \(extensions)")
-                    
-                    // Check for Display Matrix
-                    if let displayMatrix = extensions["DisplayMatrix"] as? [String: Any] {
-                        print("🔄 Display Matrix: \(displayMatrix)")
-                        if let rotation = displayMatrix["Rotation"] as? Int {
-                            print("🔄 Rotation from Display Matrix: \(rotation)°")
-                        }
-                    }
-                    
-                    // Check for other rotation metadata
-                    if let rotation = extensions["Rotation"] as? Int {
-                        print("🔄 Rotation from Extensions: \(rotation)°")
-                    }
-                    
-                    // Check for codec info
-                    if let codec = extensions["VideoCodecType"] {
-                        print("🎬 Codec: \(codec)")
-                    }
-                    
-                    // Check for bitrate
-                    if let bitrate = extensions["BitRate"] {
-                        print("📊 Bitrate: \(bitrate)")
-                    }
-                    
-                    // Check for frame rate
-                    if let frameRate = extensions["FrameRate"] {
-                        print("🎞️ Frame Rate: \(frameRate)")
-                    }
-                } else {
-                    print("📋 No extensions found")
-                }
-            }
-        } catch {
-            print("❌ Error getting format descriptions: \(error)")
-        }
-        
-        // Get additional track properties
-        do {
-            let frameRate = try await track.load(.nominalFrameRate)
-            print("🎞️ Nominal Frame Rate: \(frameRate) fps")
-        } catch {
-            print("❌ Error getting frame rate: \(error)")
-        }
-        
-        do {
-            let bitRate = try await track.load(.estimatedDataRate)
-            let bitRateMbps = bitRate / 1_000_000
-            print("📊 Estimated Data Rate: \(String(format: "%.2f", bitRateMbps)) Mbps")
-        } catch {
-            print("❌ Error getting bit rate: \(error)")
-        }
-        
-        // Get track format
-        do {
-            let formatDescriptions = try await track.load(.formatDescriptions)
-            if let firstFormat = formatDescriptions.first {
-                let mediaSubType = CMFormatDescriptionGetMediaSubType(firstFormat)
-                let mediaSubTypeString = String(describing: mediaSubType)
-                print("🎬 Media Sub Type: \(mediaSubTypeString)")
-            }
-        } catch {
-            print("❌ Error getting media sub type: \(error)")
-        }
-        
-        print("=== END VIDEO PARAMETERS ===")
-    }
-    
-    /// Get video info using AVFoundation (replaces unreliable ffprobe on iOS)
+    /// Get natural and display dimensions plus rotation from the shared media probe
     public func getVideoInfo(filePath: String) async -> (width: Int, height: Int, displayWidth: Int, displayHeight: Int, rotation: Int)? {
-        
-        let asset = AVURLAsset(url: URL(fileURLWithPath: filePath))
-        
-        do {
-            let tracks = try await asset.loadTracks(withMediaType: .video)
-            guard let videoTrack = tracks.first else {
-                print("DEBUG: [AVFoundation] No video track found")
-                return nil
-            }
-            
-            // Get natural dimensions
-            let size = try await videoTrack.load(.naturalSize)
-            let width = Int(size.width)
-            let height = Int(size.height)
-            
-            // Get rotation from preferred transform
-            let preferredTransform = try await videoTrack.load(.preferredTransform)
-            let angle = atan2(preferredTransform.b, preferredTransform.a) * 180 / .pi
-            let rotation = Int(round(angle))
-            
-            // Calculate display dimensions (accounting for rotation)
-            var displayWidth = width
-            var displayHeight = height
-            
-            if rotation == 90 || rotation == -90 || rotation == 270 || rotation == -270 {
-                displayWidth = height
-                displayHeight = width
-            }
-            
-            print("DEBUG: [AVFoundation] Video dimensions: \(width)x\(height)")
-            print("DEBUG: [AVFoundation] Display dimensions (after rotation): \(displayWidth)x\(displayHeight)")
-            print("DEBUG: [AVFoundation] Rotation: \(rotation)°")
-            
-            return (width, height, displayWidth, displayHeight, rotation)
-        } catch {
-            print("DEBUG: [AVFoundation] Error getting video info: \(error)")
+        guard let probe = await MediaProbeCache.shared.probe(fileAt: URL(fileURLWithPath: filePath)),
+              probe.hasVideo else {
+            print("DEBUG: [MediaProbe] No video track found")
             return nil
         }
+        return (probe.width, probe.height, probe.displayWidth, probe.displayHeight, probe.rotation)
     }
 } 
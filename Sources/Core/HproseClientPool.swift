@@ -1,139 +1,360 @@
 import Foundation
 import hprose
 
+/// A node address, parsed once from the "ip:port" / "[ipv6]:port" / base URL strings the
+/// rest of the app passes around.
+struct Endpoint: Hashable, Sendable {
+    enum Family: Hashable, Sendable {
+        case ipv4
+        case ipv6
+        case hostname
+    }
+
+    let family: Family
+    let scheme: String
+    let host: String
+    let port: Int?
+
+    /// hprose endpoint URI, e.g. `http://[::1]:8080/webapi/`
+    var uri: String {
+        let hostPart = family == .ipv6 ? "[\(host)]" : host
+        let portPart = port.map { ":\($0)" } ?? ""
+        return "\(scheme)://\(hostPart)\(portPart)/webapi/"
+    }
+
+    /// Parse an "ip", "ip:port", "[ipv6]:port" or bare "ipv6:port" string.
+    /// Bare IPv6 without a recognisable port gets 8080, as before.
+    init(ip: String) {
+        scheme = "http"
+        if ip.hasPrefix("["), let bracketEnd = ip.firstIndex(of: "]") {
+            host = String(ip[ip.index(after: ip.startIndex)..<bracketEnd])
+            port = Int(ip[ip.index(after: bracketEnd)...].dropFirst())
+            family = .ipv6
+            return
+        }
+        let colonCount = ip.reduce(0) { $1 == ":" ? $0 + 1 : $0 }
+        if colonCount > 1 {
+            family = .ipv6
+            if let lastColon = ip.lastIndex(of: ":"),
+               let parsedPort = Int(ip[ip.index(after: lastColon)...].trimmingCharacters(in: .whitespaces)) {
+                host = String(ip[..<lastColon])
+                port = parsedPort
+            } else {
+                host = ip
+                port = 8080
+            }
+            return
+        }
+        if colonCount == 1, let colon = ip.firstIndex(of: ":") {
+            host = String(ip[..<colon])
+            port = Int(ip[ip.index(after: colon)...])
+        } else {
+            host = ip
+            port = nil
+        }
+        family = NodeAddress.isIPv4(host) ? .ipv4 : .hostname
+    }
+
+    /// Parse a base URL string such as `http://1.2.3.4:8080`.
+    init(baseUrl: String) {
+        guard let components = URLComponents(string: baseUrl), let urlHost = components.host else {
+            self.init(ip: baseUrl)
+            return
+        }
+        scheme = components.scheme ?? "http"
+        // URLComponents keeps the brackets of IPv6 literals
+        host = urlHost.trimmingCharacters(in: CharacterSet(charactersIn: "[]"))
+        port = components.port
+        family = host.contains(":") ? .ipv6 : (NodeAddress.isIPv4(host) ? .ipv4 : .hostname)
+    }
+}
+
+/// Rolling health of one endpoint, fed by RPC attempts and health probes.
+struct EndpointHealth: Sendable {
+    /// Exponentially weighted latency of successful calls
+    var latency: TimeInterval?
+    /// Exponentially weighted failure rate, 0...1
+    var errorRate: Double = 0
+    var consecutiveFailures = 0
+    var successes = 0
+    var failures = 0
+    var updatedAt = Date()
+
+    fileprivate static let smoothing = 0.2
+
+    fileprivate mutating func record(latency sample: TimeInterval?, failed: Bool) {
+        updatedAt = Date()
+        errorRate += ((failed ? 1 : 0) - errorRate) * Self.smoothing
+        if failed {
+            failures += 1
+            consecutiveFailures += 1
+        } else {
+            successes += 1
+            consecutiveFailures = 0
+            if let sample {
+                latency = latency.map { $0 + (sample - $0) * Self.smoothing } ?? sample
+            }
+        }
+    }
+}
+
 /// A pool for managing HproseClient instances
 /// Thread-safe pool that manages creation and reuse of HproseHttpClient instances
+///
+/// Clients are kept per parsed `Endpoint`. Idle clients expire after `idleTTL` and the idle
+/// set is capped globally; a client dropped from it is closed, since its URLSession holds it
+/// until then. Borrowed clients are tracked weakly so clients that are never released show up
+/// in `borrowStats()` instead of disappearing silently. Clients handed out for a user's node
+/// (`pinnedClient`) live with their holder and are not tracked.
 class HproseClientPool {
-    private var availableClients: [String: [HproseClient]] = [:]
+    private struct IdleClient {
+        let client: HproseClient
+        let since: Date
+    }
+
+    private struct Borrow {
+        weak var client: HproseClient?
+        let endpoint: Endpoint
+        let since: Date
+    }
+
+    struct BorrowStats {
+        let outstanding: Int
+        /// Still alive and unreleased after `longHeldThreshold`
+        let longHeld: Int
+        let idle: Int
+    }
+
+    private var idleClients: [Endpoint: [IdleClient]] = [:]
+    private var idleCount = 0
+    private var borrowed: [ObjectIdentifier: Borrow] = [:]
+    private var health: [Endpoint: EndpointHealth] = [:]
+    /// Raw address strings already parsed, so hot paths don't re-parse them
+    private var internedEndpoints: [String: Endpoint] = [:]
+    private var lastSweep = Date()
+
     private let maxClientsPerURL: Int
+    private let maxIdleClients: Int
+    private let idleTTL: TimeInterval = 60
+    private let sweepInterval: TimeInterval = 30
+    private let longHeldThreshold: TimeInterval = 10 * 60
+    private let maxInternedEndpoints = 4096
+    private let maxTrackedHealth = 1024
     private let lock = NSLock()
-    
-    init(maxClientsPerURL: Int = 8) {
+
+    init(maxClientsPerURL: Int = 8, maxIdleClients: Int = 64) {
         self.maxClientsPerURL = maxClientsPerURL
+        self.maxIdleClients = maxIdleClients
     }
-    
+
     /// Get a client for a specific URL. Creates a new one if needed.
     /// - Parameter urlString: The URL string for the server endpoint
     /// - Returns: A configured HproseClient instance
     func getClientByIP(for ip: String) -> HproseClient {
-        // Properly format URL for IPv6 addresses
-        // IPv6 addresses come in format: [ipv6]:port or ipv6:port (without brackets)
-        let urlString: String
-        if ip.hasPrefix("[") {
-            // Already formatted with brackets: [ipv6]:port -> http://[ipv6]:port/webapi/
-            urlString = "http://\(ip)/webapi/"
-        } else if ip.contains(":") {
-            // Check if it's IPv6 (multiple colons) or IPv4 with port (single colon)
-            let colonCount = ip.filter { $0 == ":" }.count
-            if colonCount > 1 {
-                // IPv6 without brackets: ipv6:port -> http://[ipv6]:port/webapi/
-                // Extract port if present (last component after last colon)
-                if let lastColonIndex = ip.lastIndex(of: ":"),
-                   let portString = Int(ip[ip.index(after: lastColonIndex)...].trimmingCharacters(in: .whitespaces)) {
-                    // Has port: split and wrap IPv6 in brackets
-                    let ipv6 = String(ip[..<lastColonIndex])
-                    urlString = "http://[\(ipv6)]:\(portString)/webapi/"
-                } else {
-                    // No port or invalid format: wrap entire IPv6 in brackets with default port
-                    urlString = "http://[\(ip)]:8080/webapi/"
-                }
-            } else {
-                // IPv4 with port: ip:port -> http://ip:port/webapi/
-                urlString = "http://\(ip)/webapi/"
-            }
-        } else {
-            // IPv4 without port: ip -> http://ip/webapi/
-            urlString = "http://\(ip)/webapi/"
+        lock.withLock {
+            borrowLocked(endpointLocked(forIP: ip))
         }
+    }
 
-        lock.lock()
-        defer { lock.unlock() }
-        
-        // Try to reuse an available client for this URL
-        if var clients = availableClients[urlString], !clients.isEmpty {
-            let client = clients.removeLast()
-            availableClients[urlString] = clients
-            return client
+    func getClientByUrl(for url: String) -> HproseClient {
+        lock.withLock {
+            borrowLocked(endpointLocked(forBaseUrl: url))
         }
-        
-        // Create a new client
-        let client = HproseHttpClient()
-        client.timeout = 5  // 5 seconds timeout for health checks (fast fail for bad servers)
-        client.uri = urlString
-        return client
     }
-    
-    func getClientByUrl(for url: String) -> HproseClient {
-        let urlString = "\(url)/webapi/"
-        lock.lock()
-        defer { lock.unlock() }
-        
-        // Try to reuse an available client for this URL
-        if var clients = availableClients[urlString], !clients.isEmpty {
-            let client = clients.removeLast()
-            availableClients[urlString] = clients
-            return client
-        }
-        
-        // Create a new client
-        let client = HproseHttpClient()
-        client.timeout = 5  // 5 seconds timeout for health checks (fast fail for bad servers)
-        client.uri = urlString
-        return client
+
+    /// A client for a node the caller keeps using rather than releasing (`User.hproseClient`,
+    /// `User.writableClient`). Reuses an idle client when there is one; not tracked as a loan.
+    func pinnedClient(forUrl url: String) -> HproseClient {
+        lock.withLock {
+            pinnedLocked(endpointLocked(forBaseUrl: url))
+        }
+    }
+
+    func pinnedClient(forIP ip: String) -> HproseClient {
+        lock.withLock {
+            pinnedLocked(endpointLocked(forIP: ip))
+        }
     }
-    
+
     /// Return a client to the pool for reuse
     /// - Parameters:
     ///   - client: The client to return
-    ///   - urlString: The URL string this client was configured for
+    ///   - ip: The address this client was borrowed for
     func releaseClient(_ client: HproseClient, for ip: String) {
-        // Use same URL construction logic as getClientByIP
-        let urlString: String
-        if ip.hasPrefix("[") {
-            urlString = "http://\(ip)/webapi/"
-        } else if ip.contains(":") {
-            let colonCount = ip.filter { $0 == ":" }.count
-            if colonCount > 1 {
-                if let lastColonIndex = ip.lastIndex(of: ":"),
-                   let portString = Int(ip[ip.index(after: lastColonIndex)...].trimmingCharacters(in: .whitespaces)) {
-                    let ipv6 = String(ip[..<lastColonIndex])
-                    urlString = "http://[\(ipv6)]:\(portString)/webapi/"
-                } else {
-                    urlString = "http://[\(ip)]:8080/webapi/"
-                }
-            } else {
-                urlString = "http://\(ip)/webapi/"
+        lock.withLock {
+            releaseLocked(client, endpoint: endpointLocked(forIP: ip))
+        }
+    }
+
+    /// Return a client to the pool, using the endpoint it was borrowed for.
+    func releaseClient(_ client: HproseClient) {
+        lock.withLock {
+            guard let endpoint = borrowed[ObjectIdentifier(client)]?.endpoint else {
+                print("WARNING: [HproseClientPool] Ignoring release of a client this pool didn't lend")
+                return
             }
-        } else {
-            urlString = "http://\(ip)/webapi/"
-        }
-        
-        lock.lock()
-        defer { lock.unlock() }
-        
-        var clients = availableClients[urlString] ?? []
-        
-        // Only keep up to maxClientsPerURL in the pool
-        if clients.count < maxClientsPerURL {
-            clients.append(client)
-            availableClients[urlString] = clients
-        }
-        // If pool is full, let the client be deallocated
-    }
-    
+            releaseLocked(client, endpoint: endpoint)
+        }
+    }
+
     /// Clear all clients from the pool
     func clear() {
-        lock.lock()
-        defer { lock.unlock() }
-        
-        availableClients.removeAll()
+        lock.withLock {
+            idleClients.values.joined().forEach { $0.client.close(false) }
+            idleClients.removeAll()
+            idleCount = 0
+        }
     }
-    
+
     /// Clear clients for a specific URL
     func clear(for urlString: String) {
-        lock.lock()
-        defer { lock.unlock() }
-        
-        availableClients.removeValue(forKey: urlString)
+        lock.withLock {
+            let endpoint = endpointLocked(forBaseUrl: urlString)
+            let removed = idleClients.removeValue(forKey: endpoint) ?? []
+            removed.forEach { $0.client.close(false) }
+            idleCount -= removed.count
+        }
+    }
+
+    // MARK: - Health
+
+    /// Record one call or probe against the endpoint behind `ip` ("host:port").
+    func recordResult(forIP ip: String, latency: TimeInterval?, failed: Bool) {
+        lock.withLock {
+            recordLocked(endpointLocked(forIP: ip), latency: latency, failed: failed)
+        }
+    }
+
+    /// Record one call against the endpoint behind a base URL.
+    func recordResult(forUrl url: String, latency: TimeInterval?, failed: Bool) {
+        lock.withLock {
+            recordLocked(endpointLocked(forBaseUrl: url), latency: latency, failed: failed)
+        }
+    }
+
+    func health(forIP ip: String) -> EndpointHealth? {
+        lock.withLock {
+            health[endpointLocked(forIP: ip)]
+        }
+    }
+
+    /// `ips` with endpoints that are currently failing moved to the back; order is otherwise kept.
+    func rankedByHealth(_ ips: [String]) -> [String] {
+        lock.withLock {
+            let failing = ips.map { (health[endpointLocked(forIP: $0)]?.consecutiveFailures ?? 0) >= 2 }
+            return zip(ips, failing).filter { !$0.1 }.map(\.0) + zip(ips, failing).filter { $0.1 }.map(\.0)
+        }
+    }
+
+    func borrowStats() -> BorrowStats {
+        lock.withLock {
+            let now = Date()
+            let alive = borrowed.values.filter { $0.client != nil }
+            return BorrowStats(
+                outstanding: alive.count,
+                longHeld: alive.filter { now.timeIntervalSince($0.since) > longHeldThreshold }.count,
+                idle: idleCount
+            )
+        }
+    }
+
+    // MARK: - Private (lock held)
+
+    private func endpointLocked(forIP ip: String) -> Endpoint {
+        internLocked("ip:\(ip)") { Endpoint(ip: ip) }
+    }
+
+    private func endpointLocked(forBaseUrl url: String) -> Endpoint {
+        internLocked("url:\(url)") { Endpoint(baseUrl: url) }
+    }
+
+    private func internLocked(_ key: String, parse: () -> Endpoint) -> Endpoint {
+        if let endpoint = internedEndpoints[key] {
+            return endpoint
+        }
+        if internedEndpoints.count >= maxInternedEndpoints {
+            internedEndpoints.removeAll(keepingCapacity: true)
+        }
+        let endpoint = parse()
+        internedEndpoints[key] = endpoint
+        return endpoint
+    }
+
+    private func borrowLocked(_ endpoint: Endpoint) -> HproseClient {
+        sweepIfNeededLocked()
+
+        let client = takeIdleLocked(endpoint) ?? makeClient(endpoint)
+        client.timeout = 5  // 5 seconds timeout for health checks (fast fail for bad servers)
+        borrowed[ObjectIdentifier(client)] = Borrow(client: client, endpoint: endpoint, since: Date())
+        return client
+    }
+
+    private func pinnedLocked(_ endpoint: Endpoint) -> HproseClient {
+        let client = takeIdleLocked(endpoint) ?? makeClient(endpoint)
+        client.timeout = 5
+        return client
+    }
+
+    private func takeIdleLocked(_ endpoint: Endpoint) -> HproseClient? {
+        guard var clients = idleClients[endpoint], let idle = clients.popLast() else { return nil }
+        idleClients[endpoint] = clients.isEmpty ? nil : clients
+        idleCount -= 1
+        return idle.client
+    }
+
+    private func makeClient(_ endpoint: Endpoint) -> HproseClient {
+        let client = HproseHttpClient()
+        client.uri = endpoint.uri
+        return client
+    }
+
+    private func releaseLocked(_ client: HproseClient, endpoint: Endpoint) {
+        // Only clients currently on loan go back; a second release would lend one client twice
+        guard borrowed.removeValue(forKey: ObjectIdentifier(client)) != nil else {
+            print("WARNING: [HproseClientPool] Ignoring duplicate release for \(endpoint.uri)")
+            return
+        }
+        sweepIfNeededLocked()
+
+        var clients = idleClients[endpoint] ?? []
+        // Only keep up to maxClientsPerURL per endpoint and maxIdleClients overall
+        guard clients.count < maxClientsPerURL, idleCount < maxIdleClients else {
+            client.close(false)
+            return
+        }
+        clients.append(IdleClient(client: client, since: Date()))
+        idleClients[endpoint] = clients
+        idleCount += 1
+    }
+
+    private func recordLocked(_ endpoint: Endpoint, latency: TimeInterval?, failed: Bool) {
+        var entry = health[endpoint] ?? EndpointHealth()
+        entry.record(latency: latency, failed: failed)
+        health[endpoint] = entry
+        if health.count > maxTrackedHealth {
+            let oldest = health.min { $0.value.updatedAt < $1.value.updatedAt }?.key
+            if let oldest {
+                health.removeValue(forKey: oldest)
+            }
+        }
+    }
+
+    /// Drop idle clients past their TTL and loans whose client has been deallocated.
+    private func sweepIfNeededLocked() {
+        let now = Date()
+        guard now.timeIntervalSince(lastSweep) >= sweepInterval else { return }
+        lastSweep = now
+
+        for (endpoint, clients) in idleClients {
+            let fresh = clients.filter { now.timeIntervalSince($0.since) < idleTTL }
+            clients.filter { now.timeIntervalSince($0.since) >= idleTTL }.forEach { $0.client.close(false) }
+            idleCount -= clients.count - fresh.count
+            idleClients[endpoint] = fresh.isEmpty ? nil : fresh
+        }
+        borrowed = borrowed.filter { $0.value.client != nil }
+        let longHeld = borrowed.values.filter { now.timeIntervalSince($0.since) > longHeldThreshold }.count
+        if longHeld > 0 {
+            print("DEBUG: [HproseClientPool] \(borrowed.count) clients on loan, \(longHeld) held over \(Int(longHeldThreshold / 60)) min without release")
+        }
     }
 }
@@ -34,6 +34,10 @@ final class HproseInstance: ObservableObject {
     private let ipCacheLock = NSLock()
     private var heavyCallLastAttemptAt: [String: Date] = [:]
     private let heavyCallLock = NSLock()
+    // Unchecked provider IP lists for multi-source media fetches, keyed by "mid_v4only"
+    private static let providerIPListCacheTTL: TimeInterval = 5 * 60
+    private var providerIPListCache: [String: (ips: [String], timestamp: Date)] = [:]
+    private let providerIPListCacheLock = NSLock()
     
     /// The domain to use for sharing links
     var domainToShare: String {
@@ -198,23 +202,30 @@ final class HproseInstance: ObservableObject {
     
     // MARK: - Helper Methods
     
-    /// Generic retry helper with exponential backoff
+    /// Generic retry helper with exponential backoff.
+    /// Stops early when the enclosing `RPCDeadline` would pass before the next attempt starts.
     private func retryOperation<T>(
         maxRetries: Int = 3,
         baseDelay: UInt64 = 1_000_000_000, // 1 second in nanoseconds
+        defaultDeadline: TimeInterval = 60,
         operation: @escaping () async throws -> T
     ) async throws -> T {
+        let deadline = RPCDeadline.resolved(defaultSeconds: defaultDeadline)
         var lastError: Error?
         
         for attempt in 1...maxRetries {
             do {
-                return try await operation()
+                return try await RPCDeadline.withDeadline(deadline, operation: operation)
             } catch {
                 lastError = error
                 
                 if attempt < maxRetries {
                     let delay = baseDelay * UInt64(attempt) // Exponential backoff
-                    try await Task.sleep(nanoseconds: delay)
+                    do {
+                        try await deadline.sleepBeforeRetry(nanoseconds: delay)
+                    } catch {
+                        break
+                    }
                 }
             }
         }
@@ -559,23 +570,23 @@ final class HproseInstance: ObservableObject {
             do {
                 let urlWithPrefix = ensureHttpPrefix(url)
                 let html = try await fetchHTML(from: urlWithPrefix)
-                let paramData = Gadget.shared.extractParamMap(from: html)
+                let page = BootstrapPage(html: html)
                 // Update appId from server if provided, otherwise keep AppConfig value
-                if let serverAppId = paramData["mid"] as? String, !serverAppId.isEmpty {
+                if let serverAppId = page.appId, !serverAppId.isEmpty {
                     appId = serverAppId
                     print("DEBUG: [HproseInstance] Updated appId from server: \(appId)")
                 } else {
                     print("DEBUG: [HproseInstance] Server did not provide appId, keeping AppConfig value: \(appId)")
                 }
-                guard let addrs = paramData["addrs"] as? String else { continue }
+                guard let addrs = page.rawAddrs else { continue }
                 if lastInitializationAddresses != addrs {
                     print("DEBUG: [HproseInstance] App addresses resolved: \(addrs)")
                     lastInitializationAddresses = addrs
                 }
                 
-                let candidates = entryIPCandidates(from: addrs)
-                for entryIP in candidates {
-                    let normalizedEntryIP = normalizeHostPort(entryIP)
+                // Server-reported order, with nodes that keep failing our own probes tried last
+                let candidates = clientPool.rankedByHealth(entryIPCandidates(from: page.addresses))
+                for normalizedEntryIP in candidates {
                     print("DEBUG: [findEntryIP] Testing entry IP: \(normalizedEntryIP)")
                     if await isServerHealthyWithTimeout(normalizedEntryIP, timeout: 5.0, useCache: false) {
                         HproseInstance.baseUrl = URL(string: "http://\(normalizedEntryIP)")!
@@ -591,55 +602,14 @@ final class HproseInstance: ObservableObject {
         return nil
     }
 
-    private func entryIPCandidates(from nodeList: Any) -> [String] {
-        guard let raw = nodeList as? String else { return [] }
-        let pattern = #""([^"]+)"\s*,\s*(\d+)"#
-        guard let regex = try? NSRegularExpression(pattern: pattern) else { return [] }
-
-        let range = NSRange(raw.startIndex..<raw.endIndex, in: raw)
+    /// Public nodes on the service port range, fastest reported first
+    private func entryIPCandidates(from addresses: [NodeAddress]) -> [String] {
         var seen = Set<String>()
-        var candidates: [(ip: String, responseTime: UInt64)] = []
-
-        for match in regex.matches(in: raw, options: [], range: range) {
-            guard let ipRange = Range(match.range(at: 1), in: raw),
-                  let timeRange = Range(match.range(at: 2), in: raw),
-                  let responseTime = UInt64(raw[timeRange]) else {
-                continue
-            }
-
-            let ip = normalizeHostPort(String(raw[ipRange]))
-            guard let port = portNumber(from: ip),
-                  (8000...9000).contains(port),
-                  Gadget.isValidPublicIpAddress(ip),
-                  seen.insert(ip).inserted else {
-                continue
-            }
-
-            candidates.append((ip: ip, responseTime: responseTime))
-        }
-
-        if candidates.isEmpty, let legacyCandidate = Gadget.shared.filterIpAddresses(nodeList) {
-            return [normalizeHostPort(legacyCandidate)]
-        }
-
-        return candidates
-            .sorted { $0.responseTime < $1.responseTime }
-            .map(\.ip)
-    }
-
-    private func portNumber(from hostPort: String) -> Int? {
-        let normalized = normalizeHostPort(hostPort)
-        if normalized.hasPrefix("["),
-           let bracketEnd = normalized.firstIndex(of: "]") {
-            let suffix = normalized[normalized.index(after: bracketEnd)...]
-            guard suffix.hasPrefix(":") else { return nil }
-            return Int(suffix.dropFirst())
-        }
-
-        guard let portPart = normalized.split(separator: ":").last else {
-            return nil
-        }
-        return Int(portPart)
+        return addresses
+            .filter { $0.isPublic && ($0.port.map { (8000...9000).contains($0) } ?? false) }
+            .sorted { ($0.rtt ?? .max) < ($1.rtt ?? .max) }
+            .map(\.hostPort)
+            .filter { seen.insert($0).inserted }
     }
 
     private func normalizeHostPort(_ hostPort: String) -> String {
@@ -830,14 +800,20 @@ final class HproseInstance: ObservableObject {
             }
         }
         
-        // Use author's client - comments are on author's node
-        guard let client = author.hproseClient else {
+        // Use author's node - comments are on author's node; hedge to another provider on a slow reply
+        guard let authorBaseUrl = author.baseUrl else {
             throw NSError(domain: "HproseClient", code: -1, userInfo: [NSLocalizedDescriptionKey: NSLocalizedString("Author's client not initialized. baseUrl: \(author.baseUrl?.absoluteString ?? "nil")", comment: "Client initialization error")])
         }
         
-        print("DEBUG: [fetchComments] Using author's baseUrl (\(author.baseUrl?.absoluteString ?? "nil")) for tweet \(parentTweet.mid)")
+        print("DEBUG: [fetchComments] Using author's baseUrl (\(authorBaseUrl.absoluteString)) for tweet \(parentTweet.mid)")
         
-        let rawResponse = client.invoke("runMApp", withArgs: [entry, params])
+        let rawResponse = try await RPCHedger.shared.invoke(
+            entry: entry,
+            params: params,
+            primary: authorBaseUrl,
+            deadline: RPCDeadline.resolved(defaultSeconds: 15),
+            alternates: providerBaseUrls(for: author.mid)
+        ).response
         
         // Unwrap v2 response
         let unwrappedResponse = try Self.unwrapV2Response(rawResponse)
@@ -971,6 +947,87 @@ final class HproseInstance: ObservableObject {
             return []
         }
         
+        let (response, params) = try await invokeTweetFeed(
+            user: user,
+            pageNumber: pageNumber,
+            pageSize: pageSize,
+            entry: entry,
+            isFollowingTweetUpdate: isFollowingTweetUpdate
+        )
+        
+        // unwrapV2Response already threw for success=false
+        // Extract tweets and originalTweets from the new response format
+        let tweetsData = response["tweets"] as? [[String: Any]?] ?? []
+        let originalTweetsData = response["originalTweets"] as? [[String: Any]?] ?? []
+        
+        if isFollowingTweetUpdate {
+            print("[fetchTweetFeed] Got \(tweetsData.count) tweets and \(originalTweetsData.count) original tweets from server")
+            enqueueAccessHostSyncIfNeeded(homeResponse: response, requestParams: params)
+        }
+
+        let tweets = await processFeedTweets(tweetsData, originalTweetsData: originalTweetsData)
+
+        print("[fetchTweetFeed] Returning \(tweets.count) tweets")
+        NodePool.shared.updateFromUser(user)
+        return tweets
+    }
+
+    /// Page 0 of `user`'s feed as a patch against `mark` (see FeedDeltaSync).
+    ///
+    /// Only new and edited tweets are decoded, cached and get author fetches; unchanged ones are
+    /// skipped. Returns nil before app initialization, when callers should use the cached feed.
+    func fetchTweetFeedDelta(user: User, pageSize: UInt, since mark: FeedHighWaterMark?) async throws -> FeedDelta? {
+        guard isInitializationComplete else { return nil }
+
+        let (response, _) = try await invokeTweetFeed(
+            user: user,
+            pageNumber: 0,
+            pageSize: pageSize,
+            entry: "get_tweet_feed",
+            isFollowingTweetUpdate: false
+        )
+        let tweetsData = response["tweets"] as? [[String: Any]?] ?? []
+        let originalTweetsData = response["originalTweets"] as? [[String: Any]?] ?? []
+
+        let diff = FeedDeltaSync.diff(tweetsData, against: mark)
+        var nextMark = diff.mark
+        guard !diff.isEmpty else {
+            print("[fetchTweetFeedDelta] Page 0 unchanged (\(tweetsData.count) tweets)")
+            return FeedDelta(upserts: [], insertedCount: 0, editedCount: 0, deletedIds: [], mark: nextMark)
+        }
+
+        // Decode only changed tweets, plus the originals they reference
+        let changedData = diff.changedIndices.map { tweetsData[$0] }
+        let neededOriginalIds = Set(changedData.compactMap { $0?["originalTweetId"] as? String })
+        let neededOriginals = originalTweetsData.filter {
+            guard let mid = $0?["mid"] as? String else { return false }
+            return neededOriginalIds.contains(mid)
+        }
+        let upserts = await processFeedTweets(changedData, originalTweetsData: neededOriginals).compactMap { $0 }
+
+        // Changed tweets that didn't make it (private, missing original, decode error) stay "new"
+        let delivered = Set(upserts.map { $0.mid })
+        nextMark.forget(diff.insertedIds.union(diff.editedIds).subtracting(delivered))
+
+        print("[fetchTweetFeedDelta] \(diff.insertedIds.count) new, \(diff.editedIds.count) edited, \(diff.deletedIds.count) removed of \(tweetsData.count)")
+        NodePool.shared.updateFromUser(user)
+        return FeedDelta(
+            upserts: upserts,
+            insertedCount: delivered.intersection(diff.insertedIds).count,
+            editedCount: delivered.intersection(diff.editedIds).count,
+            deletedIds: diff.deletedIds,
+            mark: nextMark
+        )
+    }
+
+    /// Invoke a feed entry and return the unwrapped response plus the params sent.
+    private func invokeTweetFeed(
+        user: User,
+        pageNumber: UInt,
+        pageSize: UInt,
+        entry: String,
+        isFollowingTweetUpdate: Bool
+    ) async throws -> (response: [String: Any], params: [String: Any]) {
         let client: HproseClient?
         if isFollowingTweetUpdate {
             client = await followingTweetsHomeClient()
@@ -1001,18 +1058,12 @@ final class HproseInstance: ObservableObject {
         guard let response = unwrappedResponse as? [String: Any] else {
             throw NSError(domain: "HproseClient", code: -1, userInfo: [NSLocalizedDescriptionKey: "Invalid response format from server in fetchTweetFeed"])
         }
-        
-        // unwrapV2Response already threw for success=false
-        // Extract tweets and originalTweets from the new response format
-        let tweetsData = response["tweets"] as? [[String: Any]?] ?? []
-        let originalTweetsData = response["originalTweets"] as? [[String: Any]?] ?? []
-        
-        
-        if isFollowingTweetUpdate {
-            print("[fetchTweetFeed] Got \(tweetsData.count) tweets and \(originalTweetsData.count) original tweets from server")
-            await syncFollowingTweetsToAccessHostIfNeeded(homeResponse: response, requestParams: params)
-        }
+        return (response, params)
+    }
 
+    /// Decode feed dicts into tweets, caching originals under their authors and main tweets under
+    /// appUser. Private tweets and retweets whose original can't be loaded come back as nil.
+    private func processFeedTweets(_ tweetsData: [[String: Any]?], originalTweetsData: [[String: Any]?]) async -> [Tweet?] {
         var scheduledBackgroundAuthorFetches = Set<String>()
         func scheduleBackgroundAuthorFetch(authorId: String, context: String) {
             guard scheduledBackgroundAuthorFetches.insert(authorId).inserted else { return }
@@ -1097,16 +1148,14 @@ final class HproseInstance: ObservableObject {
                 tweets.append(nil)
             }
         }
-
-        print("[fetchTweetFeed] Returning \(tweets.count) tweets")
-        NodePool.shared.updateFromUser(user)
         return tweets
     }
 
     private func followingTweetsHomeClient() async -> HproseClient? {
+        let timeout = RPCDeadline.resolved(defaultSeconds: 15).attemptTimeout(cap: 15)
         if let _ = try? await appUser.resolveWritableUrl(),
            let client = appUser.writableClient {
-            client.timeout = 15
+            client.timeout = timeout
             return client
         }
 
@@ -1116,42 +1165,61 @@ final class HproseInstance: ObservableObject {
             return appUser.hproseClient
         }
 
-        let client = clientPool.getClientByIP(for: homeIP)
-        client.timeout = 15
+        // Handed to the caller like writableClient, so it isn't a tracked loan either
+        let client = clientPool.pinnedClient(forIP: homeIP)
+        client.timeout = timeout
         return client
     }
 
-    private func syncFollowingTweetsToAccessHostIfNeeded(homeResponse: [String: Any], requestParams: [String: Any]) async {
+    /// Queue the access host's pull of new following tweets from the home host. The feed fetch
+    /// never waits on it; AccessHostReplicationOutbox delivers it in the background.
+    private func enqueueAccessHostSyncIfNeeded(homeResponse: [String: Any], requestParams: [String: Any]) {
+        let outbox = AccessHostReplicationOutbox.shared
         let newTweetCount = (homeResponse["tweets"] as? [Any])?.filter { !($0 is NSNull) }.count ?? 0
-        guard newTweetCount > 0 else { return }
-
-        guard let hostIds = appUser.hostIds,
+        guard newTweetCount > 0,
+              let hostIds = appUser.hostIds,
               let homeHostId = hostIds.first,
-              hostIds.count > 1 else {
+              hostIds.count > 1,
+              hostIds[1] != homeHostId else {
+            // Nothing new, but retry whatever an earlier session left undelivered
+            outbox.kick()
             return
         }
 
-        let accessHostId = hostIds[1]
-        guard accessHostId != homeHostId else { return }
+        outbox.enqueue(
+            accessHostId: hostIds[1],
+            homeHostId: homeHostId,
+            appUserId: appUser.mid,
+            userId: requestParams["userid"] as? String ?? appUser.mid,
+            appId: requestParams["aid"] as? String ?? appId,
+            pageSize: requestParams["ps"] as? UInt ?? 20
+        )
+    }
 
-        guard let accessIP = await getHostIP(accessHostId, v4Only: true) else {
-            print("ERROR: [update_following_tweets] Unable to resolve access host \(accessHostId)")
-            return
+    /// Run update_following_tweets on the job's access host with `homeupdated`, so it pulls
+    /// the tweets the home host just received. Called by AccessHostReplicationOutbox.
+    func replicateFollowingTweets(_ job: AccessHostReplicationOutbox.Job) async throws {
+        guard let accessIP = await getHostIP(job.accessHostId, v4Only: true) else {
+            throw NSError(domain: "HproseClient", code: -1, userInfo: [NSLocalizedDescriptionKey: "Unable to resolve access host \(job.accessHostId)"])
         }
 
-        var accessParams = requestParams
-        accessParams["homeupdated"] = true
+        let params: [String: Any] = [
+            "aid": job.appId,
+            "ver": "last",
+            "version": "v2",
+            "pn": 0,
+            "ps": job.pageSize,
+            "userid": job.userId,
+            "appuserid": job.appUserId,
+            "hostid": job.homeHostId,
+            "homeupdated": true,
+        ]
 
         let accessClient = clientPool.getClientByIP(for: accessIP)
+        defer { clientPool.releaseClient(accessClient) }
         accessClient.timeout = 15
-
-        do {
-            let rawResponse = accessClient.invoke("runMApp", withArgs: [HproseInstance.updateFollowingTweetsEntry, accessParams])
-            _ = try Self.unwrapV2Response(rawResponse)
-            print("DEBUG: [update_following_tweets] Synced \(newTweetCount) tweets from home host \(homeHostId) to access host \(accessHostId)")
-        } catch {
-            print("ERROR: [update_following_tweets] Failed to sync access host \(accessHostId): \(error)")
-        }
+        let rawResponse = accessClient.invoke("runMApp", withArgs: [HproseInstance.updateFollowingTweetsEntry, params])
+        _ = try Self.unwrapV2Response(rawResponse)
     }
     
     /// Fetches a page of tweets for a specific user.
@@ -1349,7 +1417,7 @@ final class HproseInstance: ObservableObject {
         }
         
         // Fetch from server using get_tweet API (like Android's fetchTweet)
-        guard let authorClient = author?.hproseClient else {
+        guard let authorBaseUrl = author?.baseUrl else {
             throw NSError(domain: "HproseClient", code: -1, userInfo: [NSLocalizedDescriptionKey: NSLocalizedString("Author client not initialized", comment: "Author client initialization error")])
         }
         
@@ -1363,7 +1431,13 @@ final class HproseInstance: ObservableObject {
         ]
         
         do {
-            let rawResponse = authorClient.invoke("runMApp", withArgs: [entry, params])
+            let rawResponse = try await RPCHedger.shared.invoke(
+                entry: entry,
+                params: params,
+                primary: authorBaseUrl,
+                deadline: RPCDeadline.resolved(defaultSeconds: 15),
+                alternates: providerBaseUrls(for: authorId)
+            ).response
             let unwrappedResponse = try Self.unwrapV2Response(rawResponse)
             
             if let tweetDict = unwrappedResponse as? [String: Any] {
@@ -1475,6 +1549,7 @@ final class HproseInstance: ObservableObject {
                 throw NSError(domain: "HproseInstance", code: -1, userInfo: [NSLocalizedDescriptionKey: "Entry IP not available"])
             }
             let client = clientPool.getClientByIP(for: entryIP)
+            defer { self.clientPool.releaseClient(client) }
 
             let rawResponse = client.invoke("runMApp", withArgs: [entry, params])
             let unwrappedResponse = try Self.unwrapV2Response(rawResponse)
@@ -1824,9 +1899,15 @@ final class HproseInstance: ObservableObject {
         let shouldForceFreshIP = forceFreshIP || trimmedRouteHint == "" || originalBaseUrl == nil || originalBaseUrl?.isEmpty == true
         
         var lastError: Error?
+        let deadline = RPCDeadline.resolved(defaultSeconds: 30)
         
         for attempt in 1...maxRetries {
             var attemptedBaseUrl: String?
+            if attempt > 1 && deadline.hasExpired {
+                // Out of time, not evidence the user is bad: surface the error without blacklisting
+                print("DEBUG: [\(logPrefix)] Deadline passed for userId: \(user.mid) after \(attempt - 1) attempt(s)")
+                throw lastError ?? RPCDeadline.exceededError
+            }
             do {
                 // Resolve a candidate route without mutating the cached User.
                 let candidateBaseUrl = try await resolveCandidateBaseUrl(
@@ -1850,20 +1931,23 @@ final class HproseInstance: ObservableObject {
                     "v4only": v4Only ? "true" : "false"
                 ]
                 
-                let hproseClient = clientPool.getClientByUrl(for: candidateBaseUrl.absoluteString)
-                hproseClient.timeout = 15
-                
-                // Make server call
-                guard let rawResponse = hproseClient.invoke("runMApp", withArgs: [entry, params]) else {
-                    throw HproseError.noResponse(userId: user.mid)
-                }
-                
-                // Check if the response is an error object (network failure case)
-                if let error = rawResponse as? Error {
+                // Make server call, hedged to another provider if the candidate is slow.
+                // The hedger throws transport errors and nil responses.
+                let outcome: RPCHedger.Outcome
+                do {
+                    outcome = try await RPCHedger.shared.invoke(
+                        entry: entry,
+                        params: params,
+                        primary: candidateBaseUrl,
+                        deadline: deadline,
+                        alternates: providerBaseUrls(for: user.mid, v4Only: v4Only)
+                    )
+                } catch {
                     let nsError = error as NSError
                     print("ERROR: [\(logPrefix)] Network error during get_user: userId: \(user.mid), domain: \(nsError.domain), code: \(nsError.code)")
                     throw error
                 }
+                let rawResponse = outcome.response
                 
                 print("DEBUG: [\(logPrefix)] get_user rawResponse received for \(user.mid)")
                 
@@ -1875,7 +1959,7 @@ final class HproseInstance: ObservableObject {
                     user: user,
                     response: response as Any,
                     skipRetryAndBlacklist: skipRetryAndBlacklist,
-                    confirmedBaseUrl: candidateBaseUrl
+                    confirmedBaseUrl: outcome.baseUrl
                 )
                 
                 if success {
@@ -2088,6 +2172,7 @@ final class HproseInstance: ObservableObject {
             throw NSError(domain: "HproseClient", code: -1, userInfo: [NSLocalizedDescriptionKey: NSLocalizedString("Failed to initialize app entry with any URL", comment: "App initialization error")])
         }
         let entryClient = clientPool.getClientByIP(for: entryIP)
+        defer { clientPool.releaseClient(entryClient) }
 
         let providerIP = try await _getProviderIP(mid, v4Only: v4Only, hproseClient: entryClient)
         if providerIP == nil {
@@ -2096,11 +2181,68 @@ final class HproseInstance: ObservableObject {
         return providerIP
     }
     
-    private func _getProviderIP(
+    /// Get every public provider IP for `mid`, without health checks.
+    ///
+    /// Used by multi-source media fetches, which measure providers directly and drop
+    /// failing ones, so probing each IP up front would only add latency. Results are
+    /// cached briefly per mid so several attachments from one author share one lookup.
+    func getProviderIPs(_ mid: MimeiId, v4Only: Bool = false) async throws -> [String] {
+        guard mid != Constants.GUEST_ID else { return [] }
+
+        let cacheKey = "\(mid)_\(v4Only)"
+        if let cached = providerIPListCacheLock.withLock({ providerIPListCache[cacheKey] }),
+           Date().timeIntervalSince(cached.timestamp) < Self.providerIPListCacheTTL {
+            return cached.ips
+        }
+
+        guard let entryIP = try await findEntryIP() else {
+            throw NSError(domain: "HproseClient", code: -1, userInfo: [NSLocalizedDescriptionKey: NSLocalizedString("Failed to initialize app entry with any URL", comment: "App initialization error")])
+        }
+        let entryClient = clientPool.getClientByIP(for: entryIP)
+        defer { clientPool.releaseClient(entryClient) }
+        let ips = try await _getProviderIPList(mid, v4Only: v4Only, hproseClient: entryClient) ?? []
+        // An empty or malformed answer isn't cached, so it can't hold off lookups for the whole TTL
+        if !ips.isEmpty {
+            providerIPListCacheLock.withLock {
+                providerIPListCache[cacheKey] = (ips, Date())
+            }
+        }
+        return ips
+    }
+
+    /// Resolve the author's providers and hand them to the video proxy as alternate
+    /// sources for `mediaID`, so large progressive downloads can pull ranges in parallel.
+    /// Fire-and-forget; failures just leave the single-source path in place.
+    func registerAlternateMediaSources(mediaID: MimeiId, authorId: MimeiId, primaryBaseUrl: URL?) {
+        guard authorId != Constants.GUEST_ID,
+              !LocalHTTPServer.shared.hasAlternateSources(for: mediaID) else { return }
+        Task.detached(priority: .utility) {
+            guard let ips = try? await self.getProviderIPs(authorId), !ips.isEmpty else { return }
+            let primaryHost = primaryBaseUrl.map { NodePoolRegistry.nodeHost(from: $0) }
+            let baseURLs = ips
+                .compactMap { URL(string: "http://\($0)") }
+                .filter { NodePoolRegistry.nodeHost(from: $0) != primaryHost }
+            guard !baseURLs.isEmpty else { return }
+            LocalHTTPServer.shared.registerAlternateSources(for: mediaID, baseURLs: baseURLs)
+        }
+    }
+
+    /// Alternate nodes for hedged reads of `userId`'s data. Resolved only when a hedge fires;
+    /// getProviderIPs caches the list briefly, so a burst of hedges shares one lookup.
+    private func providerBaseUrls(for userId: MimeiId, v4Only: Bool = false) -> () async -> [URL] {
+        { [weak self] in
+            guard let self, let ips = try? await self.getProviderIPs(userId, v4Only: v4Only) else { return [] }
+            return ips.compactMap { URL(string: "http://\($0)") }
+        }
+    }
+
+    /// Call get_provider_ips and return the trimmed public IPs, or nil if the
+    /// response had an unexpected format. Network errors propagate.
+    private func _getProviderIPList(
         _ mid: MimeiId,
-        v4Only: Bool = false,
-        hproseClient: HproseClient? = HproseInstance.shared.appUser.hproseClient
-    ) async throws -> String? {
+        v4Only: Bool,
+        hproseClient: HproseClient?
+    ) async throws -> [String]? {
         let entry = "get_provider_ips"
         let params = [
             "aid": appId,
@@ -2127,18 +2269,29 @@ final class HproseInstance: ObservableObject {
         let unwrappedResponse = try Self.unwrapV2Response(response)
         print("DEBUG: [_getProviderIP][RAW] mid=\(mid), unwrappedResponse=\(providerIPDebugDescription(unwrappedResponse))")
         
-        if let ipList = unwrappedResponse as? [String] {
-            print("DEBUG: [_getProviderIP][RAW] mid=\(mid), rawIPList=\(providerIPDebugDescription(ipList))")
+        guard let ipList = unwrappedResponse as? [String] else {
+            print("DEBUG: [_getProviderIP] Invalid IpList response format")
+            return nil
+        }
+        print("DEBUG: [_getProviderIP][RAW] mid=\(mid), rawIPList=\(providerIPDebugDescription(ipList))")
 
-            // Filter and trim IP addresses, excluding private/reserved ranges
-            let ipAddresses = ipList
-                .map { $0.trimmingCharacters(in: .whitespacesAndNewlines) }
-                .filter { !$0.isEmpty }
-                .filter { Gadget.isValidPublicIpAddress($0) }
+        // Filter and trim IP addresses, excluding private/reserved ranges
+        let ipAddresses = ipList
+            .map { $0.trimmingCharacters(in: .whitespacesAndNewlines) }
+            .filter { !$0.isEmpty }
+            .filter { NodeAddress(hostPort: $0)?.isPublic == true }
 
-            print("DEBUG: [_getProviderIP][RAW] mid=\(mid), filteredPublicIPs=\(providerIPDebugDescription(ipAddresses))")
-            print("DEBUG: [_getProviderIP] Retrieved \(ipAddresses.count) IP address(es) from get_provider_ips API")
-            
+        print("DEBUG: [_getProviderIP][RAW] mid=\(mid), filteredPublicIPs=\(providerIPDebugDescription(ipAddresses))")
+        print("DEBUG: [_getProviderIP] Retrieved \(ipAddresses.count) IP address(es) from get_provider_ips API")
+        return ipAddresses
+    }
+
+    private func _getProviderIP(
+        _ mid: MimeiId,
+        v4Only: Bool = false,
+        hproseClient: HproseClient? = HproseInstance.shared.appUser.hproseClient
+    ) async throws -> String? {
+        if let ipAddresses = try await _getProviderIPList(mid, v4Only: v4Only, hproseClient: hproseClient) {
             // Test IPs two at a time to match Android and avoid stampeding weak nodes.
             let batchSize = 2
             for batchStart in stride(from: 0, to: ipAddresses.count, by: batchSize) {
@@ -2197,7 +2350,6 @@ final class HproseInstance: ObservableObject {
             
             return nil
         }
-        print("DEBUG: [_getProviderIP] Invalid IpList response format")
         return nil
     }
 
@@ -2304,10 +2456,12 @@ final class HproseInstance: ObservableObject {
         request.httpMethod = "HEAD"
         request.cachePolicy = .reloadIgnoringLocalCacheData
 
+        let probeStart = Date()
         do {
             _ = try await URLSession.shared.data(for: request)
             // Any response (any status code) means the server is reachable.
             cacheIP(ip, isHealthy: true)
+            clientPool.recordResult(forIP: ip, latency: Date().timeIntervalSince(probeStart), failed: false)
             print("DEBUG: [isServerHealthy] ✅ \(ip) reachable")
             return true
         } catch {
@@ -2317,6 +2471,7 @@ final class HproseInstance: ObservableObject {
                     print("DEBUG: [isServerHealthy] ❌ \(ip): \(nsError.domain) \(nsError.code)")
                 }
                 cacheIP(ip, isHealthy: false, logFailures: logFailures)
+                clientPool.recordResult(forIP: ip, latency: nil, failed: true)
             }
             return false
         }
@@ -2498,12 +2653,8 @@ final class HproseInstance: ObservableObject {
             print("DEBUG: [login] Creating client for baseUrl: \(baseUrl.absoluteString)")
             let newClient = self.clientPool.getClientByUrl(for: baseUrl.absoluteString)
             newClient.timeout = 30.0  // 30 seconds (login can be slow due to remote node communication)
-            
-            // Release client back to pool when done (no need to close)
-            defer { 
-                // Note: Not releasing back to pool since timeout is configured differently
-                // Let the pool manage lifecycle naturally
-            }
+            // Borrowers set their own timeout, so the client can go back as is
+            defer { self.clientPool.releaseClient(newClient) }
             
             print("DEBUG: [login] Invoking login API...")
             let rawResponse = newClient.invoke("runMApp", withArgs: [entry, params])
@@ -2986,8 +3137,10 @@ final class HproseInstance: ObservableObject {
         // Falls back to appUser.hproseClient if the writable host can't be
         // resolved, so the call still goes out (just risks the stale-payload bug).
         let client: HproseClient
+        var borrowedClient: HproseClient?
         if let writableUrl = try? await appUser.resolveWritableUrl() {
             client = HproseInstance.shared.clientPool.getClientByUrl(for: writableUrl.absoluteString)
+            borrowedClient = client
         } else if let fallback = appUser.hproseClient {
             client = fallback
         } else {
@@ -2995,7 +3148,12 @@ final class HproseInstance: ObservableObject {
         }
         let originalTimeout = client.timeout
         client.timeout = 30.0
-        defer { client.timeout = originalTimeout }
+        defer {
+            client.timeout = originalTimeout
+            if let borrowedClient {
+                clientPool.releaseClient(borrowedClient)
+            }
+        }
         let rawResponse = client.invoke("runMApp", withArgs: [entry, params])
         let unwrappedResponse = try Self.unwrapV2Response(rawResponse)
 
@@ -3606,270 +3764,241 @@ final class HproseInstance: ObservableObject {
     // MARK: - Media Processing
     /// Consolidated media processing class that handles all media-related operations (images, videos, audio, documents)
     class MediaProcessor {
-        /// Robust file type detection utility using multiple methods
-        private class FileTypeDetector {
-            
-            /// Comprehensive file signature database
-            private static let fileSignatures: [(signature: [UInt8], mediaType: MediaType, name: String)] = [
-                // Image formats
-                ([0xFF, 0xD8, 0xFF], .image, "JPEG"),
-                ([0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A], .image, "PNG"),
-                ([0x47, 0x49, 0x46, 0x38, 0x37, 0x61], .image, "GIF87a"),
-                ([0x47, 0x49, 0x46, 0x38, 0x39, 0x61], .image, "GIF89a"),
-                ([0x42, 0x4D], .image, "BMP"),
-                ([0x49, 0x49, 0x2A, 0x00], .image, "TIFF (Intel)"),
-                ([0x4D, 0x4D, 0x00, 0x2A], .image, "TIFF (Motorola)"),
-                ([0x52, 0x49, 0x46, 0x46], .image, "WebP/RIFF"), // Will be refined below
-                
-                // Video formats - MP4/MOV family
-                ([0x00, 0x00, 0x00, 0x18, 0x66, 0x74, 0x79, 0x70], .video, "MP4/MOV"), // Will be refined below
-                ([0x00, 0x00, 0x00, 0x20, 0x66, 0x74, 0x79, 0x70], .video, "MP4/MOV"), // Will be refined below
-                ([0x00, 0x00, 0x00, 0x1C, 0x66, 0x74, 0x79, 0x70], .video, "MP4/MOV"), // Will be refined below
-                ([0x00, 0x00, 0x00, 0x14, 0x66, 0x74, 0x79, 0x70], .video, "MP4/MOV"), // Will be refined below
-                
-                // Other video formats
-                ([0x1A, 0x45, 0xDF, 0xA3], .video, "MKV/WebM"),
-                ([0x46, 0x4C, 0x56], .video, "FLV"),
-                ([0x30, 0x26, 0xB2, 0x75, 0x8E, 0x66, 0xCF, 0x11], .video, "WMV/ASF"),
-                ([0x52, 0x49, 0x46, 0x46], .video, "AVI"), // Will be refined below
-                
-                // Audio formats
-                ([0x49, 0x44, 0x33], .audio, "MP3 (ID3)"),
-                ([0xFF, 0xFB], .audio, "MP3 (MPEG)"),
-                ([0xFF, 0xF3], .audio, "MP3 (MPEG)"),
-                ([0xFF, 0xF2], .audio, "MP3 (MPEG)"),
-                ([0x66, 0x4C, 0x61, 0x43], .audio, "FLAC"),
-                ([0x4F, 0x67, 0x67, 0x53], .audio, "OGG"),
-                
-                // Document formats
-                ([0x25, 0x50, 0x44, 0x46], .pdf, "PDF"),
-                ([0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1], .word, "Office Document"), // Will be refined below
-                ([0x50, 0x4B, 0x03, 0x04], .zip, "ZIP"),
-                ([0x50, 0x4B, 0x05, 0x06], .zip, "ZIP"),
-                ([0x50, 0x4B, 0x07, 0x08], .zip, "ZIP"),
-                
-                // Text formats
-                ([0x3C, 0x21, 0x44, 0x4F, 0x43, 0x54, 0x59, 0x50, 0x45], .html, "HTML"),
-                ([0x3C, 0x68, 0x74, 0x6D, 0x6C], .html, "HTML"),
-                ([0x3C, 0x48, 0x54, 0x4D, 0x4C], .html, "HTML"),
+        /// Table-driven magic-byte sniffer. Classification reads only the first 4KB, plus the
+        /// ZIP central directory (OOXML) or the OLE directory sector (legacy Office).
+        private enum FileTypeDetector {
+            private static let headLength = 4096
+            
+            private struct Signature {
+                let offset: Int
+                let bytes: [UInt8]
+                let name: String
+                let classify: (_ data: Data, _ head: [UInt8]) -> MediaType?
+                
+                init(_ bytes: [UInt8], at offset: Int = 0, _ name: String, _ mediaType: MediaType) {
+                    self.offset = offset
+                    self.bytes = bytes
+                    self.name = name
+                    self.classify = { _, _ in mediaType }
+                }
+                
+                init(_ bytes: [UInt8], at offset: Int = 0, _ name: String, classify: @escaping (_ data: Data, _ head: [UInt8]) -> MediaType?) {
+                    self.offset = offset
+                    self.bytes = bytes
+                    self.name = name
+                    self.classify = classify
+                }
+                
+                func matches(_ head: [UInt8]) -> Bool {
+                    guard head.count >= offset + bytes.count else { return false }
+                    return head[offset..<(offset + bytes.count)].elementsEqual(bytes)
+                }
+            }
+            
+            /// Checked in order; longer and more specific signatures come before short ones
+            private static let signatures: [Signature] = [
+                // Images
+                Signature([0xFF, 0xD8, 0xFF], "JPEG", .image),
+                Signature([0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A], "PNG", .image),
+                Signature(Array("GIF87a".utf8), "GIF87a", .image),
+                Signature(Array("GIF89a".utf8), "GIF89a", .image),
+                Signature([0x49, 0x49, 0x2A, 0x00], "TIFF (Intel)", .image),
+                Signature([0x4D, 0x4D, 0x00, 0x2A], "TIFF (Motorola)", .image),
+                
+                // ISO BMFF (MP4/MOV/M4A/HEIC/AVIF): decided by the ftyp brands
+                Signature(Array("ftyp".utf8), at: 4, "ISO BMFF") { _, head in classifyISOBMFF(head) },
+                // QuickTime files without ftyp start straight with a moov/mdat/wide/free atom
+                Signature(Array("moov".utf8), at: 4, "QuickTime", .video),
+                Signature(Array("mdat".utf8), at: 4, "QuickTime", .video),
+                Signature(Array("wide".utf8), at: 4, "QuickTime", .video),
+                
+                // RIFF family
+                Signature(Array("RIFF".utf8), "RIFF") { _, head in classifyRIFF(head) },
+                Signature(Array("FORM".utf8), "IFF") { _, head in
+                    let form = ascii(head, 8, 4)
+                    return form == "AIFF" || form == "AIFC" ? .audio : nil
+                },
+                
+                // Other video containers
+                Signature([0x1A, 0x45, 0xDF, 0xA3], "MKV/WebM", .video),
+                Signature(Array("FLV".utf8), "FLV", .video),
+                Signature([0x30, 0x26, 0xB2, 0x75, 0x8E, 0x66, 0xCF, 0x11], "WMV/ASF", .video),
+                Signature([0x00, 0x00, 0x01, 0xBA], "MPEG-PS", .video),
+                Signature([0x47], "MPEG-TS") { _, head in
+                    // Sync byte repeats every 188-byte packet
+                    head.count > 376 && head[188] == 0x47 && head[376] == 0x47 ? .video : nil
+                },
+                
+                // Audio
+                Signature(Array("ID3".utf8), "MP3 (ID3)", .audio),
+                Signature(Array("fLaC".utf8), "FLAC", .audio),
+                Signature(Array("OggS".utf8), "Ogg") { _, head in
+                    // Theora/VP8/Dirac in the first page means video; Vorbis/Opus/FLAC audio
+                    let firstPage = String(decoding: head.prefix(128), as: UTF8.self)
+                    return firstPage.contains("theora") || firstPage.contains("OVP80") || firstPage.contains("fishead") ? .video : .audio
+                },
+                Signature(Array("#!AMR".utf8), "AMR", .audio),
+                Signature(Array("caff".utf8), "CAF", .audio),
+                Signature([0xFF], "MPEG audio") { _, head in classifyMPEGAudioFrame(head) },
+                
+                // Documents and archives
+                Signature(Array("%PDF".utf8), "PDF", .pdf),
+                Signature([0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1], "OLE2") { data, head in classifyOLE(data, head) },
+                Signature([0x50, 0x4B, 0x03, 0x04], "ZIP") { data, _ in classifyZIP(data) },
+                Signature([0x50, 0x4B, 0x05, 0x06], "ZIP (empty)", .zip),
+                Signature([0x50, 0x4B, 0x07, 0x08], "ZIP (spanned)", .zip),
+                
+                // BMP last among images: a two-byte magic collides with text more easily
+                Signature(Array("BM".utf8), "BMP") { _, head in
+                    // Header size field at offset 14 is 12, 40, 52, 56, 108 or 124
+                    head.count >= 18 && [12, 40, 52, 56, 108, 124].contains(Int(head[14])) && head[15] == 0 ? .image : nil
+                },
             ]
             
-            /// Detect file type using multiple methods
-            static func detectFromData(_ data: Data) async -> MediaType {
-                // Method 1: Try iOS UniformTypeIdentifiers first (most reliable)
-                if let mediaType = detectUsingUTType(data) {
-                    return mediaType
-                }
-                
-                // Method 2: Try comprehensive file signature detection
-                if let mediaType = detectUsingFileSignatures(data) {
-                    return mediaType
-                }
-                
-                // Method 3: Try AVFoundation for media files
-                if let mediaType = await detectUsingAVFoundation(data) {
-                    return mediaType
-                }
-                
-                return .unknown
-            }
-            
-            /// Detect using iOS UniformTypeIdentifiers
-            private static func detectUsingUTType(_ data: Data) -> MediaType? {
-                guard data.count >= 512 else { return nil }
+            /// Detect file type from content
+            static func detectFromData(_ data: Data) -> MediaType {
+                let head = [UInt8](data.prefix(headLength))
+                guard !head.isEmpty else { return .unknown }
                 
-                // Create a temporary file to use UTType detection
-                let tempURL = FileManager.default.temporaryDirectory.appendingPathComponent("\(UUID().uuidString).tmp")
-                
-                do {
-                    try data.write(to: tempURL)
-                    defer { try? FileManager.default.removeItem(at: tempURL) }
-                    
-                    let resourceValues = try tempURL.resourceValues(forKeys: [.typeIdentifierKey])
-                    if let typeIdentifier = resourceValues.typeIdentifier {
-                        // Map UTI to MediaType
-                        if typeIdentifier.hasPrefix("public.image") || 
-                            typeIdentifier.contains("jpeg") || 
-                            typeIdentifier.contains("png") || 
-                            typeIdentifier.contains("gif") || 
-                            typeIdentifier.contains("heic") || 
-                            typeIdentifier.contains("heif") ||
-                            typeIdentifier.contains("tiff") ||
-                            typeIdentifier.contains("bmp") ||
-                            typeIdentifier.contains("webp") {
-                            return .image
-                        } else if typeIdentifier.hasPrefix("public.movie") || 
-                                    typeIdentifier.contains("quicktime") || 
-                                    typeIdentifier.contains("movie") ||
-                                    typeIdentifier.contains("video") ||
-                                    typeIdentifier.contains("mp4") ||
-                                    typeIdentifier.contains("mov") ||
-                                    typeIdentifier.contains("m4v") ||
-                                    typeIdentifier.contains("avi") ||
-                                    typeIdentifier.contains("mkv") ||
-                                    typeIdentifier.contains("wmv") ||
-                                    typeIdentifier.contains("flv") ||
-                                    typeIdentifier.contains("webm") {
-                            return .video
-                        } else if typeIdentifier.hasPrefix("public.audio") || 
-                                    typeIdentifier.contains("audio") ||
-                                    typeIdentifier.contains("mp3") ||
-                                    typeIdentifier.contains("m4a") ||
-                                    typeIdentifier.contains("wav") ||
-                                    typeIdentifier.contains("aac") ||
-                                    typeIdentifier.contains("flac") ||
-                                    typeIdentifier.contains("ogg") {
-                            return .audio
-                        } else if typeIdentifier == "public.composite-content" || 
-                                    typeIdentifier.contains("pdf") {
-                            return .pdf
-                        } else if typeIdentifier == "public.zip-archive" || 
-                                    typeIdentifier.contains("zip") {
-                            return .zip
-                        }
+                for signature in signatures where signature.matches(head) {
+                    if let mediaType = signature.classify(data, head) {
+                        return mediaType
                     }
-                } catch {
-                    // Silent fail - try next method
                 }
-                
-                return nil
+                return classifyText(head)
             }
             
-            /// Detect using comprehensive file signatures
-            private static func detectUsingFileSignatures(_ data: Data) -> MediaType? {
-                guard data.count >= 12 else { return nil }
-                
-                let bytes = [UInt8](data.prefix(12))
-                
-                // Check basic signatures first
-                for (signature, mediaType, name) in fileSignatures {
-                    if bytes.starts(with: signature) {
-                        // Refine detection for complex formats
-                        switch mediaType {
-                        case .image where name == "WebP/RIFF":
-                            return refineRIFFDetection(data, bytes)
-                        case .video where name == "MP4/MOV":
-                            return refineMP4Detection(data, bytes)
-                        case .video where name == "AVI":
-                            return refineAVIDetection(data, bytes)
-                        case .word where name == "Office Document":
-                            return refineOfficeDetection(data, bytes)
-                        default:
-                            return mediaType
-                        }
-                    }
-                }
-                
-                // Special handling for HEIC/HEIF
-                if bytes.count >= 12 {
-                    let ftypString = String(bytes: bytes[4...11], encoding: .ascii) ?? ""
-                    if ftypString.hasPrefix("ftyp") && (ftypString.contains("heic") || ftypString.contains("heix") || 
-                                                        ftypString.contains("heis") || ftypString.contains("heim") ||
-                                                        ftypString.contains("hevc") || ftypString.contains("hevx")) {
-                        return .image
-                    }
+            // MARK: - Container Classifiers
+            
+            private static let imageBrands: Set<String> = ["heic", "heix", "heim", "heis", "hevc", "hevx", "mif1", "msf1", "avif", "avis"]
+            private static let audioBrands: Set<String> = ["M4A ", "M4B ", "M4P ", "F4A ", "F4B "]
+            
+            /// Major brand at 8, compatible brands after the minor version at 16
+            private static func classifyISOBMFF(_ head: [UInt8]) -> MediaType {
+                let boxSize = head.count >= 4 ? Int(head[0]) << 24 | Int(head[1]) << 16 | Int(head[2]) << 8 | Int(head[3]) : 0
+                var brands = [ascii(head, 8, 4)]
+                var offset = 16
+                while offset + 4 <= min(boxSize, head.count) {
+                    brands.append(ascii(head, offset, 4))
+                    offset += 4
                 }
-                
-                // Check for plain text
-                if data.count >= 512 {
-                    let textCheck = data.prefix(512)
-                    if !textCheck.contains(0) && textCheck.allSatisfy({ $0 >= 32 || $0 == 9 || $0 == 10 || $0 == 13 }) {
-                        return .txt
-                    }
+                if let major = brands.first, audioBrands.contains(major) { return .audio }
+                if brands.contains(where: { imageBrands.contains($0) }) && !brands.contains(where: { $0.hasPrefix("mp4") || $0 == "isom" || $0 == "qt  " }) {
+                    return .image
                 }
-                
-                return nil
+                if let major = brands.first, imageBrands.contains(major) { return .image }
+                return .video
             }
             
-            /// Detect using AVFoundation for media files
-            private static func detectUsingAVFoundation(_ data: Data) async -> MediaType? {
-                guard data.count >= 1024 else { return nil }
-                
-                let tempURL = FileManager.default.temporaryDirectory.appendingPathComponent("\(UUID().uuidString).tmp")
-                
-                do {
-                    try data.write(to: tempURL)
-                    defer { try? FileManager.default.removeItem(at: tempURL) }
-                    
-                    let asset = AVURLAsset(url: tempURL)
-                    
-                    let videoTracks = try await asset.loadTracks(withMediaType: .video)
-                    if !videoTracks.isEmpty {
-                        return .video
-                    }
-                    
-                    let audioTracks = try await asset.loadTracks(withMediaType: .audio)
-                    if !audioTracks.isEmpty {
-                        return .audio
-                    }
-                    
-                } catch {
-                    // Silent fail
-                }
-                
-                return nil
+            private static func classifyRIFF(_ head: [UInt8]) -> MediaType? {
+                switch ascii(head, 8, 4) {
+                case "WEBP": return .image
+                case "AVI ", "AVIX": return .video
+                case "WAVE": return .audio
+                default: return nil
+                }
+            }
+            
+            /// MPEG audio frame sync (11 set bits), or an ADTS AAC header
+            private static func classifyMPEGAudioFrame(_ head: [UInt8]) -> MediaType? {
+                guard head.count >= 4, head[1] & 0xE0 == 0xE0 else { return nil }
+                let layerBits = (head[1] >> 1) & 0x03
+                let isADTS = head[1] & 0xF6 == 0xF0
+                let bitrateIndex = head[2] >> 4
+                return isADTS || (layerBits != 0 && bitrateIndex != 0x0F) ? .audio : nil
+            }
+            
+            /// Legacy Office: look up stream names in the first directory sector
+            private static func classifyOLE(_ data: Data, _ head: [UInt8]) -> MediaType {
+                guard head.count >= 52 else { return .word }
+                let sectorShift = Int(head[30]) | Int(head[31]) << 8
+                let sectorSize = 1 << min(max(sectorShift, 9), 12)
+                let directorySector = Int(head[48]) | Int(head[49]) << 8 | Int(head[50]) << 16 | Int(head[51]) << 24
+                let start = (directorySector + 1) * sectorSize
+                guard directorySector >= 0, start + sectorSize <= data.count else { return .word }
+                
+                let base = data.startIndex
+                let directory = data[(base + start)..<(base + start + sectorSize)]
+                // Directory entry names are UTF-16LE
+                let names = String(decoding: directory.enumerated().compactMap { $0.offset % 2 == 0 ? $0.element : nil }, as: UTF8.self)
+                if names.contains("WordDocument") { return .word }
+                if names.contains("Workbook") || names.contains("Book") { return .excel }
+                if names.contains("PowerPoint Document") { return .ppt }
+                return .word
             }
             
-            // MARK: - Refinement Methods
-            
-            private static func refineRIFFDetection(_ data: Data, _ bytes: [UInt8]) -> MediaType? {
-                guard bytes.count >= 12 else { return .image }
-                
-                let format = String(bytes: bytes[8...11], encoding: .ascii) ?? ""
-                switch format {
-                case "WEBP":
-                    return .image
-                case "AVI ":
-                    return .video
-                case "WAVE":
-                    return .audio
-                default:
-                    return .image // Default to image for other RIFF formats
+            /// OOXML is a ZIP whose central directory lists word/, xl/ or ppt/ parts
+            private static func classifyZIP(_ data: Data) -> MediaType {
+                let eocdSignature: [UInt8] = [0x50, 0x4B, 0x05, 0x06]
+                let tail = [UInt8](data.suffix(22 + 0xFFFF))
+                guard tail.count >= 22,
+                      let eocd = stride(from: tail.count - 22, through: 0, by: -1).first(where: { tail[$0..<($0 + 4)].elementsEqual(eocdSignature) }) else {
+                    return .zip
+                }
+                let directorySize = Int(le32(tail, eocd + 12))
+                let directoryOffset = Int(le32(tail, eocd + 16))
+                guard directoryOffset + directorySize <= data.count else { return .zip }
+                
+                let base = data.startIndex
+                let directory = [UInt8](data[(base + directoryOffset)..<(base + directoryOffset + min(directorySize, 1 << 20))])
+                var offset = 0
+                while offset + 46 <= directory.count, directory[offset] == 0x50, directory[offset + 1] == 0x4B {
+                    let nameLength = Int(le16(directory, offset + 28))
+                    let extraLength = Int(le16(directory, offset + 30))
+                    let commentLength = Int(le16(directory, offset + 32))
+                    guard offset + 46 + nameLength <= directory.count else { break }
+                    let name = ascii(directory, offset + 46, nameLength)
+                    if name.hasPrefix("word/") { return .word }
+                    if name.hasPrefix("xl/") { return .excel }
+                    if name.hasPrefix("ppt/") { return .ppt }
+                    offset += 46 + nameLength + extraLength + commentLength
                 }
+                return .zip
             }
             
-            private static func refineMP4Detection(_ data: Data, _ bytes: [UInt8]) -> MediaType? {
-                guard bytes.count >= 12 else { return .video }
+            /// HTML by its leading tag, otherwise plain text if the head is valid UTF-8 without NULs
+            private static func classifyText(_ head: [UInt8]) -> MediaType {
+                var bytes = head[...]
+                if bytes.starts(with: [0xEF, 0xBB, 0xBF]) { bytes = bytes.dropFirst(3) }
+                guard !bytes.contains(0) else { return .unknown }
                 
-                let codecString = String(bytes: bytes[8...11], encoding: .ascii) ?? ""
-                
-                // Video codecs
-                if codecString.contains("mp4") || codecString.contains("M4V") || codecString.contains("isom") ||
-                    codecString.contains("iso2") || codecString.contains("avc1") || codecString.contains("mp41") ||
-                    codecString.contains("mp42") || codecString.contains("3gp") || codecString.contains("qt") ||
-                    codecString.contains("M4A") || codecString.contains("M4B") || codecString.contains("M4P") {
-                    return .video
+                let leading = String(decoding: bytes.prefix(64), as: UTF8.self)
+                    .trimmingCharacters(in: .whitespacesAndNewlines)
+                    .lowercased()
+                if leading.hasPrefix("<!doctype html") || leading.hasPrefix("<html") {
+                    return .html
                 }
                 
-                // Audio codecs
-                if codecString.contains("M4A") || codecString.contains("M4B") || codecString.contains("M4P") {
-                    return .audio
+                // A multi-byte sequence may be cut at the 4KB boundary; drop the partial character
+                var checked = bytes
+                if head.count == headLength {
+                    while let last = checked.last, last & 0xC0 == 0x80, checked.count > bytes.count - 3 {
+                        checked = checked.dropLast()
+                    }
+                    if let last = checked.last, last >= 0xC0 {
+                        checked = checked.dropLast()
+                    }
                 }
-                
-                return .video // Default to video for MP4 containers
+                guard String(bytes: checked, encoding: .utf8) != nil,
+                      checked.allSatisfy({ $0 >= 32 || $0 == 9 || $0 == 10 || $0 == 13 }) else {
+                    return .unknown
+                }
+                return .txt
             }
             
-            private static func refineAVIDetection(_ data: Data, _ bytes: [UInt8]) -> MediaType? {
-                guard bytes.count >= 12 else { return .video }
-                
-                let format = String(bytes: bytes[8...11], encoding: .ascii) ?? ""
-                return format == "AVI " ? .video : .video // Default to video
+            // MARK: - Byte Helpers
+            
+            private static func ascii(_ bytes: [UInt8], _ offset: Int, _ length: Int) -> String {
+                guard offset >= 0, length >= 0, offset + length <= bytes.count else { return "" }
+                return String(decoding: bytes[offset..<(offset + length)], as: UTF8.self)
             }
             
-            private static func refineOfficeDetection(_ data: Data, _ bytes: [UInt8]) -> MediaType? {
-                guard data.count >= 512 else { return .word }
-                
-                let oleHeader = data.prefix(512)
-                if let oleString = String(data: oleHeader, encoding: .ascii) {
-                    if oleString.contains("WordDocument") {
-                        return .word
-                    } else if oleString.contains("Workbook") || oleString.contains("Excel") {
-                        return .excel
-                    } else if oleString.contains("PowerPoint") {
-                        return .ppt
-                    }
-                }
-                return .word // Default to Word for OLE files
+            private static func le16(_ bytes: [UInt8], _ offset: Int) -> UInt16 {
+                UInt16(bytes[offset]) | UInt16(bytes[offset + 1]) << 8
+            }
+            
+            private static func le32(_ bytes: [UInt8], _ offset: Int) -> UInt32 {
+                UInt32(bytes[offset]) | UInt32(bytes[offset + 1]) << 8 | UInt32(bytes[offset + 2]) << 16 | UInt32(bytes[offset + 3]) << 24
             }
         }
         
@@ -4160,7 +4289,7 @@ final class HproseInstance: ObservableObject {
                 return .html
             default:
                 // Analyze file header for unknown types
-                let detectedType = await FileTypeDetector.detectFromData(data)
+                let detectedType = FileTypeDetector.detectFromData(data)
                 print("Detected type via file header: \(detectedType.rawValue)")
                 return detectedType
             }
@@ -4237,7 +4366,7 @@ final class HproseInstance: ObservableObject {
                     isNormalized: isNormalized,
                     progressCallback: { progress in
                         DispatchQueue.main.async {
-                            progressCallback?(progress.stage, 10 + Int(Double(progress.progress) * 0.2)) // 10-30% for conversion
+                            progressCallback?(progress.displayStage, 10 + Int(Double(progress.progress) * 0.2)) // 10-30% for conversion
                         }
                     }
                 ) { result in
@@ -6142,23 +6271,22 @@ final class HproseInstance: ObservableObject {
             data: NSData,
             chunkNumber: Int
         ) async throws -> Any {
-            // Add 3 minute timeout for each chunk upload (handles slow connections)
-            return try await withThrowingTaskGroup(of: Any.self) { group in
-                group.addTask {
-                    let rawResponse = uploadClient.invoke("runMApp", withArgs: ["upload_ipfs", request, [data]])
-                    return try HproseInstance.unwrapV2Response(rawResponse) as Any
-                }
-                
-                group.addTask {
-                    try await Task.sleep(nanoseconds: 180_000_000_000) // 180 seconds (3 minutes)
-                    throw NSError(domain: "MediaProcessor", code: -1, userInfo: [NSLocalizedDescriptionKey: "Upload timeout - chunk \(chunkNumber) took too long"])
-                }
-                
-                // Return the first result (either success or timeout)
-                let result = try await group.next()!
-                group.cancelAll()
-                return result
+            // Up to 3 minutes per chunk (handles slow connections), less if the upload's deadline is nearer.
+            // The timeout is enforced by the transport: a racing sleep can't stop a blocking invoke,
+            // and the task group would wait for it anyway.
+            let deadline = RPCDeadline.resolved(defaultSeconds: 180)
+            guard !deadline.hasExpired else {
+                throw NSError(domain: "MediaProcessor", code: -1, userInfo: [NSLocalizedDescriptionKey: "Upload timeout - chunk \(chunkNumber) took too long"])
+            }
+            let originalTimeout = uploadClient.timeout
+            uploadClient.timeout = deadline.attemptTimeout(cap: 180)
+            defer { uploadClient.timeout = originalTimeout }
+            
+            let rawResponse = uploadClient.invoke("runMApp", withArgs: ["upload_ipfs", request, [data]])
+            if let error = rawResponse as? NSError, error.code == NSURLErrorTimedOut {
+                throw NSError(domain: "MediaProcessor", code: -1, userInfo: [NSLocalizedDescriptionKey: "Upload timeout - chunk \(chunkNumber) took too long"])
             }
+            return try HproseInstance.unwrapV2Response(rawResponse) as Any
         }
     }
     
@@ -6278,19 +6406,20 @@ final class HproseInstance: ObservableObject {
     private func withRetry<T>(_ block: () async throws -> T) async throws -> T {
         var attempt = 0
         let maxAttempts = 2 // Initial attempt + 1 retry
+        let deadline = RPCDeadline.resolved(defaultSeconds: 45)
         
         while attempt < maxAttempts {
             attempt += 1
             do {
-                return try await block()
+                return try await RPCDeadline.withDeadline(deadline, operation: block)
             } catch {
                 print("DEBUG: [withRetry] Attempt \(attempt)/\(maxAttempts) failed: \(error)")
                 
                 if attempt < maxAttempts {
-                    // Wait 1 second before retry
+                    // Wait 1 second before retry, unless the operation's deadline would pass first
                     let delay: UInt64 = 1_000_000_000 // 1 second
                     print("DEBUG: [withRetry] Retrying in 1 second...")
-                    try await Task.sleep(nanoseconds: delay)
+                    try await deadline.sleepBeforeRetry(nanoseconds: delay)
                     
                     // Refresh appUser from server instead of full app reinitialization
                     // IP re-resolution is automatically handled by fetchUser's internal retry mechanism
@@ -7555,7 +7684,9 @@ final class HproseInstance: ObservableObject {
             print("DEBUG: [getHostIP] Using entry IP to refresh appUser: \(entryIP)")
             
             // Refresh appUser's IP via entry
-            if let newAppUserIP = try await _getProviderIP(appUser.mid, v4Only: v4Only, hproseClient: clientPool.getClientByIP(for: entryIP)) {
+            let entryClient = clientPool.getClientByIP(for: entryIP)
+            defer { clientPool.releaseClient(entryClient) }
+            if let newAppUserIP = try await _getProviderIP(appUser.mid, v4Only: v4Only, hproseClient: entryClient) {
                 await applyBaseUrlIfNeeded(appUser, url: URL(string: "http://\(newAppUserIP)")!, reason: "getHostIP appUser refresh")
                 print("DEBUG: [getHostIP] ✅ AppUser refreshed with new IP: \(newAppUserIP)")
             } else {
@@ -617,69 +617,31 @@ class ImageCacheManager: @unchecked Sendable {
         // Return immediately without waiting for compression
         return targetImage
     }
-    
-    private func compressImageToSize(_ image: UIImage, maxSize: Int) -> Data {
-        // First, strip alpha channel if image is opaque to avoid ImageIO warnings
-        let opaqueImage: UIImage
-        if let alphaInfo = image.cgImage?.alphaInfo,
-           alphaInfo == .none || alphaInfo == .noneSkipLast || alphaInfo == .noneSkipFirst {
-            // Image is already opaque, use as-is
-            opaqueImage = image
-        } else {
-            // MODERN API: Use UIGraphicsImageRenderer instead of old UIGraphicsBeginImageContext
-            // This is more efficient and thread-safe
-            let renderer = UIGraphicsImageRenderer(size: image.size, format: UIGraphicsImageRendererFormat.default())
-            opaqueImage = renderer.image { context in
-                // Set opaque background
-                UIColor.white.setFill()
-                context.fill(CGRect(origin: .zero, size: image.size))
-                // Draw image on top
-                image.draw(in: CGRect(origin: .zero, size: image.size))
-            }
-        }
-        
-        var compression: CGFloat = 1.0
-        
-        // Try to get initial JPEG data (JPEG doesn't support alpha, so this will be opaque)
-        guard var data = opaqueImage.jpegData(compressionQuality: compression) else {
-            print("DEBUG: [ImageCacheManager] Failed to create JPEG data from image")
-            // Fallback to PNG if JPEG fails, but PNG should also be without alpha now
-            return opaqueImage.pngData() ?? Data()
-        }
-        
-        // Reduce quality until size is under maxSize
-        while data.count > maxSize && compression > 0.1 {
-            compression -= 0.1
-            guard let newData = opaqueImage.jpegData(compressionQuality: compression) else {
-                print("DEBUG: [ImageCacheManager] Failed to create JPEG data with compression \(compression)")
-                break
+
+    /// Cache an already-decoded image (e.g. an avatar variant) without re-decoding it.
+    /// Posts no `.imageCached`; callers that derive images know when they are ready.
+    func cacheImage(_ image: UIImage, for attachment: MimeiFileType) {
+        guard let key = getCacheKey(for: attachment) else { return }
+        cacheImageInMemory(image, forKey: "\(key)_compressed")
+
+        Task.detached(priority: .utility) { [weak self] in
+            guard let self = self, let data = image.jpegData(compressionQuality: 0.85) else { return }
+            do {
+                try data.write(to: self.getCompressedCacheFileURL(for: key))
+            } catch {
+                print("DEBUG: [ImageCacheManager] Failed to write image to disk for \(key): \(error)")
             }
-            data = newData
         }
-        
-        // If still too large, reduce image size
-        if data.count > maxSize {
-            let scale = sqrt(Double(maxSize) / Double(data.count))
-            let newSize = CGSize(
-                width: opaqueImage.size.width * scale,
-                height: opaqueImage.size.height * scale
-            )
-            
-            // Use opaque: true to ensure no alpha channel
-            UIGraphicsBeginImageContextWithOptions(newSize, true, 1.0)
-            opaqueImage.draw(in: CGRect(origin: .zero, size: newSize))
-            let resizedImage = UIGraphicsGetImageFromCurrentImageContext()
-            UIGraphicsEndImageContext()
-            
-            if let resizedImage = resizedImage,
-               let resizedData = resizedImage.jpegData(compressionQuality: 0.8) {
-                data = resizedData
-            } else {
-                print("DEBUG: [ImageCacheManager] Failed to create JPEG data from resized image")
-            }
+    }
+
+    private func compressImageToSize(_ image: UIImage, maxSize: Int) -> Data {
+        // Probe + at most three quality encodes + one fallback; see TargetSizeJPEGEncoder
+        if let result = TargetSizeJPEGEncoder.encode(image, maxBytes: maxSize) {
+            print("DEBUG: [ImageCacheManager] Encoded \(result.data.count) bytes at quality \(String(format: "%.2f", result.quality)), max \(result.maxPixelSize)px in \(result.encodeCount) encodes")
+            return result.data
         }
-        
-        return data
+        print("DEBUG: [ImageCacheManager] Failed to create JPEG data from image")
+        return image.jpegData(compressionQuality: 0.7) ?? Data()
     }
     
     func loadAndCacheImage(from url: URL, for attachment: MimeiFileType, priority: ImageLoadingPriority = .normal) async -> UIImage? {
@@ -848,6 +810,41 @@ class ImageCacheManager: @unchecked Sendable {
         return result
     }
     
+    /// The original image file on disk, downloaded if needed, without decoding it. Lets callers
+    /// inspect the header first and pick a decode strategy (see LargeImagePyramid).
+    func originalImageFile(from url: URL, for attachment: MimeiFileType) async -> URL? {
+        guard let key = getCacheKey(for: attachment) else {
+            print("DEBUG: [ImageCacheManager] Cannot load original image file - no cache key available")
+            return nil
+        }
+        let fileURL = getOriginalCacheFileURL(for: key)
+        if fileManager.fileExists(atPath: fileURL.path) {
+            return fileURL
+        }
+
+        do {
+            var request = URLRequest(url: url)
+            request.timeoutInterval = Constants.IMAGE_LOAD_TIMEOUT
+            request.cachePolicy = .returnCacheDataElseLoad
+
+            let (tempURL, response) = try await URLSession.shared.download(for: request)
+            defer {
+                try? FileManager.default.removeItem(at: tempURL)
+            }
+            guard let httpResponse = response as? HTTPURLResponse,
+                  (200...299).contains(httpResponse.statusCode) else {
+                print("Error: Invalid response for original image file at \(url)")
+                return nil
+            }
+            try? fileManager.removeItem(at: fileURL)
+            try fileManager.moveItem(at: tempURL, to: fileURL)
+            return fileURL
+        } catch {
+            print("Error downloading original image file from \(url): \(error.localizedDescription)")
+            return nil
+        }
+    }
+
     private func getOriginalImage(forKey key: String) -> UIImage? {
         let cacheKey = "\(key)_original"
         if let recentImage = recentImageFromMemory(forKey: cacheKey) {
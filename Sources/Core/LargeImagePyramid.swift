@@ -0,0 +1,359 @@
+import UIKit
+import ImageIO
+
+/// Decoded-tile budget for one media browser session. Tiles beyond `totalCostLimit` are
+/// evicted and re-read from disk, so zooming around a huge image never holds more than
+/// this many decoded bytes on top of what Core Animation keeps on screen.
+final class LargeImageTileCache: @unchecked Sendable {
+    private let cache = NSCache<NSString, CGImage>()
+
+    init(totalCostLimit: Int = 64 * 1024 * 1024) {
+        cache.totalCostLimit = totalCostLimit
+    }
+
+    fileprivate func tile(forKey key: String) -> CGImage? {
+        cache.object(forKey: key as NSString)
+    }
+
+    fileprivate func store(_ tile: CGImage, forKey key: String) {
+        cache.setObject(tile, forKey: key as NSString, cost: tile.bytesPerRow * tile.height)
+    }
+
+    func removeAll() {
+        cache.removeAllObjects()
+    }
+}
+
+/// Disk-backed tile pyramid for images too large to decode whole (panoramas, tall screenshots).
+///
+/// Level 0 is full resolution in `tileSize` tiles; each level above halves it, up to a level
+/// that fits one tile. Level 0 is cut from the source one strip of rows at a time and upper
+/// levels are built from the four tiles below, so building never decodes the whole image.
+/// The browser shows a screen-sized ImageIO thumbnail first and draws only the visible tiles
+/// of the level that matches the current zoom.
+final class LargeImagePyramid: @unchecked Sendable {
+    struct Metadata: Codable, Equatable {
+        let width: Int
+        let height: Int
+        let tileSize: Int
+        let levelCount: Int
+        /// Size of the source file the pyramid was cut from; a different file rebuilds it
+        let sourceByteCount: Int
+    }
+
+    let metadata: Metadata
+    let sourceURL: URL
+    private let directory: URL
+    private let tileCache: LargeImageTileCache
+
+    static let tileSize = 256
+    /// Above either limit a full decode costs more than ~100MB; below them decode directly
+    static let maxDirectDecodePixels = 24_000_000
+    static let maxDirectDecodeDimension = 8192
+    private static let tileQuality: CGFloat = 0.85
+    private static let maxStoredPyramids = 8
+
+    private static let rootDirectory: URL = {
+        let caches = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+        return caches.appendingPathComponent("ImagePyramids", isDirectory: true)
+    }()
+
+    var pixelSize: CGSize { CGSize(width: metadata.width, height: metadata.height) }
+    var aspectRatio: CGFloat { CGFloat(metadata.width) / CGFloat(max(metadata.height, 1)) }
+
+    private init(metadata: Metadata, sourceURL: URL, directory: URL, tileCache: LargeImageTileCache) {
+        self.metadata = metadata
+        self.sourceURL = sourceURL
+        self.directory = directory
+        self.tileCache = tileCache
+    }
+
+    // MARK: - Source inspection
+
+    /// Pixel size and EXIF orientation read from the file header, without decoding.
+    static func imageInfo(at url: URL) -> (size: CGSize, orientation: CGImagePropertyOrientation)? {
+        guard let source = CGImageSourceCreateWithURL(url as CFURL, [kCGImageSourceShouldCache: false] as CFDictionary),
+              let properties = CGImageSourceCopyPropertiesAtIndex(source, 0, nil) as? [CFString: Any],
+              let width = properties[kCGImagePropertyPixelWidth] as? Int,
+              let height = properties[kCGImagePropertyPixelHeight] as? Int else {
+            return nil
+        }
+        let rawOrientation = properties[kCGImagePropertyOrientation] as? UInt32 ?? 1
+        return (CGSize(width: width, height: height), CGImagePropertyOrientation(rawValue: rawOrientation) ?? .up)
+    }
+
+    static func needsTiling(_ size: CGSize) -> Bool {
+        Int(size.width * size.height) > maxDirectDecodePixels
+            || Int(max(size.width, size.height)) > maxDirectDecodeDimension
+    }
+
+    /// Screen-sized decode of the file: an ImageIO thumbnail, never the full bitmap.
+    static func screenImage(at url: URL, maxPixelSize: Int) -> UIImage? {
+        guard let source = CGImageSourceCreateWithURL(url as CFURL, [kCGImageSourceShouldCache: false] as CFDictionary) else {
+            return nil
+        }
+        let options: [CFString: Any] = [
+            kCGImageSourceCreateThumbnailFromImageAlways: true,
+            kCGImageSourceShouldCacheImmediately: true,
+            kCGImageSourceCreateThumbnailWithTransform: true,
+            kCGImageSourceThumbnailMaxPixelSize: maxPixelSize
+        ]
+        guard let thumbnail = CGImageSourceCreateThumbnailAtIndex(source, 0, options as CFDictionary) else {
+            return nil
+        }
+        return UIImage(cgImage: thumbnail)
+    }
+
+    // MARK: - Loading
+
+    /// The pyramid for `sourceURL`, cut on first use and reused from disk afterwards.
+    static func load(from sourceURL: URL, key: String, tileCache: LargeImageTileCache) async -> LargeImagePyramid? {
+        await Task.detached(priority: .userInitiated) {
+            let directory = rootDirectory.appendingPathComponent(key, isDirectory: true)
+            let sourceByteCount = (try? FileManager.default.attributesOfItem(atPath: sourceURL.path)[.size] as? Int) ?? 0
+
+            if let data = try? Data(contentsOf: directory.appendingPathComponent("metadata.json")),
+               let metadata = try? JSONDecoder().decode(Metadata.self, from: data),
+               metadata.sourceByteCount == sourceByteCount,
+               metadata.tileSize == tileSize {
+                try? FileManager.default.setAttributes([.modificationDate: Date()], ofItemAtPath: directory.path)
+                return LargeImagePyramid(metadata: metadata, sourceURL: sourceURL, directory: directory, tileCache: tileCache)
+            }
+
+            let started = Date()
+            guard let metadata = build(from: sourceURL, sourceByteCount: sourceByteCount, into: directory) else {
+                print("DEBUG: [LargeImagePyramid] Failed to build pyramid for \(key)")
+                return nil
+            }
+            print("DEBUG: [LargeImagePyramid] Built \(metadata.levelCount) levels for \(key) (\(metadata.width)x\(metadata.height)) in \(String(format: "%.2f", Date().timeIntervalSince(started)))s")
+            pruneStoredPyramids(keeping: directory)
+            return LargeImagePyramid(metadata: metadata, sourceURL: sourceURL, directory: directory, tileCache: tileCache)
+        }.value
+    }
+
+    // MARK: - Tiles
+
+    func columns(at level: Int) -> Int {
+        (Self.levelDimension(metadata.width, level) + metadata.tileSize - 1) / metadata.tileSize
+    }
+
+    func rows(at level: Int) -> Int {
+        (Self.levelDimension(metadata.height, level) + metadata.tileSize - 1) / metadata.tileSize
+    }
+
+    func tile(level: Int, column: Int, row: Int) -> CGImage? {
+        let name = Self.tileName(level: level, column: column, row: row)
+        if let cached = tileCache.tile(forKey: "\(directory.lastPathComponent)/\(name)") {
+            return cached
+        }
+        let url = directory.appendingPathComponent(name)
+        guard let source = CGImageSourceCreateWithURL(url as CFURL, nil),
+              let image = CGImageSourceCreateImageAtIndex(source, 0, [kCGImageSourceShouldCacheImmediately: true] as CFDictionary) else {
+            return nil
+        }
+        tileCache.store(image, forKey: "\(directory.lastPathComponent)/\(name)")
+        return image
+    }
+
+    /// Draw the part of the image under `rect` (in the coordinates of a view whose bounds show
+    /// the whole image) from the coarsest level that still has a pixel per device pixel.
+    func draw(_ rect: CGRect, viewBounds: CGRect, in context: CGContext) {
+        guard viewBounds.width > 0 else { return }
+        let pixelsPerPoint = CGFloat(metadata.width) / viewBounds.width
+        let devicePixelsPerPoint = max(abs(context.ctm.a), 0.01)
+        let downsample = pixelsPerPoint / devicePixelsPerPoint
+        let level = min(max(downsample > 1 ? Int(floor(log2(downsample))) : 0, 0), metadata.levelCount - 1)
+
+        let levelPixelsPerPoint = pixelsPerPoint / CGFloat(1 << level)
+        let tile = CGFloat(metadata.tileSize)
+        let pixelRect = CGRect(
+            x: rect.minX * levelPixelsPerPoint,
+            y: rect.minY * levelPixelsPerPoint,
+            width: rect.width * levelPixelsPerPoint,
+            height: rect.height * levelPixelsPerPoint
+        )
+        let firstColumn = max(0, Int(floor(pixelRect.minX / tile)))
+        let lastColumn = min(columns(at: level) - 1, Int(ceil(pixelRect.maxX / tile)) - 1)
+        let firstRow = max(0, Int(floor(pixelRect.minY / tile)))
+        let lastRow = min(rows(at: level) - 1, Int(ceil(pixelRect.maxY / tile)) - 1)
+        guard firstColumn <= lastColumn, firstRow <= lastRow else { return }
+
+        UIGraphicsPushContext(context)
+        defer { UIGraphicsPopContext() }
+        for row in firstRow...lastRow {
+            for column in firstColumn...lastColumn {
+                guard let image = self.tile(level: level, column: column, row: row) else { continue }
+                let destination = CGRect(
+                    x: CGFloat(column) * tile / levelPixelsPerPoint,
+                    y: CGFloat(row) * tile / levelPixelsPerPoint,
+                    width: CGFloat(image.width) / levelPixelsPerPoint,
+                    height: CGFloat(image.height) / levelPixelsPerPoint
+                )
+                UIImage(cgImage: image).draw(in: destination)
+            }
+        }
+    }
+
+    // MARK: - Building
+
+    private static func build(from sourceURL: URL, sourceByteCount: Int, into directory: URL) -> Metadata? {
+        let fileManager = FileManager.default
+        guard let source = CGImageSourceCreateWithURL(sourceURL as CFURL, [kCGImageSourceShouldCache: false] as CFDictionary),
+              let image = CGImageSourceCreateImageAtIndex(source, 0, [kCGImageSourceShouldCache: false] as CFDictionary) else {
+            return nil
+        }
+
+        let width = image.width
+        let height = image.height
+        var levelCount = 1
+        while max(width, height) >> (levelCount - 1) > tileSize {
+            levelCount += 1
+        }
+        let metadata = Metadata(width: width, height: height, tileSize: tileSize, levelCount: levelCount, sourceByteCount: sourceByteCount)
+
+        let workDirectory = rootDirectory.appendingPathComponent("\(directory.lastPathComponent).\(UUID().uuidString)", isDirectory: true)
+        do {
+            try fileManager.createDirectory(at: workDirectory, withIntermediateDirectories: true)
+        } catch {
+            return nil
+        }
+        var succeeded = false
+        defer {
+            if !succeeded {
+                try? fileManager.removeItem(at: workDirectory)
+            }
+        }
+
+        // Level 0: decode one strip of `tileSize` rows, cut it into tiles
+        let rowCount = (height + tileSize - 1) / tileSize
+        let columnCount = (width + tileSize - 1) / tileSize
+        for row in 0..<rowCount {
+            let ok = autoreleasepool { () -> Bool in
+                let stripHeight = min(tileSize, height - row * tileSize)
+                guard let stripSource = image.cropping(to: CGRect(x: 0, y: row * tileSize, width: width, height: stripHeight)),
+                      let context = makeOpaqueContext(width: width, height: stripHeight) else {
+                    return false
+                }
+                context.draw(stripSource, in: CGRect(x: 0, y: 0, width: width, height: stripHeight))
+                guard let strip = context.makeImage() else { return false }
+
+                for column in 0..<columnCount {
+                    let tileWidth = min(tileSize, width - column * tileSize)
+                    guard let tile = strip.cropping(to: CGRect(x: column * tileSize, y: 0, width: tileWidth, height: stripHeight)),
+                          writeTile(tile, to: workDirectory.appendingPathComponent(tileName(level: 0, column: column, row: row))) else {
+                        return false
+                    }
+                }
+                return true
+            }
+            guard ok else { return nil }
+        }
+
+        // Upper levels: each tile is its four children at half size
+        for level in 1..<levelCount {
+            let levelWidth = levelDimension(width, level)
+            let levelHeight = levelDimension(height, level)
+            let columns = (levelWidth + tileSize - 1) / tileSize
+            let rows = (levelHeight + tileSize - 1) / tileSize
+            for row in 0..<rows {
+                for column in 0..<columns {
+                    let ok = autoreleasepool { () -> Bool in
+                        let tileWidth = min(tileSize, levelWidth - column * tileSize)
+                        let tileHeight = min(tileSize, levelHeight - row * tileSize)
+                        guard let context = makeOpaqueContext(width: tileWidth, height: tileHeight) else { return false }
+                        context.interpolationQuality = .high
+
+                        for dy in 0...1 {
+                            for dx in 0...1 {
+                                let childURL = workDirectory.appendingPathComponent(
+                                    tileName(level: level - 1, column: column * 2 + dx, row: row * 2 + dy)
+                                )
+                                guard let childSource = CGImageSourceCreateWithURL(childURL as CFURL, nil),
+                                      let child = CGImageSourceCreateImageAtIndex(childSource, 0, nil) else {
+                                    continue
+                                }
+                                let childWidth = CGFloat(child.width) / 2
+                                let childHeight = CGFloat(child.height) / 2
+                                let top = CGFloat(dy * tileSize / 2)
+                                // Core Graphics puts the origin at the bottom left
+                                context.draw(child, in: CGRect(
+                                    x: CGFloat(dx * tileSize / 2),
+                                    y: CGFloat(tileHeight) - top - childHeight,
+                                    width: childWidth,
+                                    height: childHeight
+                                ))
+                            }
+                        }
+                        guard let tile = context.makeImage() else { return false }
+                        return writeTile(tile, to: workDirectory.appendingPathComponent(tileName(level: level, column: column, row: row)))
+                    }
+                    guard ok else { return nil }
+                }
+            }
+        }
+
+        do {
+            try JSONEncoder().encode(metadata).write(to: workDirectory.appendingPathComponent("metadata.json"))
+            try? fileManager.removeItem(at: directory)
+            try fileManager.moveItem(at: workDirectory, to: directory)
+        } catch {
+            return nil
+        }
+        succeeded = true
+        return metadata
+    }
+
+    private static func makeOpaqueContext(width: Int, height: Int) -> CGContext? {
+        guard let context = CGContext(
+            data: nil,
+            width: width,
+            height: height,
+            bitsPerComponent: 8,
+            bytesPerRow: 0,
+            space: CGColorSpace(name: CGColorSpace.sRGB) ?? CGColorSpaceCreateDeviceRGB(),
+            bitmapInfo: CGImageAlphaInfo.noneSkipFirst.rawValue | CGBitmapInfo.byteOrder32Little.rawValue
+        ) else {
+            return nil
+        }
+        // Transparent areas show as the browser's black background
+        context.setFillColor(UIColor.black.cgColor)
+        context.fill(CGRect(x: 0, y: 0, width: width, height: height))
+        return context
+    }
+
+    private static func writeTile(_ tile: CGImage, to url: URL) -> Bool {
+        guard let destination = CGImageDestinationCreateWithURL(url as CFURL, "public.jpeg" as CFString, 1, nil) else {
+            return false
+        }
+        CGImageDestinationAddImage(destination, tile, [kCGImageDestinationLossyCompressionQuality: tileQuality] as CFDictionary)
+        return CGImageDestinationFinalize(destination)
+    }
+
+    private static func tileName(level: Int, column: Int, row: Int) -> String {
+        "\(level)_\(column)_\(row).jpg"
+    }
+
+    private static func levelDimension(_ dimension: Int, _ level: Int) -> Int {
+        max(1, (dimension + (1 << level) - 1) >> level)
+    }
+
+    /// Keep the most recently used pyramids; they are rebuilt from the cached original on demand.
+    private static func pruneStoredPyramids(keeping current: URL) {
+        let fileManager = FileManager.default
+        guard let entries = try? fileManager.contentsOfDirectory(
+            at: rootDirectory,
+            includingPropertiesForKeys: [.contentModificationDateKey],
+            options: [.skipsHiddenFiles]
+        ), entries.count > maxStoredPyramids else {
+            return
+        }
+        let sorted = entries.sorted {
+            let lhs = (try? $0.resourceValues(forKeys: [.contentModificationDateKey]).contentModificationDate) ?? .distantPast
+            let rhs = (try? $1.resourceValues(forKeys: [.contentModificationDateKey]).contentModificationDate) ?? .distantPast
+            return lhs > rhs
+        }
+        for entry in sorted.dropFirst(maxStoredPyramids) where entry.standardizedFileURL != current.standardizedFileURL {
+            try? fileManager.removeItem(at: entry)
+        }
+    }
+}
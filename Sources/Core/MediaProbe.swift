@@ -0,0 +1,373 @@
+//
+//  MediaProbe.swift
+//  Tweet
+//
+//  One structured probe per upload input, shared by HLSVideoProcessor,
+//  VideoConversionService and the upload paths in HproseInstance.
+//
+
+import Foundation
+import AVFoundation
+import ffmpegkit
+
+/// Everything the upload pipeline needs to know about a media file, gathered in one pass.
+struct MediaProbe: Sendable {
+    enum StreamKind: String, Sendable {
+        case video, audio, subtitle, data, other
+    }
+
+    struct Stream: Sendable {
+        let index: Int
+        let kind: StreamKind
+        let codec: String?
+        /// Bits per second, when the container reports it.
+        let bitrate: Int?
+        let width: Int?
+        let height: Int?
+        let frameRate: Double?
+    }
+
+    /// Where the MP4 `moov` atom sits relative to `mdat`. Front-loaded files can be
+    /// streamed progressively and copied to HLS without a remux pass.
+    enum MoovPosition: String, Sendable {
+        case beforeMdat, afterMdat, missing, notMP4
+    }
+
+    enum Source: String, Sendable {
+        case ffprobe, avFoundation
+    }
+
+    let streams: [Stream]
+    let videoCodec: String?
+    /// Coded (natural) dimensions of the first video stream.
+    let width: Int
+    let height: Int
+    /// Rotation in degrees using AVFoundation's preferredTransform convention (iPhone portrait = 90).
+    let rotation: Int
+    /// Video stream bitrate in bits per second.
+    let videoBitrate: Int?
+    /// Container bitrate in bits per second.
+    let overallBitrate: Int?
+    let duration: Double?
+    /// Mean seconds between keyframes over the first few seconds, if at least two were seen.
+    let keyframeInterval: Double?
+    let moovPosition: MoovPosition
+    let source: Source
+
+    var hasVideo: Bool { width > 0 && height > 0 }
+
+    var isRotatedQuarterTurn: Bool {
+        rotation == 90 || rotation == -90 || rotation == 270 || rotation == -270
+    }
+
+    var displayWidth: Int { isRotatedQuarterTurn ? height : width }
+    var displayHeight: Int { isRotatedQuarterTurn ? width : height }
+
+    /// Display aspect ratio (width / height after rotation), nil without a usable video stream.
+    var displayAspectRatio: Float? {
+        guard hasVideo else { return nil }
+        let ratio = Float(displayWidth) / Float(displayHeight)
+        return ratio.isFinite && ratio > 0 ? ratio : nil
+    }
+}
+
+/// Probes each input file once and caches the result by file identity
+/// (path, inode, size and modification date), so re-probing the same upload is free
+/// and a rewritten temp file at the same path is probed again.
+final class MediaProbeCache: @unchecked Sendable {
+    static let shared = MediaProbeCache()
+
+    /// Packets are only read for this many seconds to estimate the keyframe interval.
+    private let keyframeWindowSeconds = 6
+    private let maxEntries = 32
+
+    private var entries: [String: MediaProbe] = [:]
+    private var entryOrder: [String] = []
+    private var inFlight: [String: Task<MediaProbe?, Never>] = [:]
+    private var probeCount = 0
+    private let lock = NSLock()
+
+    private init() {}
+
+    // MARK: - Public API
+
+    /// Probe the file at `url`, reusing a cached or in-flight probe of the same file.
+    func probe(fileAt url: URL) async -> MediaProbe? {
+        guard let identity = fileIdentity(for: url) else {
+            print("DEBUG: [MediaProbe] File not found: \(url.path)")
+            return nil
+        }
+
+        let task = lock.withLock { () -> Task<MediaProbe?, Never>? in
+            if entries[identity] != nil { return nil }
+            if let existing = inFlight[identity] { return existing }
+            let task = Task.detached(priority: .userInitiated) { [self] in
+                await runProbe(url: url)
+            }
+            inFlight[identity] = task
+            return task
+        }
+        guard let task else {
+            return lock.withLock { entries[identity] }
+        }
+
+        let result = await task.value
+        lock.withLock {
+            inFlight.removeValue(forKey: identity)
+            if let result, entries[identity] == nil {
+                entries[identity] = result
+                entryOrder.append(identity)
+                if entryOrder.count > maxEntries {
+                    entries.removeValue(forKey: entryOrder.removeFirst())
+                }
+            }
+        }
+        return result
+    }
+
+    /// Drop the cached probe for `url` (e.g. before deleting a temp file).
+    func invalidate(fileAt url: URL) {
+        lock.withLock {
+            let prefix = url.standardizedFileURL.path + "|"
+            entries = entries.filter { !$0.key.hasPrefix(prefix) }
+            entryOrder.removeAll { $0.hasPrefix(prefix) }
+        }
+    }
+
+    // MARK: - Probing
+
+    private func runProbe(url: URL) async -> MediaProbe? {
+        let start = CFAbsoluteTimeGetCurrent()
+        let count = lock.withLock { () -> Int in
+            probeCount += 1
+            return probeCount
+        }
+
+        let moovPosition = Self.moovPosition(in: url)
+        var probe = probeWithFFprobe(url: url, moovPosition: moovPosition)
+        if probe == nil {
+            print("DEBUG: [MediaProbe] FFprobe failed for \(url.lastPathComponent), falling back to AVFoundation")
+            probe = await probeWithAVFoundation(url: url, moovPosition: moovPosition)
+        }
+
+        let elapsedMs = Int((CFAbsoluteTimeGetCurrent() - start) * 1000)
+        if let probe {
+            print("DEBUG: [MediaProbe] #\(count) \(url.lastPathComponent) via \(probe.source.rawValue) in \(elapsedMs)ms: " +
+                  "\(probe.videoCodec ?? "no video") \(probe.width)x\(probe.height) rot \(probe.rotation)°, " +
+                  "display \(probe.displayWidth)x\(probe.displayHeight), " +
+                  "\((probe.videoBitrate ?? probe.overallBitrate ?? 0) / 1000)kbps, " +
+                  "duration \(probe.duration.map { String(format: "%.1fs", $0) } ?? "?"), " +
+                  "GOP \(probe.keyframeInterval.map { String(format: "%.2fs", $0) } ?? "?"), moov \(probe.moovPosition.rawValue)")
+        } else {
+            print("DEBUG: [MediaProbe] #\(count) \(url.lastPathComponent) could not be probed (\(elapsedMs)ms)")
+        }
+        return probe
+    }
+
+    /// Structured FFprobe pass: format, streams and the first few seconds of packet flags.
+    private func probeWithFFprobe(url: URL, moovPosition: MediaProbe.MoovPosition) -> MediaProbe? {
+        let command = "-v error -hide_banner -print_format json -show_format -show_streams " +
+            "-show_entries packet=stream_index,pts_time,flags -read_intervals %+\(keyframeWindowSeconds) " +
+            "-i \"\(url.path)\""
+        guard let session = FFprobeKit.getMediaInformationFromCommand(command),
+              let information = session.getMediaInformation() else {
+            return nil
+        }
+
+        let streams: [MediaProbe.Stream] = (information.getStreams() ?? []).compactMap { element in
+            guard let stream = element as? StreamInformation else { return nil }
+            return MediaProbe.Stream(
+                index: stream.getIndex()?.intValue ?? 0,
+                kind: MediaProbe.StreamKind(rawValue: stream.getType() ?? "") ?? .other,
+                codec: stream.getCodec(),
+                bitrate: stream.getBitrate().flatMap { Int($0) },
+                width: stream.getWidth()?.intValue,
+                height: stream.getHeight()?.intValue,
+                frameRate: Self.parseRational(stream.getAverageFrameRate())
+            )
+        }
+
+        let videoInfo = (information.getStreams() ?? [])
+            .compactMap { $0 as? StreamInformation }
+            .first { $0.getType() == "video" }
+        let video = streams.first { $0.kind == .video }
+
+        let packets = information.getAllProperties()?["packets"] as? [[String: Any]] ?? []
+        let keyframeInterval = video.flatMap { Self.keyframeInterval(packets: packets, streamIndex: $0.index) }
+
+        return MediaProbe(
+            streams: streams,
+            videoCodec: video?.codec,
+            width: video?.width ?? 0,
+            height: video?.height ?? 0,
+            rotation: videoInfo.map(Self.rotation(of:)) ?? 0,
+            videoBitrate: video?.bitrate,
+            overallBitrate: information.getBitrate().flatMap { Int($0) },
+            duration: information.getDuration().flatMap { Double($0) },
+            keyframeInterval: keyframeInterval,
+            moovPosition: moovPosition,
+            source: .ffprobe
+        )
+    }
+
+    /// Single-asset AVFoundation fallback for files FFprobe can't open.
+    private func probeWithAVFoundation(url: URL, moovPosition: MediaProbe.MoovPosition) async -> MediaProbe? {
+        let asset = AVURLAsset(url: url)
+        do {
+            let tracks = try await asset.load(.tracks)
+            var streams: [MediaProbe.Stream] = []
+            var videoCodec: String?
+            var size = CGSize.zero
+            var rotation = 0
+            var videoBitrate: Int?
+
+            for (index, track) in tracks.enumerated() {
+                let formatDescriptions = (try? await track.load(.formatDescriptions)) ?? []
+                let codec = formatDescriptions.first.map { Self.fourCC(CMFormatDescriptionGetMediaSubType($0)) }
+                let dataRate = (try? await track.load(.estimatedDataRate)).map { Int($0) }
+
+                switch track.mediaType {
+                case .video:
+                    let naturalSize = try await track.load(.naturalSize)
+                    let frameRate = try? await track.load(.nominalFrameRate)
+                    if videoCodec == nil {
+                        let transform = try await track.load(.preferredTransform)
+                        videoCodec = codec
+                        size = naturalSize
+                        rotation = Int(round(atan2(transform.b, transform.a) * 180 / .pi))
+                        videoBitrate = dataRate
+                    }
+                    streams.append(MediaProbe.Stream(
+                        index: index, kind: .video, codec: codec, bitrate: dataRate,
+                        width: Int(naturalSize.width), height: Int(naturalSize.height),
+                        frameRate: frameRate.map(Double.init)
+                    ))
+                case .audio:
+                    streams.append(MediaProbe.Stream(
+                        index: index, kind: .audio, codec: codec, bitrate: dataRate,
+                        width: nil, height: nil, frameRate: nil
+                    ))
+                default:
+                    streams.append(MediaProbe.Stream(
+                        index: index, kind: .other, codec: codec, bitrate: dataRate,
+                        width: nil, height: nil, frameRate: nil
+                    ))
+                }
+            }
+
+            let duration = try? await asset.load(.duration)
+            return MediaProbe(
+                streams: streams,
+                videoCodec: videoCodec,
+                width: Int(size.width),
+                height: Int(size.height),
+                rotation: rotation,
+                videoBitrate: videoBitrate,
+                overallBitrate: nil,
+                duration: duration.map(CMTimeGetSeconds).flatMap { $0.isFinite ? $0 : nil },
+                keyframeInterval: nil,
+                moovPosition: moovPosition,
+                source: .avFoundation
+            )
+        } catch {
+            print("DEBUG: [MediaProbe] AVFoundation probe failed for \(url.lastPathComponent): \(error)")
+            return nil
+        }
+    }
+
+    // MARK: - Helpers
+
+    private func fileIdentity(for url: URL) -> String? {
+        let path = url.standardizedFileURL.path
+        guard let attributes = try? FileManager.default.attributesOfItem(atPath: path) else { return nil }
+        let size = (attributes[.size] as? NSNumber)?.int64Value ?? 0
+        let inode = (attributes[.systemFileNumber] as? NSNumber)?.uint64Value ?? 0
+        let modified = (attributes[.modificationDate] as? Date)?.timeIntervalSince1970 ?? 0
+        return "\(path)|\(inode)|\(size)|\(modified)"
+    }
+
+    /// Rotation in AVFoundation's convention. FFprobe reports the display matrix rotation
+    /// counter-clockwise (iPhone portrait = -90); older muxers use a clockwise `rotate` tag.
+    private static func rotation(of stream: StreamInformation) -> Int {
+        if let sideData = stream.getProperty("side_data_list") as? [[String: Any]] {
+            for entry in sideData {
+                if let value = entry["rotation"] as? NSNumber {
+                    return normalizedDegrees(-value.intValue)
+                }
+            }
+        }
+        if let tag = stream.getTags()?["rotate"] as? String, let value = Int(tag) {
+            return normalizedDegrees(value)
+        }
+        return 0
+    }
+
+    /// Map to (-180, 180], the range atan2 produces for preferredTransform.
+    private static func normalizedDegrees(_ degrees: Int) -> Int {
+        var value = degrees % 360
+        if value > 180 { value -= 360 }
+        if value <= -180 { value += 360 }
+        return value
+    }
+
+    private static func keyframeInterval(packets: [[String: Any]], streamIndex: Int) -> Double? {
+        let keyframeTimes = packets.compactMap { packet -> Double? in
+            guard (packet["stream_index"] as? NSNumber)?.intValue == streamIndex,
+                  let flags = packet["flags"] as? String, flags.hasPrefix("K"),
+                  let pts = packet["pts_time"] as? String else { return nil }
+            return Double(pts)
+        }.sorted()
+        guard keyframeTimes.count >= 2, let first = keyframeTimes.first, let last = keyframeTimes.last else {
+            return nil
+        }
+        return (last - first) / Double(keyframeTimes.count - 1)
+    }
+
+    /// Parse FFprobe rationals such as "30000/1001".
+    private static func parseRational(_ value: String?) -> Double? {
+        guard let value else { return nil }
+        let parts = value.split(separator: "/")
+        if parts.count == 2, let numerator = Double(parts[0]), let denominator = Double(parts[1]), denominator != 0 {
+            return numerator / denominator
+        }
+        return Double(value)
+    }
+
+    private static func fourCC(_ code: FourCharCode) -> String {
+        let bytes = [24, 16, 8, 0].map { UInt8((code >> $0) & 0xFF) }
+        return String(bytes: bytes, encoding: .ascii)?.trimmingCharacters(in: .whitespaces) ?? "\(code)"
+    }
+
+    /// Walk top-level ISO BMFF boxes until `moov` or `mdat` is found.
+    private static func moovPosition(in url: URL) -> MediaProbe.MoovPosition {
+        guard let handle = try? FileHandle(forReadingFrom: url) else { return .notMP4 }
+        defer { try? handle.close() }
+        let fileSize = (try? handle.seekToEnd()) ?? 0
+        var offset: UInt64 = 0
+        var sawFtyp = false
+
+        for _ in 0..<64 {
+            guard offset + 8 <= fileSize else { break }
+            try? handle.seek(toOffset: offset)
+            guard let header = try? handle.read(upToCount: 16), header.count >= 8 else { break }
+            var boxSize = header.prefix(4).reduce(UInt64(0)) { $0 << 8 | UInt64($1) }
+            let type = String(bytes: header[4..<8], encoding: .ascii) ?? ""
+            if boxSize == 1, header.count >= 16 {
+                boxSize = header[8..<16].reduce(UInt64(0)) { $0 << 8 | UInt64($1) }
+            } else if boxSize == 0 {
+                boxSize = fileSize - offset
+            }
+
+            switch type {
+            case "ftyp": sawFtyp = true
+            case "moov": return .beforeMdat
+            case "mdat": return .afterMdat
+            default:
+                if !sawFtyp { return .notMP4 }
+            }
+            guard boxSize >= 8 else { break }
+            offset += boxSize
+        }
+        return sawFtyp ? .missing : .notMP4
+    }
+}
@@ -54,6 +54,9 @@ extension Notification.Name {
     /// Posted when a tweet deletion fails and needs to be restored
     static let tweetRestored = Notification.Name("TweetRestored")
     
+    /// Posted on the main queue when the content filter rules change
+    static let contentFilterChanged = Notification.Name("ContentFilterChanged")
+    
     /// Posted when a tweet's pin status changes
     static let tweetPinStatusChanged = Notification.Name("TweetPinStatusChanged")
     
@@ -7,18 +7,49 @@
 
 import Foundation
 import AVFoundation
+import UIKit
 
 /// Persistent storage for video playback state that survives player recreation
+///
+/// States are mirrored to a VideoResumeJournal so they also survive the app being killed.
+/// Player time observers only touch the in-memory dictionary; journal writes are batched
+/// by a debounce and flushed when the app leaves the foreground.
 @MainActor
 class PersistentVideoStateManager: ObservableObject {
     static let shared = PersistentVideoStateManager()
     
-    private init() {}
+    private init() {
+        restoredStates = journal.load()
+        for name in [UIApplication.willResignActiveNotification, UIApplication.didEnterBackgroundNotification] {
+            NotificationCenter.default.addObserver(forName: name, object: nil, queue: .main) { [weak self] _ in
+                MainActor.assumeIsolated {
+                    self?.flushJournal()
+                    self?.journal.flush()
+                }
+            }
+        }
+    }
     
     // Storage for video states, isolated by context (detail vs fullscreen vs feed cell)
     // This prevents one surface (e.g. feed) from overwriting another (e.g. detail view).
     private var videoStates: [VideoPlaybackState.VideoContext: [String: VideoPlaybackState]] = [:]
     private let stateFreshnessInterval: TimeInterval = 300
+    private let staleStateInterval: TimeInterval = 3600
+
+    private lazy var journal: VideoResumeJournal = {
+        let directory = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask)[0]
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        return VideoResumeJournal(
+            url: directory.appendingPathComponent("VideoResumePositions.journal"),
+            maxAge: staleStateInterval
+        )
+    }()
+    /// States from earlier launches, keyed by mid hash; promoted into `videoStates` on first lookup
+    private var restoredStates: [VideoResumeJournal.Key: VideoResumeJournal.Entry] = [:]
+    /// Latest unwritten record per video and context
+    private var pendingJournalEntries: [VideoResumeJournal.Key: VideoResumeJournal.Entry] = [:]
+    private var journalFlushWorkItem: DispatchWorkItem?
+    private let journalDebounceInterval: TimeInterval = 2
     
     /// Video playback state
     struct VideoPlaybackState {
@@ -65,6 +96,7 @@ class PersistentVideoStateManager: ObservableObject {
         var bucket = videoStates[context] ?? [:]
         bucket[videoMid] = state
         videoStates[context] = bucket
+        recordInJournal(state, duration: nil)
     }
     
     /// Save video playback state with duration check
@@ -98,12 +130,15 @@ class PersistentVideoStateManager: ObservableObject {
         
         // Save normally if not at end
         saveState(videoMid: videoMid, currentTime: currentTime, wasPlaying: wasPlaying, context: context)
+        if let state = videoStates[context]?[videoMid], duration.isValid, duration.seconds.isFinite {
+            recordInJournal(state, duration: duration.seconds)
+        }
     }
     
     /// Get saved video playback state
     /// Automatically validates and clears states that are at/near the end
     func getState(videoMid: String, context: VideoPlaybackState.VideoContext, duration: CMTime? = nil) -> VideoPlaybackState? {
-        guard let state = videoStates[context]?[videoMid] else {
+        guard let state = videoStates[context]?[videoMid] ?? promoteRestoredState(videoMid: videoMid, context: context) else {
             return nil
         }
         
@@ -151,21 +186,33 @@ class PersistentVideoStateManager: ObservableObject {
     
     /// Remove saved state for a video
     func clearState(videoMid: String, context: VideoPlaybackState.VideoContext) {
-        videoStates[context]?.removeValue(forKey: videoMid)
+        let hadState = videoStates[context]?.removeValue(forKey: videoMid) != nil
+        let key = journalKey(videoMid: videoMid, context: context)
+        let hadRestored = restoredStates.removeValue(forKey: key) != nil
+        if hadState || hadRestored || pendingJournalEntries[key] != nil {
+            recordClearInJournal(key)
+        }
     }
 
     /// Remove saved state for a video across all contexts
     func clearState(videoMid: String) {
         for context in VideoPlaybackState.VideoContext.allCases {
-            videoStates[context]?.removeValue(forKey: videoMid)
+            clearState(videoMid: videoMid, context: context)
         }
     }
     
     /// Clear states older than 1 hour
     func clearStaleStates() {
-        let oneHourAgo = Date().addingTimeInterval(-3600)
+        let oneHourAgo = Date().addingTimeInterval(-staleStateInterval)
         var removedCount = 0
 
+        // Journal compaction drops these on disk; only the restored mirror needs pruning
+        let staleRestored = restoredStates.filter { $0.value.timestamp < oneHourAgo.timeIntervalSince1970 }.map { $0.key }
+        for key in staleRestored {
+            restoredStates.removeValue(forKey: key)
+            removedCount += 1
+        }
+
         for context in VideoPlaybackState.VideoContext.allCases {
             guard var bucket = videoStates[context] else { continue }
             let staleMids = bucket.filter { $0.value.timestamp < oneHourAgo }.map { $0.key }
@@ -184,6 +231,10 @@ class PersistentVideoStateManager: ObservableObject {
     /// Clear all states
     func clearAllStates() {
         videoStates.removeAll()
+        restoredStates.removeAll()
+        pendingJournalEntries.removeAll()
+        journalFlushWorkItem?.cancel()
+        journal.removeAll()
         print("🗑️ [VIDEO STATE] Cleared all states")
     }
     
@@ -230,4 +281,82 @@ class PersistentVideoStateManager: ObservableObject {
             print("🗑️ [VIDEO STATE] Cleared \(clearedCount) suspicious end-position states on launch")
         }
     }
+
+    // MARK: - Journal
+
+    private func journalKey(videoMid: String, context: VideoPlaybackState.VideoContext) -> VideoResumeJournal.Key {
+        VideoResumeJournal.Key(midHash: VideoResumeJournal.hash(videoMid), context: journalContext(context))
+    }
+
+    private func journalContext(_ context: VideoPlaybackState.VideoContext) -> UInt8 {
+        UInt8(VideoPlaybackState.VideoContext.allCases.firstIndex(of: context) ?? 0)
+    }
+
+    /// Called from player time observers: an in-memory write plus a debounce, never I/O.
+    private func recordInJournal(_ state: VideoPlaybackState, duration: Double?) {
+        let key = journalKey(videoMid: state.videoMid, context: state.context)
+        restoredStates.removeValue(forKey: key)
+        pendingJournalEntries[key] = VideoResumeJournal.Entry(
+            midHash: key.midHash,
+            context: key.context,
+            position: state.currentTime.seconds,
+            duration: duration ?? pendingJournalEntries[key]?.duration ?? 0,
+            timestamp: state.timestamp.timeIntervalSince1970,
+            wasPlaying: state.wasPlaying,
+            cleared: false
+        )
+        scheduleJournalFlush()
+    }
+
+    private func recordClearInJournal(_ key: VideoResumeJournal.Key) {
+        pendingJournalEntries[key] = VideoResumeJournal.Entry(
+            midHash: key.midHash,
+            context: key.context,
+            position: 0,
+            duration: 0,
+            timestamp: Date().timeIntervalSince1970,
+            wasPlaying: false,
+            cleared: true
+        )
+        scheduleJournalFlush()
+    }
+
+    private func scheduleJournalFlush() {
+        guard journalFlushWorkItem == nil else { return }
+        let workItem = DispatchWorkItem { [weak self] in
+            MainActor.assumeIsolated {
+                self?.flushJournal()
+            }
+        }
+        journalFlushWorkItem = workItem
+        DispatchQueue.main.asyncAfter(deadline: .now() + journalDebounceInterval, execute: workItem)
+    }
+
+    private func flushJournal() {
+        journalFlushWorkItem?.cancel()
+        journalFlushWorkItem = nil
+        guard !pendingJournalEntries.isEmpty else { return }
+        journal.append(Array(pendingJournalEntries.values))
+        pendingJournalEntries.removeAll()
+    }
+
+    /// Turn a state saved before the app was relaunched into a live one. The journal stores
+    /// only a hash of the mid, so the caller's mid completes it.
+    private func promoteRestoredState(videoMid: String, context: VideoPlaybackState.VideoContext) -> VideoPlaybackState? {
+        guard let entry = restoredStates.removeValue(forKey: journalKey(videoMid: videoMid, context: context)),
+              entry.position.isFinite else {
+            return nil
+        }
+        let state = VideoPlaybackState(
+            videoMid: videoMid,
+            currentTime: CMTime(seconds: entry.position, preferredTimescale: 600),
+            wasPlaying: entry.wasPlaying,
+            timestamp: Date(timeIntervalSince1970: entry.timestamp),
+            context: context
+        )
+        var bucket = videoStates[context] ?? [:]
+        bucket[videoMid] = state
+        videoStates[context] = bucket
+        return state
+    }
 }
@@ -0,0 +1,265 @@
+import Foundation
+import hprose
+
+/// Absolute time by which a user-facing operation's RPCs must finish, retries and hedges included.
+///
+/// The UI sets one where an operation starts (`RPCDeadline.withDeadline(.interactive) { ... }`).
+/// HproseInstance reads `RPCDeadline.current` to size each attempt's transport timeout and to
+/// stop retrying once the budget is spent, instead of every layer applying its own fixed timeout.
+struct RPCDeadline: Sendable {
+    let expiresAt: Date
+
+    init(seconds: TimeInterval) {
+        expiresAt = Date().addingTimeInterval(seconds)
+    }
+
+    /// Budget for screens waiting on a spinner.
+    static var interactive: RPCDeadline { RPCDeadline(seconds: 10) }
+
+    @TaskLocal static var current: RPCDeadline?
+
+    /// The deadline of the enclosing operation, or one `defaultSeconds` from now.
+    static func resolved(defaultSeconds: TimeInterval) -> RPCDeadline {
+        current ?? RPCDeadline(seconds: defaultSeconds)
+    }
+
+    /// Run `operation` with `deadline` as `current`. A nested deadline never extends an outer one.
+    static func withDeadline<T>(_ deadline: RPCDeadline, operation: () async throws -> T) async rethrows -> T {
+        let effective = current.map { $0.expiresAt < deadline.expiresAt ? $0 : deadline } ?? deadline
+        return try await $current.withValue(effective, operation: operation)
+    }
+
+    var remaining: TimeInterval { expiresAt.timeIntervalSinceNow }
+    var hasExpired: Bool { remaining <= 0 }
+
+    /// Transport timeout for one attempt: what's left of the deadline, capped at `cap`.
+    /// Never below one second so a nearly spent budget still gets a real try.
+    func attemptTimeout(cap: TimeInterval) -> TimeInterval {
+        max(1, min(cap, remaining))
+    }
+
+    /// Sleep before a retry, or throw `exceededError` if the retry couldn't start before the deadline.
+    func sleepBeforeRetry(nanoseconds: UInt64) async throws {
+        guard Double(nanoseconds) / 1_000_000_000 < remaining else {
+            throw Self.exceededError
+        }
+        try await Task.sleep(nanoseconds: nanoseconds)
+    }
+
+    static var exceededError: NSError {
+        NSError(domain: "HproseClient", code: NSURLErrorTimedOut, userInfo: [
+            NSLocalizedDescriptionKey: NSLocalizedString("Request timed out", comment: "RPC deadline error")
+        ])
+    }
+}
+
+/// Hedged invocation of idempotent reads (get_tweet, get_user, get_comments).
+///
+/// The request goes to the primary node first. If it hasn't answered by the entry's observed
+/// p95 latency, the same request is sent to an alternate provider; the first good response
+/// wins and the other request is cancelled by invalidating its client's URL session.
+/// Only a primary failure before the hedge fires is surfaced directly, so callers' existing
+/// retry logic still sees the same errors.
+final class RPCHedger: @unchecked Sendable {
+    static let shared = RPCHedger()
+
+    struct Outcome {
+        let response: Any
+        /// Node that produced `response` (the primary or the alternate that won)
+        let baseUrl: URL
+    }
+
+    private struct EntryStats {
+        var samples: [TimeInterval] = []
+        var nextSample = 0
+        var calls = 0
+        var hedges = 0
+        var hedgeWins = 0
+    }
+
+    private var stats: [String: EntryStats] = [:]
+    private let lock = NSLock()
+    private let sampleCapacity = 128
+    /// Below this many samples the p95 is noise; use `defaultHedgeDelay` instead
+    private let minSamples = 20
+    private let defaultHedgeDelay: TimeInterval = 2.0
+    private let minHedgeDelay: TimeInterval = 0.15
+    private let logInterval = 50
+
+    private init() {}
+
+    /// Invoke `entry` on `primary`, hedging to the first of `alternates()` whose host differs.
+    /// `alternates` is only called if the hedge fires.
+    func invoke(
+        entry: String,
+        params: [String: Any],
+        primary: URL,
+        timeoutCap: TimeInterval = 15,
+        deadline: RPCDeadline,
+        alternates: @escaping () async -> [URL]
+    ) async throws -> Outcome {
+        guard !deadline.hasExpired else { throw RPCDeadline.exceededError }
+
+        let started = Date()
+        let hedgeDelay = self.hedgeDelay(for: entry)
+        let hedgeState = HedgeState()
+
+        let (winner, isHedge, firstError) = await withTaskGroup(
+            of: (isHedge: Bool, result: Result<Outcome, Error>?).self
+        ) { group -> (Outcome?, Bool, Error?) in
+            group.addTask {
+                do {
+                    let timeout = deadline.attemptTimeout(cap: timeoutCap)
+                    return (false, .success(try await self.attempt(entry: entry, params: params, baseUrl: primary, timeout: timeout)))
+                } catch {
+                    return (false, .failure(error))
+                }
+            }
+            group.addTask {
+                try? await Task.sleep(nanoseconds: UInt64(hedgeDelay * 1_000_000_000))
+                guard !Task.isCancelled, deadline.remaining > self.minHedgeDelay else { return (true, nil) }
+                let primaryHost = NodePoolRegistry.nodeHost(from: primary)
+                guard let alternate = await alternates().first(where: { NodePoolRegistry.nodeHost(from: $0) != primaryHost }),
+                      !Task.isCancelled,
+                      hedgeState.launch() else {
+                    return (true, nil)
+                }
+                print("DEBUG: [RPCHedger] \(entry) slower than \(String(format: "%.2f", hedgeDelay))s on \(primaryHost), hedging to \(NodePoolRegistry.nodeHost(from: alternate))")
+                do {
+                    let timeout = deadline.attemptTimeout(cap: timeoutCap)
+                    return (true, .success(try await self.attempt(entry: entry, params: params, baseUrl: alternate, timeout: timeout)))
+                } catch {
+                    return (true, .failure(error))
+                }
+            }
+
+            var firstError: Error?
+            while let next = await group.next() {
+                switch next.result {
+                case .success(let outcome)?:
+                    group.cancelAll()
+                    return (outcome, next.isHedge, nil)
+                case .failure(let error)?:
+                    firstError = firstError ?? error
+                    // Primary failed before the hedge fired: surface it now rather than wait for the timer
+                    if !next.isHedge && hedgeState.closeIfNotLaunched() {
+                        group.cancelAll()
+                        return (nil, false, error)
+                    }
+                case nil:
+                    continue
+                }
+            }
+            return (nil, false, firstError)
+        }
+
+        // A hedge win means the primary took at least this long; record that lower bound.
+        // Failures aren't latency samples: fast errors would drag the p95 down.
+        record(
+            entry,
+            latency: winner == nil ? nil : Date().timeIntervalSince(started),
+            launchedHedge: hedgeState.launched,
+            hedgeWon: winner != nil && isHedge
+        )
+
+        if let winner {
+            return winner
+        }
+        throw firstError ?? RPCDeadline.exceededError
+    }
+
+    // MARK: - Attempt
+
+    private func attempt(entry: String, params: [String: Any], baseUrl: URL, timeout: TimeInterval) async throws -> Outcome {
+        let pool = HproseInstance.shared.clientPool
+        let client = pool.getClientByUrl(for: baseUrl.absoluteString)
+        client.timeout = timeout
+        let start = Date()
+
+        let response: Any? = await withTaskCancellationHandler {
+            await withCheckedContinuation { continuation in
+                DispatchQueue.global(qos: .userInitiated).async {
+                    continuation.resume(returning: client.invoke("runMApp", withArgs: [entry, params]))
+                }
+            }
+        } onCancel: {
+            // invalidateAndCancel aborts the in-flight request so the loser stops using the node
+            client.close(true)
+        }
+
+        // A cancelled loser says nothing about the node, and its client was closed above
+        try Task.checkCancellation()
+        // Anything else leaves the session usable, so the client goes back for reuse
+        pool.releaseClient(client)
+        if let error = response as? Error {
+            pool.recordResult(forUrl: baseUrl.absoluteString, latency: nil, failed: true)
+            throw error
+        }
+        guard let response else {
+            pool.recordResult(forUrl: baseUrl.absoluteString, latency: nil, failed: true)
+            throw NSError(domain: "HproseClient", code: -1, userInfo: [NSLocalizedDescriptionKey: NSLocalizedString("Nil response from server", comment: "Server response error")])
+        }
+        pool.recordResult(forUrl: baseUrl.absoluteString, latency: Date().timeIntervalSince(start), failed: false)
+        return Outcome(response: response, baseUrl: baseUrl)
+    }
+
+    // MARK: - Latency stats
+
+    /// p95 of recent latencies for `entry`, or `defaultHedgeDelay` until enough samples exist.
+    private func hedgeDelay(for entry: String) -> TimeInterval {
+        let samples = lock.withLock { stats[entry]?.samples ?? [] }
+        guard samples.count >= minSamples else { return defaultHedgeDelay }
+        let sorted = samples.sorted()
+        let index = min(sorted.count - 1, Int(Double(sorted.count) * 0.95))
+        return max(minHedgeDelay, sorted[index])
+    }
+
+    private func record(_ entry: String, latency: TimeInterval?, launchedHedge: Bool, hedgeWon: Bool) {
+        let snapshot = lock.withLock { () -> EntryStats in
+            var entryStats = stats[entry] ?? EntryStats()
+            if let latency {
+                if entryStats.samples.count < sampleCapacity {
+                    entryStats.samples.append(latency)
+                } else {
+                    entryStats.samples[entryStats.nextSample] = latency
+                }
+                entryStats.nextSample = (entryStats.nextSample + 1) % sampleCapacity
+            }
+            entryStats.calls += 1
+            if launchedHedge { entryStats.hedges += 1 }
+            if hedgeWon { entryStats.hedgeWins += 1 }
+            stats[entry] = entryStats
+            return entryStats
+        }
+        if snapshot.calls % logInterval == 0 {
+            let extra = Double(snapshot.hedges) / Double(snapshot.calls) * 100
+            print("DEBUG: [RPCHedger] \(entry): \(snapshot.calls) calls, p95 \(String(format: "%.2f", hedgeDelay(for: entry)))s, hedged \(snapshot.hedges) (\(String(format: "%.1f", extra))% extra requests), hedge won \(snapshot.hedgeWins)")
+        }
+    }
+}
+
+/// Whether the hedge was sent. The primary's early failure and the hedge timer race to decide it.
+private final class HedgeState: @unchecked Sendable {
+    private let lock = NSLock()
+    private var state: Int = 0 // 0 = pending, 1 = launched, 2 = closed
+
+    var launched: Bool { lock.withLock { state == 1 } }
+
+    /// Claim the hedge slot. False if the call already gave up on hedging.
+    func launch() -> Bool {
+        lock.withLock {
+            guard state == 0 else { return false }
+            state = 1
+            return true
+        }
+    }
+
+    /// Close the hedge slot unless the hedge is already in flight. True if closed (or already closed).
+    func closeIfNotLaunched() -> Bool {
+        lock.withLock {
+            guard state != 1 else { return false }
+            state = 2
+            return true
+        }
+    }
+}
@@ -0,0 +1,252 @@
+//
+//  SDWebImageBridge.swift
+//  Tweet
+//
+//  Routes SDWebImage through ImageCacheManager so both stacks share one disk store,
+//  one decoded-memory budget and one in-flight request per mid.
+//
+
+import UIKit
+import SDWebImage
+
+extension SDWebImageContextOption {
+    /// MimeiId of the image being requested. Optional: without it the mid is parsed from
+    /// `/ipfs/<mid>` or `/mm/<mid>` URLs.
+    static let mimeiId = SDWebImageContextOption(rawValue: "com.tweet.mimeiId")
+}
+
+enum SDWebImageBridge {
+    /// Install the bridge as SDWebImageManager's default cache and loader.
+    /// Must run before anything touches `SDWebImageManager.shared`.
+    static func install() {
+        SDWebImageManager.defaultImageCache = ImageCacheManagerSDCache.shared
+        SDWebImageManager.defaultImageLoader = ImageCacheManagerSDLoader.shared
+        print("DEBUG: [SDWebImageBridge] SDWebImage routed through ImageCacheManager")
+    }
+
+    /// Mid for a request: the explicit context value, else the last component of an
+    /// `/ipfs/<mid>` or `/mm/<mid>` path. Nil for URLs that aren't Mimei content.
+    static func mimeiId(forKey key: String?, context: [SDWebImageContextOption: Any]?) -> MimeiId? {
+        if let mid = context?[.mimeiId] as? String, !mid.isEmpty {
+            return mid
+        }
+        guard let key, let url = URL(string: key) else { return nil }
+        let components = url.path.split(separator: "/")
+        guard components.count >= 2,
+              components[components.count - 2] == "ipfs" || components[components.count - 2] == "mm" else {
+            return nil
+        }
+        return String(components[components.count - 1])
+    }
+
+    static func attachment(forMid mid: MimeiId) -> MimeiFileType {
+        MimeiFileType(mid: mid, mediaType: .image)
+    }
+}
+
+// MARK: - Cache
+
+/// SDImageCache conformance backed by ImageCacheManager.
+///
+/// Mimei content is read from and written to ImageCacheManager's `<mid>_compressed` entries.
+/// Other URLs go to a disk-only SDImageCache, so decoded images still count against a
+/// single memory budget.
+final class ImageCacheManagerSDCache: NSObject, SDImageCacheProtocol, @unchecked Sendable {
+    static let shared = ImageCacheManagerSDCache()
+
+    private let fallback: SDImageCache = {
+        let cache = SDImageCache(namespace: "external")
+        cache.config.shouldCacheImagesInMemory = false
+        return cache
+    }()
+
+    private override init() {
+        super.init()
+    }
+
+    func queryImage(
+        forKey key: String?,
+        options: SDWebImageOptions = [],
+        context: [SDWebImageContextOption: Any]?,
+        completion completionBlock: SDImageCacheQueryCompletionBlock? = nil
+    ) -> SDWebImageOperation? {
+        queryImage(forKey: key, options: options, context: context, cacheType: .all, completion: completionBlock)
+    }
+
+    func queryImage(
+        forKey key: String?,
+        options: SDWebImageOptions = [],
+        context: [SDWebImageContextOption: Any]?,
+        cacheType queryCacheType: SDImageCacheType,
+        completion completionBlock: SDImageCacheQueryCompletionBlock? = nil
+    ) -> SDWebImageOperation? {
+        guard let mid = SDWebImageBridge.mimeiId(forKey: key, context: context) else {
+            return fallback.queryImage(forKey: key, options: options, context: context, cacheType: queryCacheType, completion: completionBlock)
+        }
+
+        // Memory hit: answer synchronously like SDImageCache does.
+        if queryCacheType != .disk,
+           let image = ImageCacheManager.shared.getCachedCompressedImageFromMemory(forMid: mid) {
+            completionBlock?(image, nil, .memory)
+            return nil
+        }
+        guard queryCacheType == .disk || queryCacheType == .all else {
+            completionBlock?(nil, nil, .none)
+            return nil
+        }
+
+        let operation = BridgeOperation()
+        operation.task = Task.detached(priority: .userInitiated) {
+            let image = ImageCacheManager.shared.getCachedCompressedImage(forMid: mid)
+            guard !Task.isCancelled else { return }
+            await MainActor.run {
+                completionBlock?(image, nil, image == nil ? .none : .disk)
+            }
+        }
+        return operation
+    }
+
+    func store(
+        _ image: UIImage?,
+        imageData: Data?,
+        forKey key: String?,
+        cacheType: SDImageCacheType,
+        completion completionBlock: SDWebImageNoParamsBlock? = nil
+    ) {
+        store(image, imageData: imageData, forKey: key, options: [], context: nil, cacheType: cacheType, completion: completionBlock)
+    }
+
+    func store(
+        _ image: UIImage?,
+        imageData: Data?,
+        forKey key: String?,
+        options: SDWebImageOptions = [],
+        context: [SDWebImageContextOption: Any]?,
+        cacheType: SDImageCacheType,
+        completion completionBlock: SDWebImageNoParamsBlock? = nil
+    ) {
+        guard let mid = SDWebImageBridge.mimeiId(forKey: key, context: context) else {
+            fallback.store(image, imageData: imageData, forKey: key, options: options, context: context, cacheType: cacheType, completion: completionBlock)
+            return
+        }
+        // The loader already cached through ImageCacheManager; only store images that
+        // reached SDWebImage some other way (e.g. sd_setImage with a preloaded image).
+        if ImageCacheManager.shared.getCachedCompressedImageFromMemory(forMid: mid) == nil {
+            let data = imageData ?? image?.jpegData(compressionQuality: 0.9)
+            if let data {
+                ImageCacheManager.shared.cacheImageData(data, for: SDWebImageBridge.attachment(forMid: mid))
+            }
+        }
+        completionBlock?()
+    }
+
+    func removeImage(forKey key: String?, cacheType: SDImageCacheType, completion completionBlock: SDWebImageNoParamsBlock? = nil) {
+        guard let mid = SDWebImageBridge.mimeiId(forKey: key, context: nil) else {
+            fallback.removeImage(forKey: key, cacheType: cacheType, completion: completionBlock)
+            return
+        }
+        ImageCacheManager.shared.clearCache(for: mid)
+        completionBlock?()
+    }
+
+    func containsImage(forKey key: String?, cacheType: SDImageCacheType, completion completionBlock: SDImageCacheContainsCompletionBlock? = nil) {
+        guard let mid = SDWebImageBridge.mimeiId(forKey: key, context: nil) else {
+            fallback.containsImage(forKey: key, cacheType: cacheType, completion: completionBlock)
+            return
+        }
+        if cacheType != .disk, ImageCacheManager.shared.getCachedCompressedImageFromMemory(forMid: mid) != nil {
+            completionBlock?(.memory)
+            return
+        }
+        Task.detached(priority: .utility) {
+            let found = ImageCacheManager.shared.getCachedCompressedImage(forMid: mid) != nil
+            await MainActor.run {
+                completionBlock?(found ? .disk : .none)
+            }
+        }
+    }
+
+    func clear(with cacheType: SDImageCacheType, completion completionBlock: SDWebImageNoParamsBlock? = nil) {
+        // Memory is ImageCacheManager's to manage (MemoryCapManager / MemoryWarningManager);
+        // wiping the shared disk store from SDWebImage would drop feed images too.
+        if cacheType == .memory || cacheType == .all {
+            ImageCacheManager.shared.clearMemoryCache()
+        }
+        fallback.clear(with: cacheType, completion: completionBlock)
+    }
+}
+
+// MARK: - Loader
+
+/// SDImageLoader conformance backed by ImageCacheManager.loadAndCacheImage, so an image
+/// requested by a WebImage view and a feed cell at the same time is fetched once.
+final class ImageCacheManagerSDLoader: NSObject, SDImageLoader, @unchecked Sendable {
+    static let shared = ImageCacheManagerSDLoader()
+
+    private override init() {
+        super.init()
+    }
+
+    func canRequestImage(for url: URL?) -> Bool {
+        guard let scheme = url?.scheme?.lowercased() else { return false }
+        return scheme == "http" || scheme == "https"
+    }
+
+    func canRequestImage(for url: URL?, options: SDWebImageOptions = [], context: [SDWebImageContextOption: Any]?) -> Bool {
+        canRequestImage(for: url)
+    }
+
+    func requestImage(
+        with url: URL?,
+        options: SDWebImageOptions = [],
+        context: [SDWebImageContextOption: Any]?,
+        progress progressBlock: SDImageLoaderProgressBlock?,
+        completed completedBlock: SDImageLoaderCompletedBlock? = nil
+    ) -> SDWebImageOperation? {
+        guard let url else {
+            completedBlock?(nil, nil, NSError(domain: SDWebImageErrorDomain, code: SDWebImageError.invalidURL.rawValue), true)
+            return nil
+        }
+        guard let mid = SDWebImageBridge.mimeiId(forKey: url.absoluteString, context: context) else {
+            return SDWebImageDownloader.shared.requestImage(with: url, options: options, context: context, progress: progressBlock, completed: completedBlock)
+        }
+
+        let operation = BridgeOperation()
+        operation.task = Task.detached(priority: .userInitiated) {
+            let image = await ImageCacheManager.shared.loadAndCacheImage(
+                from: url,
+                for: SDWebImageBridge.attachment(forMid: mid)
+            )
+            guard !Task.isCancelled else { return }
+            await MainActor.run {
+                if let image {
+                    completedBlock?(image, nil, nil, true)
+                } else {
+                    completedBlock?(nil, nil, NSError(domain: SDWebImageErrorDomain, code: SDWebImageError.badImageData.rawValue), true)
+                }
+            }
+        }
+        return operation
+    }
+
+    func shouldBlockFailedURL(with url: URL, error: Error) -> Bool {
+        // Nodes come and go; a failed mid is retried on the next request.
+        false
+    }
+
+    func shouldBlockFailedURL(with url: URL, error: Error, options: SDWebImageOptions = [], context: [SDWebImageContextOption: Any]?) -> Bool {
+        false
+    }
+}
+
+// MARK: - Operation
+
+/// Cancels the backing Task when SDWebImage cancels the request (e.g. the view disappears).
+/// The shared ImageCacheManager download keeps running for other waiters.
+private final class BridgeOperation: NSObject, SDWebImageOperation, @unchecked Sendable {
+    var task: Task<Void, Never>?
+
+    func cancel() {
+        task?.cancel()
+    }
+}
@@ -971,6 +971,7 @@ class SharedAssetCache: ObservableObject {
         let nextCount = max((visibleVideoMidCounts[mediaID] ?? 0) - 1, 0)
         if nextCount == 0 {
             visibleVideoMidCounts.removeValue(forKey: mediaID)
+            LocalHTTPServer.shared.stopMultiSourceFill(for: mediaID)
         } else {
             visibleVideoMidCounts[mediaID] = nextCount
         }
@@ -0,0 +1,160 @@
+import UIKit
+import ImageIO
+import UniformTypeIdentifiers
+
+/// JPEG encoder that hits a byte budget in a bounded number of encodes.
+///
+/// The image is flattened once into an opaque bitmap (only when it has alpha). A probe encode
+/// of a small proxy estimates bytes per pixel, which picks the output scale; quality is then
+/// bisected over at most `maxQualityEncodes` full encodes. Downscaling happens inside ImageIO
+/// (`kCGImageDestinationImageMaxPixelSize`), so every encode reads the same bitmap.
+enum TargetSizeJPEGEncoder {
+    private static let probeMaxPixelSize = 256
+    private static let probeQuality: CGFloat = 0.7
+    private static let minQuality: CGFloat = 0.4
+    private static let maxQuality: CGFloat = 0.95
+    private static let maxQualityEncodes = 3
+    /// Bytes allowed at `probeQuality` after scaling; bisection trims the rest through quality
+    private static let scaledEstimateHeadroom = 1.3
+
+    struct Result {
+        let data: Data
+        let quality: CGFloat
+        let maxPixelSize: Int
+        /// Encodes performed, the probe included
+        let encodeCount: Int
+    }
+
+    /// Encode `image` as JPEG no larger than `maxBytes` when at all possible; the last
+    /// fallback encode is returned even if it is still over budget.
+    static func encode(_ image: UIImage, maxBytes: Int) -> Result? {
+        guard let bitmap = opaqueBitmap(for: image) else { return nil }
+        let orientation = CGImagePropertyOrientation(image.imageOrientation)
+        let fullPixelSize = max(bitmap.width, bitmap.height)
+        var encodeCount = 0
+
+        func jpeg(quality: CGFloat, maxPixelSize: Int) -> Data? {
+            encodeCount += 1
+            return encodeJPEG(bitmap, quality: quality, maxPixelSize: maxPixelSize, orientation: orientation)
+        }
+
+        // Probe: bytes per pixel at `probeQuality` on a small proxy. Proxies carry more detail per
+        // pixel than the full image, so the estimate errs on the large side.
+        let probeSize = min(fullPixelSize, probeMaxPixelSize)
+        guard let probe = jpeg(quality: probeQuality, maxPixelSize: probeSize) else { return nil }
+        let probePixels = Double(pixelCount(width: bitmap.width, height: bitmap.height, maxPixelSize: probeSize))
+        let bytesPerPixel = Double(probe.count) / max(probePixels, 1)
+        let fullEstimate = bytesPerPixel * Double(bitmap.width * bitmap.height)
+
+        if fullPixelSize <= probeMaxPixelSize, probe.count <= maxBytes {
+            return Result(data: probe, quality: probeQuality, maxPixelSize: probeSize, encodeCount: encodeCount)
+        }
+
+        // Scale so the estimate at `probeQuality` is within reach of quality alone
+        let budget = Double(maxBytes) * scaledEstimateHeadroom
+        let scale = fullEstimate > budget ? sqrt(budget / fullEstimate) : 1
+        var maxPixelSize = max(1, Int(Double(fullPixelSize) * scale))
+        let scaledEstimate = fullEstimate * scale * scale
+
+        // Bisect quality; start high when the estimate leaves plenty of room
+        var low = minQuality
+        var high = maxQuality
+        var quality: CGFloat = scaledEstimate < Double(maxBytes) * 0.6 ? 0.9 : probeQuality
+        var best: (data: Data, quality: CGFloat)?
+        var lastSize = Int(scaledEstimate)
+        for _ in 0..<maxQualityEncodes {
+            guard let data = jpeg(quality: quality, maxPixelSize: maxPixelSize) else { break }
+            lastSize = data.count
+            if data.count <= maxBytes {
+                // `low` only rises on a fit, so each fit beats the previous one
+                best = (data, quality)
+                low = quality
+            } else {
+                high = quality
+            }
+            quality = (low + high) / 2
+        }
+        if let best {
+            return Result(data: best.data, quality: best.quality, maxPixelSize: maxPixelSize, encodeCount: encodeCount)
+        }
+
+        // Still over budget at the lowest quality tried: shrink by the observed overshoot
+        maxPixelSize = max(1, Int(Double(maxPixelSize) * sqrt(Double(maxBytes) / Double(max(lastSize, 1))) * 0.9))
+        guard let data = jpeg(quality: low, maxPixelSize: maxPixelSize) else { return nil }
+        return Result(data: data, quality: low, maxPixelSize: maxPixelSize, encodeCount: encodeCount)
+    }
+
+    // MARK: - Helpers
+
+    /// The image's pixels without alpha. Opaque images are used as-is; others are drawn once
+    /// over white into a single BGRX buffer.
+    private static func opaqueBitmap(for image: UIImage) -> CGImage? {
+        guard let cgImage = image.cgImage else {
+            // CIImage-backed images: let UIKit flatten them
+            return UIGraphicsImageRenderer(size: image.size).image { _ in image.draw(at: .zero) }.cgImage
+        }
+        switch cgImage.alphaInfo {
+        case .none, .noneSkipLast, .noneSkipFirst:
+            return cgImage
+        default:
+            break
+        }
+
+        let rect = CGRect(x: 0, y: 0, width: cgImage.width, height: cgImage.height)
+        guard let context = CGContext(
+            data: nil,
+            width: cgImage.width,
+            height: cgImage.height,
+            bitsPerComponent: 8,
+            bytesPerRow: 0,
+            space: CGColorSpace(name: CGColorSpace.sRGB) ?? CGColorSpaceCreateDeviceRGB(),
+            bitmapInfo: CGImageAlphaInfo.noneSkipFirst.rawValue | CGBitmapInfo.byteOrder32Little.rawValue
+        ) else {
+            return nil
+        }
+        context.setFillColor(UIColor.white.cgColor)
+        context.fill(rect)
+        context.draw(cgImage, in: rect)
+        return context.makeImage()
+    }
+
+    private static func encodeJPEG(_ image: CGImage, quality: CGFloat, maxPixelSize: Int, orientation: CGImagePropertyOrientation) -> Data? {
+        let data = NSMutableData()
+        guard let destination = CGImageDestinationCreateWithData(data, UTType.jpeg.identifier as CFString, 1, nil) else {
+            return nil
+        }
+        var options: [CFString: Any] = [
+            kCGImageDestinationLossyCompressionQuality: quality,
+            kCGImagePropertyOrientation: orientation.rawValue,
+        ]
+        if maxPixelSize < max(image.width, image.height) {
+            options[kCGImageDestinationImageMaxPixelSize] = maxPixelSize
+        }
+        CGImageDestinationAddImage(destination, image, options as CFDictionary)
+        guard CGImageDestinationFinalize(destination) else { return nil }
+        return data as Data
+    }
+
+    private static func pixelCount(width: Int, height: Int, maxPixelSize: Int) -> Int {
+        let longest = max(width, height)
+        guard maxPixelSize < longest else { return width * height }
+        let scale = Double(maxPixelSize) / Double(longest)
+        return max(1, Int(Double(width) * scale)) * max(1, Int(Double(height) * scale))
+    }
+}
+
+private extension CGImagePropertyOrientation {
+    init(_ orientation: UIImage.Orientation) {
+        switch orientation {
+        case .up: self = .up
+        case .upMirrored: self = .upMirrored
+        case .down: self = .down
+        case .downMirrored: self = .downMirrored
+        case .left: self = .left
+        case .leftMirrored: self = .leftMirrored
+        case .right: self = .right
+        case .rightMirrored: self = .rightMirrored
+        @unknown default: self = .up
+        }
+    }
+}
@@ -0,0 +1,142 @@
+//
+//  TranscodeProgress.swift
+//  Tweet
+//
+//  Turns FFmpeg statistics (media time, speed, bytes written) into per-pass and overall
+//  progress, a smoothed ETA and a speed-collapse signal. No FFmpegKit or UIKit here, so it
+//  can be driven by recorded statistics.
+//
+
+import Foundation
+
+/// Progress across the passes of one conversion, each of which reads the whole source.
+///
+/// Every statistics sample carries the media time reached so far in the current pass. The
+/// instantaneous speed between two samples (media seconds per wall second) is smoothed
+/// with an EWMA; the ETA is the remaining media time of this and all later passes divided
+/// by that speed. Passes are weighted by `Pass.weight` so a cheap remux doesn't count as
+/// much as an encode.
+struct TranscodeProgress {
+    struct Pass {
+        let name: String
+        /// Relative cost; only the ratios between passes matter
+        let weight: Double
+    }
+
+    struct Snapshot: Equatable {
+        let passIndex: Int
+        let passFraction: Double
+        let overallFraction: Double
+        /// nil until there are enough samples to trust the speed
+        let estimatedTimeRemaining: TimeInterval?
+        /// Smoothed media seconds per wall second
+        let speed: Double
+        let bytesWritten: Int64
+        let isSpeedCollapsed: Bool
+    }
+
+    let passes: [Pass]
+    /// Probed source duration in seconds
+    let duration: TimeInterval
+
+    /// Weight of the EWMA's newest sample
+    var smoothing = 0.2
+    /// Smoothed speed below this fraction of the pass's best counts as collapsed...
+    var collapseRatio = 0.4
+    /// ...once it has stayed there this long
+    var collapseGrace: TimeInterval = 10
+
+    private(set) var passIndex = 0
+    private var mediaTime: TimeInterval = 0
+    private var bytesWritten: Int64 = 0
+    private var lastSample: (wall: TimeInterval, media: TimeInterval)?
+    private var smoothedSpeed: Double?
+    private var samplesInPass = 0
+    private var peakSpeed = 0.0
+    private var slowSince: TimeInterval?
+    private var isCollapsed = false
+
+    init(passes: [Pass], duration: TimeInterval) {
+        self.passes = passes.isEmpty ? [Pass(name: "", weight: 1)] : passes
+        self.duration = duration
+    }
+
+    /// Start pass `index`. The previous pass's speed keeps the ETA going until this pass's
+    /// first sample reseeds it; the collapse baseline starts over.
+    mutating func beginPass(_ index: Int, at wallTime: TimeInterval) {
+        passIndex = min(max(0, index), passes.count - 1)
+        mediaTime = 0
+        bytesWritten = 0
+        lastSample = (wallTime, 0)
+        samplesInPass = 0
+        peakSpeed = 0
+        slowSince = nil
+        isCollapsed = false
+    }
+
+    /// Feed one statistics sample. `time` is FFmpeg's media time in milliseconds, `speed`
+    /// its own (cumulative) speed factor, `size` the output bytes so far.
+    @discardableResult
+    mutating func record(time milliseconds: Double, speed reportedSpeed: Double, size: Int64, at wallTime: TimeInterval) -> Snapshot {
+        let media = min(max(0, milliseconds / 1000), duration > 0 ? duration : .greatestFiniteMagnitude)
+        bytesWritten = max(bytesWritten, size)
+
+        if let last = lastSample, wallTime > last.wall, media >= last.media {
+            let instantaneous = (media - last.media) / (wallTime - last.wall)
+            if let current = smoothedSpeed, samplesInPass > 0 {
+                smoothedSpeed = current + smoothing * (instantaneous - current)
+            } else if reportedSpeed > 0 {
+                // FFmpeg's cumulative factor is a steadier seed than the first delta
+                smoothedSpeed = reportedSpeed
+            } else {
+                smoothedSpeed = instantaneous
+            }
+            samplesInPass += 1
+        }
+        lastSample = (wallTime, media)
+        mediaTime = max(mediaTime, media)
+        updateCollapse(at: wallTime)
+        return snapshot
+    }
+
+    var snapshot: Snapshot {
+        let passFraction = duration > 0 ? min(1, mediaTime / duration) : 0
+        let totalWeight = passes.reduce(0) { $0 + $1.weight }
+        let doneWeight = passes[..<passIndex].reduce(0) { $0 + $1.weight } + passes[passIndex].weight * passFraction
+        let overall = totalWeight > 0 ? min(1, doneWeight / totalWeight) : 0
+
+        var eta: TimeInterval?
+        if let speed = smoothedSpeed, speed > 0, samplesInPass >= 2 || passIndex > 0, duration > 0 {
+            // Later passes are assumed to run at this pass's speed scaled by their weight
+            let weight = passes[passIndex].weight
+            let remainingHere = (duration - mediaTime) / speed
+            let later = passes[(passIndex + 1)...].reduce(0) { $0 + duration * ($1.weight / max(weight, .ulpOfOne)) / speed }
+            eta = remainingHere + later
+        }
+
+        return Snapshot(
+            passIndex: passIndex,
+            passFraction: passFraction,
+            overallFraction: overall,
+            estimatedTimeRemaining: eta,
+            speed: smoothedSpeed ?? 0,
+            bytesWritten: bytesWritten,
+            isSpeedCollapsed: isCollapsed
+        )
+    }
+
+    // MARK: - Private
+
+    private mutating func updateCollapse(at wallTime: TimeInterval) {
+        guard let speed = smoothedSpeed, samplesInPass >= 2 else { return }
+        peakSpeed = max(peakSpeed, speed)
+        if speed < peakSpeed * collapseRatio {
+            let since = slowSince ?? wallTime
+            slowSince = since
+            isCollapsed = wallTime - since >= collapseGrace
+        } else {
+            slowSince = nil
+            isCollapsed = false
+        }
+    }
+}
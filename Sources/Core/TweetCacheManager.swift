@@ -9,16 +9,29 @@ final class TweetCacheManager: @unchecked Sendable {
     private let maxCacheSize: Int = 5000 // Maximum number of tweets to cache
     private var cleanupTimer: Timer?
     
-    // Track last access time for tweets (in memory, persisted to UserDefaults)
-    private var tweetAccessTimes: [String: Date] = [:]
-    private let accessTimesKey = "TweetAccessTimes"
+    // Tweet views not yet written to CDTweet.lastAccess; flushed to the store in batches
+    private var pendingAccessTimes: [String: Date] = [:]
+    private let accessFlushThreshold = 20
+    /// Views are recorded from the UI and flushed from the writer queue
+    private let accessTimesLock = NSLock()
+    /// Pre-column access times were a JSON map in UserDefaults; imported once, then removed
+    private let legacyAccessTimesKey = "TweetAccessTimes"
 
     private init() {
-        // Load access times from UserDefaults
-        loadAccessTimes()
+        // Fill lastAccess / mediaIds / isPermanent for rows cached before those columns existed
+        importLegacyAccessTimes()
+        backfillCacheColumns()
         
         // Set up periodic cleanup
         setupPeriodicCleanup()
+        
+        NotificationCenter.default.addObserver(
+            forName: UIApplication.didEnterBackgroundNotification,
+            object: nil,
+            queue: nil
+        ) { [weak self] _ in
+            self?.flushAccessTimes()
+        }
     }
     
     deinit {
@@ -33,75 +46,148 @@ final class TweetCacheManager: @unchecked Sendable {
         }
     }
     
-    // Load access times from UserDefaults
-    private func loadAccessTimes() {
-        if let data = UserDefaults.standard.data(forKey: accessTimesKey),
-           let times = try? JSONDecoder().decode([String: Date].self, from: data) {
-            tweetAccessTimes = times
-            print("DEBUG: [TweetCacheManager] Loaded \(times.count) tweet access times")
+    // Mark tweet as accessed (called when tweet is viewed)
+    func markTweetAccessed(_ tweetId: String) {
+        let count = accessTimesLock.withLock { () -> Int in
+            pendingAccessTimes[tweetId] = Date()
+            return pendingAccessTimes.count
+        }
+        // Write in batches, not on every view (performance)
+        if count >= accessFlushThreshold {
+            flushAccessTimes()
         }
     }
     
-    // Save access times to UserDefaults
-    private func saveAccessTimes() {
-        if let data = try? JSONEncoder().encode(tweetAccessTimes) {
-            UserDefaults.standard.set(data, forKey: accessTimesKey)
+    /// Write pending views to CDTweet.lastAccess on the writer queue.
+    private func flushAccessTimes() {
+        let pending = accessTimesLock.withLock { () -> [String: Date] in
+            defer { pendingAccessTimes.removeAll() }
+            return pendingAccessTimes
+        }
+        guard !pending.isEmpty else { return }
+        
+        coreDataManager.performWrite { context in
+            let request: NSFetchRequest<CDTweet> = CDTweet.fetchRequest()
+            request.predicate = NSPredicate(format: "tid IN %@", Array(pending.keys))
+            guard let cdTweets = try? context.fetch(request) else { return }
+            for cdTweet in cdTweets {
+                guard let tid = cdTweet.tid, let accessed = pending[tid] else { continue }
+                if cdTweet.lastAccess.map({ $0 < accessed }) ?? true {
+                    cdTweet.lastAccess = accessed
+                }
+            }
         }
     }
     
-    // Mark tweet as accessed (called when tweet is viewed)
-    func markTweetAccessed(_ tweetId: String) {
-        tweetAccessTimes[tweetId] = Date()
-        // Save periodically, not on every access (performance)
-        if tweetAccessTimes.count % 20 == 0 {
-            saveAccessTimes()
+    private func importLegacyAccessTimes() {
+        guard let data = UserDefaults.standard.data(forKey: legacyAccessTimesKey) else { return }
+        if let times = try? JSONDecoder().decode([String: Date].self, from: data) {
+            accessTimesLock.withLock { pendingAccessTimes.merge(times) { max($0, $1) } }
+            print("DEBUG: [TweetCacheManager] Imported \(times.count) legacy tweet access times")
         }
+        UserDefaults.standard.removeObject(forKey: legacyAccessTimesKey)
+        flushAccessTimes()
     }
     
-    private func performPeriodicCleanup() {
-        context.performAndWait {
-            // Delete expired tweets (2 weeks old, excluding private tweets)
-            deleteExpiredTweets()
-            
-            // Save access times after cleanup
-            saveAccessTimes()
-            
-            // Limit total number of tweets
+    /// Decode rows whose denormalized columns are unset (mediaIds == nil), in batches.
+    /// Runs once after the model migration; new rows get their columns in saveTweet.
+    /// Each batch is its own writer block, so other writes (and main-thread waits) interleave.
+    private func backfillCacheColumns(filled: Int = 0) {
+        coreDataManager.performWrite { context in
             let request: NSFetchRequest<CDTweet> = CDTweet.fetchRequest()
-            request.sortDescriptors = [NSSortDescriptor(key: "timeCached", ascending: false)]
-            request.fetchLimit = maxCacheSize
+            request.predicate = NSPredicate(format: "mediaIds == nil")
+            request.fetchLimit = 500
             
-            if let allTweets = try? context.fetch(request) {
-                // Only delete tweets if we have more than maxCacheSize
-                if allTweets.count > maxCacheSize {
-                    let tweetsToDelete = Array(allTweets[maxCacheSize...])
-                    for tweet in tweetsToDelete {
-                        context.delete(tweet)
-                    }
-                    try? context.save()
+            guard let batch = try? context.fetch(request), !batch.isEmpty else {
+                if filled > 0 {
+                    print("DEBUG: [TweetCacheManager] Backfilled cache columns for \(filled) tweets")
                 }
+                return
+            }
+            for cdTweet in batch {
+                let columns = CachedTweetColumns.decode(cdTweet.tweetData)
+                Self.setCacheColumns(
+                    on: cdTweet,
+                    uid: cdTweet.uid ?? "",
+                    isPrivate: columns?.isPrivate == true,
+                    mediaIds: columns?.attachments?.map { $0.mid } ?? []
+                )
+            }
+            do {
+                try context.save()
+            } catch {
+                print("[TweetCacheManager] Cache column backfill failed: \(error)")
+                context.rollback()
+                return
             }
+            context.reset()
+            self.backfillCacheColumns(filled: filled + batch.count)
+        }
+    }
+    
+    /// Denormalized columns that let cleanup run as predicates without decoding tweetData.
+    /// `mediaIds` is space-separated ("" when the tweet has no attachments).
+    private static func setCacheColumns(on cdTweet: CDTweet, uid: String, isPrivate: Bool, mediaIds: [MimeiId]) {
+        // NEVER auto-delete: private tweets OR bookmarks/favorites
+        cdTweet.isPermanent = isPrivate || uid.hasPrefix("bookmark_list_") || uid.hasPrefix("favorite_list_")
+        cdTweet.mediaIds = mediaIds.joined(separator: " ")
+    }
+    
+    private func performPeriodicCleanup() {
+        // Delete expired tweets (2 weeks old, excluding private tweets)
+        deleteExpiredTweets()
+        
+        // Limit total number of tweets: delete the least recently cached rows past maxCacheSize.
+        // Private tweets, bookmarks and favorites are never trimmed.
+        coreDataManager.performWrite { context in
+            let request = NSFetchRequest<NSManagedObjectID>(entityName: "CDTweet")
+            request.resultType = .managedObjectIDResultType
+            request.predicate = NSPredicate(format: "isPermanent == NO")
+            request.sortDescriptors = [NSSortDescriptor(key: "timeCached", ascending: false)]
+            request.fetchOffset = self.maxCacheSize
+            
+            guard let overflow = try? context.fetch(request), !overflow.isEmpty else { return }
+            let deleted = self.deleteTweetsAndMedia(matching: NSPredicate(format: "self IN %@", overflow), in: context)
+            print("DEBUG: [TweetCacheManager] Trimmed \(deleted) tweets over the \(self.maxCacheSize) cache limit")
         }
     }
     
+    /// Main-queue context for reads that feed the UI. All writes go through `coreDataManager.performWrite`.
     var context: NSManagedObjectContext { coreDataManager.context }
     
     // MARK: - Media Cleanup
     
-    /// Delete media files associated with a tweet
-    private func deleteMediaForTweet(_ tweet: Tweet) {
-        // Collect all media IDs from attachments
-        var mediaIds: [String] = []
+    /// Batch-delete the rows matching `predicate` and the media listed in their `mediaIds`.
+    /// Call from inside a writer block. Returns the number of deleted rows.
+    private func deleteTweetsAndMedia(matching predicate: NSPredicate, in context: NSManagedObjectContext) -> Int {
+        let mediaRequest = NSFetchRequest<NSDictionary>(entityName: "CDTweet")
+        mediaRequest.resultType = .dictionaryResultType
+        mediaRequest.propertiesToFetch = ["mediaIds"]
+        mediaRequest.predicate = NSCompoundPredicate(andPredicateWithSubpredicates: [
+            predicate, NSPredicate(format: "mediaIds != nil AND mediaIds != ''")
+        ])
         
-        if let attachments = tweet.attachments {
-            for attachment in attachments {
-                mediaIds.append(attachment.mid)
+        var mediaIds = Set<MimeiId>()
+        for row in (try? context.fetch(mediaRequest)) ?? [] {
+            if let ids = row["mediaIds"] as? String {
+                mediaIds.formUnion(ids.split(separator: " ").map(String.init))
             }
         }
         
+        let deleteRequest = NSFetchRequest<NSFetchRequestResult>(entityName: "CDTweet")
+        deleteRequest.predicate = predicate
+        let deleted = coreDataManager.batchDelete(deleteRequest, in: context)
+        if deleted > 0 {
+            deleteMedia(Array(mediaIds))
+        }
+        return deleted
+    }
+    
+    /// Delete cached media files (videos, audio, images) by media id
+    private func deleteMedia(_ mediaIds: [MimeiId]) {
         if mediaIds.isEmpty { return }
         
-        print("DEBUG: [TweetCacheManager] Deleting \(mediaIds.count) media files for tweet \(tweet.mid)")
+        print("DEBUG: [TweetCacheManager] Deleting \(mediaIds.count) media files")
         
         // Delete from SharedAssetCache (videos/audio) on main actor
         Task { @MainActor in
@@ -122,38 +208,14 @@ final class TweetCacheManager: @unchecked Sendable {
     func manualClearAllCache() {
         print("DEBUG: [TweetCacheManager] Manual cache clear - clearing EVERYTHING")
 
-        // Log initial state
-        let initialTweetCount = context.performAndWait {
-            let request: NSFetchRequest<CDTweet> = CDTweet.fetchRequest()
-            return (try? context.fetch(request).count) ?? 0
+        // Media caches are wiped wholesale below, so tweets are batch-deleted without decoding them
+        let deletedCount = coreDataManager.performWriteAndWait { context in
+            self.coreDataManager.batchDelete(NSFetchRequest<NSFetchRequestResult>(entityName: "CDTweet"), in: context)
         }
-        print("DEBUG: [TweetCacheManager] Initial tweet count: \(initialTweetCount)")
+        print("DEBUG: [TweetCacheManager] Manual clear: deleted \(deletedCount) cached tweets")
 
-        context.performAndWait {
-            // Get all tweets
-            let request: NSFetchRequest<CDTweet> = CDTweet.fetchRequest()
-            if let allTweets = try? context.fetch(request) {
-                print("DEBUG: [TweetCacheManager] Manual clear: deleting \(allTweets.count) tweets and their media")
-
-                for cdTweet in allTweets {
-                    // Delete associated media (clears from caches per media ID)
-                    if let tweet = try? Tweet.from(cdTweet: cdTweet) {
-                        deleteMediaForTweet(tweet)
-                    }
-
-                    // Delete tweet from CoreData
-                    context.delete(cdTweet)
-                }
-
-                try? context.save()
-                print("DEBUG: [TweetCacheManager] CoreData tweets deleted successfully")
-            }
-        }
-
-        // Clear access times
-        tweetAccessTimes.removeAll()
-        saveAccessTimes()
-        print("DEBUG: [TweetCacheManager] Access times cleared")
+        // Drop views not yet flushed; their rows are gone
+        accessTimesLock.withLock { pendingAccessTimes.removeAll() }
 
         // Final sweep: clear any remaining caches that might not be tweet-associated
         Task { @MainActor in
@@ -168,9 +230,8 @@ final class TweetCacheManager: @unchecked Sendable {
         print("DEBUG: [TweetCacheManager] Memory cache cleared")
 
         // Verify cleanup
-        let finalTweetCount = context.performAndWait {
-            let request: NSFetchRequest<CDTweet> = CDTweet.fetchRequest()
-            return (try? context.fetch(request).count) ?? 0
+        let finalTweetCount = coreDataManager.performWriteAndWait { context in
+            (try? context.count(for: NSFetchRequest<NSFetchRequestResult>(entityName: "CDTweet"))) ?? 0
         }
         print("✅ Manual cache clear complete - final tweet count: \(finalTweetCount)")
     }
@@ -434,9 +495,12 @@ extension TweetCacheManager {
                             tweet.author = User.getInstance(mid: tweet.authorId)
                         }
                         
-                        // Then update the cache time in a separate operation
-                        cdTweet.timeCached = Date()
-                        try? self.context.save()
+                        // Touch the cache time on the writer queue; viewContext stays read-only
+                        let objectID = cdTweet.objectID
+                        self.coreDataManager.performWrite { writer in
+                            guard let row = try? writer.existingObject(with: objectID) as? CDTweet else { return }
+                            row.timeCached = Date()
+                        }
                         
                         continuation.resume(returning: tweet)
                     } catch {
@@ -464,7 +528,17 @@ extension TweetCacheManager {
             return
         }
         
-        context.performAndWait {
+        // Encode on the caller, where the in-memory tweet is owned; the row write happens on the writer queue
+        let encoder = JSONEncoder()
+        encoder.dateEncodingStrategy = .millisecondsSince1970
+        let tweetData = try? encoder.encode(tweet)
+        let tweetMid = tweet.mid
+        let tweetTimestamp = tweet.timestamp
+        let cachedAt = timeCached ?? Date()
+        let tweetIsPrivate = tweet.isPrivate == true
+        let mediaIds = tweet.attachments?.map { $0.mid } ?? []
+        
+        coreDataManager.performWrite { context in
             // For bookmarks/favorites, look up by both tid AND uid to find the exact cache entry
             // This ensures we update the correct entry and preserve order
             let isBookmarkOrFavorite = userId.hasPrefix("bookmark_list_") || userId.hasPrefix("favorite_list_")
@@ -472,10 +546,10 @@ extension TweetCacheManager {
             
             if isBookmarkOrFavorite {
                 // Look up by both tid and uid for bookmarks/favorites to find exact cache entry
-                request.predicate = NSPredicate(format: "tid == %@ AND uid == %@", tweet.mid, userId)
+                request.predicate = NSPredicate(format: "tid == %@ AND uid == %@", tweetMid, userId)
             } else {
                 // For other types, look up by tid only (tweet can be in multiple caches)
-                request.predicate = NSPredicate(format: "tid == %@", tweet.mid)
+                request.predicate = NSPredicate(format: "tid == %@", tweetMid)
             }
             
             let cdTweet: CDTweet
@@ -486,7 +560,7 @@ extension TweetCacheManager {
                 // If not found with the specific uid (for bookmarks/favorites), check if tweet exists with different uid
                 if isBookmarkOrFavorite {
                     let fallbackRequest: NSFetchRequest<CDTweet> = CDTweet.fetchRequest()
-                    fallbackRequest.predicate = NSPredicate(format: "tid == %@", tweet.mid)
+                    fallbackRequest.predicate = NSPredicate(format: "tid == %@", tweetMid)
                     if let existingWithDifferentUid = try? context.fetch(fallbackRequest).first {
                         // Update existing entry to use the bookmark/favorite cache key
                         cdTweet = existingWithDifferentUid
@@ -500,21 +574,18 @@ extension TweetCacheManager {
             
             // Always save the current in-memory tweet state to cache
             // This ensures that any updates made to the tweet in memory are preserved
-            let encoder = JSONEncoder()
-            encoder.dateEncodingStrategy = .millisecondsSince1970
-            if let tweetData = try? encoder.encode(tweet) {
+            if let tweetData {
                 cdTweet.tweetData = tweetData
             }
                         
             // Update common fields
-            cdTweet.tid = tweet.mid
+            cdTweet.tid = tweetMid
             cdTweet.uid = userId
-            cdTweet.timestamp = tweet.timestamp
+            cdTweet.timestamp = tweetTimestamp
             // Use provided timeCached, or current time if not provided
             // For bookmarks/favorites, timeCached should be set to preserve server order
-            cdTweet.timeCached = timeCached ?? Date()
-            
-            try? context.save()
+            cdTweet.timeCached = cachedAt
+            Self.setCacheColumns(on: cdTweet, uid: userId, isPrivate: tweetIsPrivate, mediaIds: mediaIds)
         }
         
         // Mark media as permanent for: private tweets OR bookmarks/favorites
@@ -547,97 +618,61 @@ extension TweetCacheManager {
     }
 
     func deleteExpiredTweets() {
-        context.performAndWait {
-            let request: NSFetchRequest<CDTweet> = CDTweet.fetchRequest()
-            let expirationDate = Date().addingTimeInterval(-maxCacheAge)
-            
-            if let allCachedTweets = try? context.fetch(request) {
-                var deletedCount = 0
-                var preservedPrivateCount = 0
-                
-                for cdTweet in allCachedTweets {
-                    guard let tweetId = cdTweet.tid else { continue }
-                    
-                    // Decode tweet to check if it's private
-                    guard let tweet = try? Tweet.from(cdTweet: cdTweet) else { continue }
-                    
-                    // NEVER auto-delete: private tweets OR bookmarks/favorites
-                    let isPrivate = tweet.isPrivate == true
-                    let isBookmarkOrFavorite = cdTweet.uid?.hasPrefix("bookmark_list_") == true || 
-                                               cdTweet.uid?.hasPrefix("favorite_list_") == true
-                    
-                    if isPrivate || isBookmarkOrFavorite {
-                        if isPrivate {
-                            preservedPrivateCount += 1
-                        }
-                        print("💾 [TweetCacheManager] Preserving permanent tweet: \(tweetId) (private: \(isPrivate), bookmarked: \(isBookmarkOrFavorite))")
-                        continue
-                    }
-                    
-                    // Check last access time (if available), otherwise fall back to timeCached
-                    let lastAccess = tweetAccessTimes[tweetId] ?? (cdTweet.timeCached ?? Date.distantPast)
-                    
-                    if lastAccess < expirationDate {
-                        // Tweet hasn't been accessed in 2 weeks - delete it and its media
-                        print("DEBUG: [TweetCacheManager] Deleting expired tweet: \(tweetId) (last access: \(lastAccess))")
-                        
-                        // Delete associated media files
-                        deleteMediaForTweet(tweet)
-                        
-                        // Remove from access times
-                        tweetAccessTimes.removeValue(forKey: tweetId)
-                        
-                        // Delete tweet from CoreData
-                        context.delete(cdTweet)
-                        deletedCount += 1
-                    }
-                }
-                
-                if deletedCount > 0 {
-                    try? context.save()
-                    saveAccessTimes()
-                    print("DEBUG: [TweetCacheManager] Deleted \(deletedCount) expired tweets, preserved \(preservedPrivateCount) private tweets")
-                }
+        // Pending views must reach lastAccess first, or recently viewed tweets would expire
+        flushAccessTimes()
+        
+        coreDataManager.performWrite { context in
+            let expirationDate = Date().addingTimeInterval(-self.maxCacheAge) as NSDate
+            // Last view if known, otherwise when the row was cached; permanent rows are never expired
+            let predicate = NSPredicate(
+                format: "isPermanent == NO AND (lastAccess < %@ OR (lastAccess == nil AND (timeCached == nil OR timeCached < %@)))",
+                expirationDate, expirationDate
+            )
+            let deleted = self.deleteTweetsAndMedia(matching: predicate, in: context)
+            if deleted > 0 {
+                print("DEBUG: [TweetCacheManager] Deleted \(deleted) expired tweets")
             }
         }
     }
     
     func deleteTweetsWithInvalidTimestamps() {
-        context.performAndWait {
-            let request: NSFetchRequest<CDTweet> = CDTweet.fetchRequest()
+        coreDataManager.performWrite { context in
+            let request = NSFetchRequest<NSFetchRequestResult>(entityName: "CDTweet")
             // Find tweets with timestamps before 1970 (invalid dates)
             let invalidDate = Date(timeIntervalSince1970: 0)
             request.predicate = NSPredicate(format: "timestamp <= %@", invalidDate as NSDate)
-            if let invalidTweets = try? context.fetch(request) {
-                print("ERROR: [TweetCacheManager] Found \(invalidTweets.count) tweets with invalid timestamps, deleting them")
-                for tweet in invalidTweets {
-                    context.delete(tweet)
-                }
-                try? context.save()
+            let deleted = self.coreDataManager.batchDelete(request, in: context)
+            if deleted > 0 {
+                print("ERROR: [TweetCacheManager] Deleted \(deleted) tweets with invalid timestamps")
             }
         }
     }
 
     func deleteTweet(mid: String) {
-        context.performAndWait {
-            let request: NSFetchRequest<CDTweet> = CDTweet.fetchRequest()
+        coreDataManager.performWrite { context in
+            let request = NSFetchRequest<NSFetchRequestResult>(entityName: "CDTweet")
             request.predicate = NSPredicate(format: "tid == %@", mid)
             // Delete ALL instances of this tweet (might be in multiple caches)
-            if let cdTweets = try? context.fetch(request) {
-                for cdTweet in cdTweets {
-                    context.delete(cdTweet)
-                }
-                if !cdTweets.isEmpty {
-                    print("DEBUG: [TweetCacheManager] Deleted \(cdTweets.count) cache entries for tweet: \(mid)")
-                }
-                try? context.save()
+            let deleted = self.coreDataManager.batchDelete(request, in: context)
+            if deleted > 0 {
+                print("DEBUG: [TweetCacheManager] Deleted \(deleted) cache entries for tweet: \(mid)")
             }
         }
     }
     
+    /// Delete one tweet from one cache only (e.g. it dropped out of the main feed), leaving
+    /// copies under other keys such as bookmarks untouched.
+    func removeTweet(mid: String, fromCache cacheKey: String) {
+        coreDataManager.performWrite { context in
+            let request = NSFetchRequest<NSFetchRequestResult>(entityName: "CDTweet")
+            request.predicate = NSPredicate(format: "tid == %@ AND uid == %@", mid, cacheKey)
+            self.coreDataManager.batchDelete(request, in: context)
+        }
+    }
+    
     /// Delete all tweets from a specific user from a specific cache (e.g., when unfollowing)
     func deleteTweetsFromUser(userId: String, cacheKey: String) {
-        context.performAndWait {
+        coreDataManager.performWrite { context in
             let request: NSFetchRequest<CDTweet> = CDTweet.fetchRequest()
             // Match tweets where uid (cache key) matches AND tweet's authorId matches userId
             request.predicate = NSPredicate(format: "uid == %@", cacheKey)
@@ -647,15 +682,12 @@ extension TweetCacheManager {
                 for cdTweet in cdTweets {
                     // Decode tweet to check authorId
                     if let tweet = try? Tweet.from(cdTweet: cdTweet), tweet.authorId == userId {
-                        // Remove from access times
-                        tweetAccessTimes.removeValue(forKey: tweet.mid)
                         context.delete(cdTweet)
                         deletedCount += 1
                     }
                 }
                 if deletedCount > 0 {
                     try? context.save()
-                    saveAccessTimes()
                     print("DEBUG: [TweetCacheManager] Deleted \(deletedCount) tweets from user \(userId) in cache: \(cacheKey)")
                 }
             }
@@ -663,14 +695,8 @@ extension TweetCacheManager {
     }
 
     func clearAllCache() {
-        context.performAndWait {
-            let request: NSFetchRequest<CDTweet> = CDTweet.fetchRequest()
-            if let allTweets = try? context.fetch(request) {
-                for tweet in allTweets {
-                    context.delete(tweet)
-                }
-                try? context.save()
-            }
+        coreDataManager.performWrite { context in
+            self.coreDataManager.batchDelete(NSFetchRequest<NSFetchRequestResult>(entityName: "CDTweet"), in: context)
         }
         
         // Also clear all users for soft restart
@@ -688,40 +714,45 @@ extension TweetCacheManager {
     func releasePartialCache(percentage: Int) {
         let percentageToRemove = max(1, min(percentage, 90)) // Ensure 1-90% range
         
-        context.performAndWait {
-            let request: NSFetchRequest<CDTweet> = CDTweet.fetchRequest()
+        coreDataManager.performWrite { context in
+            let request = NSFetchRequest<NSManagedObjectID>(entityName: "CDTweet")
+            request.resultType = .managedObjectIDResultType
             
             // Sort by cache time (oldest first) for LRU strategy
             request.sortDescriptors = [NSSortDescriptor(key: "timeCached", ascending: true)]
             
-            if let allTweets = try? context.fetch(request) {
-                let countToRemove = max(1, (allTweets.count * percentageToRemove) / 100)
-                let tweetsToRemove = Array(allTweets.prefix(countToRemove))
-                
-                for tweet in tweetsToRemove {
-                    context.delete(tweet)
-                }
-                
-                try? context.save()
+            guard let total = try? context.count(for: request), total > 0 else { return }
+            request.fetchLimit = max(1, (total * percentageToRemove) / 100)
+            if let tweetsToRemove = try? context.fetch(request) {
+                self.coreDataManager.batchDelete(objectIDs: tweetsToRemove, in: context)
             }
         }
     }
     
     func clearCacheForUser(userId: String) {
-        context.performAndWait {
-            let request: NSFetchRequest<CDTweet> = CDTweet.fetchRequest()
+        coreDataManager.performWrite { context in
+            let request = NSFetchRequest<NSFetchRequestResult>(entityName: "CDTweet")
             request.predicate = NSPredicate(format: "uid == %@", userId)
-            if let userTweets = try? context.fetch(request) {
-                for tweet in userTweets {
-                    context.delete(tweet)
-                }
-                try? context.save()
-                print("[TweetCacheManager] Cleared cache for user: \(userId)")
-            }
+            let deleted = self.coreDataManager.batchDelete(request, in: context)
+            print("[TweetCacheManager] Cleared \(deleted) cached tweets for user: \(userId)")
         }
     }
 }
 
+/// The two Tweet fields the cache columns are derived from, decoded without building a Tweet
+/// (Tweet.from(cdTweet:) registers singletons and may trigger user fetches).
+private struct CachedTweetColumns: Decodable {
+    let isPrivate: Bool?
+    let attachments: [MimeiFileType]?
+    
+    static func decode(_ data: Data?) -> CachedTweetColumns? {
+        guard let data else { return nil }
+        let decoder = JSONDecoder()
+        decoder.dateDecodingStrategy = .millisecondsSince1970
+        return try? decoder.decode(CachedTweetColumns.self, from: data)
+    }
+}
+
 // MARK: - Tweet <-> Core Data Conversion
 extension Tweet {
     static func from(cdTweet: CDTweet) throws -> Tweet {
@@ -813,6 +844,32 @@ extension TweetCacheManager {
         }
     }
     
+    /// Load a batch of users into their singletons with one Core Data fetch.
+    /// Returns the ids that now have a username, i.e. can be rendered without a network call.
+    func fetchUsers(mids: [String]) async -> Set<String> {
+        guard !mids.isEmpty else { return [] }
+        return await withCheckedContinuation { continuation in
+            let inMemory = Set(mids.filter { User.getInstance(mid: $0).username != nil })
+            let missing = mids.filter { !inMemory.contains($0) }
+            guard !missing.isEmpty else {
+                continuation.resume(returning: inMemory)
+                return
+            }
+            context.perform {
+                var resolved = inMemory
+                let request: NSFetchRequest<CDUser> = CDUser.fetchRequest()
+                request.predicate = NSPredicate(format: "mid IN %@", missing)
+                for cdUser in (try? self.context.fetch(request)) ?? [] {
+                    let user = User.from(cdUser: cdUser)
+                    if user.username != nil {
+                        resolved.insert(user.mid)
+                    }
+                }
+                continuation.resume(returning: resolved)
+            }
+        }
+    }
+
     /// Internal method used by User.hasExpired computed property
     /// Checks if a user's cache has expired (30 minutes)
     func hasExpired(mid: String) async -> Bool {
@@ -837,16 +894,19 @@ extension TweetCacheManager {
             return
         }
 
-        // Use async perform to avoid blocking the main thread
-        context.perform {
+        // Encode on the caller, then write on the writer queue so the main thread never blocks
+        let mid = user.mid
+        let userAvatarMissing = User.sanitizedAvatarId(user.avatar) == nil
+        let freshUserData = try? JSONEncoder().encode(user)
+        coreDataManager.performWrite { context in
             let request: NSFetchRequest<CDUser> = CDUser.fetchRequest()
-            request.predicate = NSPredicate(format: "mid == %@", user.mid)
-            let cdUser = (try? self.context.fetch(request).first) ?? CDUser(context: self.context)
-            cdUser.mid = user.mid
+            request.predicate = NSPredicate(format: "mid == %@", mid)
+            let cdUser = (try? context.fetch(request).first) ?? CDUser(context: context)
+            cdUser.mid = mid
             cdUser.timeCached = Date()
 
-            var encodedUserData = try? JSONEncoder().encode(user)
-            if User.sanitizedAvatarId(user.avatar) == nil,
+            var encodedUserData = freshUserData
+            if userAvatarMissing,
                let existingData = cdUser.userData,
                let existingUser = try? JSONDecoder().decode(User.self, from: existingData),
                let existingAvatar = User.sanitizedAvatarId(existingUser.avatar),
@@ -859,7 +919,6 @@ extension TweetCacheManager {
             if let userData = encodedUserData {
                 cdUser.userData = userData
             }
-            try? self.context.save()
         }
     }
     
@@ -871,25 +930,16 @@ extension TweetCacheManager {
     }
 
     func deleteUser(mid: String) {
-        context.performAndWait {
-            let request: NSFetchRequest<CDUser> = CDUser.fetchRequest()
+        coreDataManager.performWrite { context in
+            let request = NSFetchRequest<NSFetchRequestResult>(entityName: "CDUser")
             request.predicate = NSPredicate(format: "mid == %@", mid)
-            if let cdUser = try? context.fetch(request).first {
-                context.delete(cdUser)
-                try? context.save()
-            }
+            self.coreDataManager.batchDelete(request, in: context)
         }
     }
 
     func clearAllUsers() {
-        context.performAndWait {
-            let request: NSFetchRequest<CDUser> = CDUser.fetchRequest()
-            if let allUsers = try? context.fetch(request) {
-                for user in allUsers {
-                    context.delete(user)
-                }
-                try? context.save()
-            }
+        coreDataManager.performWrite { context in
+            self.coreDataManager.batchDelete(NSFetchRequest<NSFetchRequestResult>(entityName: "CDUser"), in: context)
         }
     }
     
@@ -2,7 +2,6 @@ import Foundation
 import UIKit
 
 /// Persists measured tweet cell heights to UserDefaults so they survive app restarts.
-/// Mirrors the TweetAccessTimes pattern in TweetCacheManager.
 class TweetHeightCache {
     static let shared = TweetHeightCache()
 
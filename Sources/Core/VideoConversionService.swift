@@ -18,6 +18,17 @@ struct ConversionProgress {
     let stage: String
     let progress: Int // 0-100
     let estimatedTimeRemaining: TimeInterval?
+
+    /// `stage` with the remaining time appended once it is known
+    var displayStage: String {
+        guard let eta = estimatedTimeRemaining, eta.isFinite, eta >= 1 else { return stage }
+        let formatter = DateComponentsFormatter()
+        formatter.unitsStyle = .abbreviated
+        formatter.allowedUnits = eta >= 3600 ? [.hour, .minute] : [.minute, .second]
+        formatter.maximumUnitCount = 2
+        guard let remaining = formatter.string(from: eta.rounded()) else { return stage }
+        return String(format: NSLocalizedString("%@ (%@ left)", comment: "Conversion stage with time remaining"), stage, remaining)
+    }
 }
 
 class VideoConversionService {
@@ -30,6 +41,21 @@ class VideoConversionService {
     private var currentConversion: Task<Void, Never>?
     private var progressCallback: ((ConversionProgress) -> Void)?
 
+    // Statistics-driven progress of the running conversion; FFmpegKit reports on its own thread
+    private let stateLock = NSLock()
+    private var transcode: TranscodeProgress?
+    /// The conversion `transcode` belongs to; a cancelled one winding down must not clear its successor's
+    private var transcodeOwner: UUID?
+    private var currentSessionId: Int?
+    private var currentStage = ""
+    private var lastProgressEmit: TimeInterval = 0
+    private let progressEmitInterval: TimeInterval = 0.5
+    /// Share of the 0-100 scale before the first pass and after the last one
+    private let passProgressRange = 10...90
+    /// Pause before the next pass when the previous one collapsed or the device is hot
+    private let minimumCooldown: TimeInterval = 5
+    private let maximumCooldown: TimeInterval = 60
+
     private init() {
         // FFmpegKit configuration
     }
@@ -262,9 +288,19 @@ class VideoConversionService {
         }
     }
     
+    /// Cancels the conversion task and kills its FFmpeg session; the task removes the
+    /// partial HLS output when the session ends.
     func cancelCurrentConversion() {
         currentConversion?.cancel()
         currentConversion = nil
+        let sessionId = stateLock.withLock { () -> Int? in
+            defer { currentSessionId = nil }
+            return currentSessionId
+        }
+        if let sessionId {
+            print("DEBUG: [VIDEO CONVERSION] Cancelling FFmpeg session \(sessionId)")
+            FFmpegKit.cancel(sessionId)
+        }
     }
     
     // MARK: - Async Conversion
@@ -344,12 +380,33 @@ class VideoConversionService {
         }
         print("DEBUG: [MASTER PLAYLIST] Final \(lowerResolution)p resolution: \(actualLowerResResolution)")
         
+        // Each pass reads the whole source, so progress is driven by FFmpeg's media time
+        // against the probed duration
+        let duration = await MediaProbeCache.shared.probe(fileAt: inputURL)?.duration ?? 0
+        var passes = [TranscodeProgress.Pass(name: "\(lowerResolution)p", weight: 1)]
+        if !singleVariant480p {
+            passes.insert(TranscodeProgress.Pass(name: "\(highQualityResolution)p", weight: 1), at: 0)
+        }
+        let conversionId = UUID()
+        stateLock.withLock {
+            transcode = TranscodeProgress(passes: passes, duration: duration)
+            transcodeOwner = conversionId
+        }
+        defer {
+            stateLock.withLock {
+                if transcodeOwner == conversionId {
+                    transcode = nil
+                    transcodeOwner = nil
+                }
+            }
+        }
+        
         var resultHighQuality = true
         
         // Step 1: Convert to high-quality HLS (if dual variant mode)
         if !singleVariant480p {
             print("📹 [HLS CONVERSION] Step 1/3: Converting high-quality variant (\(highQualityResolution)p)")
-            await updateProgress(stage: "Converting to \(highQualityResolution)p HLS...", progress: 10)
+            await beginPass(0, stage: "Converting to \(highQualityResolution)p HLS...")
             logMemoryUsage("before \(highQualityResolution)p conversion")
             
             resultHighQuality = await convertToHLSAsync(
@@ -374,6 +431,10 @@ class VideoConversionService {
             logMemoryUsage("after cleanup pause")
             
             guard resultHighQuality else {
+                if Task.isCancelled {
+                    await finishCancelled(hlsDirectory: hlsDirectory, completion: completion)
+                    return
+                }
                 await MainActor.run {
                     completion(HLSConversionResult(
                         success: false,
@@ -386,10 +447,16 @@ class VideoConversionService {
         }
         
         // Step 2: Convert to lower resolution HLS
-        let progressStart = singleVariant480p ? 10 : 60
         let stepNumber = singleVariant480p ? "1/2" : "2/3"
+        if !singleVariant480p {
+            await coolDownIfNeeded()
+        }
+        guard !Task.isCancelled else {
+            await finishCancelled(hlsDirectory: hlsDirectory, completion: completion)
+            return
+        }
         print("📹 [HLS CONVERSION] Step \(stepNumber): Converting lower variant (480p)")
-        await updateProgress(stage: "Converting to \(lowerResolution)p HLS...", progress: progressStart)
+        await beginPass(passes.count - 1, stage: "Converting to \(lowerResolution)p HLS...")
         logMemoryUsage("before \(lowerResolution)p conversion")
         
         let resultLowerRes = await convertToHLSAsync(
@@ -413,6 +480,10 @@ class VideoConversionService {
         logMemoryUsage("after final cleanup pause")
         
         guard resultLowerRes else {
+            if Task.isCancelled {
+                await finishCancelled(hlsDirectory: hlsDirectory, completion: completion)
+                return
+            }
             await MainActor.run {
                 completion(HLSConversionResult(
                     success: false,
@@ -423,10 +494,16 @@ class VideoConversionService {
             return
         }
         
+        // A cancel after the last pass finished must not publish the output
+        guard !Task.isCancelled else {
+            await finishCancelled(hlsDirectory: hlsDirectory, completion: completion)
+            return
+        }
+        
         // Step 3: Create master playlist (both single and dual variant)
         let finalStepNumber = singleVariant480p ? "2/2" : "3/3"
         print("📹 [HLS CONVERSION] Step \(finalStepNumber): Creating master playlist")
-        await updateProgress(stage: "Creating master playlist...", progress: 90)
+        await updateProgress(stage: "Creating master playlist...", progress: passProgressRange.upperBound)
         logMemoryUsage("before master playlist creation")
         
         let masterPlaylistCreated = await createMasterPlaylist(
@@ -469,12 +546,106 @@ class VideoConversionService {
         }
     }
     
-    private func updateProgress(stage: String, progress: Int) async {
+    private func updateProgress(stage: String, progress: Int, estimatedTimeRemaining: TimeInterval? = nil) async {
         await MainActor.run {
             self.progressCallback?(ConversionProgress(
                 stage: stage,
                 progress: progress,
-                estimatedTimeRemaining: nil
+                estimatedTimeRemaining: estimatedTimeRemaining
+            ))
+        }
+    }
+    
+    // MARK: - Statistics-Driven Progress
+    
+    private func beginPass(_ index: Int, stage: String) async {
+        let snapshot = stateLock.withLock { () -> TranscodeProgress.Snapshot? in
+            currentStage = stage
+            lastProgressEmit = 0
+            transcode?.beginPass(index, at: ProcessInfo.processInfo.systemUptime)
+            return transcode?.snapshot
+        }
+        await updateProgress(
+            stage: stage,
+            progress: scaledProgress(snapshot?.overallFraction ?? 0),
+            estimatedTimeRemaining: snapshot?.estimatedTimeRemaining
+        )
+    }
+    
+    /// Called on FFmpegKit's statistics thread; forwards at most every `progressEmitInterval`.
+    private func handleStatistics(_ statistics: Statistics) {
+        let now = ProcessInfo.processInfo.systemUptime
+        let update = stateLock.withLock { () -> (snapshot: TranscodeProgress.Snapshot, stage: String, collapsedNow: Bool)? in
+            guard statistics.getSessionId() == currentSessionId, var model = transcode else { return nil }
+            let wasCollapsed = model.snapshot.isSpeedCollapsed
+            let snapshot = model.record(
+                time: statistics.getTime(),
+                speed: statistics.getSpeed(),
+                size: Int64(statistics.getSize()),
+                at: now
+            )
+            transcode = model
+            let collapsedNow = snapshot.isSpeedCollapsed && !wasCollapsed
+            guard collapsedNow || now - lastProgressEmit >= progressEmitInterval else { return nil }
+            lastProgressEmit = now
+            return (snapshot, currentStage, collapsedNow)
+        }
+        guard let update else { return }
+        
+        if update.collapsedNow {
+            print("WARNING: [VIDEO CONVERSION] Encode speed collapsed to \(String(format: "%.2f", update.snapshot.speed))x (thermal state \(ProcessInfo.processInfo.thermalState.rawValue))")
+        }
+        Task {
+            await updateProgress(
+                stage: update.stage,
+                progress: scaledProgress(update.snapshot.overallFraction),
+                estimatedTimeRemaining: update.snapshot.estimatedTimeRemaining
+            )
+        }
+    }
+    
+    private func scaledProgress(_ fraction: Double) -> Int {
+        let span = Double(passProgressRange.upperBound - passProgressRange.lowerBound)
+        return passProgressRange.lowerBound + Int((min(1, max(0, fraction)) * span).rounded(.down))
+    }
+    
+    /// FFmpegKit can't pause a session, so a pass whose speed collapsed (typically thermal
+    /// throttling) is allowed to finish and the next one waits for the device to cool down.
+    private func coolDownIfNeeded() async {
+        let collapsed = stateLock.withLock { transcode?.snapshot.isSpeedCollapsed ?? false }
+        guard collapsed || isThermallyConstrained else { return }
+        
+        let snapshot = stateLock.withLock { transcode?.snapshot }
+        print("WARNING: [VIDEO CONVERSION] Pausing before next pass (speed collapsed: \(collapsed), thermal state \(ProcessInfo.processInfo.thermalState.rawValue))")
+        await updateProgress(
+            stage: NSLocalizedString("Waiting for device to cool down...", comment: "Video conversion paused while the device is hot"),
+            progress: scaledProgress(snapshot?.overallFraction ?? 0)
+        )
+        
+        var waited: TimeInterval = 0
+        while waited < maximumCooldown, !Task.isCancelled {
+            if !isThermallyConstrained && (!collapsed || waited >= minimumCooldown) {
+                break
+            }
+            try? await Task.sleep(nanoseconds: 1_000_000_000)
+            waited += 1
+        }
+        print("DEBUG: [VIDEO CONVERSION] Resumed after \(Int(waited))s cooldown")
+    }
+    
+    private var isThermallyConstrained: Bool {
+        let state = ProcessInfo.processInfo.thermalState
+        return state == .serious || state == .critical
+    }
+    
+    private func finishCancelled(hlsDirectory: URL, completion: @escaping (HLSConversionResult) -> Void) async {
+        try? FileManager.default.removeItem(at: hlsDirectory)
+        print("DEBUG: [VIDEO CONVERSION] Conversion cancelled, removed partial output at \(hlsDirectory.lastPathComponent)")
+        await MainActor.run {
+            completion(HLSConversionResult(
+                success: false,
+                hlsDirectoryURL: nil,
+                errorMessage: "Conversion cancelled"
             ))
         }
     }
@@ -593,18 +764,27 @@ class VideoConversionService {
         cachedVideoInfo: (width: Int, height: Int, displayWidth: Int, displayHeight: Int, rotation: Int)?,
         isNormalized: Bool
     ) async -> Bool {
-        return await withCheckedContinuation { continuation in
-            convertToHLS(
-                inputURL: inputURL,
-                outputURL: outputURL,
-                resolution: resolution,
-                bitrate: bitrate,
-                aspectRatio: aspectRatio,
-                cachedVideoInfo: cachedVideoInfo,
-                isNormalized: isNormalized
-            ) { success in
-                continuation.resume(returning: success)
+        guard !Task.isCancelled else { return false }
+        // convertToHLS builds the command in a task of its own, which doesn't see this one's
+        // cancellation; the flag carries it up to the moment FFmpeg starts
+        let cancellation = PassCancellation()
+        return await withTaskCancellationHandler {
+            await withCheckedContinuation { continuation in
+                convertToHLS(
+                    inputURL: inputURL,
+                    outputURL: outputURL,
+                    resolution: resolution,
+                    bitrate: bitrate,
+                    aspectRatio: aspectRatio,
+                    cachedVideoInfo: cachedVideoInfo,
+                    isNormalized: isNormalized,
+                    cancellation: cancellation
+                ) { success in
+                    continuation.resume(returning: success)
+                }
             }
+        } onCancel: {
+            cancellation.cancel()
         }
     }
     
@@ -666,6 +846,7 @@ class VideoConversionService {
         aspectRatio: Float?,
         cachedVideoInfo: (width: Int, height: Int, displayWidth: Int, displayHeight: Int, rotation: Int)?,
         isNormalized: Bool,
+        cancellation: PassCancellation,
         completion: @escaping (Bool) -> Void
     ) {
         Task {
@@ -735,7 +916,7 @@ class VideoConversionService {
                 )
 
                 await MainActor.run {
-                    self.executeFFmpegCommand(command: copyCommand, outputURL: outputURL, resolution: resolution, completion: completion)
+                    self.executeFFmpegCommand(command: copyCommand, outputURL: outputURL, resolution: resolution, cancellation: cancellation, completion: completion)
                 }
             } else {
                 print("========== \(targetResolution)p VARIANT: RE-ENCODING (VideoToolbox H.264) ==========")
@@ -809,7 +990,7 @@ class VideoConversionService {
                 )
 
                 await MainActor.run {
-                    self.executeFFmpegCommand(command: h264Command, outputURL: outputURL, resolution: resolution, completion: completion)
+                    self.executeFFmpegCommand(command: h264Command, outputURL: outputURL, resolution: resolution, cancellation: cancellation, completion: completion)
                 }
             }
         }
@@ -894,19 +1075,37 @@ class VideoConversionService {
         command: String,
         outputURL: URL,
         resolution: String,
+        cancellation: PassCancellation,
         completion: @escaping (Bool) -> Void
     ) {
+        guard !cancellation.isCancelled else {
+            print("🛑 [FFMPEG] Conversion to \(resolution) cancelled before it started")
+            completion(false)
+            return
+        }
         print("🎬 [FFMPEG] Starting conversion to \(resolution)")
         print("  Full command: \(command)")
         
-        FFmpegKit.executeAsync(command) { session in
+        let session = FFmpegKit.executeAsync(command, withCompleteCallback: { [weak self] session in
             guard let session = session else {
                 print("❌ [FFMPEG] Failed to create FFmpeg session for \(resolution)")
                 completion(false)
                 return
             }
+            if let self {
+                self.stateLock.withLock {
+                    if self.currentSessionId == session.getSessionId() {
+                        self.currentSessionId = nil
+                    }
+                }
+            }
             
             let returnCode = session.getReturnCode()
+            if ReturnCode.isCancel(returnCode) {
+                print("🛑 [FFMPEG] Conversion to \(resolution) cancelled")
+                completion(false)
+                return
+            }
             let logs = session.getLogs()
             
             print("🎬 [FFMPEG] Conversion to \(resolution) completed with return code: \(String(describing: returnCode))")
@@ -954,6 +1153,20 @@ class VideoConversionService {
                 print("❌ [FFMPEG] Conversion failed for \(resolution)")
                 completion(false)
             }
+        }, withLogCallback: nil, withStatisticsCallback: { [weak self] statistics in
+            guard let statistics else { return }
+            self?.handleStatistics(statistics)
+        })
+        
+        if let session {
+            stateLock.withLock {
+                currentSessionId = session.getSessionId()
+            }
+            // cancelCurrentConversion sets the flag before it looks for a session, so a cancel
+            // that found none is caught here
+            if cancellation.isCancelled {
+                FFmpegKit.cancel(session.getSessionId())
+            }
         }
     }
     
@@ -961,64 +1174,26 @@ class VideoConversionService {
         inputURL: URL,
         completion: @escaping (VideoInfo?) -> Void
     ) {
-        let command = "-i \"\(inputURL.path)\" -f null -"
-        
-        FFmpegKit.executeAsync(command) { session in
-            guard let session = session else {
+        Task {
+            guard let probe = await MediaProbeCache.shared.probe(fileAt: inputURL) else {
                 completion(nil)
                 return
             }
-            
-            let logs = session.getLogs()
-            let videoInfo = self.parseVideoInfo(from: logs?.compactMap { $0 as? Log } ?? [])
-            completion(videoInfo)
+            completion(VideoInfo(width: probe.width, height: probe.height, duration: probe.duration))
         }
     }
-    
-    private func parseVideoInfo(from logs: [Log]) -> VideoInfo? {
-        var width: Int = 0
-        var height: Int = 0
-        var duration: Double?
-        
-        for log in logs {
-            guard let message = log.getMessage() else { continue }
-            
-            // Parse resolution from stream info
-            if message.contains("Stream #0:0") && message.contains("Video:") {
-                let components = message.components(separatedBy: ",")
-                for component in components {
-                    let trimmed = component.trimmingCharacters(in: .whitespacesAndNewlines)
-                    if trimmed.contains("x") && trimmed.allSatisfy({ $0.isNumber || $0 == "x" }) {
-                        let dimensions = trimmed.components(separatedBy: "x")
-                        if dimensions.count == 2,
-                           let w = Int(dimensions[0]),
-                           let h = Int(dimensions[1]) {
-                            width = w
-                            height = h
-                        }
-                    }
-                }
-            }
-            
-            // Parse duration
-            if message.contains("Duration:") {
-                let components = message.components(separatedBy: " ")
-                for component in components {
-                    if component.contains(":") && component.contains(".") {
-                        let timeComponents = component.components(separatedBy: ":")
-                        if timeComponents.count == 3 {
-                            let seconds = timeComponents[2].components(separatedBy: ".")[0]
-                            if let secs = Double(seconds) {
-                                let minutes = Double(timeComponents[1]) ?? 0
-                                let hours = Double(timeComponents[0]) ?? 0
-                                duration = hours * 3600 + minutes * 60 + secs
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        
-        return VideoInfo(width: width, height: height, duration: duration)
+}
+
+/// Cancellation of one FFmpeg pass, readable from the threads that start it.
+private final class PassCancellation: @unchecked Sendable {
+    private var cancelled = false
+    private let lock = NSLock()
+
+    var isCancelled: Bool {
+        lock.withLock { cancelled }
+    }
+
+    func cancel() {
+        lock.withLock { cancelled = true }
     }
 }
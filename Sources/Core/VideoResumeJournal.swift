@@ -0,0 +1,259 @@
+//
+//  VideoResumeJournal.swift
+//  Tweet
+//
+//  Append-only, memory-mapped log of video resume positions so they survive the app
+//  being killed or evicted.
+//
+
+import Foundation
+
+/// Fixed-size records appended to a memory-mapped file.
+///
+/// Each record carries a checksum written after its payload; on launch the file is replayed
+/// up to the first record that doesn't verify, so a kill in the middle of an append loses at
+/// most that record. When the file fills up, the live records (newest `maxEntries`) are
+/// rewritten into a fresh file and the tail starts over. All I/O runs on `queue`.
+final class VideoResumeJournal: @unchecked Sendable {
+    struct Key: Hashable {
+        let midHash: UInt64
+        let context: UInt8
+    }
+
+    struct Entry {
+        let midHash: UInt64
+        let context: UInt8
+        let position: Double
+        /// Zero when the saver didn't know the duration
+        let duration: Double
+        let timestamp: Double
+        let wasPlaying: Bool
+        /// Tombstone: the state was cleared
+        let cleared: Bool
+
+        var key: Key { Key(midHash: midHash, context: context) }
+    }
+
+    private static let headerSize = 64
+    private static let recordSize = 48
+    private static let magic: UInt32 = 0x56524A31 // "VRJ1"
+
+    private let url: URL
+    private let capacity: Int
+    private let maxEntries: Int
+    private let maxAge: TimeInterval
+    private let queue = DispatchQueue(label: "com.zz.VideoResumeJournal", qos: .utility)
+
+    private var fileDescriptor: Int32 = -1
+    private var mapping: UnsafeMutableRawPointer?
+    private var mappedSize = 0
+    private var tail = 0
+    /// Latest record per key, mirrored so compaction doesn't have to re-read the file
+    private var live: [Key: Entry] = [:]
+
+    init(url: URL, capacity: Int = 4096, maxEntries: Int = 500, maxAge: TimeInterval) {
+        self.url = url
+        self.capacity = capacity
+        self.maxEntries = maxEntries
+        self.maxAge = maxAge
+    }
+
+    deinit {
+        unmap()
+    }
+
+    // MARK: - Public Methods
+
+    /// Replay the journal. Call once, before the first append.
+    func load() -> [Key: Entry] {
+        queue.sync {
+            guard map() else { return [:] }
+            replay()
+            // Start each launch with a compact file so the tail has room
+            if tail > capacity / 2 {
+                compact()
+            }
+            return live.filter { !$0.value.cleared }
+        }
+    }
+
+    /// Append records. Returns immediately; the write happens on the journal queue.
+    func append(_ entries: [Entry]) {
+        guard !entries.isEmpty else { return }
+        queue.async {
+            for entry in entries {
+                if self.tail >= self.capacity {
+                    self.compact()
+                }
+                guard self.write(entry, at: self.tail) else { return }
+                self.tail += 1
+                self.live[entry.key] = entry
+            }
+            if let mapping = self.mapping {
+                msync(mapping, self.mappedSize, MS_ASYNC)
+            }
+        }
+    }
+
+    /// Block until queued appends have reached the mapping (app backgrounding).
+    func flush() {
+        queue.sync {
+            if let mapping {
+                msync(mapping, mappedSize, MS_SYNC)
+            }
+        }
+    }
+
+    func removeAll() {
+        queue.async {
+            self.live.removeAll()
+            self.compact()
+        }
+    }
+
+    static func hash(_ mid: String) -> UInt64 {
+        var hash: UInt64 = 0xcbf29ce484222325
+        for byte in mid.utf8 {
+            hash ^= UInt64(byte)
+            hash &*= 0x100000001b3
+        }
+        return hash
+    }
+
+    // MARK: - File
+
+    private var fileSize: Int { Self.headerSize + capacity * Self.recordSize }
+
+    private func map() -> Bool {
+        let fd = open(url.path, O_RDWR | O_CREAT, 0o644)
+        guard fd >= 0 else {
+            print("ERROR: [VideoResumeJournal] open failed: \(errno)")
+            return false
+        }
+        var info = stat()
+        if fstat(fd, &info) != 0 || Int(info.st_size) != fileSize {
+            // New file or a different capacity: start empty
+            guard ftruncate(fd, 0) == 0, ftruncate(fd, off_t(fileSize)) == 0 else {
+                close(fd)
+                return false
+            }
+        }
+        let pointer = mmap(nil, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+        guard let pointer, pointer != MAP_FAILED else {
+            print("ERROR: [VideoResumeJournal] mmap failed: \(errno)")
+            close(fd)
+            return false
+        }
+        fileDescriptor = fd
+        mapping = pointer
+        mappedSize = fileSize
+        if pointer.load(as: UInt32.self) != Self.magic {
+            memset(pointer, 0, fileSize)
+            pointer.storeBytes(of: Self.magic, as: UInt32.self)
+        }
+        return true
+    }
+
+    private func unmap() {
+        if let mapping {
+            munmap(mapping, mappedSize)
+        }
+        if fileDescriptor >= 0 {
+            close(fileDescriptor)
+        }
+        mapping = nil
+        fileDescriptor = -1
+    }
+
+    private func replay() {
+        live.removeAll()
+        tail = 0
+        while tail < capacity, let entry = read(at: tail) {
+            live[entry.key] = entry
+            tail += 1
+        }
+        if tail > 0 {
+            print("DEBUG: [VideoResumeJournal] Replayed \(tail) records, \(live.count) keys")
+        }
+    }
+
+    /// Rewrite the newest `maxEntries` live, unexpired records into a fresh file.
+    private func compact() {
+        let cutoff = Date().timeIntervalSince1970 - maxAge
+        let kept = live.values
+            .filter { !$0.cleared && $0.timestamp > cutoff }
+            .sorted { $0.timestamp > $1.timestamp }
+            .prefix(min(maxEntries, capacity))
+
+        var buffer = Data(count: fileSize)
+        buffer.withUnsafeMutableBytes { raw in
+            guard let base = raw.baseAddress else { return }
+            base.storeBytes(of: Self.magic, as: UInt32.self)
+            for (slot, entry) in kept.enumerated() {
+                Self.encode(entry, into: base.advanced(by: Self.headerSize + slot * Self.recordSize))
+            }
+        }
+
+        unmap()
+        do {
+            try buffer.write(to: url, options: [.atomic])
+        } catch {
+            print("ERROR: [VideoResumeJournal] Compaction write failed: \(error)")
+        }
+        guard map() else {
+            live.removeAll()
+            tail = capacity
+            return
+        }
+        live = Dictionary(kept.map { ($0.key, $0) }, uniquingKeysWith: { $1 })
+        tail = kept.count
+    }
+
+    // MARK: - Records
+
+    private func write(_ entry: Entry, at slot: Int) -> Bool {
+        guard let mapping else { return false }
+        Self.encode(entry, into: mapping.advanced(by: Self.headerSize + slot * Self.recordSize))
+        return true
+    }
+
+    private func read(at slot: Int) -> Entry? {
+        guard let mapping else { return nil }
+        let record = UnsafeRawPointer(mapping.advanced(by: Self.headerSize + slot * Self.recordSize))
+        guard record.load(fromByteOffset: 44, as: UInt32.self) == Self.checksum(record) else { return nil }
+        let flags = record.load(fromByteOffset: 33, as: UInt8.self)
+        return Entry(
+            midHash: record.load(fromByteOffset: 0, as: UInt64.self),
+            context: record.load(fromByteOffset: 32, as: UInt8.self),
+            position: record.load(fromByteOffset: 8, as: Double.self),
+            duration: record.load(fromByteOffset: 16, as: Double.self),
+            timestamp: record.load(fromByteOffset: 24, as: Double.self),
+            wasPlaying: flags & 1 != 0,
+            cleared: flags & 2 != 0
+        )
+    }
+
+    /// Layout: hash(8) position(8) duration(8) timestamp(8) context(1) flags(1) pad(10) checksum(4).
+    /// The checksum is stored last so a torn write never verifies.
+    private static func encode(_ entry: Entry, into record: UnsafeMutableRawPointer) {
+        record.storeBytes(of: UInt32(0), toByteOffset: 44, as: UInt32.self)
+        record.storeBytes(of: entry.midHash, toByteOffset: 0, as: UInt64.self)
+        record.storeBytes(of: entry.position, toByteOffset: 8, as: Double.self)
+        record.storeBytes(of: entry.duration, toByteOffset: 16, as: Double.self)
+        record.storeBytes(of: entry.timestamp, toByteOffset: 24, as: Double.self)
+        record.storeBytes(of: entry.context, toByteOffset: 32, as: UInt8.self)
+        record.storeBytes(of: UInt8((entry.wasPlaying ? 1 : 0) | (entry.cleared ? 2 : 0)), toByteOffset: 33, as: UInt8.self)
+        memset(record.advanced(by: 34), 0, 10)
+        record.storeBytes(of: checksum(UnsafeRawPointer(record)), toByteOffset: 44, as: UInt32.self)
+    }
+
+    /// FNV-1a over the first 44 bytes, folded to 32 bits. An all-zero slot never verifies.
+    private static func checksum(_ record: UnsafeRawPointer) -> UInt32 {
+        var hash: UInt64 = 0xcbf29ce484222325
+        for offset in 0..<44 {
+            hash ^= UInt64(record.load(fromByteOffset: offset, as: UInt8.self))
+            hash &*= 0x100000001b3
+        }
+        return UInt32(truncatingIfNeeded: hash ^ (hash >> 32))
+    }
+}
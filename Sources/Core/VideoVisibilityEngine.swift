@@ -0,0 +1,166 @@
+//
+//  VideoVisibilityEngine.swift
+//  Tweet
+//
+//  Picks the video to autoplay from registered content-space frames and the visible
+//  scroll rect. Foundation only, so the decision logic has no view or UIKit state.
+//
+
+import Foundation
+
+/// Chooses the topmost video that is visible enough to play.
+///
+/// Frames are registered in scroll-content coordinates, so they only change on layout, not
+/// on scroll. They are kept sorted by `minY`; a decision binary-searches the first frame that
+/// can overlap the viewport and walks only the frames inside it.
+///
+/// Hysteresis: the current video keeps playing while at least `continueRatio` of it is
+/// visible, and a different winner must hold for `switchDelay` before playback moves to it.
+struct VideoVisibilityEngine {
+    struct Frame: Equatable {
+        var minY: Double
+        var maxY: Double
+
+        var height: Double { maxY - minY }
+    }
+
+    private struct Entry {
+        let id: String
+        var frame: Frame
+    }
+
+    let startRatio: Double
+    let continueRatio: Double
+    let switchDelay: TimeInterval
+
+    /// Sorted by `frame.minY`, then `id`
+    private var entries: [Entry] = []
+    /// Upper bound of any registered height, so the search can start above the viewport
+    private var maxHeight: Double = 0
+
+    private(set) var current: String?
+    private var pending: (id: String?, since: TimeInterval)?
+
+    init(startRatio: Double, continueRatio: Double, switchDelay: TimeInterval) {
+        self.startRatio = startRatio
+        self.continueRatio = continueRatio
+        self.switchDelay = switchDelay
+    }
+
+    var count: Int { entries.count }
+
+    // MARK: - Registration
+
+    /// Register or move a video. Returns false when the frame didn't change.
+    @discardableResult
+    mutating func update(id: String, frame: Frame) -> Bool {
+        if let index = indexOf(id) {
+            guard entries[index].frame != frame else { return false }
+            entries.remove(at: index)
+        }
+        entries.insert(Entry(id: id, frame: frame), at: insertionIndex(minY: frame.minY, id: id))
+        maxHeight = max(maxHeight, frame.height)
+        return true
+    }
+
+    mutating func remove(id: String) {
+        guard let index = indexOf(id) else { return }
+        entries.remove(at: index)
+        if entries.isEmpty {
+            maxHeight = 0
+        }
+    }
+
+    mutating func removeAll() {
+        entries.removeAll()
+        maxHeight = 0
+        current = nil
+        pending = nil
+    }
+
+    /// Forget the current choice so the next decision starts playback again.
+    mutating func resetCurrent() {
+        current = nil
+        pending = nil
+    }
+
+    // MARK: - Decision
+
+    /// Run one decision for the viewport `[viewportMinY, viewportMaxY]` at time `now`.
+    /// Returns the id that should be playing; `current` is updated to match.
+    mutating func decide(viewportMinY: Double, viewportMaxY: Double, now: TimeInterval) -> String? {
+        if let current, let frame = frame(of: current),
+           visibleRatio(frame, viewportMinY, viewportMaxY) >= continueRatio {
+            pending = nil
+            return current
+        }
+
+        let winner = topmostCandidate(viewportMinY: viewportMinY, viewportMaxY: viewportMaxY)
+        guard winner != current else {
+            pending = nil
+            return current
+        }
+        // Nothing to keep playing: stop right away, there is nothing to ping-pong with
+        if current == nil || winner == nil || switchDelay <= 0 {
+            return commit(winner)
+        }
+        if let pending, pending.id == winner {
+            return now - pending.since >= switchDelay ? commit(winner) : current
+        }
+        pending = (winner, now)
+        return current
+    }
+
+    /// True while a switch is waiting out `switchDelay`; the caller keeps ticking until it resolves.
+    var hasPendingSwitch: Bool { pending != nil }
+
+    private mutating func commit(_ id: String?) -> String? {
+        current = id
+        pending = nil
+        return id
+    }
+
+    private func topmostCandidate(viewportMinY: Double, viewportMaxY: Double) -> String? {
+        var index = insertionIndex(minY: viewportMinY - maxHeight, id: "")
+        while index < entries.count, entries[index].frame.minY < viewportMaxY {
+            let entry = entries[index]
+            if visibleRatio(entry.frame, viewportMinY, viewportMaxY) >= startRatio {
+                return entry.id
+            }
+            index += 1
+        }
+        return nil
+    }
+
+    private func visibleRatio(_ frame: Frame, _ viewportMinY: Double, _ viewportMaxY: Double) -> Double {
+        guard frame.height > 0 else { return 0 }
+        let visible = min(frame.maxY, viewportMaxY) - max(frame.minY, viewportMinY)
+        return max(0, visible) / frame.height
+    }
+
+    // MARK: - Storage
+
+    private func frame(of id: String) -> Frame? {
+        indexOf(id).map { entries[$0].frame }
+    }
+
+    /// Registration is rare next to decisions, so ids are found by a linear scan.
+    private func indexOf(_ id: String) -> Int? {
+        entries.firstIndex { $0.id == id }
+    }
+
+    private func insertionIndex(minY: Double, id: String) -> Int {
+        var low = 0
+        var high = entries.count
+        while low < high {
+            let mid = (low + high) / 2
+            let entry = entries[mid]
+            if entry.frame.minY < minY || (entry.frame.minY == minY && entry.id < id) {
+                low = mid + 1
+            } else {
+                high = mid
+            }
+        }
+        return low
+    }
+}
@@ -196,7 +196,7 @@ class User: ObservableObject, Codable, Identifiable, Hashable {
                 return nil 
             }
             
-            let client = HproseInstance.shared.clientPool.getClientByUrl(for: baseUrl.absoluteString)
+            let client = HproseInstance.shared.clientPool.pinnedClient(forUrl: baseUrl.absoluteString)
             
             // Configure timeout for regular operations (15 seconds - fast fail for bad servers)
             client.timeout = 15  // 15 seconds (detect slow/dead servers quickly)
@@ -216,7 +216,7 @@ class User: ObservableObject, Codable, Identifiable, Hashable {
                 return nil
             }
 
-            let client = HproseInstance.shared.clientPool.getClientByUrl(for: writableUrl.absoluteString)
+            let client = HproseInstance.shared.clientPool.pinnedClient(forUrl: writableUrl.absoluteString)
 
             // Default timeout: 10s. Fast-fail on bad servers. Long-running mutations
             // (e.g. file uploads use URLSession with its own 10-minute timeout;
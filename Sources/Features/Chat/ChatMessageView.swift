@@ -210,7 +210,7 @@ struct AttachmentView: View {
             if attachment.type == .image {
                 // Image preview
                 if let url = attachment.url, let imageUrl = URL(string: url) {
-                    AsyncImage(url: imageUrl) { image in
+                    WebImage(url: imageUrl, context: [.mimeiId: attachment.mid]) { image in
                         image
                             .resizable()
                             .aspectRatio(contentMode: .fit)
@@ -177,6 +177,8 @@ struct CommentComposeView: View {
                         let selectedImages = selectedImages
                         let selectedVideos = selectedVideos
                         let isQuotingCaptured = isQuoting
+                        // Keep the staged copies for the upload while the picker goes away
+                        MediaStaging.pickerItems.detach(selectedItems)
                         
                         dismiss()
                         
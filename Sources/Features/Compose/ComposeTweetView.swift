@@ -72,6 +72,8 @@ struct ComposeTweetView: View {
                         let selectedVideos = viewModel.selectedVideos
                         let selectedDocuments = viewModel.selectedDocuments
                         let isPrivate = viewModel.isPrivate
+                        // Keep the staged copies for the upload; clearing the form deselects them
+                        MediaStaging.pickerItems.detach(selectedItems)
                         
                         // Note: Upload dialog is now shown by the upload queue
                         // No need to call startUpload here - scheduleTweetUpload handles it
@@ -308,6 +308,8 @@ struct ReplyEditorView: View {
                     let selectedItems = selectedItems
                     let selectedImages = selectedImages
                     let selectedVideos = selectedVideos
+                    // Keep the staged copies for the upload; clearing deselects them
+                    MediaStaging.pickerItems.detach(selectedItems)
                     
                     clearAndClose()
                     
@@ -1,6 +1,7 @@
 import SwiftUI
 import PhotosUI
 import AVFoundation
+import ImageIO
 import UIKit
 
 @available(iOS 16.0, *)
@@ -10,6 +11,7 @@ struct ThumbnailView: View {
     @State private var mediaType: MediaType = .unknown
     @State private var isLoading = true
     @State private var error: Error?
+    @ObservedObject private var stagingProgress = MediaStagingProgress.shared
 
     // Thread-safe static cache to avoid regenerating thumbnails for the same item
     // Using a more robust cache key that includes both item ID and media type
@@ -69,9 +71,17 @@ struct ThumbnailView: View {
                     }
                 }
             } else if isLoading {
-                ProgressView()
-                    .progressViewStyle(CircularProgressViewStyle())
-                    .scaleEffect(1.2)
+                VStack(spacing: 8) {
+                    ProgressView()
+                        .progressViewStyle(CircularProgressViewStyle())
+                        .scaleEffect(1.2)
+                    // Copy progress while the item is staged from the photo library
+                    if let fraction = stagingProgress.fractions[item] {
+                        ProgressView(value: fraction)
+                            .progressViewStyle(LinearProgressViewStyle())
+                            .frame(width: 40)
+                    }
+                }
             } else {
                 // Fallback for errors or unknown types
                 fallbackView
@@ -130,20 +140,16 @@ struct ThumbnailView: View {
         
         // CRITICAL: Check file size BEFORE generating thumbnail
         // Thumbnail generation (especially for videos) can take a long time
-        // If file is too large, MediaPicker.filterOversizedFiles() will remove it from selection
+        // If file is too large, MediaPicker's preflight will remove it from selection
         // So we just skip thumbnail generation to save time - the view will disappear anyway
-        do {
-            if let data = try? await item.loadTransferable(type: Data.self) {
-                if data.count > Constants.MAX_FILE_SIZE {
-                    let fileSizeMB = Double(data.count) / (1024 * 1024)
-                    print("DEBUG: [\(itemId)] File too large (\(String(format: "%.1f", fileSizeMB))MB), skipping thumbnail generation (will be removed by MediaPicker)")
-                    await MainActor.run {
-                        self.isLoading = false
-                    }
-                    return
-                }
-                print("DEBUG: [\(itemId)] File size OK (\(String(format: "%.1f", Double(data.count) / (1024 * 1024)))MB)")
+        // The staged copy is shared with preflight and upload, so this reads nothing extra
+        let staged = try? await MediaStaging.pickerItems.staged(item)
+        if let staged, MediaStaging.policy.rejection(for: staged.metadata) != nil {
+            print("DEBUG: [\(itemId)] File too large (\(staged.metadata.byteCount) bytes), skipping thumbnail generation (will be removed by MediaPicker)")
+            await MainActor.run {
+                self.isLoading = false
             }
+            return
         }
         
         // First, detect the media type to create a proper cache key
@@ -171,7 +177,9 @@ struct ThumbnailView: View {
             // If media type is unknown, try to detect from file data
             if mediaType == .unknown {
                 print("DEBUG: [\(itemId)] Trying to detect media type from file data...")
-                if let data = try? await item.loadTransferable(type: Data.self) {
+                if let staged, let handle = try? FileHandle(forReadingFrom: staged.url),
+                   let data = try? handle.read(upToCount: 12) {
+                    try? handle.close()
                     mediaType = detectMediaTypeFromData(data)
                     print("DEBUG: [\(itemId)] Re-detected media type from data: \(mediaType.rawValue)")
                 }
@@ -180,13 +188,13 @@ struct ThumbnailView: View {
             switch mediaType {
             case .video:
                 print("DEBUG: [\(itemId)] Generating video thumbnail")
-                thumbnail = try await generateVideoThumbnail()
+                thumbnail = try await generateVideoThumbnail(staged)
             case .audio:
                 print("DEBUG: [\(itemId)] Generating audio thumbnail")
                 thumbnail = generateAudioThumbnail()
             case .image:
                 print("DEBUG: [\(itemId)] Generating image thumbnail")
-                thumbnail = try await generateImageThumbnail()
+                thumbnail = try await generateImageThumbnail(staged)
             default:
                 print("DEBUG: [\(itemId)] Generating default thumbnail")
                 thumbnail = generateDefaultThumbnail()
@@ -375,17 +383,13 @@ struct ThumbnailView: View {
         return .unknown
     }
     
-    private func generateVideoThumbnail() async throws -> UIImage {
-        guard let data = try await item.loadTransferable(type: Data.self) else {
+    private func generateVideoThumbnail(_ staged: StagedMedia?) async throws -> UIImage {
+        // AVFoundation reads the staged copy directly
+        guard let staged else {
             throw ThumbnailError.dataLoadingFailed
         }
         
-        // Create temporary file for AVFoundation
-        let tempURL = FileManager.default.temporaryDirectory.appendingPathComponent("\(UUID().uuidString).mp4")
-        try data.write(to: tempURL)
-        defer { try? FileManager.default.removeItem(at: tempURL) }
-        
-        let asset = AVURLAsset(url: tempURL)
+        let asset = AVURLAsset(url: staged.url)
         let imageGenerator = AVAssetImageGenerator(asset: asset)
         imageGenerator.appliesPreferredTrackTransform = true
         imageGenerator.maximumSize = CGSize(width: 400, height: 400) // Higher resolution for better quality
@@ -481,15 +485,24 @@ struct ThumbnailView: View {
         }
     }
     
-    private func generateImageThumbnail() async throws -> UIImage {
-        guard let data = try await item.loadTransferable(type: Data.self) else {
+    private func generateImageThumbnail(_ staged: StagedMedia?) async throws -> UIImage {
+        guard let staged else {
             throw ThumbnailError.dataLoadingFailed
         }
         
-        guard let image = UIImage(data: data) else {
+        // Decode a downsampled copy from the staged file instead of the full image;
+        // the transform option applies the EXIF orientation
+        let options: [CFString: Any] = [
+            kCGImageSourceCreateThumbnailFromImageAlways: true,
+            kCGImageSourceCreateThumbnailWithTransform: true,
+            kCGImageSourceThumbnailMaxPixelSize: 400
+        ]
+        guard let source = CGImageSourceCreateWithURL(staged.url as CFURL, nil),
+              let cgImage = CGImageSourceCreateThumbnailAtIndex(source, 0, options as CFDictionary) else {
             print("DEBUG: Failed to create UIImage from data")
             throw ThumbnailError.thumbnailGenerationFailed
         }
+        let image = UIImage(cgImage: cgImage)
         
         print("DEBUG: Original image size: \(image.size)")
         
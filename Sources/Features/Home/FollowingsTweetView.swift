@@ -37,6 +37,7 @@ struct FollowingsTweetView: View {
                 await viewModel.performForegroundFeedRefresh()
             },
             showTitle: false,
+            contentFilterScope: .feed,
             notifications: [
                 TweetListNotification(
                     name: .newTweetCreated,
@@ -32,7 +32,17 @@ class FollowingsTweetViewModel: ObservableObject {
     @Published var showTweetDetail: Bool = false
     @Published var selectedTweet: Tweet?
     let hproseInstance: HproseInstance
-    private let feedRefreshInterval: TimeInterval = 5 * 60
+    /// Periodic refresh interval; adapts to how often page 0 actually changes
+    private var feedRefreshInterval: TimeInterval = 5 * 60
+    private let minFeedRefreshInterval: TimeInterval = 2 * 60
+    private let maxFeedRefreshInterval: TimeInterval = 15 * 60
+    /// The interval is sized so an average refresh finds about this many changes
+    private let targetChangesPerRefresh: Double = 3
+    /// Smoothed page-0 changes (new, edited, removed tweets) per minute
+    private var feedChangeRate: Double?
+    private var lastDeltaRefreshAt: Date?
+    /// What periodic refreshes have already applied to `tweets`; main actor only
+    private var feedMark: FeedHighWaterMark?
     private var feedRefreshTask: Task<Void, Never>?
     private var nextFeedRefreshAt: Date?
     private var foregroundObservers: [NSObjectProtocol] = []
@@ -95,7 +105,7 @@ class FollowingsTweetViewModel: ObservableObject {
 
                 guard !Task.isCancelled else { return }
 
-                await self.performPeriodicFeedRefresh(reason: "5-minute foreground feed refresh", pageSize: 10)
+                await self.performPeriodicFeedRefresh(reason: "periodic foreground feed refresh", pageSize: 10)
                 self.nextFeedRefreshAt = Date().addingTimeInterval(self.feedRefreshInterval)
             }
         }
@@ -129,13 +139,75 @@ class FollowingsTweetViewModel: ObservableObject {
 
         do {
             print("DEBUG: [FollowingsTweetViewModel] \(reason)")
-            _ = try await fetchTweets(page: 0, pageSize: pageSize, isPeriodicRefresh: true)
+            try await refreshFeedDelta(pageSize: pageSize)
             NotificationCenter.default.post(name: .mainFeedPeriodicRefreshCompleted, object: nil)
         } catch {
             print("ERROR: [FollowingsTweetViewModel] \(reason) failed: \(error)")
         }
     }
 
+    /// Periodic page-0 refresh applied as a patch: only new and edited tweets are merged and
+    /// tweets the server dropped are removed, instead of re-merging the whole page.
+    private func refreshFeedDelta(pageSize: UInt) async throws {
+        // Guests browse the alphaId user's tweets, which have no feed to diff against
+        guard !hproseInstance.appUser.isGuest else {
+            _ = try await fetchTweets(page: 0, pageSize: pageSize, isPeriodicRefresh: true)
+            return
+        }
+        guard await beginPageZeroFetchIfNeeded(page: 0, isPeriodicRefresh: true) else { return }
+        defer {
+            endPageZeroFetchIfNeeded(page: 0)
+        }
+
+        let mark = await MainActor.run { feedMark }
+        guard let delta = try await hproseInstance.fetchTweetFeedDelta(
+            user: hproseInstance.appUser,
+            pageSize: pageSize,
+            since: mark
+        ) else {
+            print("DEBUG: [FollowingsTweetViewModel] App not initialized, skipping feed delta")
+            return
+        }
+
+        await MainActor.run {
+            feedMark = delta.mark
+            if !delta.upserts.isEmpty {
+                tweets.mergeTweets(ContentFilter.shared.filter(delta.upserts, in: .feed))
+            }
+            if !delta.deletedIds.isEmpty {
+                let removed = Set(delta.deletedIds)
+                tweets.removeAll { removed.contains($0.mid) }
+            }
+        }
+        let cacheKey = hproseInstance.appUser.mid
+        for tweet in delta.upserts {
+            TweetCacheManager.shared.saveTweet(tweet, userId: cacheKey)
+        }
+        for mid in delta.deletedIds {
+            TweetCacheManager.shared.removeTweet(mid: mid, fromCache: cacheKey)
+        }
+
+        adaptFeedRefreshInterval(changes: delta.changeCount)
+        await refreshFollowingTweetsAsync(pageSize: pageSize)
+    }
+
+    /// Size the next interval so an average refresh finds about `targetChangesPerRefresh` changes:
+    /// busy feeds refresh sooner, quiet ones back off toward `maxFeedRefreshInterval`.
+    private func adaptFeedRefreshInterval(changes: Int) {
+        let now = Date()
+        defer { lastDeltaRefreshAt = now }
+        guard let last = lastDeltaRefreshAt else { return }
+
+        let minutes = max(now.timeIntervalSince(last) / 60, 0.5)
+        let observed = Double(changes) / minutes
+        let rate = feedChangeRate.map { 0.5 * $0 + 0.5 * observed } ?? observed
+        feedChangeRate = rate
+
+        let interval = rate > 0 ? targetChangesPerRefresh / rate * 60 : feedRefreshInterval * 1.5
+        feedRefreshInterval = min(maxFeedRefreshInterval, max(minFeedRefreshInterval, interval))
+        print("DEBUG: [FollowingsTweetViewModel] Feed changes \(String(format: "%.2f", rate))/min, next refresh in \(Int(feedRefreshInterval))s")
+    }
+
     private func beginPageZeroFetchIfNeeded(page: UInt, isPeriodicRefresh: Bool) async -> Bool {
         guard page == 0 else { return true }
 
@@ -202,7 +274,7 @@ class FollowingsTweetViewModel: ObservableObject {
                     let serverTweets = try await hproseInstance.fetchUserTweets(user: adminUser, pageNumber: page, pageSize: pageSize)
                     print("[HproseInstance] Loaded \(serverTweets.compactMap { $0 }.count) tweets for guest user")
                     await MainActor.run {
-                        tweets.mergeTweets(serverTweets.compactMap{ $0 })
+                        tweets.mergeTweets(ContentFilter.shared.filter(serverTweets.compactMap{ $0 }, in: .feed))
                     }
                     return serverTweets
                 }
@@ -234,7 +306,7 @@ class FollowingsTweetViewModel: ObservableObject {
             }
             
             await MainActor.run {
-                tweets.mergeTweets(filteredTweets)
+                tweets.mergeTweets(ContentFilter.shared.filter(filteredTweets, in: .feed))
             }
             
             // Cache main feed tweets under appUser.mid for efficient loading
@@ -279,7 +351,7 @@ class FollowingsTweetViewModel: ObservableObject {
             guard !filteredTweets.isEmpty else { return }
 
             await MainActor.run {
-                tweets.mergeTweets(filteredTweets)
+                tweets.mergeTweets(ContentFilter.shared.filter(filteredTweets, in: .feed))
             }
 
             let cacheKey = hproseInstance.appUser.mid
@@ -355,7 +427,7 @@ class FollowingsTweetViewModel: ObservableObject {
             if !validTweets.isEmpty {
                 await MainActor.run {
                     // Add tweets to the feed (mergeTweets will sort them by timestamp)
-                    tweets.mergeTweets(validTweets)
+                    tweets.mergeTweets(ContentFilter.shared.filter(validTweets, in: .feed))
                 }
                 
                 // Cache newly followed user's tweets under appUser.mid for main feed
@@ -379,6 +451,7 @@ class FollowingsTweetViewModel: ObservableObject {
     // Method to clear tweets when user logs in/out
     func clearTweets() {
         tweets.removeAll()
+        feedMark = nil
         // Don't clear cache on logout - cache persists per user and is cleared periodically or manually
     }
 }
@@ -11,6 +11,7 @@ struct ContentFilterView: View {
     
     // Filter options
     @State private var blockUser = false
+    @State private var muteUser = false
     @State private var hideKeywords = false
     @State private var customKeywords = ""
     @State private var filterProfanity = false
@@ -47,6 +48,13 @@ struct ContentFilterView: View {
                             Divider()
                                 .padding(.leading)
                             
+                            Toggle(LocalizedStringKey("Hide posts from this user"), isOn: $muteUser)
+                                .padding()
+                                .background(Color(.systemGray6))
+                            
+                            Divider()
+                                .padding(.leading)
+                            
                             VStack(alignment: .leading, spacing: 8) {
                                 Toggle(LocalizedStringKey("Hide posts with keywords"), isOn: $hideKeywords)
                                     .padding()
@@ -137,6 +145,48 @@ struct ContentFilterView: View {
             }
             .animation(.easeInOut(duration: 0.3), value: showToast)
         )
+        .onAppear {
+            loadFilters()
+        }
+    }
+    
+    /// Show the saved rules; the keyword toggle is on whenever keywords are saved
+    private func loadFilters() {
+        let rules = ContentFilter.shared.currentRules
+        muteUser = rules.mutedAuthorIds.contains(tweet.authorId)
+        hideKeywords = !rules.keywords.isEmpty
+        customKeywords = rules.keywords.joined(separator: ", ")
+        filterProfanity = rules.categories.contains(.profanity)
+        filterViolence = rules.categories.contains(.violence)
+        filterAdultContent = rules.categories.contains(.adult)
+    }
+    
+    private func saveFilters() {
+        let authorId = tweet.authorId
+        // Accept both ASCII and full-width commas
+        let keywords = hideKeywords
+            ? customKeywords.components(separatedBy: CharacterSet(charactersIn: ",，、"))
+            : []
+        let categories: [(ContentFilter.Category, Bool)] = [
+            (.profanity, filterProfanity),
+            (.violence, filterViolence),
+            (.adult, filterAdultContent)
+        ]
+        ContentFilter.shared.update { rules in
+            rules.keywords = keywords
+            if muteUser {
+                rules.mutedAuthorIds.insert(authorId)
+            } else {
+                rules.mutedAuthorIds.remove(authorId)
+            }
+            for (category, isOn) in categories {
+                if isOn {
+                    rules.categories.insert(category)
+                } else {
+                    rules.categories.remove(category)
+                }
+            }
+        }
     }
     
     private func applyFilters() {
@@ -168,8 +218,8 @@ struct ContentFilterView: View {
                     }
                 }
                 
-                // Store filter preferences (in a real app, this would save to user preferences)
                 await MainActor.run {
+                    saveFilters()
                     if !blockUser {
                         toastMessage = NSLocalizedString("Content filters applied", comment: "Filter success")
                         toastType = .success
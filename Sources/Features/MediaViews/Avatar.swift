@@ -15,6 +15,7 @@ struct Avatar: View {
     @State private var loadFailed = false // Track if load failed/timed out
     @State private var loadTask: Task<Void, Never>?
     @State private var displayedAvatarId: String?
+    @Environment(\.displayScale) private var displayScale
     
     init(user: User, size: CGFloat = 40) {
         self.user = user
@@ -59,7 +60,8 @@ struct Avatar: View {
                         let avatarAttachment = MimeiFileType(mid: "avatar_\(rawKey)", mediaType: .image)
                         
                         // CRITICAL: Use memory-only cache check to avoid blocking disk I/O in view body
-                        if let cached = ImageCacheManager.shared.getCompressedImageFromMemory(for: avatarAttachment) {
+                        if let cached = variantAttachment.flatMap({ ImageCacheManager.shared.getCompressedImageFromMemory(for: $0) })
+                            ?? ImageCacheManager.shared.getCompressedImageFromMemory(for: avatarAttachment) {
                             // Found in cache - use it and reset failed state
                             cachedImage = cached
                             displayedAvatarId = user.avatar
@@ -154,6 +156,13 @@ struct Avatar: View {
         }
         .id("\(user.mid)_\(user.avatar ?? "noavatar")") // Force recreation only when avatar changes, not baseUrl
     }
+
+    /// The smallest size variant covering this view's pixels, or nil when it needs the original
+    private var variantAttachment: MimeiFileType? {
+        guard let avatar = user.avatar,
+              let tier = AvatarDerivatives.tier(for: size, scale: displayScale) else { return nil }
+        return AvatarDerivatives.cacheAttachment(avatarId: avatar, tier: tier)
+    }
     
     private func loadAvatar(from urlString: String) {
         guard !isLoading else {
@@ -171,6 +180,7 @@ struct Avatar: View {
             mediaType: .image
         )
         let expectedAvatarId = user.avatar
+        let variant = variantAttachment
         
         // ✅ PERFORMANCE FIX: Check disk cache asynchronously to avoid blocking main thread
         // Set isLoading synchronously to prevent race conditions, but clear it immediately if cache is found
@@ -178,8 +188,24 @@ struct Avatar: View {
 
         loadTask?.cancel()
         loadTask = Task {
-            // Check disk cache first (async, non-blocking)
+            // Check disk cache first (async, non-blocking): the size variant, then the original
+            if let variant, let cached = ImageCacheManager.shared.getCompressedImage(for: variant) {
+                await MainActor.run {
+                    guard user.avatar == expectedAvatarId else { return }
+                    cachedImage = cached
+                    displayedAvatarId = expectedAvatarId
+                    loadFailed = false
+                    isLoading = false
+                }
+                return
+            }
             if let cached = ImageCacheManager.shared.getCompressedImage(for: avatarAttachment) {
+                // Cached before variants existed; derive them so later rows decode the small one
+                if variant != nil, let expectedAvatarId {
+                    Task.detached(priority: .utility) {
+                        AvatarDerivatives.cacheVariants(of: cached, avatarId: expectedAvatarId)
+                    }
+                }
                 await MainActor.run {
                     guard user.avatar == expectedAvatarId else { return }
                     // Found in disk cache - set immediately and clear loading state
@@ -203,6 +229,11 @@ struct Avatar: View {
             }
 
             let result = await ImageCacheManager.shared.loadAndCacheImage(from: url, for: avatarAttachment)
+            if let result, variant != nil, let expectedAvatarId {
+                Task.detached(priority: .utility) {
+                    AvatarDerivatives.cacheVariants(of: result, avatarId: expectedAvatarId)
+                }
+            }
 
             await MainActor.run {
                 guard user.avatar == expectedAvatarId else { return }
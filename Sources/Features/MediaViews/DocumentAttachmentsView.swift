@@ -124,158 +124,32 @@ struct DocumentAttachmentsView: View {
             return
         }
         
-        // Create consistent filename based on document CID
-        let tempDirectory = FileManager.default.temporaryDirectory
+        // QuickLook picks the viewer from the extension, so default to .pdf when the name has none
         let originalFileName = document.fileName ?? "Document.pdf"
         let fileExtension = (originalFileName as NSString).pathExtension
         let baseName = (originalFileName as NSString).deletingPathExtension
-        let ext = fileExtension.isEmpty ? "pdf" : fileExtension
+        let displayFileName = "\(baseName).\(fileExtension.isEmpty ? "pdf" : fileExtension)"
         
-        // Use document ID for unique but consistent filename
-        let uniqueFileName = "\(baseName)_\(document.mid.prefix(8)).\(ext)"
-        let cachedURL = tempDirectory.appendingPathComponent(uniqueFileName)
-        
-        // Check if file already exists in cache
-        if FileManager.default.fileExists(atPath: cachedURL.path),
-           let attributes = try? FileManager.default.attributesOfItem(atPath: cachedURL.path),
-           let fileSize = attributes[.size] as? Int64,
-           fileSize > 0,
-           FileManager.default.isReadableFile(atPath: cachedURL.path),
-           (try? FileHandle(forReadingFrom: cachedURL)) != nil {
-            
-            // File exists and is valid - use cached version
-            print("DEBUG: [DocumentAttachmentsView] Using cached file: \(uniqueFileName) (\(fileSize) bytes)")
-            
-            // Show spinner briefly while presenting
-            downloadingDocuments.insert(document.mid)
-            
-            // Present sheet with URL item after a small delay to ensure file system is ready
-            DispatchQueue.main.asyncAfter(deadline: .now() + 0.1) {
-                // Double-check file is still accessible before presenting
-                guard FileManager.default.fileExists(atPath: cachedURL.path),
-                      FileManager.default.isReadableFile(atPath: cachedURL.path),
-                      (try? FileHandle(forReadingFrom: cachedURL)) != nil else {
-                    print("ERROR: [DocumentAttachmentsView] Cached file became inaccessible before presentation")
-                    downloadingDocuments.remove(document.mid)
-                    return
-                }
-                
-                self.documentURLItem = DocumentURLItem(id: document.mid, url: cachedURL)
-                print("DEBUG: [DocumentAttachmentsView] Presenting PDF viewer (cached) with URL: \(cachedURL.lastPathComponent)")
-                
-                // Hide spinner after sheet is presented
-                DispatchQueue.main.asyncAfter(deadline: .now() + 0.2) {
-                    downloadingDocuments.remove(document.mid)
-                }
-            }
-            return
-        }
-        
-        // If cached file exists but is invalid, remove it and download fresh
-        if FileManager.default.fileExists(atPath: cachedURL.path) {
-            print("DEBUG: [DocumentAttachmentsView] Cached file exists but is invalid, removing and re-downloading")
-            try? FileManager.default.removeItem(at: cachedURL)
-        }
-        
-        // File doesn't exist or is invalid - need to download
         documentURLItem = nil
-        
-        print("DEBUG: [DocumentAttachmentsView] Downloading file from server...")
         downloadingDocuments.insert(document.mid)
         
-        let task = URLSession.shared.downloadTask(with: url) { localURL, response, error in
-            // CRITICAL: Copy file IMMEDIATELY before URLSession deletes the temp file
-            // Do NOT dispatch to main queue until after file is copied!
-            
-            if let error = error {
-                DispatchQueue.main.async {
-                    downloadingDocuments.remove(document.mid)
-                    print("ERROR: [DocumentAttachmentsView] Failed to download: \(error)")
-                }
-                return
-            }
-            
-            guard let localURL = localURL else {
-                DispatchQueue.main.async {
-                    downloadingDocuments.remove(document.mid)
-                    print("ERROR: [DocumentAttachmentsView] No local URL")
-                }
-                return
-            }
-            
-            // Copy file synchronously BEFORE URLSession cleans it up
+        // Cached blobs return immediately; otherwise this joins or starts a resumable download
+        Task {
             do {
-                // Remove existing file if present
-                if FileManager.default.fileExists(atPath: cachedURL.path) {
-                    try FileManager.default.removeItem(at: cachedURL)
-                    print("DEBUG: [DocumentAttachmentsView] Removed existing cached file")
-                }
-                
-                // Copy downloaded file to cache (MUST happen before returning from this handler)
-                try FileManager.default.copyItem(at: localURL, to: cachedURL)
-                print("DEBUG: [DocumentAttachmentsView] File copied to cache: \(uniqueFileName)")
-                
-                // Ensure file is flushed to disk by opening and closing a file handle
-                let fileHandle = try FileHandle(forWritingTo: cachedURL)
-                try fileHandle.synchronize()
-                try fileHandle.close()
-                
-                // Verify file is valid and readable with multiple checks
-                guard FileManager.default.fileExists(atPath: cachedURL.path),
-                      let attributes = try? FileManager.default.attributesOfItem(atPath: cachedURL.path),
-                      let fileSize = attributes[.size] as? Int64,
-                      fileSize > 0,
-                      FileManager.default.isReadableFile(atPath: cachedURL.path) else {
-                    DispatchQueue.main.async {
-                        downloadingDocuments.remove(document.mid)
-                    }
-                    print("ERROR: [DocumentAttachmentsView] Downloaded file is empty, invalid, or not readable")
-                    try? FileManager.default.removeItem(at: cachedURL)
-                    return
-                }
-                
-                // Verify file can actually be opened (QuickLook requirement)
-                guard (try? FileHandle(forReadingFrom: cachedURL)) != nil else {
-                    DispatchQueue.main.async {
-                        downloadingDocuments.remove(document.mid)
-                    }
-                    print("ERROR: [DocumentAttachmentsView] Cannot open file for reading")
-                    try? FileManager.default.removeItem(at: cachedURL)
-                    return
-                }
-                
-                print("DEBUG: [DocumentAttachmentsView] File verified and readable: \(fileSize) bytes")
-                
-                // Now switch to main queue for UI updates
-                DispatchQueue.main.asyncAfter(deadline: .now() + 0.1) {
-                    // Double-check file is still accessible before presenting
-                    guard FileManager.default.fileExists(atPath: cachedURL.path),
-                          FileManager.default.isReadableFile(atPath: cachedURL.path),
-                          (try? FileHandle(forReadingFrom: cachedURL)) != nil else {
-                        print("ERROR: [DocumentAttachmentsView] File became inaccessible before presentation")
-                        downloadingDocuments.remove(document.mid)
-                        return
-                    }
-                    
-                    self.documentURLItem = DocumentURLItem(id: document.mid, url: cachedURL)
-                    print("DEBUG: [DocumentAttachmentsView] Presenting PDF viewer (downloaded) with URL: \(cachedURL.lastPathComponent)")
-                    
-                    // Hide spinner after sheet is presented
-                    DispatchQueue.main.asyncAfter(deadline: .now() + 0.2) {
-                        downloadingDocuments.remove(document.mid)
-                    }
+                let blobURL = try await DocumentBlobCache.shared.fetch(mid: document.mid, from: url)
+                let presentableURL = try DocumentBlobCache.shared.presentableURL(for: blobURL, fileName: displayFileName)
+                await MainActor.run {
+                    self.documentURLItem = DocumentURLItem(id: document.mid, url: presentableURL)
+                    print("DEBUG: [DocumentAttachmentsView] Presenting document viewer with URL: \(presentableURL.lastPathComponent)")
+                    downloadingDocuments.remove(document.mid)
                 }
             } catch {
-                DispatchQueue.main.async {
+                await MainActor.run {
                     downloadingDocuments.remove(document.mid)
                 }
-                print("ERROR: [DocumentAttachmentsView] Failed to cache file: \(error.localizedDescription)")
-                // Clean up partial file
-                try? FileManager.default.removeItem(at: cachedURL)
+                print("ERROR: [DocumentAttachmentsView] Failed to load document: \(error)")
             }
         }
-        
-        task.resume()
     }
     
     private func downloadAndShare(_ document: MimeiFileType) {
@@ -286,83 +160,66 @@ struct DocumentAttachmentsView: View {
         
         downloadingForShare.insert(document.mid)
         
-        // Download and present share sheet with original filename
-        let task = URLSession.shared.downloadTask(with: url) { localURL, response, error in
-            guard let localURL = localURL else {
-                DispatchQueue.main.async {
+        // Share the cached blob under its original filename
+        Task {
+            let originalFileName = document.fileName ?? getDefaultFileName(for: document.type)
+            let destinationURL: URL
+            do {
+                let blobURL = try await DocumentBlobCache.shared.fetch(mid: document.mid, from: url)
+                destinationURL = try DocumentBlobCache.shared.presentableURL(for: blobURL, fileName: originalFileName)
+            } catch {
+                await MainActor.run {
                     downloadingForShare.remove(document.mid)
-                    print("ERROR: [DocumentAttachmentsView] No local URL for download")
+                    print("ERROR: [DocumentAttachmentsView] Failed to prepare file for sharing: \(error)")
                 }
                 return
             }
             
-            do {
-                // Copy to temp directory with original filename
-                // IMPORTANT: Do this immediately in the completion handler, not in DispatchQueue.main.async
-                // The temporary file from URLSession may be cleaned up if we wait
-                let tempDirectory = FileManager.default.temporaryDirectory
-                let originalFileName = document.fileName ?? getDefaultFileName(for: document.type)
-                let destinationURL = tempDirectory.appendingPathComponent(originalFileName)
-                
-                // Remove existing file if present
-                try? FileManager.default.removeItem(at: destinationURL)
+            await MainActor.run {
+                // Present share sheet with properly named file
+                let activityVC = UIActivityViewController(
+                    activityItems: [destinationURL],
+                    applicationActivities: nil
+                )
                 
-                // Copy file with original name
-                try FileManager.default.copyItem(at: localURL, to: destinationURL)
+                // Exclude some activities that don't make sense for documents
+                activityVC.excludedActivityTypes = [
+                    .assignToContact,
+                    .addToReadingList,
+                    .postToFacebook,
+                    .postToTwitter,
+                    .postToWeibo,
+                    .postToVimeo,
+                    .postToFlickr
+                ]
                 
-                DispatchQueue.main.async {
-                    // Present share sheet with properly named file
-                    let activityVC = UIActivityViewController(
-                        activityItems: [destinationURL],
-                        applicationActivities: nil
-                    )
+                if let windowScene = UIApplication.shared.connectedScenes.first as? UIWindowScene,
+                   let rootViewController = windowScene.windows.first?.rootViewController {
+                    var topController = rootViewController
+                    while let presented = topController.presentedViewController {
+                        topController = presented
+                    }
                     
-                    // Exclude some activities that don't make sense for documents
-                    activityVC.excludedActivityTypes = [
-                        .assignToContact,
-                        .addToReadingList,
-                        .postToFacebook,
-                        .postToTwitter,
-                        .postToWeibo,
-                        .postToVimeo,
-                        .postToFlickr
-                    ]
+                    // For iPad, need to set source view
+                    if let popover = activityVC.popoverPresentationController {
+                        popover.sourceView = topController.view
+                        popover.sourceRect = CGRect(x: topController.view.bounds.midX,
+                                                   y: topController.view.bounds.midY,
+                                                   width: 0, height: 0)
+                        popover.permittedArrowDirections = []
+                    }
                     
-                    if let windowScene = UIApplication.shared.connectedScenes.first as? UIWindowScene,
-                       let rootViewController = windowScene.windows.first?.rootViewController {
-                        var topController = rootViewController
-                        while let presented = topController.presentedViewController {
-                            topController = presented
-                        }
-                        
-                        // For iPad, need to set source view
-                        if let popover = activityVC.popoverPresentationController {
-                            popover.sourceView = topController.view
-                            popover.sourceRect = CGRect(x: topController.view.bounds.midX,
-                                                       y: topController.view.bounds.midY,
-                                                       width: 0, height: 0)
-                            popover.permittedArrowDirections = []
-                        }
-                        
-                        topController.present(activityVC, animated: true) {
-                            // Only hide spinner after share sheet is presented
-                            downloadingForShare.remove(document.mid)
-                            print("DEBUG: [DocumentAttachmentsView] Share sheet presented with file: \(originalFileName)")
-                        }
-                    } else {
-                        // Fallback: hide spinner if we can't present
+                    topController.present(activityVC, animated: true) {
+                        // Only hide spinner after share sheet is presented
                         downloadingForShare.remove(document.mid)
+                        print("DEBUG: [DocumentAttachmentsView] Share sheet presented with file: \(originalFileName)")
                     }
-                }
-            } catch {
-                DispatchQueue.main.async {
+                } else {
+                    // Fallback: hide spinner if we can't present
                     downloadingForShare.remove(document.mid)
-                    print("ERROR: [DocumentAttachmentsView] Failed to prepare file for sharing: \(error)")
                 }
             }
         }
-        
-        task.resume()
     }
     
     private func getDefaultFileName(for type: MediaType) -> String {
@@ -36,6 +36,7 @@ struct MediaBrowserView: View {
     @State private var suppressTabPagingAnimation: Bool = false // Suppress TabView paging during vertical next-video transitions
     @State private var isDismissingForBackground = false
     @State private var originalImageTasks: [Int: Task<Void, Never>] = [:]
+    @State private var largeImageTileCache = LargeImageTileCache()
     private var attachments: [MimeiFileType] {
         // Audio is handled by the compact playlist player; the browser pages visual media only.
         let allAttachments = currentTweet.attachments ?? []
@@ -661,7 +662,8 @@ struct MediaBrowserView: View {
         private func audioView(for attachment: MimeiFileType, url: URL, index: Int) -> some View {
             SimpleAudioPlayer(
                 url: url,
-                autoPlay: currentIndex == index
+                autoPlay: currentIndex == index,
+                fileName: attachment.fileName
             )
             .environmentObject(MuteState.shared)
         }
@@ -760,6 +762,17 @@ struct MediaBrowserView: View {
     private func startOriginalImageLoad(for attachment: MimeiFileType, at index: Int, url: URL) {
         originalImageTasks[index]?.cancel()
         originalImageTasks[index] = Task {
+            // Huge images (panoramas, tall screenshots) are never decoded whole: show a
+            // screen-sized thumbnail, then zoom through a tile pyramid.
+            if await loadLargeImageIfNeeded(for: attachment, at: index, url: url) {
+                await MainActor.run {
+                    if self.originalImageTasks[index]?.isCancelled == false {
+                        self.originalImageTasks.removeValue(forKey: index)
+                    }
+                }
+                return
+            }
+
             if let originalImage = await ImageCacheManager.shared.loadOriginalImage(
                 from: url,
                 for: attachment,
@@ -789,6 +802,40 @@ struct MediaBrowserView: View {
     
 
     
+    /// Show `attachment` through a LargeImagePyramid if its header says a full decode would be
+    /// too large. Returns false for ordinary images, which take the original-image path.
+    private func loadLargeImageIfNeeded(for attachment: MimeiFileType, at index: Int, url: URL) async -> Bool {
+        guard let fileURL = await ImageCacheManager.shared.originalImageFile(from: url, for: attachment),
+              let info = LargeImagePyramid.imageInfo(at: fileURL),
+              LargeImagePyramid.needsTiling(info.size) else {
+            return false
+        }
+        // Tiles are cut in stored pixel order; rotated EXIF images keep the thumbnail only
+        let screenPixels = await MainActor.run {
+            Int(max(UIScreen.main.bounds.width, UIScreen.main.bounds.height) * UIScreen.main.scale)
+        }
+        guard !Task.isCancelled,
+              let screenImage = LargeImagePyramid.screenImage(at: fileURL, maxPixelSize: screenPixels) else {
+            return true
+        }
+        await MainActor.run {
+            guard self.attachments.indices.contains(index),
+                  self.attachments[index].mid == attachment.mid else { return }
+            self.imageStates[index] = .loaded(screenImage)
+        }
+        guard info.orientation == .up,
+              let pyramid = await LargeImagePyramid.load(from: fileURL, key: attachment.mid, tileCache: largeImageTileCache),
+              !Task.isCancelled else {
+            return true
+        }
+        await MainActor.run {
+            guard self.attachments.indices.contains(index),
+                  self.attachments[index].mid == attachment.mid else { return }
+            self.imageStates[index] = .tiled(screenImage, pyramid)
+        }
+        return true
+    }
+    
     private func getCachedPlaceholder(for attachment: MimeiFileType) -> UIImage? {
         return ImageCacheManager.shared.getCompressedImage(for: attachment)
     }
@@ -818,6 +865,7 @@ struct MediaBrowserView: View {
         }
 
         imageStates.removeAll()
+        largeImageTileCache.removeAll()
     }
     
     private static func cleanupNonVisibleImages(attachments: [MimeiFileType], currentIndex: Int, imageStates: Binding<[Int: ImageState]>, baseUrl: URL) {
@@ -864,6 +912,8 @@ enum ImageState {
     case loading
     case placeholder(UIImage)
     case loaded(UIImage)
+    /// Screen-sized thumbnail shown at rest; zoomed views draw tiles from the pyramid
+    case tiled(UIImage, LargeImagePyramid)
     case error
 }
 
@@ -890,6 +940,8 @@ struct ImageViewWithPlaceholder: View {
             return image.size.width / image.size.height
         case .placeholder(let image):
             return image.size.width / image.size.height
+        case .tiled(_, let pyramid):
+            return pyramid.aspectRatio
         default:
             return CGFloat(attachment.aspectRatio ?? 1.0)
         }
@@ -916,7 +968,15 @@ struct ImageViewWithPlaceholder: View {
     
     private func calculateMaxScale(for geometry: GeometryProxy) -> CGFloat {
         // Allow up to 2x the double-tap scale for pinch zoom
-        return calculateDoubleTapScale(for: geometry) * 2.0
+        let doubleTapMax = calculateDoubleTapScale(for: geometry) * 2.0
+        guard case .tiled(_, let pyramid) = imageState,
+              geometry.size.width > 0, geometry.size.height > 0 else {
+            return doubleTapMax
+        }
+        // Tiled images may zoom to one image pixel per device pixel
+        let fittedWidth = min(geometry.size.width, geometry.size.height * pyramid.aspectRatio)
+        let nativeScale = pyramid.pixelSize.width / (fittedWidth * UIScreen.main.scale)
+        return max(doubleTapMax, nativeScale)
     }
     
     private func downloadImage() {
@@ -928,6 +988,9 @@ struct ImageViewWithPlaceholder: View {
             imageToDownload = image
         case .placeholder(let image):
             imageToDownload = image
+        case .tiled(_, let pyramid):
+            saveImageFile(pyramid.sourceURL)
+            return
         default:
             imageToDownload = nil
         }
@@ -960,6 +1023,30 @@ struct ImageViewWithPlaceholder: View {
         }
     }
     
+    /// Save the original file as-is; decoding a huge image to hand it to Photos is what tiling avoids.
+    private func saveImageFile(_ fileURL: URL) {
+        PHPhotoLibrary.requestAuthorization { status in
+            guard status == .authorized else {
+                DispatchQueue.main.async {
+                    self.showDownloadToast(message: NSLocalizedString("Photo library access denied", comment: "Photo library permission error"))
+                }
+                return
+            }
+            
+            PHPhotoLibrary.shared().performChanges({
+                PHAssetChangeRequest.creationRequestForAssetFromImage(atFileURL: fileURL)
+            }) { success, error in
+                DispatchQueue.main.async {
+                    if success {
+                        self.showDownloadToast(message: NSLocalizedString("Image saved to Photos", comment: "Image save success"))
+                    } else {
+                        self.showDownloadToast(message: NSLocalizedString("Failed to save image", comment: "Image save error"))
+                    }
+                }
+            }
+        }
+    }
+    
     private func showDownloadToast(message: String) {
         downloadToastMessage = message
         showDownloadToast = true
@@ -992,6 +1079,16 @@ struct ImageViewWithPlaceholder: View {
                             .resizable()
                             .aspectRatio(contentMode: .fit)
                         
+                    case .tiled(let screenImage, let pyramid):
+                        ZStack {
+                            Image(uiImage: screenImage)
+                                .resizable()
+                            if scale > 1.0 {
+                                TiledImageLayerView(pyramid: pyramid)
+                            }
+                        }
+                        .aspectRatio(pyramid.aspectRatio, contentMode: .fit)
+                        
                     case .error:
                         VStack {
                             Image(systemName: "photo")
@@ -1122,6 +1219,58 @@ struct ImageViewWithPlaceholder: View {
     }
 }
 
+// MARK: - Tiled Image Layer
+/// CATiledLayer-backed view that draws the visible region of a LargeImagePyramid. The layer
+/// asks for tiles at the scale it is rendered, so the zoom applied by `scaleEffect` selects
+/// the pyramid level; tiles are drawn off the main thread.
+private struct TiledImageLayerView: UIViewRepresentable {
+    let pyramid: LargeImagePyramid
+
+    func makeUIView(context: Context) -> TiledPyramidView {
+        let view = TiledPyramidView()
+        view.pyramid = pyramid
+        return view
+    }
+
+    func updateUIView(_ uiView: TiledPyramidView, context: Context) {
+        if uiView.pyramid !== pyramid {
+            uiView.pyramid = pyramid
+        }
+    }
+
+    final class TiledPyramidView: UIView {
+        override class var layerClass: AnyClass { CATiledLayer.self }
+
+        var pyramid: LargeImagePyramid? {
+            didSet {
+                guard let pyramid, let tiledLayer = layer as? CATiledLayer else { return }
+                let tileSide = CGFloat(LargeImagePyramid.tileSize)
+                tiledLayer.tileSize = CGSize(width: tileSide, height: tileSide)
+                // One detail level per pyramid level, all of them magnified above the fitted size
+                tiledLayer.levelsOfDetail = pyramid.metadata.levelCount + 1
+                tiledLayer.levelsOfDetailBias = pyramid.metadata.levelCount
+                setNeedsDisplay()
+            }
+        }
+
+        override init(frame: CGRect) {
+            super.init(frame: frame)
+            isOpaque = false
+            backgroundColor = .clear
+            isUserInteractionEnabled = false
+        }
+
+        required init?(coder: NSCoder) {
+            fatalError("init(coder:) has not been implemented")
+        }
+
+        override func draw(_ rect: CGRect) {
+            guard let pyramid, let context = UIGraphicsGetCurrentContext() else { return }
+            pyramid.draw(rect, viewBounds: bounds, in: context)
+        }
+    }
+}
+
 // MARK: - Singleton Video Player View
 struct SingletonVideoPlayerView: View {
     let url: URL
@@ -161,7 +161,7 @@ struct MediaCell: View, Equatable, MediaCellDelegate {
                         videoPlayerViewContent(url: url, width: width, height: height)
                     case .audio:
                         // Audio autoplay controlled by visibility
-                        SimpleAudioPlayer(url: url, autoPlay: isVisible)
+                        SimpleAudioPlayer(url: url, autoPlay: isVisible, fileName: attachment.fileName)
                             .environmentObject(MuteState.shared)
                             .frame(width: width, height: height, alignment: .center)
                             .onTapGesture {
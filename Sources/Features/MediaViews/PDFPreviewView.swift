@@ -82,70 +82,35 @@ struct PDFPreviewView: View {
         downloadProgress = 0.0
         downloadError = nil
         
-        // Download PDF to temporary location
-        let task = URLSession.shared.downloadTask(with: url) { localURL, response, error in
-            DispatchQueue.main.async {
-                isDownloading = false
-                
-                if let error = error {
-                    downloadError = error.localizedDescription
-                    print("ERROR: [PDFPreviewView] Failed to download PDF: \(error)")
-                    return
-                }
-                
-                guard let localURL = localURL else {
-                    downloadError = "Download failed"
-                    return
-                }
-                
-                // Move to a more permanent temporary location
-                let tempDirectory = FileManager.default.temporaryDirectory
-                // Make filename unique by incrementing suffix if needed
-                let originalFileName = displayFileName
-                let fileExtension = (originalFileName as NSString).pathExtension
-                let baseName = (originalFileName as NSString).deletingPathExtension
-                let ext = fileExtension.isEmpty ? "pdf" : fileExtension
-                
-                // Find unique filename
-                var destinationURL = tempDirectory.appendingPathComponent("\(baseName).\(ext)")
-                var counter = 1
-                while FileManager.default.fileExists(atPath: destinationURL.path) {
-                    let uniqueName = "\(baseName)_\(counter).\(ext)"
-                    destinationURL = tempDirectory.appendingPathComponent(uniqueName)
-                    counter += 1
+        let originalFileName = displayFileName
+        let fileExtension = (originalFileName as NSString).pathExtension
+        let baseName = (originalFileName as NSString).deletingPathExtension
+        let fileName = "\(baseName).\(fileExtension.isEmpty ? "pdf" : fileExtension)"
+        
+        // Shared blob cache: instant on re-open, resumes interrupted downloads,
+        // and joins a download already started by another view for the same attachment
+        Task {
+            do {
+                let blobURL = try await DocumentBlobCache.shared.fetch(mid: attachment.mid, from: url) { fraction in
+                    DispatchQueue.main.async {
+                        downloadProgress = fraction
+                    }
                 }
-                
-                do {
-                    // Remove existing file if present
-                    try? FileManager.default.removeItem(at: destinationURL)
-                    
-                    // Move downloaded file
-                    try FileManager.default.moveItem(at: localURL, to: destinationURL)
-                    
+                let destinationURL = try DocumentBlobCache.shared.presentableURL(for: blobURL, fileName: fileName)
+                await MainActor.run {
+                    isDownloading = false
                     self.pdfURL = destinationURL
                     self.showPDFViewer = true
-                    
-                    print("DEBUG: [PDFPreviewView] Successfully downloaded PDF to: \(destinationURL)")
-                } catch {
-                    downloadError = "Failed to save PDF"
-                    print("ERROR: [PDFPreviewView] Failed to move PDF: \(error)")
+                    print("DEBUG: [PDFPreviewView] PDF ready at: \(destinationURL)")
                 }
+            } catch {
+                await MainActor.run {
+                    isDownloading = false
+                    downloadError = error.localizedDescription
+                }
+                print("ERROR: [PDFPreviewView] Failed to download PDF: \(error)")
             }
         }
-        
-        // Track download progress
-        let observation = task.progress.observe(\.fractionCompleted) { progress, _ in
-            DispatchQueue.main.async {
-                downloadProgress = progress.fractionCompleted
-            }
-        }
-        
-        task.resume()
-        
-        // Keep observation alive until task completes
-        DispatchQueue.main.asyncAfter(deadline: .now() + 60) {
-            observation.invalidate()
-        }
     }
 }
 
@@ -268,70 +233,35 @@ struct PDFPreviewViewFullScreen: View {
         downloadProgress = 0.0
         downloadError = nil
         
-        // Download PDF to temporary location
-        let task = URLSession.shared.downloadTask(with: url) { localURL, response, error in
-            DispatchQueue.main.async {
-                isDownloading = false
-                
-                if let error = error {
-                    downloadError = error.localizedDescription
-                    print("ERROR: [PDFPreviewView] Failed to download PDF: \(error)")
-                    return
-                }
-                
-                guard let localURL = localURL else {
-                    downloadError = "Download failed"
-                    return
-                }
-                
-                // Move to a more permanent temporary location
-                let tempDirectory = FileManager.default.temporaryDirectory
-                // Make filename unique by incrementing suffix if needed
-                let originalFileName = displayFileName
-                let fileExtension = (originalFileName as NSString).pathExtension
-                let baseName = (originalFileName as NSString).deletingPathExtension
-                let ext = fileExtension.isEmpty ? "pdf" : fileExtension
-                
-                // Find unique filename
-                var destinationURL = tempDirectory.appendingPathComponent("\(baseName).\(ext)")
-                var counter = 1
-                while FileManager.default.fileExists(atPath: destinationURL.path) {
-                    let uniqueName = "\(baseName)_\(counter).\(ext)"
-                    destinationURL = tempDirectory.appendingPathComponent(uniqueName)
-                    counter += 1
+        let originalFileName = displayFileName
+        let fileExtension = (originalFileName as NSString).pathExtension
+        let baseName = (originalFileName as NSString).deletingPathExtension
+        let fileName = "\(baseName).\(fileExtension.isEmpty ? "pdf" : fileExtension)"
+        
+        // Shared blob cache: instant on re-open, resumes interrupted downloads,
+        // and joins a download already started by another view for the same attachment
+        Task {
+            do {
+                let blobURL = try await DocumentBlobCache.shared.fetch(mid: attachment.mid, from: url) { fraction in
+                    DispatchQueue.main.async {
+                        downloadProgress = fraction
+                    }
                 }
-                
-                do {
-                    // Remove existing file if present
-                    try? FileManager.default.removeItem(at: destinationURL)
-                    
-                    // Move downloaded file
-                    try FileManager.default.moveItem(at: localURL, to: destinationURL)
-                    
+                let destinationURL = try DocumentBlobCache.shared.presentableURL(for: blobURL, fileName: fileName)
+                await MainActor.run {
+                    isDownloading = false
                     self.pdfURL = destinationURL
                     self.showPDFViewer = true
-                    
-                    print("DEBUG: [PDFPreviewView] Successfully downloaded PDF to: \(destinationURL)")
-                } catch {
-                    downloadError = "Failed to save PDF"
-                    print("ERROR: [PDFPreviewView] Failed to move PDF: \(error)")
+                    print("DEBUG: [PDFPreviewView] PDF ready at: \(destinationURL)")
                 }
+            } catch {
+                await MainActor.run {
+                    isDownloading = false
+                    downloadError = error.localizedDescription
+                }
+                print("ERROR: [PDFPreviewView] Failed to download PDF: \(error)")
             }
         }
-        
-        // Track download progress
-        let observation = task.progress.observe(\.fractionCompleted) { progress, _ in
-            DispatchQueue.main.async {
-                downloadProgress = progress.fractionCompleted
-            }
-        }
-        
-        task.resume()
-        
-        // Keep observation alive until task completes
-        DispatchQueue.main.asyncAfter(deadline: .now() + 60) {
-            observation.invalidate()
-        }
     }
     
     private func formatFileSize(_ bytes: Int64) -> String {
@@ -33,6 +33,8 @@ private func isAudioResourceUnavailableError(_ error: Error?) -> Bool {
 struct SimpleAudioPlayer: View {
     let url: URL
     var autoPlay: Bool = true
+    /// Original file name; its extension lets the caching proxy serve the right Content-Type.
+    var fileName: String? = nil
     
     @State private var player: AVPlayer?
     @State private var playerItem: AVPlayerItem?
@@ -169,29 +171,36 @@ struct SimpleAudioPlayer: View {
             print("DEBUG: [AUDIO PLAYER] Failed to configure audio session: \(error)")
         }
         
-        // Create AVPlayerItem and AVPlayer
-        let asset = AVURLAsset(url: url)
-        playerItem = AVPlayerItem(asset: asset)
-        player = AVPlayer(playerItem: playerItem)
+        let player = AVPlayer()
+        self.player = player
         
         // Audio should always play through when the user explicitly starts it.
-        player?.isMuted = false
-        player?.volume = 1
-        
-        // Set up observers
-        setupPlayerObservers()
-        
-        // Get duration
-        Task {
-            await loadDuration()
-        }
+        player.isMuted = false
+        player.volume = 1
         
-        if autoPlay {
-            print("DEBUG: [AUDIO PLAYER] Auto-playing audio")
-            wantsPlayback = true
-            scheduleStartupTimeout(for: playerItem)
-            player?.play()
-            isPlaying = true
+        // The item goes through the caching proxy, which may need a moment to be ready
+        Task { @MainActor in
+            let item = await AudioAssetLoader.playerItem(for: url, fileName: fileName)
+            guard self.player === player, player.currentItem == nil else { return }
+            playerItem = item
+            player.replaceCurrentItem(with: item)
+            
+            // Set up observers
+            setupPlayerObservers()
+            
+            // Get duration
+            Task {
+                await loadDuration()
+            }
+            
+            if autoPlay {
+                print("DEBUG: [AUDIO PLAYER] Auto-playing audio")
+                wantsPlayback = true
+                AudioAssetLoader.setPlaybackActive(true, for: url)
+                scheduleStartupTimeout(for: item)
+                player.play()
+                isPlaying = true
+            }
         }
     }
     
@@ -289,6 +298,7 @@ struct SimpleAudioPlayer: View {
             print("DEBUG: [AUDIO PLAYER] Pausing playback")
             player.pause()
             startupTimeoutTask?.cancel()
+            AudioAssetLoader.setPlaybackActive(false, for: url)
             wantsPlayback = false
             isPlaybackLoading = false
             isPlaying = false
@@ -299,6 +309,7 @@ struct SimpleAudioPlayer: View {
             }
 
             print("DEBUG: [AUDIO PLAYER] Starting playback")
+            AudioAssetLoader.setPlaybackActive(true, for: url)
             wantsPlayback = true
             isPlaybackLoading = true
             player.isMuted = false
@@ -319,21 +330,25 @@ struct SimpleAudioPlayer: View {
         playbackLoadFailed = false
         wantsPlayback = true
         isPlaybackLoading = true
+        AudioAssetLoader.setPlaybackActive(true, for: url)
 
-        let item = AVPlayerItem(asset: AVURLAsset(url: url))
-        playerItem = item
-        player.replaceCurrentItem(with: item)
-        player.isMuted = false
-        player.volume = 1
-        setupPlayerObservers()
+        Task { @MainActor in
+            let item = await AudioAssetLoader.playerItem(for: url, fileName: fileName)
+            guard self.player === player, wantsPlayback else { return }
+            playerItem = item
+            player.replaceCurrentItem(with: item)
+            player.isMuted = false
+            player.volume = 1
+            setupPlayerObservers()
 
-        Task {
-            await loadDuration()
-        }
+            Task {
+                await loadDuration()
+            }
 
-        scheduleStartupTimeout(for: item)
-        player.play()
-        isPlaying = true
+            scheduleStartupTimeout(for: item)
+            player.play()
+            isPlaying = true
+        }
     }
 
     private func scheduleStartupTimeout(for item: AVPlayerItem?) {
@@ -413,6 +428,7 @@ struct SimpleAudioPlayer: View {
         
         // Stop and cleanup player
         player?.pause()
+        AudioAssetLoader.setPlaybackActive(false, for: url)
         player = nil
         playerItem = nil
         wantsPlayback = false
@@ -438,6 +454,7 @@ struct CompactAudioPlaylistPlayer: View {
     @State private var isPlaybackLoading = false
     @State private var lastPlaybackWarningDate = Date.distantPast
     @State private var startupTimeoutTask: Task<Void, Never>?
+    @State private var activeAudioURL: URL?
 
     private var baseUrl: URL {
         parentTweet.author?.baseUrl
@@ -647,9 +664,25 @@ struct CompactAudioPlaylistPlayer: View {
         player.isMuted = false
         player.volume = 1
 
-        let item = AVPlayerItem(asset: AVURLAsset(url: url))
+        // Build the item through the caching proxy, then warm the start of the next track
+        // so skipping ahead doesn't begin with a cold IPFS fetch.
+        let index = currentIndex
+        Task { @MainActor in
+            let item = await AudioAssetLoader.playerItem(for: url, fileName: attachment.fileName)
+            guard self.player === player, currentIndex == index else { return }
+            startItem(item, on: player, url: url, shouldPlay: shouldPlay)
+            prefetchNextTrack(after: index)
+        }
+    }
+
+    private func startItem(_ item: AVPlayerItem, on player: AVPlayer, url: URL, shouldPlay: Bool) {
         player.replaceCurrentItem(with: item)
         observe(item: item)
+        if let previousURL = activeAudioURL, previousURL != url {
+            AudioAssetLoader.setPlaybackActive(false, for: previousURL)
+        }
+        activeAudioURL = url
+        AudioAssetLoader.setPlaybackActive(shouldPlay, for: url)
 
         Task {
             do {
@@ -689,6 +722,14 @@ struct CompactAudioPlaylistPlayer: View {
         }
     }
 
+    private func prefetchNextTrack(after index: Int) {
+        let attachments = playableAttachments
+        guard attachments.count > 1 else { return }
+        let next = attachments[(index + 1) % attachments.count]
+        guard let nextURL = next.getUrl(baseUrl) else { return }
+        AudioAssetLoader.prefetchStart(of: nextURL, fileName: next.fileName)
+    }
+
     private func observe(item: AVPlayerItem) {
         item.publisher(for: \.status)
             .receive(on: DispatchQueue.main)
@@ -754,6 +795,7 @@ struct CompactAudioPlaylistPlayer: View {
         if isPlaying {
             player.pause()
             startupTimeoutTask?.cancel()
+            if let activeAudioURL { AudioAssetLoader.setPlaybackActive(false, for: activeAudioURL) }
             isPlaybackLoading = false
             isPlaying = false
             wantsPlayback = false
@@ -763,6 +805,7 @@ struct CompactAudioPlaylistPlayer: View {
                 return
             }
 
+            if let activeAudioURL { AudioAssetLoader.setPlaybackActive(true, for: activeAudioURL) }
             wantsPlayback = true
             isPlaybackLoading = true
             player.isMuted = false
@@ -841,6 +884,8 @@ struct CompactAudioPlaylistPlayer: View {
         player?.pause()
         player?.replaceCurrentItem(with: nil)
         player = nil
+        if let activeAudioURL { AudioAssetLoader.setPlaybackActive(false, for: activeAudioURL) }
+        activeAudioURL = nil
         cancellables.removeAll()
         isPlaying = false
         wantsPlayback = false
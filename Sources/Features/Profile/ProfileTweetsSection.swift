@@ -72,7 +72,7 @@ class ProfileTweetsViewModel: ObservableObject {
             
             
             await MainActor.run {
-                tweets.mergeTweets(filteredTweets.compactMap{ $0 })
+                tweets.mergeTweets(ContentFilter.shared.filter(filteredTweets.compactMap{ $0 }, in: .profile(user.mid)))
             }
             
             // Cache profile tweets under their authorId (which is user.mid for profile view)
@@ -112,7 +112,7 @@ class ProfileTweetsViewModel: ObservableObject {
         }
 
         guard !visibleTweets.isEmpty else { return }
-        tweets.mergeTweets(visibleTweets)
+        tweets.mergeTweets(ContentFilter.shared.filter(visibleTweets, in: .profile(user.mid)))
 
         for tweet in visibleTweets {
             TweetCacheManager.shared.saveTweet(tweet, userId: tweet.authorId)
@@ -228,6 +228,7 @@ struct ProfileTweetsSection<Header: View>: View {
                 }
             },
             showTitle: false,
+            contentFilterScope: .profile(user.mid),
             notifications: [
                 TweetListNotification(
                     name: .newTweetCreated,
@@ -0,0 +1,165 @@
+//
+//  UserListPrefetcher.swift
+//  Tweet
+//
+//  List-level user loading for UserListView: resolves a window around the visible rows
+//  instead of one fetch per row in appearance order.
+//
+
+import Foundation
+
+/// Keeps the users around the visible rows of a user list resolved.
+///
+/// The window is the visible index range plus `lookAhead` rows in the scroll direction and
+/// `lookBehind` rows the other way, over all known ids (including ones not revealed yet).
+/// Ids entering the window are resolved in batches of up to `batchSize`: one Core Data fetch
+/// per batch, then a `fetchUser` per cache miss through `UserRowLoadGate`, visible rows first.
+/// Fetches that leave the window are cancelled. Results land in the `User` singletons rows
+/// already observe, and rows join an in-flight fetch instead of starting their own.
+@MainActor
+final class UserListPrefetcher {
+    private let lookAhead: Int
+    private let lookBehind: Int
+    private let batchSize: Int
+
+    private var ids: [String] = []
+    private var indexById: [String: Int] = [:]
+    private var visibleIds: Set<String> = []
+    private var lastVisibleStart = 0
+    private var isScrollingForward = true
+
+    /// Renderable from the cache or a finished fetch
+    private var resolved: Set<String> = []
+    /// Waiting for the batched cache read
+    private var pendingCacheLookup: Set<String> = []
+    private var inFlight: [String: (token: UUID, task: Task<User?, Error>)] = [:]
+
+    init(lookAhead: Int = 30, lookBehind: Int = 10, batchSize: Int = 50) {
+        self.lookAhead = lookAhead
+        self.lookBehind = lookBehind
+        self.batchSize = batchSize
+    }
+
+    // MARK: - Public Methods
+
+    /// The ordered ids of the whole list, revealed or not.
+    func setIds(_ newIds: [String]) {
+        guard newIds != ids else { return }
+        ids = newIds
+        indexById = Dictionary(newIds.enumerated().map { ($1, $0) }, uniquingKeysWith: { first, _ in first })
+        visibleIds = visibleIds.filter { indexById[$0] != nil }
+        updateWindow()
+    }
+
+    func rowAppeared(_ userId: String) {
+        visibleIds.insert(userId)
+        updateWindow()
+    }
+
+    func rowDisappeared(_ userId: String) {
+        visibleIds.remove(userId)
+        updateWindow()
+    }
+
+    /// The user for a row: joins the prefetch when one is running, otherwise fetches now.
+    func load(_ userId: String) async throws -> User? {
+        if let running = inFlight[userId], !running.task.isCancelled {
+            return try await running.task.value
+        }
+        return try await startFetch(userId).value
+    }
+
+    func cancelAll() {
+        inFlight.values.forEach { $0.task.cancel() }
+        inFlight.removeAll()
+        pendingCacheLookup.removeAll()
+    }
+
+    // MARK: - Window
+
+    private var visibleRange: ClosedRange<Int>? {
+        let indices = visibleIds.compactMap { indexById[$0] }
+        guard let low = indices.min(), let high = indices.max() else { return nil }
+        return low...high
+    }
+
+    private func updateWindow() {
+        guard let visible = visibleRange else { return }
+        if visible.lowerBound != lastVisibleStart {
+            isScrollingForward = visible.lowerBound > lastVisibleStart
+            lastVisibleStart = visible.lowerBound
+        }
+        let before = isScrollingForward ? lookBehind : lookAhead
+        let after = isScrollingForward ? lookAhead : lookBehind
+        let window = max(0, visible.lowerBound - before)...min(ids.count - 1, visible.upperBound + after)
+
+        // Cancel fetches for rows that left the window; a visible row's own load keeps its task
+        for (userId, running) in inFlight where !isInWindow(userId, window) && !visibleIds.contains(userId) {
+            running.task.cancel()
+            inFlight.removeValue(forKey: userId)
+        }
+
+        // Visible rows first, then outward in the scroll direction
+        let ahead = isScrollingForward
+            ? Array(visible.upperBound + 1 ..< window.upperBound + 1)
+            : Array((window.lowerBound ..< visible.lowerBound).reversed())
+        let behind = isScrollingForward
+            ? Array((window.lowerBound ..< visible.lowerBound).reversed())
+            : Array(visible.upperBound + 1 ..< window.upperBound + 1)
+        let wanted = (Array(visible) + ahead + behind)
+            .map { ids[$0] }
+            .filter { !resolved.contains($0) && !pendingCacheLookup.contains($0) && inFlight[$0] == nil }
+        guard !wanted.isEmpty else { return }
+
+        for start in stride(from: 0, to: wanted.count, by: batchSize) {
+            resolveBatch(Array(wanted[start ..< min(start + batchSize, wanted.count)]))
+        }
+    }
+
+    private func isInWindow(_ userId: String, _ window: ClosedRange<Int>) -> Bool {
+        guard let index = indexById[userId] else { return false }
+        return window.contains(index)
+    }
+
+    // MARK: - Loading
+
+    private func resolveBatch(_ batch: [String]) {
+        pendingCacheLookup.formUnion(batch)
+        Task {
+            let cached = await TweetCacheManager.shared.fetchUsers(mids: batch)
+            pendingCacheLookup.subtract(batch)
+            resolved.formUnion(cached)
+            let misses = batch.filter { !cached.contains($0) && inFlight[$0] == nil }
+            guard !misses.isEmpty else { return }
+            print("DEBUG: [UserListPrefetcher] \(batch.count - misses.count)/\(batch.count) users cached, fetching \(misses.count)")
+            // The window may have moved while the cache was read
+            guard let visible = visibleRange else { return }
+            let low = visible.lowerBound - max(lookAhead, lookBehind)
+            let high = visible.upperBound + max(lookAhead, lookBehind)
+            for userId in misses where visibleIds.contains(userId) || (indexById[userId].map { (low...high).contains($0) } ?? false) {
+                startFetch(userId)
+            }
+        }
+    }
+
+    @discardableResult
+    private func startFetch(_ userId: String) -> Task<User?, Error> {
+        let token = UUID()
+        let task = Task<User?, Error> {
+            defer {
+                if inFlight[userId]?.token == token {
+                    inFlight.removeValue(forKey: userId)
+                }
+            }
+            let user = try await UserRowLoadGate.shared.withPermit {
+                try await HproseInstance.shared.fetchUser(userId, refreshExpiredCacheInBackground: false)
+            }
+            if user?.hasValidUsername == true {
+                resolved.insert(userId)
+            }
+            return user
+        }
+        inFlight[userId] = (token, task)
+        return task
+    }
+}
@@ -28,6 +28,7 @@ struct UserListView: View {
     @State private var nextPageNumber: Int = 0
     @State private var nextDisplayIndex: Int = 0
     @State private var cancellationToken: UUID = UUID()
+    @State private var prefetcher = UserListPrefetcher()
 
     /// Match Android's ID page size, but reveal only the visible row count.
     private let pageSize: Int = Constants.USER_BATCH_SIZE
@@ -76,6 +77,7 @@ struct UserListView: View {
                     UserRowView(
                         userId: rowUserId,
                         cancellationToken: cancellationToken,
+                        prefetcher: prefetcher,
                         onFollowToggle: onFollowToggle,
                         onTap: { selectedUser in
                             navigationPath.append(selectedUser)
@@ -88,6 +90,8 @@ struct UserListView: View {
                         }
                     )
                     .id(rowUserId)
+                    .onAppear { prefetcher.rowAppeared(rowUserId) }
+                    .onDisappear { prefetcher.rowDisappeared(rowUserId) }
                 }
 
                 if isLoading {
@@ -129,9 +133,14 @@ struct UserListView: View {
             errorMessage = nil
             Task { await refreshUsers() }
         }
+        .onChange(of: allUserIds) { _, ids in
+            // Ids not revealed yet still count, so the window can look ahead of the last row
+            prefetcher.setIds(ids)
+        }
         .onDisappear {
             refreshTask?.cancel()
             loadMoreTask?.cancel()
+            prefetcher.cancelAll()
             cancellationToken = UUID()
         }
     }
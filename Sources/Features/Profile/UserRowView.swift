@@ -71,6 +71,7 @@ actor UserRowLoadGate {
 struct UserRowView: View {
     let userId: String
     let cancellationToken: UUID
+    let prefetcher: UserListPrefetcher?
     let onFollowToggle: ((User) async -> Void)?
     let onTap: ((User) -> Void)?
     let onLoadFailed: ((String) -> Void)?
@@ -91,12 +92,14 @@ struct UserRowView: View {
     init(
         userId: String,
         cancellationToken: UUID,
+        prefetcher: UserListPrefetcher? = nil,
         onFollowToggle: ((User) async -> Void)? = nil,
         onTap: ((User) -> Void)? = nil,
         onLoadFailed: ((String) -> Void)? = nil
     ) {
         self.userId = userId
         self.cancellationToken = cancellationToken
+        self.prefetcher = prefetcher
         self.onFollowToggle = onFollowToggle
         self.onTap = onTap
         self.onLoadFailed = onLoadFailed
@@ -360,14 +363,20 @@ struct UserRowView: View {
                     return
                 }
                 
-                let fetchedUser = try await UserRowLoadGate.shared.withPermit {
-                    guard !Task.isCancelled else {
-                        throw CancellationError()
+                let fetchedUser: User?
+                if let prefetcher {
+                    // Usually already in flight from the list's look-ahead window
+                    fetchedUser = try await prefetcher.load(userId)
+                } else {
+                    fetchedUser = try await UserRowLoadGate.shared.withPermit {
+                        guard !Task.isCancelled else {
+                            throw CancellationError()
+                        }
+                        print("DEBUG: [UserRowView] Loading user with ID: \(userId)")
+                        // Keep spinner showing while fetchUser is in progress (includes retries)
+                        // fetchUser will retry up to 3 times before returning skeleton on failure
+                        return try await hproseInstance.fetchUser(userId, refreshExpiredCacheInBackground: false)
                     }
-                    print("DEBUG: [UserRowView] Loading user with ID: \(userId)")
-                    // Keep spinner showing while fetchUser is in progress (includes retries)
-                    // fetchUser will retry up to 3 times before returning skeleton on failure
-                    return try await hproseInstance.fetchUser(userId, refreshExpiredCacheInBackground: false)
                 }
                 
                 // Check if task should be cancelled before processing
@@ -372,7 +372,7 @@ class SearchViewModel: ObservableObject {
         if !isUsernameOnly {
             let tweets = await cacheManager.searchTweets(query: query, limit: 40)
             await MainActor.run {
-                self.tweetResults = tweets
+                self.tweetResults = ContentFilter.shared.filter(tweets, in: .feed)
             }
         }
     }
@@ -429,7 +429,11 @@ struct ProfileEditView: View {
             onAvatarUploadStateChange?(true) // Notify parent about upload start
             
             do {
-                // Convert UIImage to JPEG data
+                // The full crop is uploaded, so it stays the fallback for full screen and other
+                // clients; the size tiers are only cached locally
+                let variants = await Task.detached(priority: .userInitiated) {
+                    AvatarDerivatives.render(from: image)
+                }.value
                 guard let data = image.jpegData(compressionQuality: 0.9) else {
                     throw NSError(domain: "ProfileEditView", code: -1, userInfo: [NSLocalizedDescriptionKey: "Failed to convert image to data"])
                 }
@@ -455,6 +459,9 @@ struct ProfileEditView: View {
                         // Clear old avatar image cache
                         if let old = oldAvatar {
                             ImageCacheManager.shared.clearCache(for: "avatar_\(old)")
+                            for tier in AvatarDerivatives.tiers {
+                                ImageCacheManager.shared.clearCache(for: AvatarDerivatives.cacheAttachment(avatarId: old, tier: tier).mid)
+                            }
                             print("🗑️ [Avatar Upload] Cleared cache for old avatar: \(old)")
                         }
                         
@@ -466,6 +473,9 @@ struct ProfileEditView: View {
                     // Pre-cache the uploaded image locally so Avatar doesn't show spinner
                     let avatarAttachment = MimeiFileType(mid: "avatar_\(confirmedAvatar)", mediaType: .image)
                     _ = ImageCacheManager.shared.cacheImageData(data, for: avatarAttachment)
+                    for (tier, variant) in variants {
+                        ImageCacheManager.shared.cacheImage(variant, for: AvatarDerivatives.cacheAttachment(avatarId: confirmedAvatar, tier: tier))
+                    }
                     print("✅ [Avatar Upload] Pre-cached new avatar image locally")
                     
                     // Update UI state
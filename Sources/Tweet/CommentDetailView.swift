@@ -286,11 +286,18 @@ struct CommentDetailView: View {
             title: "Replies",
             comments: $replies,
             commentFetcher: { page, size in
-                let (fetched, _) = try await hproseInstance.fetchComments(
-                    comment,
-                    pageNumber: page,
-                    pageSize: size
-                )
+                // Replies may already be prefetched from the parent tweet's comment list
+                let (fetched, _) = try await CommentStore.shared.page(for: comment, page: page, pageSize: size) { fresh, removedIds in
+                    let removed = Set(removedIds)
+                    replies.removeAll { removed.contains($0.mid) }
+                    let existingIds = Set(replies.map { $0.mid })
+                    let added = fresh.filter { !existingIds.contains($0.mid) }
+                    if page == 0 {
+                        replies.insert(contentsOf: added, at: 0)
+                    } else {
+                        replies.append(contentsOf: added)
+                    }
+                }
                 return fetched
             },
             showTitle: false,
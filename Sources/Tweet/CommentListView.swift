@@ -28,6 +28,9 @@ struct CommentListView<RowView: View>: View {
     // suppress the open-time auto-probe's "No more comments" flash. The
     // default is a non-functional constant binding for non-embedded usage.
     var hasUserScrolled: Binding<Bool> = .constant(true)
+    /// Called once per page when the user scrolls past `CommentStore.prefetchThreshold` of the
+    /// loaded comments, with the next page number, the page size and whether more may exist.
+    let onApproachEnd: ((UInt, UInt, Bool) -> Void)?
     private let pageSize: UInt = 10
 
     @EnvironmentObject private var hproseInstance: HproseInstance
@@ -44,6 +47,7 @@ struct CommentListView<RowView: View>: View {
     @State private var loadingStartTime: Date? = nil
     @State private var showNoMoreComments = false
     @State private var hasTriggeredInitialTaskLoad = false
+    @State private var approachEndReportedForPage: UInt? = nil
     
     // Minimum duration to show the loading spinner (in seconds)
     private let minimumLoadingDuration: TimeInterval = 0.5
@@ -57,6 +61,7 @@ struct CommentListView<RowView: View>: View {
         notifications: [CommentListNotification]? = nil,
         isEmbedded: Bool = false,
         hasUserScrolled: Binding<Bool> = .constant(true),
+        onApproachEnd: ((UInt, UInt, Bool) -> Void)? = nil,
         rowView: @escaping (Tweet) -> RowView
     ) {
         self.title = title
@@ -66,6 +71,7 @@ struct CommentListView<RowView: View>: View {
         self.notifications = notifications ?? []
         self.isEmbedded = isEmbedded
         self.hasUserScrolled = hasUserScrolled
+        self.onApproachEnd = onApproachEnd
         self.rowView = rowView
     }
 
@@ -85,6 +91,7 @@ struct CommentListView<RowView: View>: View {
                         isLoading: isLoading,
                         initialLoadComplete: initialLoadComplete,
                         showNoMoreComments: showNoMoreComments,
+                        onRowAppear: { handleRowAppear($0) },
                         onReachBottom: { handleReachBottom() }
                     )
                 } else {
@@ -100,6 +107,7 @@ struct CommentListView<RowView: View>: View {
                             isLoading: isLoading,
                             initialLoadComplete: initialLoadComplete,
                             showNoMoreComments: showNoMoreComments,
+                            onRowAppear: { handleRowAppear($0) },
                             onReachBottom: { handleReachBottom() }
                         )
                     }
@@ -164,6 +172,7 @@ struct CommentListView<RowView: View>: View {
         isLoading = true
         initialLoadComplete = false
         currentPage = 0
+        approachEndReportedForPage = nil
         
         do {
             let newComments = try await commentFetcher(0, pageSize)
@@ -224,8 +233,11 @@ struct CommentListView<RowView: View>: View {
                 }
                 
                 await MainActor.run {
-                    if !validComments.isEmpty {
-                        comments.append(contentsOf: validComments)
+                    // Pages shift when comments are added or deleted meanwhile; skip rows already shown
+                    let existingIds = Set(comments.map { $0.mid })
+                    let uniqueComments = validComments.filter { !existingIds.contains($0.mid) }
+                    if !uniqueComments.isEmpty {
+                        comments.append(contentsOf: uniqueComments)
                     }
                     
                     // Use the same logic as TweetListView
@@ -271,6 +283,14 @@ struct CommentListView<RowView: View>: View {
         }
     }
 
+    private func handleRowAppear(_ index: Int) {
+        guard let onApproachEnd, initialLoadComplete, !comments.isEmpty,
+              approachEndReportedForPage != currentPage,
+              Double(index + 1) >= Double(comments.count) * CommentStore.prefetchThreshold else { return }
+        approachEndReportedForPage = currentPage
+        onApproachEnd(currentPage + 1, pageSize, hasMoreComments)
+    }
+
     // Called whenever the last comment row appears on screen. Triggers a
     // load-more fetch when something is fetchable. The "No more comments"
     // flash and the open-time suppression live in `showNoMoreMessage`.
@@ -318,6 +338,7 @@ struct CommentListContentView<RowView: View>: View {
     let isLoading: Bool
     let initialLoadComplete: Bool
     let showNoMoreComments: Bool
+    let onRowAppear: (Int) -> Void
     let onReachBottom: () -> Void
 
     var body: some View {
@@ -366,6 +387,7 @@ struct CommentListContentView<RowView: View>: View {
                     // LazyVStack (as in TweetDetailView). Fires for both "load more" and
                     // "no more" feedback.
                     .onAppear {
+                        onRowAppear(index)
                         if index == comments.count - 1 {
                             onReachBottom()
                         }
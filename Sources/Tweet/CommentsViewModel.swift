@@ -28,11 +28,13 @@ class CommentsViewModel: ObservableObject {
     func loadInitial() async {
         await MainActor.run { isLoading = true; currentPage = 0 }
         do {
-            let (newComments, _) = try await hproseInstance.fetchComments(
-                parentTweet,
-                pageNumber: 0,
-                pageSize: pageSize
-            )
+            let (newComments, _) = try await RPCDeadline.withDeadline(.interactive) {
+                try await hproseInstance.fetchComments(
+                    parentTweet,
+                    pageNumber: 0,
+                    pageSize: pageSize
+                )
+            }
             await MainActor.run {
                 comments = newComments.compactMap{ $0 }
                 hasMore = newComments.count == pageSize
@@ -52,11 +54,13 @@ class CommentsViewModel: ObservableObject {
         await MainActor.run { isLoading = true }
         let nextPage = currentPage + 1
         do {
-            let (moreComments, _) = try await hproseInstance.fetchComments(
-                parentTweet,
-                pageNumber: nextPage,
-                pageSize: pageSize
-            )
+            let (moreComments, _) = try await RPCDeadline.withDeadline(.interactive) {
+                try await hproseInstance.fetchComments(
+                    parentTweet,
+                    pageNumber: nextPage,
+                    pageSize: pageSize
+                )
+            }
             await MainActor.run {
                 let existingIds = Set(comments.map { $0.mid })
                 let uniqueNew = moreComments.compactMap { $0 }.filter { !existingIds.contains($0.mid) }
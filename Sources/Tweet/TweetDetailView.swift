@@ -3,21 +3,6 @@ import AVKit
 import UIKit
 
 @MainActor
-private final class TweetDetailCommentsCache {
-    static let shared = TweetDetailCommentsCache()
-    private var commentsByParentTweetId: [String: [Tweet]] = [:]
-
-    private init() {}
-
-    func comments(for parentTweetId: String) -> [Tweet]? {
-        commentsByParentTweetId[parentTweetId]
-    }
-
-    func setComments(_ comments: [Tweet], for parentTweetId: String) {
-        commentsByParentTweetId[parentTweetId] = comments
-    }
-}
-
 // MARK: - Bottom bar scroll tracker
 // Observes scroll view and updates SwiftUI state for bottom bar visibility
 private class BottomBarScrollObserver: NSObject {
@@ -422,7 +407,7 @@ struct DetailMediaCell: View {
                     )
                 case .audio:
                     // Show audio player with SimpleAudioPlayer
-                    SimpleAudioPlayer(url: url, autoPlay: false)
+                    SimpleAudioPlayer(url: url, autoPlay: false, fileName: attachment.fileName)
                         .environmentObject(MuteState.shared)
                 case .image:
                     // Images: use .fit for landscape, .fill for portrait, with black background
@@ -1001,11 +986,17 @@ struct TweetDetailView: View {
                             commentsListView
                                 .padding(.leading, -4)
                         }
+                        .coordinateSpace(name: "commentsContent")
                         .task {
                             setupInitialData()
                         }
                     }
-                    .coordinateSpace(name: "commentsScroll")
+                    .onScrollGeometryChange(for: CGRect.self) { geometry in
+                        geometry.visibleRect
+                    } action: { _, visibleRect in
+                        // Video frames are reported in content coordinates; only the viewport moves on scroll
+                        commentsVideoCoordinator.updateViewport(visibleRect)
+                    }
                     .refreshable {
                         await refreshTweetAndComments()
                     }
@@ -1076,7 +1067,6 @@ struct TweetDetailView: View {
                !comments.contains(where: { $0.mid == comment.mid }) {
                 comments.append(comment)
                 comments.sort { $0.timestamp > $1.timestamp }
-                TweetDetailCommentsCache.shared.setComments(comments, for: displayTweet.mid)
             }
         }
         .onReceive(NotificationCenter.default.publisher(for: .tweetDeleted)) { notification in
@@ -1175,7 +1165,6 @@ struct TweetDetailView: View {
         .onChange(of: comments.count) { _, _ in
             // Rebuild video list for fullscreen navigation when comments change
             commentsVideoCoordinator.buildVideoList(from: comments, outerTweetId: displayTweet.mid)
-            TweetDetailCommentsCache.shared.setComments(comments, for: displayTweet.mid)
         }
         .onChange(of: displayTweet.mid) { _, _ in
             configureCommentCacheContextIfNeeded()
@@ -1263,7 +1252,7 @@ struct TweetDetailView: View {
                                             attachmentIndex: origIdx,
                                             videoMid: attachment.mid,
                                             coordinator: commentsVideoCoordinator,
-                                            scrollCoordinateSpace: "commentsScroll"
+                                            contentCoordinateSpace: "commentsContent"
                                         )
                                     }
                                 } else {
@@ -1412,30 +1401,29 @@ struct TweetDetailView: View {
             commentFetcher: { page, size in
                 let parentTweet = await MainActor.run { displayTweet }
 
-                if page == 0 {
-                    let cachedComments: [Tweet]? = await MainActor.run {
-                        guard !hasServedCachedCommentsForCurrentParentTweet else { return nil }
-                        guard let cached = TweetDetailCommentsCache.shared.comments(for: parentTweet.mid),
-                              !cached.isEmpty else { return nil }
-                        hasServedCachedCommentsForCurrentParentTweet = true
-                        comments = cached
-                        return cached
-                    }
-                    if let cachedComments {
-                        return cachedComments.map { Optional($0) }
+                // Pull-to-refresh asks for page 0 again: that one goes to the network
+                let useCachedWindow = await MainActor.run {
+                    page > 0 || !hasServedCachedCommentsForCurrentParentTweet
+                }
+                let (fetched, failed) = try await RPCDeadline.withDeadline(.interactive) {
+                    if useCachedWindow {
+                        return try await CommentStore.shared.page(for: parentTweet, page: page, pageSize: size) { fresh, removedIds in
+                            guard displayTweet.mid == parentTweet.mid else { return }
+                            let removed = Set(removedIds)
+                            comments.removeAll { removed.contains($0.mid) }
+                            let existingIds = Set(comments.map { $0.mid })
+                            let added = fresh.filter { !existingIds.contains($0.mid) }
+                            if page == 0 {
+                                comments.insert(contentsOf: added, at: 0)
+                            } else {
+                                comments.append(contentsOf: added)
+                            }
+                        }
                     }
+                    return try await CommentStore.shared.fetchPage(for: parentTweet, page: page, pageSize: size)
                 }
-
-                let (fetched, failed) = try await hproseInstance.fetchComments(
-                    parentTweet,
-                    pageNumber: page,
-                    pageSize: size
-                )
                 if page == 0 {
-                    await MainActor.run {
-                        hasServedCachedCommentsForCurrentParentTweet = true
-                        TweetDetailCommentsCache.shared.setComments(fetched.compactMap { $0 }, for: parentTweet.mid)
-                    }
+                    await MainActor.run { hasServedCachedCommentsForCurrentParentTweet = true }
                 }
                 if !failed.isEmpty {
                     await MainActor.run { failedCommentIds.formUnion(failed) }
@@ -1468,12 +1456,15 @@ struct TweetDetailView: View {
             ],
             isEmbedded: true, // Embedded in TweetDetailView's ScrollView, avoid nested scrolling
             hasUserScrolled: $hasUserScrolledComments,
+            onApproachEnd: { nextPage, pageSize, hasMore in
+                CommentStore.shared.prefetch(after: comments, parentTweet: displayTweet, nextPage: nextPage, pageSize: pageSize, hasMore: hasMore)
+            },
             rowView: { comment in
                 CommentVideoTrackingWrapper(
                     parentTweet: displayTweet,
                     comment: comment,
                     coordinator: commentsVideoCoordinator,
-                    scrollCoordinateSpace: "commentsScroll"
+                    contentCoordinateSpace: "commentsContent"
                 )
                 .environment(\.videoListProvider, { videoMid, outerTweetId, mediaTweetId, attachmentIndex in
                     let list = commentsVideoCoordinator.getVideoListForFullscreen()
@@ -1612,7 +1603,6 @@ struct TweetDetailView: View {
             await MainActor.run {
                 if !allNewComments.isEmpty {
                     comments.insert(contentsOf: allNewComments, at: 0)
-                    TweetDetailCommentsCache.shared.setComments(comments, for: displayTweet.mid)
                 }
             }
         } catch {}
@@ -1644,13 +1634,8 @@ struct TweetDetailView: View {
 
         currentCommentsParentTweetId = parentTweetId
         hasServedCachedCommentsForCurrentParentTweet = false
-
-        if let cachedComments = TweetDetailCommentsCache.shared.comments(for: parentTweetId) {
-            comments = cachedComments
-            hasServedCachedCommentsForCurrentParentTweet = true
-        } else {
-            comments = []
-        }
+        // The first page comes from CommentStore's cached window, so there is no flash of network latency
+        comments = []
     }
     
     private func aspectRatio(for attachment: MimeiFileType, at index: Int) -> CGFloat {
@@ -1826,7 +1811,7 @@ struct CommentVideoTrackingWrapper: View {
     let parentTweet: Tweet
     @ObservedObject var comment: Tweet
     let coordinator: CommentsVideoPlaybackCoordinator
-    let scrollCoordinateSpace: String
+    let contentCoordinateSpace: String
 
     /// Returns the first video attachment in the comment, if any
     private var videoAttachment: (index: Int, attachment: MimeiFileType)? {
@@ -1856,7 +1841,7 @@ struct CommentVideoTrackingWrapper: View {
                             .onAppear {
                                 updateVisibility(geometry: geometry, videoInfo: video)
                             }
-                            .onChange(of: geometry.frame(in: .named(scrollCoordinateSpace))) { _, _ in
+                            .onChange(of: geometry.frame(in: .named(contentCoordinateSpace))) { _, _ in
                                 updateVisibility(geometry: geometry, videoInfo: video)
                             }
                     }
@@ -1871,28 +1856,12 @@ struct CommentVideoTrackingWrapper: View {
     }
 
     private func updateVisibility(geometry: GeometryProxy, videoInfo: (index: Int, attachment: MimeiFileType)) {
-        let frame = geometry.frame(in: .named(scrollCoordinateSpace))
-        let screenBounds = UIScreen.main.bounds
-
-        // Calculate how much of the comment is visible
-        let visibleTop = max(frame.minY, 0)
-        let visibleBottom = min(frame.maxY, screenBounds.height)
-        let visibleHeight = max(0, visibleBottom - visibleTop)
-        let totalHeight = frame.height
-
-        let visibilityRatio = totalHeight > 0 ? visibleHeight / totalHeight : 0
-
-        if visibilityRatio > 0 {
-            coordinator.reportVideoVisible(
-                commentId: comment.mid,
-                outerTweetId: parentTweet.mid,
-                videoMid: videoInfo.attachment.mid,
-                attachmentIndex: videoInfo.index,
-                visibilityRatio: visibilityRatio,
-                yPosition: frame.minY
-            )
-        } else {
-            coordinator.reportVideoNotVisible(commentId: comment.mid)
-        }
+        coordinator.reportVideoFrame(
+            commentId: comment.mid,
+            outerTweetId: parentTweet.mid,
+            videoMid: videoInfo.attachment.mid,
+            attachmentIndex: videoInfo.index,
+            frame: geometry.frame(in: .named(contentCoordinateSpace))
+        )
     }
 }
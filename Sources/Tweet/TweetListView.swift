@@ -42,6 +42,8 @@ struct TweetListView: View {
     /// External signal used by profile route recovery to reload page 0 while preserving currently visible tweets.
     let externalRefreshToken: Int
     let emptyStateText: LocalizedStringKey?
+    /// Content filter applied to fetched pages; nil for lists the user curated (bookmarks, favorites)
+    let contentFilterScope: ContentFilter.ListScope?
     private let pageSize: UInt = 10  // Manual load-more only
 
     // Navigation callbacks (passed through to UIKit cells)
@@ -177,6 +179,7 @@ struct TweetListView: View {
         allowNewTweetsBanner: Bool = false,
         externalRefreshToken: Int = 0,
         emptyStateText: LocalizedStringKey? = nil,
+        contentFilterScope: ContentFilter.ListScope? = nil,
         header: (() -> AnyView)? = nil,
         headerRefreshToken: Int = 0,
         onRefreshExtra: (() async -> Void)? = nil,
@@ -187,7 +190,14 @@ struct TweetListView: View {
     ) {
         self.title = title
         self._tweets = tweets
-        self.tweetFetcher = tweetFetcher
+        if let contentFilterScope {
+            // Hidden tweets become nil so pagination still sees the page's full length
+            self.tweetFetcher = { page, size, isFromCache in
+                ContentFilter.shared.masked(try await tweetFetcher(page, size, isFromCache), in: contentFilterScope)
+            }
+        } else {
+            self.tweetFetcher = tweetFetcher
+        }
         self.onForegroundRefresh = onForegroundRefresh
         self.showTitle = showTitle
         self.onScroll = onScroll
@@ -200,6 +210,7 @@ struct TweetListView: View {
         self.allowNewTweetsBanner = allowNewTweetsBanner
         self.externalRefreshToken = externalRefreshToken
         self.emptyStateText = emptyStateText
+        self.contentFilterScope = contentFilterScope
         self.header = header
         self.headerRefreshToken = headerRefreshToken
         self.onRefreshExtra = onRefreshExtra
@@ -382,6 +393,12 @@ struct TweetListView: View {
                 hasAppearedOnce = true
             }
         }
+        .onReceive(NotificationCenter.default.publisher(for: .contentFilterChanged)) { _ in
+            guard let contentFilterScope else { return }
+            let originalCount = tweets.count
+            tweets.removeAll { ContentFilter.shared.shouldHide($0, in: contentFilterScope) }
+            print("DEBUG: [TweetListView] Content filter changed, removed \(originalCount - tweets.count) tweets")
+        }
         .onReceive(NotificationCenter.default.publisher(for: NSNotification.Name("CacheCleared"))) { _ in
             // Refresh tweets when cache is cleared
             print("DEBUG: [TweetListView] Received CacheCleared notification, refreshing tweets")
@@ -126,7 +126,8 @@ class AvatarUIView: UIView {
                   avatarId == avatar || avatarId == "avatar_\(avatar)" else { return }
 
             let avatarAttachment = MimeiFileType(mid: "avatar_\(avatar)", mediaType: .image)
-            if let cached = ImageCacheManager.shared.getCompressedImageFromMemory(for: avatarAttachment) {
+            if let cached = self.variantAttachment(avatarId: avatar).flatMap({ ImageCacheManager.shared.getCompressedImageFromMemory(for: $0) })
+                ?? ImageCacheManager.shared.getCompressedImageFromMemory(for: avatarAttachment) {
                 self.imageView.image = cached
                 self.placeholderImageView.isHidden = true
             }
@@ -158,9 +159,12 @@ class AvatarUIView: UIView {
         let rawKey = user.avatar ?? (URL(string: avatarUrl)?.lastPathComponent ?? avatarUrl)
         let cacheKey = "avatar_\(rawKey)"
         let avatarAttachment = MimeiFileType(mid: cacheKey, mediaType: .image)
+        let expectedAvatarId = user.avatar
+        let variant = variantAttachment(avatarId: expectedAvatarId)
 
-        // Check memory cache first (synchronous, fast)
-        if let cached = ImageCacheManager.shared.getCompressedImageFromMemory(for: avatarAttachment) {
+        // Check memory cache first (synchronous, fast): the size variant, then the original
+        if let cached = variant.flatMap({ ImageCacheManager.shared.getCompressedImageFromMemory(for: $0) })
+            ?? ImageCacheManager.shared.getCompressedImageFromMemory(for: avatarAttachment) {
             imageView.image = cached
             placeholderImageView.isHidden = true
             return
@@ -172,8 +176,21 @@ class AvatarUIView: UIView {
         // Load asynchronously
         loadTask?.cancel()
         loadTask = Task { [weak self] in
-            // Check disk cache
+            // Check disk cache: the size variant, then the original
+            if let variant, let cached = ImageCacheManager.shared.getCompressedImage(for: variant) {
+                await MainActor.run {
+                    self?.imageView.image = cached
+                    self?.placeholderImageView.isHidden = true
+                }
+                return
+            }
             if let cached = ImageCacheManager.shared.getCompressedImage(for: avatarAttachment) {
+                // Cached before variants existed; derive them so later rows decode the small one
+                if variant != nil, let expectedAvatarId {
+                    Task.detached(priority: .utility) {
+                        AvatarDerivatives.cacheVariants(of: cached, avatarId: expectedAvatarId)
+                    }
+                }
                 await MainActor.run {
                     self?.imageView.image = cached
                     self?.placeholderImageView.isHidden = true
@@ -188,6 +205,11 @@ class AvatarUIView: UIView {
             }
 
             let result = await ImageCacheManager.shared.loadAndCacheImage(from: url, for: avatarAttachment)
+            if let result, variant != nil, let expectedAvatarId {
+                Task.detached(priority: .utility) {
+                    AvatarDerivatives.cacheVariants(of: result, avatarId: expectedAvatarId)
+                }
+            }
 
             guard !Task.isCancelled else { return }
 
@@ -202,6 +224,15 @@ class AvatarUIView: UIView {
         }
     }
 
+    /// The smallest size variant covering this view's pixels, or nil when it needs the original
+    private func variantAttachment(avatarId: MimeiId?) -> MimeiFileType? {
+        // Cells are configured before they join a window, when the trait scale can still be 0
+        let scale = traitCollection.displayScale > 0 ? traitCollection.displayScale : UIScreen.main.scale
+        guard let avatarId,
+              let tier = AvatarDerivatives.tier(for: avatarSize, scale: scale) else { return nil }
+        return AvatarDerivatives.cacheAttachment(avatarId: avatarId, tier: tier)
+    }
+
     func prepareForReuse() {
         loadTask?.cancel()
         loadTask = nil
@@ -1106,6 +1106,15 @@ class MediaCellUIView: UIView, MediaCellDelegate, UIGestureRecognizerDelegate {
         }
         requestFallbackVideoThumbnailIfNeeded(for: attachment.mid)
 
+        // Progressive videos can be range-filled from every provider of the author.
+        if attachment.type == .video, let authorId = parentTweet.author?.mid {
+            HproseInstance.shared.registerAlternateMediaSources(
+                mediaID: attachment.mid,
+                authorId: authorId,
+                primaryBaseUrl: effectiveBaseUrl
+            )
+        }
+
         // Tap gesture for fullscreen — on both videoPlayerView and imageView so that
         // any visible video is tappable (thumbnail state or non-primary use imageView).
         // Listen for .stopAllVideos (posted by non-coordinator code like handleVideoTap)
@@ -4499,7 +4508,7 @@ class MediaCellUIView: UIView, MediaCellDelegate, UIGestureRecognizerDelegate {
         imageView.isHidden = true
         removeAudioHosting()
 
-        let audioView = SimpleAudioPlayer(url: url, autoPlay: isVisible)
+        let audioView = SimpleAudioPlayer(url: url, autoPlay: isVisible, fileName: attachment?.fileName)
             .environmentObject(MuteState.shared)
 
         let hostingController = UIHostingController(rootView: AnyView(audioView))
@@ -0,0 +1,89 @@
+//
+//  AvatarDerivatives.swift
+//  Tweet
+//
+//  Fixed-size avatar variants, so a 40pt feed avatar decodes a 128px image instead of
+//  the full upload.
+//
+
+import UIKit
+
+/// The avatar size ladder and the helpers that produce and pick variants.
+///
+/// Variants are made from one decoded image: the largest tier is drawn from the source and
+/// each smaller tier from the one above it, so the source is never decoded twice. They are
+/// cached under `avatar_<id>_<px>`, which keeps the avatar eviction protection and is
+/// removed with the rest of a user's avatar cache.
+enum AvatarDerivatives {
+    /// Pixel edges of the square variants, smallest first
+    static let tiers = [64, 128, 256, 512]
+
+    static var largestTier: Int { tiers[tiers.count - 1] }
+
+    /// The smallest tier covering `pointSize` at `scale`, or nil when only the original will do.
+    static func tier(for pointSize: CGFloat, scale: CGFloat) -> Int? {
+        let pixels = Int((pointSize * scale).rounded(.up))
+        return tiers.first { $0 >= pixels }
+    }
+
+    static func cacheAttachment(avatarId: MimeiId, tier: Int) -> MimeiFileType {
+        MimeiFileType(mid: "avatar_\(avatarId)_\(tier)", mediaType: .image)
+    }
+
+    /// Every tier, keyed by pixel edge. Tiers larger than the source hold the source squared at
+    /// its own size, so whatever `tier(for:scale:)` asks for exists; they share one image.
+    static func render(from source: UIImage) -> [Int: UIImage] {
+        let sourceEdge = Int(min(source.size.width * source.scale, source.size.height * source.scale))
+        guard sourceEdge > 0 else { return [:] }
+
+        var variants: [Int: UIImage] = [:]
+        var previous: (edge: Int, image: UIImage)?
+        for tier in tiers.reversed() {
+            let edge = min(tier, sourceEdge)
+            if let previous, previous.edge == edge {
+                variants[tier] = previous.image
+                continue
+            }
+            let variant = draw(previous?.image ?? source, edge: edge)
+            variants[tier] = variant
+            previous = (edge, variant)
+        }
+        return variants
+    }
+
+    /// JPEG data for every tier; the largest is what gets uploaded as the avatar.
+    static func encode(_ variants: [Int: UIImage], quality: CGFloat = 0.85) -> [Int: Data] {
+        variants.compactMapValues { $0.jpegData(compressionQuality: quality) }
+    }
+
+    /// Cache the variants of an avatar that was just decoded (uploaded or downloaded).
+    static func cacheVariants(of image: UIImage, avatarId: MimeiId) {
+        let variants = render(from: image)
+        for (tier, variant) in variants {
+            ImageCacheManager.shared.cacheImage(variant, for: cacheAttachment(avatarId: avatarId, tier: tier))
+        }
+        print("DEBUG: [AvatarDerivatives] Cached tiers \(variants.keys.sorted()) for \(avatarId)")
+    }
+
+    // MARK: - Private
+
+    /// Square, opaque, 1x so the pixel edge is exact.
+    private static func draw(_ image: UIImage, edge: Int) -> UIImage {
+        let format = UIGraphicsImageRendererFormat()
+        format.scale = 1
+        format.opaque = true
+        let size = CGSize(width: edge, height: edge)
+        return UIGraphicsImageRenderer(size: size, format: format).image { _ in
+            // Aspect-fill, centered, in case the source isn't square
+            let sourceSize = image.size
+            let fill = max(size.width / sourceSize.width, size.height / sourceSize.height)
+            let drawSize = CGSize(width: sourceSize.width * fill, height: sourceSize.height * fill)
+            image.draw(in: CGRect(
+                x: (size.width - drawSize.width) / 2,
+                y: (size.height - drawSize.height) / 2,
+                width: drawSize.width,
+                height: drawSize.height
+            ))
+        }
+    }
+}
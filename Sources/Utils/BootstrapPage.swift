@@ -0,0 +1,535 @@
+//
+//  BootstrapPage.swift
+//  Tweet
+//
+//  Single-pass parsing of the entry page's `window.setParam({...})` block and of the
+//  node addresses it lists.
+//
+
+import Foundation
+
+/// A node address from the bootstrap page or a provider IP list, validated and classified
+/// once on its parsed octets.
+///
+/// Accepts "a.b.c.d", "a.b.c.d:port", "[v6]", "[v6]:port" and bare "v6" / "v6:port" (a
+/// trailing group is only taken as the port when the whole string isn't a valid address),
+/// optionally behind "http://" or "https://" and followed by "/".
+struct NodeAddress: Hashable, Sendable {
+    enum Family: Hashable, Sendable {
+        case ipv4
+        case ipv6
+    }
+
+    enum Scope: Hashable, Sendable {
+        case global
+        /// RFC 1918, fc00::/7
+        case privateNetwork
+        /// 100.64.0.0/10, RFC 6598 shared space (CGNAT, Tailscale)
+        case sharedAddressSpace
+        /// 169.254.0.0/16, fe80::/10
+        case linkLocal
+        case loopback
+        /// 0.0.0.0/8, multicast, 240.0.0.0/4, ::, ff00::/8
+        case reserved
+    }
+
+    let family: Family
+    /// Address text without brackets or port
+    let address: String
+    let port: Int?
+    /// Response time the bootstrap page reported for this node, in ms
+    let rtt: UInt64?
+    let scope: Scope
+
+    var isPublic: Bool { scope == .global }
+
+    /// "a.b.c.d:port" / "[v6]:port", the form the rest of the app keys nodes by
+    var hostPort: String {
+        let host = family == .ipv6 ? "[\(address)]" : address
+        return port.map { "\(host):\($0)" } ?? host
+    }
+
+    init?(hostPort: String, rtt: UInt64? = nil) {
+        var text = hostPort
+        guard let parsed = text.withUTF8({ Self.parse($0, 0, $0.count, rtt: rtt) }) else { return nil }
+        self = parsed
+    }
+
+    private init(family: Family, address: String, port: Int?, rtt: UInt64?, scope: Scope) {
+        self.family = family
+        self.address = address
+        self.port = port
+        self.rtt = rtt
+        self.scope = scope
+    }
+
+    /// True for a dotted-quad IPv4 address without port.
+    static func isIPv4(_ text: String) -> Bool {
+        var text = text
+        return text.withUTF8 { AddressText.ipv4($0, 0, $0.count) } != nil
+    }
+
+    // MARK: - Parsing
+
+    fileprivate static func parse(_ bytes: UnsafeBufferPointer<UInt8>, _ start: Int, _ end: Int, rtt: UInt64?) -> NodeAddress? {
+        var start = start
+        var end = end
+        while start < end, AddressText.isSpace(bytes[start]) { start += 1 }
+        while end > start, AddressText.isSpace(bytes[end - 1]) { end -= 1 }
+        if AddressText.hasPrefix(bytes, start, end, "http://") {
+            start += 7
+        } else if AddressText.hasPrefix(bytes, start, end, "https://") {
+            start += 8
+        }
+        if end > start, bytes[end - 1] == UInt8(ascii: "/") {
+            end -= 1
+        }
+        guard start < end else { return nil }
+
+        // [v6] or [v6]:port
+        if bytes[start] == UInt8(ascii: "[") {
+            guard let close = AddressText.firstIndex(of: UInt8(ascii: "]"), bytes, start, end),
+                  let value = AddressText.ipv6(bytes, start + 1, close) else { return nil }
+            var port: Int?
+            if close + 1 < end {
+                guard bytes[close + 1] == UInt8(ascii: ":"), let parsed = AddressText.port(bytes, close + 2, end) else { return nil }
+                port = parsed
+            }
+            return make(ipv6: value, bytes, start + 1, close, port: port, rtt: rtt)
+        }
+
+        var colons = 0
+        var lastColon = -1
+        for index in start..<end where bytes[index] == UInt8(ascii: ":") {
+            colons += 1
+            lastColon = index
+        }
+        switch colons {
+        case 0:
+            guard let value = AddressText.ipv4(bytes, start, end) else { return nil }
+            return make(ipv4: value, bytes, start, end, port: nil, rtt: rtt)
+        case 1:
+            guard let value = AddressText.ipv4(bytes, start, lastColon),
+                  let port = AddressText.port(bytes, lastColon + 1, end) else { return nil }
+            return make(ipv4: value, bytes, start, lastColon, port: port, rtt: rtt)
+        default:
+            if let value = AddressText.ipv6(bytes, start, end) {
+                return make(ipv6: value, bytes, start, end, port: nil, rtt: rtt)
+            }
+            guard let value = AddressText.ipv6(bytes, start, lastColon),
+                  let port = AddressText.port(bytes, lastColon + 1, end) else { return nil }
+            return make(ipv6: value, bytes, start, lastColon, port: port, rtt: rtt)
+        }
+    }
+
+    private static func make(ipv4 value: UInt32, _ bytes: UnsafeBufferPointer<UInt8>, _ start: Int, _ end: Int, port: Int?, rtt: UInt64?) -> NodeAddress {
+        NodeAddress(family: .ipv4, address: AddressText.string(bytes, start, end), port: port, rtt: rtt, scope: scope(ipv4: value))
+    }
+
+    private static func make(ipv6 value: (high: UInt64, low: UInt64), _ bytes: UnsafeBufferPointer<UInt8>, _ start: Int, _ end: Int, port: Int?, rtt: UInt64?) -> NodeAddress {
+        NodeAddress(family: .ipv6, address: AddressText.string(bytes, start, end), port: port, rtt: rtt, scope: scope(ipv6: value))
+    }
+
+    // MARK: - Classification
+
+    private static func scope(ipv4 value: UInt32) -> Scope {
+        let first = value >> 24
+        let second = (value >> 16) & 0xFF
+        switch first {
+        case 10:
+            return .privateNetwork
+        case 172 where (16...31).contains(second):
+            return .privateNetwork
+        case 192 where second == 168:
+            return .privateNetwork
+        case 100 where (64...127).contains(second):
+            return .sharedAddressSpace
+        case 169 where second == 254:
+            return .linkLocal
+        case 127:
+            return .loopback
+        case 0, 224...:
+            return .reserved
+        default:
+            return .global
+        }
+    }
+
+    private static func scope(ipv6 value: (high: UInt64, low: UInt64)) -> Scope {
+        if value.high == 0 {
+            if value.low == 0 { return .reserved }
+            if value.low == 1 { return .loopback }
+            // ::ffff:a.b.c.d is the IPv4 address
+            if value.low >> 32 == 0xFFFF { return scope(ipv4: UInt32(truncatingIfNeeded: value.low)) }
+        }
+        if value.high >> 57 == 0x7E { return .privateNetwork }   // fc00::/7
+        if value.high >> 54 == 0x3FA { return .linkLocal }       // fe80::/10
+        if value.high >> 56 == 0xFF { return .reserved }         // multicast
+        return .global
+    }
+}
+
+/// What the bootstrap (entry) page publishes in `window.setParam({...})`.
+///
+/// The page is scanned once at the byte level: the parameter object is tokenized as a
+/// JavaScript object literal, `mid` is read as a string and `addrs` is walked for
+/// `["host:port", rtt]` pairs at any nesting depth. Unknown keys are skipped.
+struct BootstrapPage {
+    /// App id (`mid`), when the page has one
+    private(set) var appId: String?
+    /// Every `addrs` entry that parsed as an address, in page order
+    private(set) var addresses: [NodeAddress] = []
+    /// `addrs` as written on the page, to log changes
+    private(set) var rawAddrs: String?
+
+    private static let marker = Array("window.setParam(".utf8)
+    /// Deeper arrays than this are skipped rather than walked
+    private static let maxDepth = 16
+
+    init(html: String) {
+        var html = html
+        html.withUTF8 { bytes in
+            guard let markerEnd = AddressText.firstIndex(of: Self.marker, bytes) else { return }
+            var scanner = ScriptScanner(bytes: bytes, index: markerEnd)
+            scanner.skipTrivia()
+            guard scanner.consume(UInt8(ascii: "{")) else { return }
+            parseParams(&scanner)
+        }
+    }
+
+    private mutating func parseParams(_ scanner: inout ScriptScanner) {
+        while true {
+            scanner.skipTrivia()
+            if scanner.atEnd || scanner.consume(UInt8(ascii: "}")) { return }
+            guard let key = scanner.readKey() else { return }
+            scanner.skipTrivia()
+            guard scanner.consume(UInt8(ascii: ":")) else { return }
+            scanner.skipTrivia()
+
+            switch key {
+            case "mid":
+                if let range = scanner.readString() {
+                    appId = AddressText.string(scanner.bytes, range.lowerBound, range.upperBound)
+                } else {
+                    scanner.skipValue()
+                }
+            case "addrs":
+                let start = scanner.index
+                collectAddresses(&scanner, depth: 0)
+                rawAddrs = AddressText.string(scanner.bytes, start, scanner.index)
+            default:
+                scanner.skipValue()
+            }
+
+            scanner.skipTrivia()
+            guard scanner.consume(UInt8(ascii: ",")) else { return }
+        }
+    }
+
+    /// Walk one value of `addrs`, adding every `[string, number, ...]` array as an address.
+    private mutating func collectAddresses(_ scanner: inout ScriptScanner, depth: Int) {
+        guard depth < Self.maxDepth, scanner.peek == UInt8(ascii: "[") else {
+            scanner.skipValue()
+            return
+        }
+        scanner.index += 1
+        var position = 0
+        var host: Range<Int>?
+        while true {
+            scanner.skipTrivia()
+            if scanner.atEnd || scanner.consume(UInt8(ascii: "]")) { return }
+
+            if scanner.peek == UInt8(ascii: "[") {
+                collectAddresses(&scanner, depth: depth + 1)
+            } else if position == 0, let range = scanner.readString() {
+                host = range
+            } else if position == 1, let host, let rtt = scanner.readInteger() {
+                if let address = NodeAddress.parse(scanner.bytes, host.lowerBound, host.upperBound, rtt: rtt) {
+                    addresses.append(address)
+                }
+            } else {
+                scanner.skipValue()
+            }
+            position += 1
+
+            scanner.skipTrivia()
+            if scanner.consume(UInt8(ascii: "]")) { return }
+            guard scanner.consume(UInt8(ascii: ",")) else {
+                // Malformed: give up on this array, keep what was found
+                scanner.index = scanner.bytes.count
+                return
+            }
+        }
+    }
+}
+
+// MARK: - Scanning
+
+/// Cursor over the bytes of a JavaScript object literal; tolerant of what the page
+/// generator emits (unquoted keys, single quotes, comments, trailing commas).
+private struct ScriptScanner {
+    let bytes: UnsafeBufferPointer<UInt8>
+    var index: Int
+
+    var atEnd: Bool { index >= bytes.count }
+    var peek: UInt8? { atEnd ? nil : bytes[index] }
+
+    mutating func consume(_ byte: UInt8) -> Bool {
+        guard peek == byte else { return false }
+        index += 1
+        return true
+    }
+
+    mutating func skipTrivia() {
+        while !atEnd {
+            let byte = bytes[index]
+            if AddressText.isSpace(byte) {
+                index += 1
+            } else if byte == UInt8(ascii: "/"), index + 1 < bytes.count, bytes[index + 1] == UInt8(ascii: "/") {
+                while !atEnd, bytes[index] != UInt8(ascii: "\n") { index += 1 }
+            } else if byte == UInt8(ascii: "/"), index + 1 < bytes.count, bytes[index + 1] == UInt8(ascii: "*") {
+                index += 2
+                while index + 1 < bytes.count, !(bytes[index] == UInt8(ascii: "*") && bytes[index + 1] == UInt8(ascii: "/")) { index += 1 }
+                index = min(index + 2, bytes.count)
+            } else {
+                return
+            }
+        }
+    }
+
+    /// An identifier or quoted key.
+    mutating func readKey() -> String? {
+        if let range = readString() {
+            return AddressText.string(bytes, range.lowerBound, range.upperBound)
+        }
+        let start = index
+        while !atEnd, AddressText.isIdentifier(bytes[index]) { index += 1 }
+        return index > start ? AddressText.string(bytes, start, index) : nil
+    }
+
+    /// The contents of a quoted string, quotes excluded. Escapes are skipped over, not decoded;
+    /// nothing this page carries needs them.
+    mutating func readString() -> Range<Int>? {
+        guard let quote = peek, quote == UInt8(ascii: "\"") || quote == UInt8(ascii: "'") || quote == UInt8(ascii: "`") else { return nil }
+        let start = index + 1
+        var cursor = start
+        while cursor < bytes.count, bytes[cursor] != quote {
+            cursor += bytes[cursor] == UInt8(ascii: "\\") ? 2 : 1
+        }
+        guard cursor < bytes.count else {
+            index = bytes.count
+            return nil
+        }
+        index = cursor + 1
+        return start..<cursor
+    }
+
+    /// A non-negative number, fraction truncated.
+    mutating func readInteger() -> UInt64? {
+        let start = index
+        var value: UInt64 = 0
+        while !atEnd, let digit = AddressText.digit(bytes[index]) {
+            let (scaled, overflow) = value.multipliedReportingOverflow(by: 10)
+            value = overflow ? .max : scaled.addingReportingOverflow(UInt64(digit)).partialValue
+            index += 1
+        }
+        guard index > start else { return nil }
+        if consume(UInt8(ascii: ".")) {
+            while !atEnd, AddressText.digit(bytes[index]) != nil { index += 1 }
+        }
+        return value
+    }
+
+    /// Skip one value: string, array or object (brackets balanced, strings respected), or a bare token.
+    mutating func skipValue() {
+        if readString() != nil { return }
+        guard let first = peek else { return }
+        guard first == UInt8(ascii: "[") || first == UInt8(ascii: "{") else {
+            while !atEnd {
+                let byte = bytes[index]
+                if byte == UInt8(ascii: ",") || byte == UInt8(ascii: "}") || byte == UInt8(ascii: "]") { return }
+                index += 1
+            }
+            return
+        }
+        var depth = 0
+        while !atEnd {
+            let byte = bytes[index]
+            if byte == UInt8(ascii: "\"") || byte == UInt8(ascii: "'") || byte == UInt8(ascii: "`") {
+                _ = readString()
+                continue
+            }
+            if byte == UInt8(ascii: "[") || byte == UInt8(ascii: "{") {
+                depth += 1
+            } else if byte == UInt8(ascii: "]") || byte == UInt8(ascii: "}") {
+                depth -= 1
+                if depth == 0 {
+                    index += 1
+                    return
+                }
+            }
+            index += 1
+        }
+    }
+}
+
+/// Byte-level address grammar shared by `NodeAddress` and `BootstrapPage`.
+private enum AddressText {
+    static func isSpace(_ byte: UInt8) -> Bool {
+        byte == 0x20 || byte == 0x09 || byte == 0x0A || byte == 0x0D
+    }
+
+    static func isIdentifier(_ byte: UInt8) -> Bool {
+        digit(byte) != nil || byte == UInt8(ascii: "_") || byte == UInt8(ascii: "$")
+            || (byte | 0x20 >= UInt8(ascii: "a") && byte | 0x20 <= UInt8(ascii: "z"))
+    }
+
+    static func digit(_ byte: UInt8) -> UInt8? {
+        byte >= UInt8(ascii: "0") && byte <= UInt8(ascii: "9") ? byte - UInt8(ascii: "0") : nil
+    }
+
+    static func hexDigit(_ byte: UInt8) -> UInt8? {
+        if let value = digit(byte) { return value }
+        let lower = byte | 0x20
+        return lower >= UInt8(ascii: "a") && lower <= UInt8(ascii: "f") ? lower - UInt8(ascii: "a") + 10 : nil
+    }
+
+    static func string(_ bytes: UnsafeBufferPointer<UInt8>, _ start: Int, _ end: Int) -> String {
+        String(decoding: UnsafeBufferPointer(rebasing: bytes[start..<end]), as: UTF8.self)
+    }
+
+    static func hasPrefix(_ bytes: UnsafeBufferPointer<UInt8>, _ start: Int, _ end: Int, _ prefix: StaticString) -> Bool {
+        guard end - start >= prefix.utf8CodeUnitCount else { return false }
+        return prefix.withUTF8Buffer { prefixBytes in
+            prefixBytes.indices.allSatisfy { bytes[start + $0] | 0x20 == prefixBytes[$0] | 0x20 }
+        }
+    }
+
+    static func firstIndex(of byte: UInt8, _ bytes: UnsafeBufferPointer<UInt8>, _ start: Int, _ end: Int) -> Int? {
+        var index = start
+        while index < end {
+            if bytes[index] == byte { return index }
+            index += 1
+        }
+        return nil
+    }
+
+    /// Index just past the first occurrence of `needle`.
+    static func firstIndex(of needle: [UInt8], _ bytes: UnsafeBufferPointer<UInt8>) -> Int? {
+        guard let first = needle.first, bytes.count >= needle.count else { return nil }
+        var index = 0
+        while let candidate = firstIndex(of: first, bytes, index, bytes.count - needle.count + 1) {
+            if needle.indices.allSatisfy({ bytes[candidate + $0] == needle[$0] }) {
+                return candidate + needle.count
+            }
+            index = candidate + 1
+        }
+        return nil
+    }
+
+    /// 1...65535, decimal, at most 5 digits
+    static func port(_ bytes: UnsafeBufferPointer<UInt8>, _ start: Int, _ end: Int) -> Int? {
+        guard start < end, end - start <= 5 else { return nil }
+        var value = 0
+        for index in start..<end {
+            guard let digit = digit(bytes[index]) else { return nil }
+            value = value * 10 + Int(digit)
+        }
+        return (1...65535).contains(value) ? value : nil
+    }
+
+    /// Dotted-quad IPv4 (RFC 791 text form, no leading zeros).
+    static func ipv4(_ bytes: UnsafeBufferPointer<UInt8>, _ start: Int, _ end: Int) -> UInt32? {
+        var value: UInt32 = 0
+        var octet: UInt32 = 0
+        var digits = 0
+        var dots = 0
+        for index in start..<max(start, end) {
+            let byte = bytes[index]
+            if byte == UInt8(ascii: ".") {
+                guard digits > 0, dots < 3 else { return nil }
+                value = value << 8 | octet
+                octet = 0
+                digits = 0
+                dots += 1
+            } else if let digit = digit(byte) {
+                // "0" is fine, "01" is not
+                guard !(digits > 0 && octet == 0) else { return nil }
+                octet = octet * 10 + UInt32(digit)
+                digits += 1
+                guard octet <= 255 else { return nil }
+            } else {
+                return nil
+            }
+        }
+        guard dots == 3, digits > 0 else { return nil }
+        return value << 8 | octet
+    }
+
+    /// RFC 4291 text form: up to eight 16-bit hex groups, at most one "::", optionally
+    /// ending in a dotted-quad. Zone ids are not accepted.
+    static func ipv6(_ bytes: UnsafeBufferPointer<UInt8>, _ start: Int, _ end: Int) -> (high: UInt64, low: UInt64)? {
+        guard start < end else { return nil }
+        var groups = SIMD8<UInt16>()
+        var count = 0
+        var gap: Int?
+        var index = start
+
+        if bytes[index] == UInt8(ascii: ":") {
+            guard index + 1 < end, bytes[index + 1] == UInt8(ascii: ":") else { return nil }
+            gap = 0
+            index += 2
+        }
+        while index < end {
+            var cursor = index
+            var value: UInt32 = 0
+            while cursor < end, cursor - index < 4, let hex = hexDigit(bytes[cursor]) {
+                value = value << 4 | UInt32(hex)
+                cursor += 1
+            }
+            if cursor < end, bytes[cursor] == UInt8(ascii: ".") {
+                // Embedded IPv4 takes the last two groups
+                guard count <= 6, let v4 = ipv4(bytes, index, end) else { return nil }
+                groups[count] = UInt16(truncatingIfNeeded: v4 >> 16)
+                groups[count + 1] = UInt16(truncatingIfNeeded: v4)
+                count += 2
+                break
+            }
+            guard cursor > index, count < 8 else { return nil }
+            groups[count] = UInt16(value)
+            count += 1
+            index = cursor
+            if index == end { break }
+
+            guard bytes[index] == UInt8(ascii: ":") else { return nil }
+            index += 1
+            if index < end, bytes[index] == UInt8(ascii: ":") {
+                guard gap == nil else { return nil }
+                gap = count
+                index += 1
+            } else if index == end {
+                return nil
+            }
+        }
+
+        if let gap {
+            guard count < 8 else { return nil }
+            let shift = 8 - count
+            var expanded = SIMD8<UInt16>()
+            for position in 0..<count {
+                expanded[position < gap ? position : position + shift] = groups[position]
+            }
+            groups = expanded
+        } else {
+            guard count == 8 else { return nil }
+        }
+
+        var high: UInt64 = 0
+        var low: UInt64 = 0
+        for position in 0..<4 {
+            high = high << 16 | UInt64(groups[position])
+            low = low << 16 | UInt64(groups[position + 4])
+        }
+        return (high, low)
+    }
+}
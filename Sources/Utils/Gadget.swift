@@ -1,211 +1,12 @@
 import Foundation
 import Network
 
-// MARK: - String Extension for getIP
-extension String {
-    func getIP() -> String? {
-        let ipv4Regex = "^(?:(?:25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)\\.){3}(?:25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)(?::\\d+)?$"
-        let ipv6Regex = "\\[(.*?)\\]"
-        if let _ = self.range(of: ipv4Regex, options: .regularExpression) {
-            return self
-        }
-        if let match = self.range(of: ipv6Regex, options: .regularExpression) {
-            let nsrange = NSRange(match, in: self)
-            if let regex = try? NSRegularExpression(pattern: ipv6Regex),
-               let result = regex.firstMatch(in: self, options: [], range: nsrange),
-               let range = Range(result.range(at: 1), in: self) {
-                return String(self[range])
-            }
-        }
-        return nil
-    }
-}
-
 // MARK: - Gadget Utility
 class Gadget {
     static let shared = Gadget()
     
     private init() {}
     
-    // Filter IP addresses from a nested array structure
-    func filterIpAddresses(_ nodeList: Any) -> String? {
-        let cleanedInput = (nodeList as? String)?.replacingOccurrences(of: "\"", with: "") ?? ""
-        
-        // Split the input into groups
-        let groups = cleanedInput.components(separatedBy: "],[")
-            .map { $0.trimmingCharacters(in: CharacterSet(charactersIn: "[]")) }
-            .filter { !$0.isEmpty }
-        
-        var fastestIP: String? = nil
-        var fastestResponseTime: UInt64 = UInt64.max
-        
-        for group in groups {
-            let pairs = group.components(separatedBy: "],[")
-                .map { $0.trimmingCharacters(in: CharacterSet(charactersIn: "[]")) }
-                .filter { !$0.isEmpty }
-            
-            for pair in pairs {
-                let components = pair.components(separatedBy: ",")
-                guard components.count >= 2,
-                      let responseTime = UInt64(components[1].trimmingCharacters(in: .whitespaces)) else {
-                    continue
-                }
-                
-                let ipWithPort = components[0].trimmingCharacters(in: .whitespaces)
-                
-                // Extract IP and port
-                let ipComponents = ipWithPort.split(separator: ":")
-                guard ipComponents.count >= 2 else { continue }
-                
-                let port = String(ipComponents.last!)
-                guard let portNumber = Int(port), (8000...9000).contains(portNumber) else {
-                    continue
-                }
-                
-                // Get clean IP address
-                var ipAddress = ipWithPort.replacingOccurrences(of: ":" + port, with: "")
-                if ipAddress.hasPrefix("[") && ipAddress.hasSuffix("]") {
-                    ipAddress = String(ipAddress.dropFirst().dropLast())
-                }
-                
-                // Check if it's a private IP
-                if Gadget.isPrivateIP(ipAddress) {
-                    continue
-                }
-                
-                // Check if this is the fastest response so far
-                if responseTime < fastestResponseTime {
-                    fastestResponseTime = responseTime
-                    fastestIP = ipWithPort
-                }
-            }
-        }
-        
-        return fastestIP
-    }
-    
-//    func getAccessibleIP(ipList: [String]) async -> String? {
-//        await withTaskGroup(of: String?.self) { group in
-//            for ip in ipList {
-//                if Gadget.isValidPublicIpAddress(ip) {
-//                    group.addTask {
-//                        // Replace this with your actual async accessibility check
-//                        let accessible = await HproseInstance.isAccessible(ip)
-//                        return accessible
-//                    }
-//                }
-//            }
-//            // Wait for the first non-nil result, or nil if none found
-//            for await result in group {
-//                if let ip = result {
-//                    print("Fastest ip: \(ip)")
-//                    group.cancelAll() // Cancel remaining tasks
-//                    return ip
-//                }
-//            }
-//            return nil
-//        }
-//    }
-    
-    // 100.64.0.0/10 — RFC 6598 CGNAT / Tailscale (second octet 64–127)
-    private static func isRFC6598Address(_ ip: String) -> Bool {
-        guard ip.starts(with: "100.") else { return false }
-        let parts = ip.split(separator: ".")
-        guard parts.count >= 2, let second = Int(parts[1]) else { return false }
-        return (64...127).contains(second)
-    }
-
-    // Helper function to check if an IP is private
-    static func isPrivateIP(_ ip: String) -> Bool {
-        // IPv4 private ranges
-        if ip.starts(with: "10.") ||
-           ip.starts(with: "192.168.") ||
-           ip.range(of: "^172\\.(1[6-9]|2[0-9]|3[0-1])\\.", options: .regularExpression) != nil ||
-           isRFC6598Address(ip) { // RFC 6598 Shared Address Space (Tailscale)
-            return true
-        }
-        
-        // IPv6 private ranges (fc00::/7 - unique local addresses)
-        if ip.lowercased().starts(with: "fc") || ip.lowercased().starts(with: "fd") {
-            return true
-        }
-        
-        // IPv6 link-local (fe80::/10)
-        if ip.lowercased().starts(with: "fe8") ||
-           ip.lowercased().starts(with: "fe9") ||
-           ip.lowercased().starts(with: "fea") ||
-           ip.lowercased().starts(with: "feb") {
-            return true
-        }
-        
-        return false
-    }
-
-    // Check if an IP is a valid public IP address
-    static func isValidPublicIpAddress(_ fullIp: String) -> Bool {
-        // Extract clean IP address from the full IP string (which may include port)
-        let cleanIP: String
-        
-        if fullIp.hasPrefix("[") && fullIp.contains("]:") {
-            // IPv6 with port, e.g. [240e:391:edf:ad90:b25a:daff:fe87:21d4]:8002
-            if let endBracket = fullIp.firstIndex(of: "]") {
-                cleanIP = String(fullIp[fullIp.index(after: fullIp.startIndex)..<endBracket])
-            } else {
-                return false
-            }
-        } else if fullIp.contains(":") && !fullIp.contains("]:") && !fullIp.contains("[") {
-            // IPv4 with port, e.g. 60.163.239.184:8002
-            let parts = fullIp.split(separator: ":", maxSplits: 1)
-            if parts.count == 2 {
-                cleanIP = String(parts[0])
-            } else {
-                return false
-            }
-        } else {
-            // No port specified, use the full string
-            cleanIP = fullIp.hasPrefix("[") && fullIp.hasSuffix("]") ? 
-                String(fullIp.dropFirst().dropLast()) : fullIp
-        }
-        
-        if isIPv6Address(cleanIP) {
-            // For IPv6, check if it's NOT a private address
-            return !isPrivateIP(cleanIP)
-        } else {
-            let ipv4Regex = "^(([0-9]|[1-9][0-9]|1[0-9]{2}|2[0-4][0-9]|25[0-5])\\.){3}([0-9]|[1-9][0-9]|1[0-9]{2}|2[0-4][0-9]|25[0-5])$"
-            guard cleanIP.range(of: ipv4Regex, options: .regularExpression) != nil else { return false }
-            let octets = cleanIP.split(separator: ".").compactMap { UInt8($0) }
-            guard octets.count == 4 else { return false }
-            return !isPrivateIP(cleanIP)
-        }
-    }
-
-    // Check if an IP is IPv6
-    static func isIPv6Address(_ ip: String) -> Bool {
-        return ip.contains(":")
-    }
-
-    // Get accessible IP (prefer IPv4, fallback to IPv6)
-    func getAccessibleIP2(_ ipList: [String]) -> String? {
-        var ip4: String? = nil
-        var ip6: String? = nil
-        for it in ipList {
-            let i = it.split(separator: ":").dropLast().joined(separator: ":").trimmingCharacters(in: CharacterSet(charactersIn: "[]"))
-            guard let p = Int(it.split(separator: ":").last ?? "") else { continue }
-            if !(8000...9000).contains(p) { continue }
-            if Gadget.isIPv6Address(i) {
-                ip6 = "[i]:\(p)"
-            } else {
-                let ipv4Regex = "^(([0-9]|[1-9][0-9]|1[0-9]{2}|2[0-4][0-9]|25[0-5])\\.){3}([0-9]|[1-9][0-9]|1[0-9]{2}|2[0-4][0-9]|25[0-5])$"
-                guard i.range(of: ipv4Regex, options: .regularExpression) != nil else { continue }
-                let octets = i.split(separator: ".").compactMap { UInt8($0) }
-                guard octets.count == 4 else { continue }
-                if Gadget.isPrivateIP(i) { continue }
-                ip4 = "\(i):\(p)"
-            }
-        }
-        return ip4 ?? ip6
-    }
-
     static func getAlphaIds() -> [String] {
         let alphaIdString = AppConfig.alphaId
         return alphaIdString
@@ -236,43 +37,6 @@ class Gadget {
         if allowDeleteAll { return true }
         return isResearchAdminUser(appUser)
     }
-    
-    func extractParamMap(from html: String) -> [String: Any] {
-        var result: [String: Any] = [:]
-        
-        // Find the window.setParam section
-        let startText = "window.setParam({"
-        let endText = "})\nwindow.request()"
-        
-        guard let startRange = html.range(of: startText),
-              let endRange = html.range(of: endText, options: .backwards) else {
-            return result
-        }
-        
-        // Extract the parameter text
-        let startIndex = startRange.upperBound
-        let endIndex = endRange.lowerBound
-        let paramText = html[startIndex..<endIndex]
-        
-        // Extract addrs (complex array)
-        if let addrsStartRange = paramText.range(of: "addrs: "),
-           let bracketStart = paramText[addrsStartRange.upperBound...].firstIndex(of: "["),
-           let lastBracketRange = paramText[bracketStart...].range(of: "]]]", options: .backwards) {
-            let addrsValue = paramText[bracketStart...lastBracketRange.upperBound]
-            result["addrs"] = String(addrsValue)
-        }
-        
-        // Extract mid (string) - using double quotes
-        if let midStartRange = paramText.range(of: "mid:\""),
-           let midEndRange = paramText[midStartRange.upperBound...].range(of: "\"") {
-            let midValue = paramText[midStartRange.upperBound..<midEndRange.lowerBound]
-            result["mid"] = String(midValue)
-        }
-        
-        return result
-    }
-    
-
 }
 
 // MARK: - Error Message Helper
@@ -50,12 +50,21 @@ struct MediaPicker: View {
                     .font(.system(size: 20))
             }
             .onChange(of: selectedItems) { oldItems, newItems in
-                // Check for oversized files and remove them from selection
+                // Stage new items, cancel deselected ones, then drop oversized files
+                MediaStaging.pickerItems.select(newItems)
+                MediaStagingProgress.shared.retain(only: newItems)
+                let addedItems = newItems.filter { !oldItems.contains($0) }
                 Task {
-                    await filterOversizedFiles(from: newItems)
+                    await removeOversizedFiles(from: addedItems)
                 }
                 onItemAdded?()
             }
+            .onDisappear {
+                // A discarded draft never clears its selection; drop its staged copies with the
+                // picker. Items a post was prepared from are detached and survive this.
+                MediaStaging.pickerItems.select([])
+                MediaStagingProgress.shared.retain(only: [])
+            }
             
             // Camera button (show if images or videos are supported)
             if supportedTypes.contains(.image) || supportedTypes.contains(.movie) {
@@ -70,75 +79,35 @@ struct MediaPicker: View {
         }
     }
     
-    private func filterOversizedFiles(from items: [PhotosPickerItem]) async {
-        let maxFileSize = Constants.MAX_FILE_SIZE
-        var validItems: [PhotosPickerItem] = []
-        
+    /// Preflight on file metadata: items are staged to disk once (shared with thumbnails and
+    /// upload preparation) and oversized ones are dropped from the selection.
+    private func removeOversizedFiles(from items: [PhotosPickerItem]) async {
+        var rejected: [PhotosPickerItem] = []
         for item in items {
             do {
-                // Load file data to check size for all file types
-                if let data = try await item.loadTransferable(type: Data.self) {
-                    if data.count > maxFileSize {
-                        let typeIdentifier = item.supportedContentTypes.first?.identifier ?? "public.image"
-                        let fileType = getFileTypeDescription(from: typeIdentifier)
-                        let fileSizeMB = Double(data.count) / (1024 * 1024)
-                        let maxSizeMB = Double(maxFileSize) / (1024 * 1024)
-                        
-                        // Show error message
-                        let errorMessage = NSError(
-                            domain: "FileProcessing", 
-                            code: -1, 
-                            userInfo: [
-                                NSLocalizedDescriptionKey: String(format: NSLocalizedString("%@ file is too large (%.1fMB). Maximum allowed size is %.0fMB.", comment: "File size error message"), fileType, fileSizeMB, maxSizeMB)
-                            ]
-                        )
-                        await MainActor.run {
-                            NotificationCenter.default.post(name: .errorOccurred, object: errorMessage)
-                        }
-                        continue // Skip this oversized file
-                    }
+                let staged = try await MediaStaging.pickerItems.staged(item)
+                guard let message = MediaStaging.policy.rejection(for: staged.metadata) else { continue }
+                rejected.append(item)
+                let errorMessage = NSError(
+                    domain: "FileProcessing",
+                    code: -1,
+                    userInfo: [NSLocalizedDescriptionKey: message]
+                )
+                await MainActor.run {
+                    NotificationCenter.default.post(name: .errorOccurred, object: errorMessage)
                 }
-                
-                // Add valid items (all file types under size limit)
-                validItems.append(item)
-                
+            } catch is CancellationError {
+                // Deselected while staging
             } catch {
-                print("DEBUG: Error checking file size: \(error)")
+                print("DEBUG: [MediaPicker] Preflight failed, keeping item: \(error)")
                 // If we can't check the size, allow the item (fallback)
-                validItems.append(item)
             }
         }
         
-        // Update selection to only include valid items
-        if validItems.count != items.count {
-            await MainActor.run {
-                selectedItems = validItems
-            }
-        }
-    }
-    
-    private func getFileTypeDescription(from typeIdentifier: String) -> String {
-        if typeIdentifier.contains("movie") || typeIdentifier.contains("video") || 
-           typeIdentifier.contains("mpeg") || typeIdentifier.contains("mp4") || 
-           typeIdentifier.contains("mov") || typeIdentifier.contains("avi") || 
-           typeIdentifier.contains("wmv") || typeIdentifier.contains("flv") || 
-           typeIdentifier.contains("webm") {
-            return "Video"
-        } else if typeIdentifier.contains("image") || typeIdentifier.contains("jpeg") || 
-                  typeIdentifier.contains("png") || typeIdentifier.contains("gif") || 
-                  typeIdentifier.contains("heic") || typeIdentifier.contains("heif") {
-            return "Image"
-        } else if typeIdentifier.contains("audio") || typeIdentifier.contains("mp3") || 
-                  typeIdentifier.contains("wav") || typeIdentifier.contains("m4a") {
-            return "Audio"
-        } else if typeIdentifier.contains("pdf") {
-            return "PDF"
-        } else if typeIdentifier.contains("zip") {
-            return "ZIP"
-        } else if typeIdentifier.contains("doc") || typeIdentifier.contains("word") {
-            return "Document"
-        } else {
-            return "File"
+        guard !rejected.isEmpty else { return }
+        MediaStaging.pickerItems.cancel(rejected)
+        await MainActor.run {
+            selectedItems.removeAll { rejected.contains($0) }
         }
     }
 }
@@ -326,35 +295,37 @@ struct MediaUploadHelper {
         var itemData: [HproseInstance.PendingTweetUpload.ItemData] = []
         
         // Process PhotosPicker items (videos and images)
-        for item in selectedItems {
+        // They were staged to files during preflight (or are staged now, in parallel);
+        // each file is read once, memory-mapped, and the staged files go either way
+        defer { MediaStaging.pickerItems.release(selectedItems) }
+        let stagedItems = try await MediaStaging.pickerItems.staged(inOrder: selectedItems)
+        for (item, staged) in zip(selectedItems, stagedItems) {
             do {
-                if let data = try await item.loadTransferable(type: Data.self) {
-                    print("DEBUG: Successfully loaded media data: \(data.count) bytes")
-                    
-                    // Get the type identifier and determine file extension
-                    let typeIdentifier = item.supportedContentTypes.first?.identifier ?? "public.image"
-                    let fileExtension = getFileExtension(for: typeIdentifier)
-                    print("📎 [MediaUpload] Prepared picker item: typeIdentifier=\(typeIdentifier), extension=\(fileExtension), size=\(data.count) bytes")
-                    
-                    
-                    // Create a unique filename with timestamp
-                    let timestamp = Int(Date().timeIntervalSince1970)
-                    let filename = "\(timestamp)_\(UUID().uuidString).\(fileExtension)"
-                    
-                    itemData.append(HproseInstance.PendingTweetUpload.ItemData(
-                        identifier: item.itemIdentifier ?? UUID().uuidString,
-                        typeIdentifier: typeIdentifier,
-                        data: data,
-                        fileName: filename,
-                        noResample: false
-                    ))
-                }
+                let data = try Data(contentsOf: staged.url, options: .mappedIfSafe)
+                print("DEBUG: Successfully loaded media data: \(data.count) bytes")
+                
+                // Get the type identifier and determine file extension
+                let typeIdentifier = item.supportedContentTypes.first?.identifier ?? "public.image"
+                let fileExtension = getFileExtension(for: typeIdentifier)
+                print("📎 [MediaUpload] Prepared picker item: typeIdentifier=\(typeIdentifier), extension=\(fileExtension), size=\(data.count) bytes")
+                
+                
+                // Create a unique filename with timestamp
+                let timestamp = Int(Date().timeIntervalSince1970)
+                let filename = "\(timestamp)_\(UUID().uuidString).\(fileExtension)"
+                
+                itemData.append(HproseInstance.PendingTweetUpload.ItemData(
+                    identifier: item.itemIdentifier ?? UUID().uuidString,
+                    typeIdentifier: typeIdentifier,
+                    data: data,
+                    fileName: filename,
+                    noResample: false
+                ))
             } catch {
                 print("DEBUG: Error loading media data: \(error)")
                 throw error
             }
         }
-        
         // Process camera images
         for image in selectedImages {
             // Validate image dimensions before processing
@@ -0,0 +1,406 @@
+//
+//  MediaStaging.swift
+//  Tweet
+//
+//  Preflight and preparation of picked media: each item is copied to a local file once,
+//  checked on its file metadata, and read from that file when the post is prepared.
+//
+
+import SwiftUI
+import PhotosUI
+import AVFoundation
+import ImageIO
+import UniformTypeIdentifiers
+
+/// What preflight learns about a picked item from its file, without reading it into memory.
+struct MediaMetadata: Sendable {
+    let byteCount: Int64
+    let contentType: UTType?
+    /// Videos only
+    let duration: TimeInterval?
+    /// Pixel size, orientation applied for videos
+    let pixelSize: CGSize?
+
+    /// Size from the file system, dimensions from the image header or the video track.
+    static func read(from url: URL, declaredType: UTType?) async -> MediaMetadata {
+        let values = try? url.resourceValues(forKeys: [.fileSizeKey, .contentTypeKey])
+        let byteCount = Int64(values?.fileSize ?? 0)
+        let contentType = declaredType ?? values?.contentType
+
+        if contentType?.conforms(to: .movie) == true || contentType?.conforms(to: .video) == true {
+            let asset = AVURLAsset(url: url)
+            let duration = try? await asset.load(.duration).seconds
+            var pixelSize: CGSize?
+            if let track = try? await asset.loadTracks(withMediaType: .video).first,
+               let geometry = try? await track.load(.naturalSize, .preferredTransform) {
+                let rotated = geometry.0.applying(geometry.1)
+                pixelSize = CGSize(width: abs(rotated.width), height: abs(rotated.height))
+            }
+            return MediaMetadata(byteCount: byteCount, contentType: contentType, duration: duration, pixelSize: pixelSize)
+        }
+
+        var pixelSize: CGSize?
+        if let source = CGImageSourceCreateWithURL(url as CFURL, nil),
+           let properties = CGImageSourceCopyPropertiesAtIndex(source, 0, nil) as? [CFString: Any],
+           let width = properties[kCGImagePropertyPixelWidth] as? Int,
+           let height = properties[kCGImagePropertyPixelHeight] as? Int {
+            pixelSize = CGSize(width: width, height: height)
+        }
+        return MediaMetadata(byteCount: byteCount, contentType: contentType, duration: nil, pixelSize: pixelSize)
+    }
+}
+
+/// A picked item copied to a local file, with its preflight metadata.
+struct StagedMedia: Sendable {
+    let url: URL
+    let metadata: MediaMetadata
+}
+
+/// A picked item that can be copied to a local file.
+protocol StageableMedia: Hashable {
+    var declaredContentType: UTType? { get }
+    /// Copy the item to a local file the stager then owns, reporting progress in 0...1.
+    func stageToFile(onProgress: @escaping @Sendable (Double) -> Void) async throws -> URL
+}
+
+/// Which picked files may be attached.
+struct MediaAdmissionPolicy {
+    var maxFileSize = Int64(Constants.MAX_FILE_SIZE)
+
+    /// The message to show when `metadata` is not allowed, nil when it is.
+    func rejection(for metadata: MediaMetadata) -> String? {
+        guard metadata.byteCount > maxFileSize else { return nil }
+        let fileType = Self.fileTypeDescription(metadata.contentType)
+        let fileSizeMB = Double(metadata.byteCount) / (1024 * 1024)
+        let maxSizeMB = Double(maxFileSize) / (1024 * 1024)
+        return String(format: NSLocalizedString("%@ file is too large (%.1fMB). Maximum allowed size is %.0fMB.", comment: "File size error message"), fileType, fileSizeMB, maxSizeMB)
+    }
+
+    private static func fileTypeDescription(_ type: UTType?) -> String {
+        guard let type else { return "File" }
+        if type.conforms(to: .movie) || type.conforms(to: .video) { return "Video" }
+        if type.conforms(to: .image) { return "Image" }
+        if type.conforms(to: .audio) { return "Audio" }
+        if type.conforms(to: .pdf) { return "PDF" }
+        if type.conforms(to: .zip) { return "ZIP" }
+        return "File"
+    }
+}
+
+enum MediaStagingError: LocalizedError {
+    case unavailable
+
+    var errorDescription: String? {
+        NSLocalizedString("Failed to load media", comment: "Picked media could not be loaded")
+    }
+}
+
+/// Stages picked items to files with bounded concurrency.
+///
+/// Each item is staged at most once however many callers ask for it (preflight, thumbnails,
+/// preparation); later callers join the running copy or get the staged file. Items wait in
+/// selection order for one of `maxConcurrent` slots. Cancelling an item (the user deselected it)
+/// cancels its copy, fails its waiters with `CancellationError` and deletes its file. Items a
+/// post is being prepared from are detached first, so clearing the form doesn't cancel them;
+/// they are deleted when the preparation releases them.
+final class MediaStager<Item: StageableMedia>: @unchecked Sendable {
+    private enum State {
+        case queued
+        case running(Task<Void, Never>)
+        case staged(StagedMedia)
+    }
+
+    private struct Entry {
+        let token = UUID()
+        var state = State.queued
+        var reportedProgress = 0.0
+        /// Claimed by a preparation; selection changes leave it alone
+        var isDetached = false
+        var waiters: [CheckedContinuation<StagedMedia, Error>] = []
+    }
+
+    private var entries: [Item: Entry] = [:]
+    private var queue: [Item] = []
+    private var running = 0
+    private let maxConcurrent: Int
+    private let onProgress: ((Item, Double) -> Void)?
+    private let lock = NSLock()
+    /// Progress is reported in steps of at least this much
+    private let progressStep = 0.05
+
+    init(maxConcurrent: Int, onProgress: ((Item, Double) -> Void)? = nil) {
+        self.maxConcurrent = maxConcurrent
+        self.onProgress = onProgress
+    }
+
+    // MARK: - Public Methods
+
+    /// Make `items` the selection: stage the new ones, cancel everything else.
+    func select(_ items: [Item]) {
+        let selected = Set(items)
+        let removed = lock.withLock {
+            entries.filter { !selected.contains($0.key) && !$0.value.isDetached }.map(\.key)
+        }
+        cancel(removed)
+        stage(items)
+    }
+
+    /// Take `items` out of the selection's hands before it is cleared, staging any that
+    /// aren't yet. Only `cancel` or `release` removes them afterwards.
+    func detach(_ items: [Item]) {
+        lock.withLock {
+            for item in items {
+                var entry = entries[item] ?? Entry()
+                if entries[item] == nil {
+                    queue.append(item)
+                }
+                entry.isDetached = true
+                entries[item] = entry
+            }
+        }
+        pump()
+    }
+
+    /// Queue `items` that aren't staged or queued yet, in order.
+    func stage(_ items: [Item]) {
+        lock.withLock {
+            for item in items where entries[item] == nil {
+                entries[item] = Entry()
+                queue.append(item)
+            }
+        }
+        pump()
+    }
+
+    /// The staged file for `item`, staging it first when needed.
+    func staged(_ item: Item) async throws -> StagedMedia {
+        try await withCheckedThrowingContinuation { continuation in
+            lock.withLock {
+                var entry: Entry
+                if let existing = entries[item] {
+                    entry = existing
+                } else {
+                    entry = Entry()
+                    queue.append(item)
+                }
+                if case .staged(let media) = entry.state {
+                    continuation.resume(returning: media)
+                    return
+                }
+                entry.waiters.append(continuation)
+                entries[item] = entry
+            }
+            pump()
+        }
+    }
+
+    /// Staged files for `items`, in the same order. All are queued up front, so they stage
+    /// in parallel up to the concurrency limit.
+    func staged(inOrder items: [Item]) async throws -> [StagedMedia] {
+        stage(items)
+        var result: [StagedMedia] = []
+        result.reserveCapacity(items.count)
+        for item in items {
+            try Task.checkCancellation()
+            result.append(try await staged(item))
+        }
+        return result
+    }
+
+    func cancel(_ items: [Item]) {
+        var cancelled: [Entry] = []
+        lock.withLock {
+            for item in items {
+                guard let entry = entries.removeValue(forKey: item) else { continue }
+                queue.removeAll { $0 == item }
+                cancelled.append(entry)
+            }
+        }
+        for entry in cancelled {
+            switch entry.state {
+            case .running(let task):
+                task.cancel()
+            case .staged(let media):
+                try? FileManager.default.removeItem(at: media.url)
+            case .queued:
+                break
+            }
+            entry.waiters.forEach { $0.resume(throwing: CancellationError()) }
+        }
+        pump()
+    }
+
+    /// Delete the staged files of `items` once their data has been handed on.
+    func release(_ items: [Item]) {
+        cancel(items)
+    }
+
+    // MARK: - Private
+
+    private func pump() {
+        lock.withLock {
+            while running < maxConcurrent, !queue.isEmpty {
+                let item = queue.removeFirst()
+                guard var entry = entries[item], case .queued = entry.state else { continue }
+                running += 1
+                let token = entry.token
+                let task = Task(priority: .userInitiated) { [weak self] in
+                    await self?.run(item, token: token)
+                }
+                entry.state = .running(task)
+                entries[item] = entry
+            }
+        }
+    }
+
+    private func run(_ item: Item, token: UUID) async {
+        let result: Result<StagedMedia, Error>
+        do {
+            let url = try await item.stageToFile { [weak self] fraction in
+                self?.report(item, token: token, fraction: fraction)
+            }
+            let metadata = await MediaMetadata.read(from: url, declaredType: item.declaredContentType)
+            result = .success(StagedMedia(url: url, metadata: metadata))
+        } catch {
+            result = .failure(error)
+        }
+
+        let waiters: [CheckedContinuation<StagedMedia, Error>]? = lock.withLock {
+            running -= 1
+            guard var entry = entries[item], entry.token == token else { return nil }
+            let waiters = entry.waiters
+            switch result {
+            case .success(let media):
+                entry.state = .staged(media)
+                entry.waiters = []
+                entries[item] = entry
+            case .failure:
+                // Forget failures so the next request tries again
+                entries.removeValue(forKey: item)
+            }
+            return waiters
+        }
+        if let waiters {
+            waiters.forEach { $0.resume(with: result) }
+            if case .success = result {
+                onProgress?(item, 1)
+            }
+        } else if case .success(let media) = result {
+            // Cancelled while the copy finished
+            try? FileManager.default.removeItem(at: media.url)
+        }
+        pump()
+    }
+
+    private func report(_ item: Item, token: UUID, fraction: Double) {
+        let shouldReport: Bool = lock.withLock {
+            guard var entry = entries[item], entry.token == token,
+                  fraction - entry.reportedProgress >= progressStep else { return false }
+            entry.reportedProgress = fraction
+            entries[item] = entry
+            return true
+        }
+        if shouldReport {
+            onProgress?(item, fraction)
+        }
+    }
+}
+
+// MARK: - Photos picker
+
+enum MediaStaging {
+    /// Staged copies live here until released; leftovers from a previous run are removed at launch.
+    static let directory: URL = {
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent("MediaStaging", isDirectory: true)
+        try? FileManager.default.removeItem(at: directory)
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        return directory
+    }()
+
+    /// Videos are copied from the photo library (and possibly iCloud); three at a time keeps
+    /// the first thumbnails quick without saturating I/O.
+    static let pickerItems = MediaStager<PhotosPickerItem>(maxConcurrent: 3) { item, fraction in
+        Task { @MainActor in
+            MediaStagingProgress.shared.update(item, fraction: fraction)
+        }
+    }
+
+    static let policy = MediaAdmissionPolicy()
+}
+
+/// Staging progress of picked items, for their previews.
+@MainActor
+final class MediaStagingProgress: ObservableObject {
+    static let shared = MediaStagingProgress()
+
+    /// Items still being copied; removed once staged
+    @Published private(set) var fractions: [PhotosPickerItem: Double] = [:]
+
+    func update(_ item: PhotosPickerItem, fraction: Double) {
+        if fraction >= 1 {
+            fractions.removeValue(forKey: item)
+        } else {
+            fractions[item] = fraction
+        }
+    }
+
+    func retain(only items: [PhotosPickerItem]) {
+        let selected = Set(items)
+        fractions = fractions.filter { selected.contains($0.key) }
+    }
+}
+
+/// A picked item received as a file; the copy is cloned into `MediaStaging.directory`.
+private struct StagedPickerFile: Transferable {
+    let url: URL
+
+    static var transferRepresentation: some TransferRepresentation {
+        FileRepresentation(importedContentType: .movie) { try StagedPickerFile(copying: $0.file) }
+        FileRepresentation(importedContentType: .image) { try StagedPickerFile(copying: $0.file) }
+        FileRepresentation(importedContentType: .data) { try StagedPickerFile(copying: $0.file) }
+    }
+
+    init(copying received: URL) throws {
+        // The received file is deleted when the import returns
+        let destination = MediaStaging.directory.appendingPathComponent("\(UUID().uuidString).\(received.pathExtension)")
+        try FileManager.default.copyItem(at: received, to: destination)
+        url = destination
+    }
+}
+
+/// Holds the load's Progress for cancellation and its observation until the load completes.
+private final class PickerLoad: @unchecked Sendable {
+    var progress: Progress?
+    var observation: NSKeyValueObservation?
+}
+
+extension PhotosPickerItem: StageableMedia {
+    var declaredContentType: UTType? {
+        supportedContentTypes.first
+    }
+
+    func stageToFile(onProgress: @escaping @Sendable (Double) -> Void) async throws -> URL {
+        let load = PickerLoad()
+        return try await withTaskCancellationHandler {
+            try await withCheckedThrowingContinuation { continuation in
+                let progress = loadTransferable(type: StagedPickerFile.self) { result in
+                    load.observation?.invalidate()
+                    switch result {
+                    case .success(let file?):
+                        continuation.resume(returning: file.url)
+                    case .success(nil):
+                        continuation.resume(throwing: MediaStagingError.unavailable)
+                    case .failure(let error):
+                        continuation.resume(throwing: error)
+                    }
+                }
+                load.progress = progress
+                load.observation = progress.observe(\.fractionCompleted) { progress, _ in
+                    onProgress(progress.fractionCompleted)
+                }
+            }
+        } onCancel: {
+            load.progress?.cancel()
+        }
+    }
+}